@@ -0,0 +1,46 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by CMake Version 3.25
+cmake_policy(SET CMP0009 NEW)
+
+# _toolbox_test_srcs at CMakeLists.txt:69 (file)
+file(GLOB_RECURSE NEW_GLOB LIST_DIRECTORIES false "/root/repo/tests/*.cpp")
+set(OLD_GLOB
+  "/root/repo/tests/bioinfo/extension_alignment/main.cpp"
+  "/root/repo/tests/bioinfo/global_alignment/main.cpp"
+  "/root/repo/tests/bioinfo/local_alignment/main.cpp"
+  "/root/repo/tests/bioinfo/multiple_alignment/main.cpp"
+  "/root/repo/tests/bioinfo/overlap_alignment/main.cpp"
+  "/root/repo/tests/bioinfo/rna_2d/main.cpp"
+  "/root/repo/tests/bioinfo/seed_alignment/main.cpp"
+  "/root/repo/tests/datastructure/implicit_treap/main.cpp"
+  "/root/repo/tests/datastructure/sparse_table/main.cpp"
+  "/root/repo/tests/datastructure/treap/main.cpp"
+  "/root/repo/tests/datastructure/unionfind/main.cpp"
+  "/root/repo/tests/datastructure/unionfind_weighted/main.cpp"
+  "/root/repo/tests/datastructure/wavelet_tree/main.cpp"
+  "/root/repo/tests/graph/bellman_ford/main.cpp"
+  "/root/repo/tests/graph/boruvka/main.cpp"
+  "/root/repo/tests/graph/diameter_tree/main.cpp"
+  "/root/repo/tests/graph/dijkstra/main.cpp"
+  "/root/repo/tests/graph/kruskal/main.cpp"
+  "/root/repo/tests/graph/prim/main.cpp"
+  "/root/repo/tests/graph/topological/main.cpp"
+  "/root/repo/tests/math/main.cpp"
+  "/root/repo/tests/parallel/thread_pool/main.cpp"
+  "/root/repo/tests/probabilistic/bloom_filter/main.cpp"
+  "/root/repo/tests/sorting/main.cpp"
+  "/root/repo/tests/string/boyer_moore/main.cpp"
+  "/root/repo/tests/string/fm_index/main.cpp"
+  "/root/repo/tests/string/kmp/main.cpp"
+  "/root/repo/tests/string/morris_pratt/main.cpp"
+  "/root/repo/tests/string/packed_dna/main.cpp"
+  "/root/repo/tests/string/patricia_trie/main.cpp"
+  "/root/repo/tests/string/rabin_karp/main.cpp"
+  "/root/repo/tests/string/suffixarray/main.cpp"
+  "/root/repo/tests/string/trie/main.cpp"
+  "/root/repo/tests/string/zalgorithm/main.cpp"
+  )
+if(NOT "${NEW_GLOB}" STREQUAL "${OLD_GLOB}")
+  message("-- GLOB mismatch!")
+  file(TOUCH_NOCREATE "/root/repo/build/release/CMakeFiles/cmake.verify_globs")
+endif()
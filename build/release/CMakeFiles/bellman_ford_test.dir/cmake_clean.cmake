@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bellman_ford_test.dir/tests/graph/bellman_ford/main.cpp.o"
+  "CMakeFiles/bellman_ford_test.dir/tests/graph/bellman_ford/main.cpp.o.d"
+  "bellman_ford_test"
+  "bellman_ford_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bellman_ford_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bloom_filter_test.dir/tests/probabilistic/bloom_filter/main.cpp.o"
+  "CMakeFiles/bloom_filter_test.dir/tests/probabilistic/bloom_filter/main.cpp.o.d"
+  "bloom_filter_test"
+  "bloom_filter_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bloom_filter_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/boruvka_test.dir/tests/graph/boruvka/main.cpp.o"
+  "CMakeFiles/boruvka_test.dir/tests/graph/boruvka/main.cpp.o.d"
+  "boruvka_test"
+  "boruvka_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/boruvka_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/boyer_moore_test.dir/tests/string/boyer_moore/main.cpp.o"
+  "CMakeFiles/boyer_moore_test.dir/tests/string/boyer_moore/main.cpp.o.d"
+  "boyer_moore_test"
+  "boyer_moore_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/boyer_moore_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/diameter_tree_test.dir/tests/graph/diameter_tree/main.cpp.o"
+  "CMakeFiles/diameter_tree_test.dir/tests/graph/diameter_tree/main.cpp.o.d"
+  "diameter_tree_test"
+  "diameter_tree_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/diameter_tree_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/extension_alignment_test.dir/tests/bioinfo/extension_alignment/main.cpp.o"
+  "CMakeFiles/extension_alignment_test.dir/tests/bioinfo/extension_alignment/main.cpp.o.d"
+  "extension_alignment_test"
+  "extension_alignment_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/extension_alignment_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/global_alignment_test.dir/tests/bioinfo/global_alignment/main.cpp.o"
+  "CMakeFiles/global_alignment_test.dir/tests/bioinfo/global_alignment/main.cpp.o.d"
+  "global_alignment_test"
+  "global_alignment_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/global_alignment_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
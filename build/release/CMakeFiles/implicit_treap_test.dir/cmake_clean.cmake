@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/implicit_treap_test.dir/tests/datastructure/implicit_treap/main.cpp.o"
+  "CMakeFiles/implicit_treap_test.dir/tests/datastructure/implicit_treap/main.cpp.o.d"
+  "implicit_treap_test"
+  "implicit_treap_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/implicit_treap_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
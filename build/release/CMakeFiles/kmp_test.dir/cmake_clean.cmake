@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/kmp_test.dir/tests/string/kmp/main.cpp.o"
+  "CMakeFiles/kmp_test.dir/tests/string/kmp/main.cpp.o.d"
+  "kmp_test"
+  "kmp_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/kmp_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/kruskal_test.dir/tests/graph/kruskal/main.cpp.o"
+  "CMakeFiles/kruskal_test.dir/tests/graph/kruskal/main.cpp.o.d"
+  "kruskal_test"
+  "kruskal_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/kruskal_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
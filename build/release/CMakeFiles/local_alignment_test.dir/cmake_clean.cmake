@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/local_alignment_test.dir/tests/bioinfo/local_alignment/main.cpp.o"
+  "CMakeFiles/local_alignment_test.dir/tests/bioinfo/local_alignment/main.cpp.o.d"
+  "local_alignment_test"
+  "local_alignment_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/local_alignment_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/math_test.dir/tests/math/main.cpp.o"
+  "CMakeFiles/math_test.dir/tests/math/main.cpp.o.d"
+  "math_test"
+  "math_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/math_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
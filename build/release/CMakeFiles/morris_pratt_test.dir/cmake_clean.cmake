@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/morris_pratt_test.dir/tests/string/morris_pratt/main.cpp.o"
+  "CMakeFiles/morris_pratt_test.dir/tests/string/morris_pratt/main.cpp.o.d"
+  "morris_pratt_test"
+  "morris_pratt_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/morris_pratt_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
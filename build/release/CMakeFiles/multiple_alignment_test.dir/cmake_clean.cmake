@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/multiple_alignment_test.dir/tests/bioinfo/multiple_alignment/main.cpp.o"
+  "CMakeFiles/multiple_alignment_test.dir/tests/bioinfo/multiple_alignment/main.cpp.o.d"
+  "multiple_alignment_test"
+  "multiple_alignment_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/multiple_alignment_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
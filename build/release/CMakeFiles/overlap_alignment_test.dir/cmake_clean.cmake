@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/overlap_alignment_test.dir/tests/bioinfo/overlap_alignment/main.cpp.o"
+  "CMakeFiles/overlap_alignment_test.dir/tests/bioinfo/overlap_alignment/main.cpp.o.d"
+  "overlap_alignment_test"
+  "overlap_alignment_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/overlap_alignment_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/packed_dna_test.dir/tests/string/packed_dna/main.cpp.o"
+  "CMakeFiles/packed_dna_test.dir/tests/string/packed_dna/main.cpp.o.d"
+  "packed_dna_test"
+  "packed_dna_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/packed_dna_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
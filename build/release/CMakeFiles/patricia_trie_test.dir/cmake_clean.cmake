@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/patricia_trie_test.dir/tests/string/patricia_trie/main.cpp.o"
+  "CMakeFiles/patricia_trie_test.dir/tests/string/patricia_trie/main.cpp.o.d"
+  "patricia_trie_test"
+  "patricia_trie_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/patricia_trie_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/prim_test.dir/tests/graph/prim/main.cpp.o"
+  "CMakeFiles/prim_test.dir/tests/graph/prim/main.cpp.o.d"
+  "prim_test"
+  "prim_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/prim_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
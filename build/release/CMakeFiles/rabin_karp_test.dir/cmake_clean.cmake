@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/rabin_karp_test.dir/tests/string/rabin_karp/main.cpp.o"
+  "CMakeFiles/rabin_karp_test.dir/tests/string/rabin_karp/main.cpp.o.d"
+  "rabin_karp_test"
+  "rabin_karp_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/rabin_karp_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/rna_2d_test.dir/tests/bioinfo/rna_2d/main.cpp.o"
+  "CMakeFiles/rna_2d_test.dir/tests/bioinfo/rna_2d/main.cpp.o.d"
+  "rna_2d_test"
+  "rna_2d_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/rna_2d_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/seed_alignment_test.dir/tests/bioinfo/seed_alignment/main.cpp.o"
+  "CMakeFiles/seed_alignment_test.dir/tests/bioinfo/seed_alignment/main.cpp.o.d"
+  "seed_alignment_test"
+  "seed_alignment_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/seed_alignment_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/sparse_table_test.dir/tests/datastructure/sparse_table/main.cpp.o"
+  "CMakeFiles/sparse_table_test.dir/tests/datastructure/sparse_table/main.cpp.o.d"
+  "sparse_table_test"
+  "sparse_table_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/sparse_table_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/suffixarray_test.dir/tests/string/suffixarray/main.cpp.o"
+  "CMakeFiles/suffixarray_test.dir/tests/string/suffixarray/main.cpp.o.d"
+  "suffixarray_test"
+  "suffixarray_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/suffixarray_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/topological_test.dir/tests/graph/topological/main.cpp.o"
+  "CMakeFiles/topological_test.dir/tests/graph/topological/main.cpp.o.d"
+  "topological_test"
+  "topological_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/topological_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
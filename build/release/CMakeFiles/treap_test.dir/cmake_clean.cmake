@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/treap_test.dir/tests/datastructure/treap/main.cpp.o"
+  "CMakeFiles/treap_test.dir/tests/datastructure/treap/main.cpp.o.d"
+  "treap_test"
+  "treap_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/treap_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
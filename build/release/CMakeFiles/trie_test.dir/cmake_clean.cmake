@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/trie_test.dir/tests/string/trie/main.cpp.o"
+  "CMakeFiles/trie_test.dir/tests/string/trie/main.cpp.o.d"
+  "trie_test"
+  "trie_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/trie_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/unionfind_test.dir/tests/datastructure/unionfind/main.cpp.o"
+  "CMakeFiles/unionfind_test.dir/tests/datastructure/unionfind/main.cpp.o.d"
+  "unionfind_test"
+  "unionfind_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/unionfind_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
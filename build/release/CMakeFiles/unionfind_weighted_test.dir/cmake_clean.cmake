@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/unionfind_weighted_test.dir/tests/datastructure/unionfind_weighted/main.cpp.o"
+  "CMakeFiles/unionfind_weighted_test.dir/tests/datastructure/unionfind_weighted/main.cpp.o.d"
+  "unionfind_weighted_test"
+  "unionfind_weighted_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/unionfind_weighted_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
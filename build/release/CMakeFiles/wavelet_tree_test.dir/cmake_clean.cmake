@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/wavelet_tree_test.dir/tests/datastructure/wavelet_tree/main.cpp.o"
+  "CMakeFiles/wavelet_tree_test.dir/tests/datastructure/wavelet_tree/main.cpp.o.d"
+  "wavelet_tree_test"
+  "wavelet_tree_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/wavelet_tree_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/zalgorithm_test.dir/tests/string/zalgorithm/main.cpp.o"
+  "CMakeFiles/zalgorithm_test.dir/tests/string/zalgorithm/main.cpp.o.d"
+  "zalgorithm_test"
+  "zalgorithm_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/zalgorithm_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
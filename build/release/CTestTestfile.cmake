@@ -0,0 +1,74 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/build/release
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test([=[extension_alignment_test]=] "/root/repo/build/release/extension_alignment_test")
+set_tests_properties([=[extension_alignment_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[global_alignment_test]=] "/root/repo/build/release/global_alignment_test")
+set_tests_properties([=[global_alignment_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[local_alignment_test]=] "/root/repo/build/release/local_alignment_test")
+set_tests_properties([=[local_alignment_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[multiple_alignment_test]=] "/root/repo/build/release/multiple_alignment_test")
+set_tests_properties([=[multiple_alignment_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[overlap_alignment_test]=] "/root/repo/build/release/overlap_alignment_test")
+set_tests_properties([=[overlap_alignment_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[rna_2d_test]=] "/root/repo/build/release/rna_2d_test")
+set_tests_properties([=[rna_2d_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[seed_alignment_test]=] "/root/repo/build/release/seed_alignment_test")
+set_tests_properties([=[seed_alignment_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[implicit_treap_test]=] "/root/repo/build/release/implicit_treap_test")
+set_tests_properties([=[implicit_treap_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[sparse_table_test]=] "/root/repo/build/release/sparse_table_test")
+set_tests_properties([=[sparse_table_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[treap_test]=] "/root/repo/build/release/treap_test")
+set_tests_properties([=[treap_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[unionfind_test]=] "/root/repo/build/release/unionfind_test")
+set_tests_properties([=[unionfind_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[unionfind_weighted_test]=] "/root/repo/build/release/unionfind_weighted_test")
+set_tests_properties([=[unionfind_weighted_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[wavelet_tree_test]=] "/root/repo/build/release/wavelet_tree_test")
+set_tests_properties([=[wavelet_tree_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[bellman_ford_test]=] "/root/repo/build/release/bellman_ford_test")
+set_tests_properties([=[bellman_ford_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[boruvka_test]=] "/root/repo/build/release/boruvka_test")
+set_tests_properties([=[boruvka_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[diameter_tree_test]=] "/root/repo/build/release/diameter_tree_test")
+set_tests_properties([=[diameter_tree_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[dijkstra_test]=] "/root/repo/build/release/dijkstra_test")
+set_tests_properties([=[dijkstra_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[kruskal_test]=] "/root/repo/build/release/kruskal_test")
+set_tests_properties([=[kruskal_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[prim_test]=] "/root/repo/build/release/prim_test")
+set_tests_properties([=[prim_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[topological_test]=] "/root/repo/build/release/topological_test")
+set_tests_properties([=[topological_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[math_test]=] "/root/repo/build/release/math_test")
+set_tests_properties([=[math_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[thread_pool_test]=] "/root/repo/build/release/thread_pool_test")
+set_tests_properties([=[thread_pool_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[bloom_filter_test]=] "/root/repo/build/release/bloom_filter_test")
+set_tests_properties([=[bloom_filter_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[sorting_test]=] "/root/repo/build/release/sorting_test")
+set_tests_properties([=[sorting_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[boyer_moore_test]=] "/root/repo/build/release/boyer_moore_test")
+set_tests_properties([=[boyer_moore_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[fm_index_test]=] "/root/repo/build/release/fm_index_test")
+set_tests_properties([=[fm_index_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[kmp_test]=] "/root/repo/build/release/kmp_test")
+set_tests_properties([=[kmp_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[morris_pratt_test]=] "/root/repo/build/release/morris_pratt_test")
+set_tests_properties([=[morris_pratt_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[packed_dna_test]=] "/root/repo/build/release/packed_dna_test")
+set_tests_properties([=[packed_dna_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[patricia_trie_test]=] "/root/repo/build/release/patricia_trie_test")
+set_tests_properties([=[patricia_trie_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[rabin_karp_test]=] "/root/repo/build/release/rabin_karp_test")
+set_tests_properties([=[rabin_karp_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[suffixarray_test]=] "/root/repo/build/release/suffixarray_test")
+set_tests_properties([=[suffixarray_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[trie_test]=] "/root/repo/build/release/trie_test")
+set_tests_properties([=[trie_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[zalgorithm_test]=] "/root/repo/build/release/zalgorithm_test")
+set_tests_properties([=[zalgorithm_test]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;59;add_test;/root/repo/CMakeLists.txt;78;toolbox_add_test;/root/repo/CMakeLists.txt;0;")
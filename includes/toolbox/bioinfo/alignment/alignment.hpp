@@ -1,7 +1,25 @@
 #pragma once
+#include "toolbox/bioinfo/alignment/extension_alignment/xdrop.hpp"
+#include "toolbox/bioinfo/alignment/global_alignment/banded.hpp"
 #include "toolbox/bioinfo/alignment/global_alignment/diff.hpp"
+#include "toolbox/bioinfo/alignment/global_alignment/hirschberg.hpp"
+#include "toolbox/bioinfo/alignment/global_alignment/myers_bitvector.hpp"
 #include "toolbox/bioinfo/alignment/global_alignment/nw.hpp"
+#include "toolbox/bioinfo/alignment/global_alignment/nw_scored.hpp"
 #include "toolbox/bioinfo/alignment/global_alignment/nwg.hpp"
 #include "toolbox/bioinfo/alignment/global_alignment/wavefront.hpp"
+#include "toolbox/bioinfo/alignment/global_alignment/wavefront_compact.hpp"
 #include "toolbox/bioinfo/alignment/local_alignment/smith_waterman.hpp"
+#include "toolbox/bioinfo/alignment/local_alignment/smith_waterman_banded.hpp"
+#include "toolbox/bioinfo/alignment/local_alignment/smith_waterman_batch.hpp"
+#include "toolbox/bioinfo/alignment/local_alignment/smith_waterman_hirschberg.hpp"
+#include "toolbox/bioinfo/alignment/local_alignment/smith_waterman_scored.hpp"
+#include "toolbox/bioinfo/alignment/local_alignment/smith_waterman_striped.hpp"
+#include "toolbox/bioinfo/alignment/multiple_alignment/progressive.hpp"
 #include "toolbox/bioinfo/alignment/overlap_alignment/overlap.hpp"
+#include "toolbox/bioinfo/alignment/overlap_alignment/overlap_hirschberg.hpp"
+#include "toolbox/bioinfo/alignment/scoring.hpp"
+#include "toolbox/bioinfo/alignment/seed_alignment/kmer_index.hpp"
+#include "toolbox/bioinfo/alignment/seed_alignment/seed_chain.hpp"
+#include "toolbox/bioinfo/alignment/tiled_dp.hpp"
+#include "toolbox/bioinfo/alignment/traceback.hpp"
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "toolbox/bioinfo/alignment/traceback.hpp"
+
+namespace toolbox {
+
+namespace alignment {
+
+/**
+ * @brief Gapped X-drop extension (BLAST-style) from the start of both strings.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment (score, coordinates and CIGAR) of a prefix of s1 with a prefix of s2.
+ * @param X The drop-off: cells scoring more than X below the best score so far are pruned.
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param g The gap penalty.
+ * @return The best score of an alignment of a prefix of s1 with a prefix of s2.
+ * @note max-score alignment anchored at (0, 0), as used to extend a seed hit: call it on the
+ * sequences after the seed (and on the reversed sequences before it). Unlike Smith-Waterman no
+ * cell is floored at 0, and the extension stops once a whole row has dropped more than X below
+ * the best score. With X large enough the result is the best prefix-prefix alignment score.
+ * @note Row i only stores the window of columns still alive (within X of the best), so the
+ * traceback needs one byte per live cell rather than a full (m + 1)(n + 1) table.
+ * @note [Complexity]: O(sum of live window widths) time and space complexity, at most O(nm).
+ */
+int xdrop_extend(const std::string &s1, const std::string &s2, alignment_result &res, int X,
+                 int a = 1, int x = 1, int g = 1) {
+    const int m = static_cast<int>(s1.size());
+    const int n = static_cast<int>(s2.size());
+    const int NEG = -(1 << 29);
+    std::vector<int> prev(n + 1, NEG), cur(n + 1, NEG);
+    std::vector<uint8_t> tb;
+    std::vector<std::size_t> row_start;
+    std::vector<int> row_lo;
+    int best = 0;
+    int bi = 0;
+    int bj = 0;
+    int plo = 0;
+    int phi = -1;  // live window of the previous row (empty before row 0)
+    for (int i = 0; i <= m; i++) {
+        const int cutoff = best - X;
+        const int lo = i == 0 ? 0 : plo;
+        row_start.push_back(tb.size());
+        row_lo.push_back(lo);
+        int last = lo - 1;  // last column computed in this row
+        for (int j = lo; j <= n; j++) {
+            int h = NEG;
+            uint8_t from = detail::TB_STOP;
+            if (i == 0 && j == 0) {
+                h = 0;
+            }
+            if (i > 0 && j > 0 && j - 1 >= plo && j - 1 <= phi && prev[j - 1] > NEG) {
+                h = prev[j - 1] + (s1[i - 1] == s2[j - 1] ? a : -x);
+                from = detail::TB_DIAG;
+            }
+            if (i > 0 && j <= phi && prev[j] > NEG && prev[j] - g > h) {
+                h = prev[j] - g;
+                from = detail::TB_UP;
+            }
+            if (j > lo && cur[j - 1] > NEG && cur[j - 1] - g > h) {
+                h = cur[j - 1] - g;
+                from = detail::TB_LEFT;
+            }
+            if (h < cutoff) {
+                h = NEG;
+            }
+            // Past the previous window only the left neighbour can feed a cell.
+            if (h == NEG && j > phi) {
+                break;
+            }
+            cur[j] = h;
+            tb.push_back(from);
+            last = j;
+            if (h > best) {
+                best = h;
+                bi = i;
+                bj = j;
+            }
+        }
+        // Trim the dead cells at both ends of the row.
+        int nlo = lo;
+        int nhi = last;
+        while (nlo <= nhi && cur[nlo] < best - X) {
+            nlo++;
+        }
+        while (nhi >= nlo && cur[nhi] < best - X) {
+            nhi--;
+        }
+        if (nlo > nhi) {
+            break;
+        }
+        for (int j = nlo; j <= nhi; j++) {
+            if (cur[j] < best - X) {
+                cur[j] = NEG;
+            }
+        }
+        prev.swap(cur);
+        plo = nlo;
+        phi = nhi;
+    }
+    res.ops.clear();
+    int i = bi;
+    int j = bj;
+    while (i > 0 || j > 0) {
+        const uint8_t from = tb[row_start[i] + (j - row_lo[i])];
+        if (from == detail::TB_DIAG) {
+            detail::cigar_push(res.ops, 'M');
+            i--;
+            j--;
+        } else if (from == detail::TB_UP) {
+            detail::cigar_push(res.ops, 'D');
+            i--;
+        } else {
+            detail::cigar_push(res.ops, 'I');
+            j--;
+        }
+    }
+    detail::cigar_finish(res.ops);
+    detail::finish_result(res, best, 0, 0);
+    return best;
+}
+
+/**
+ * @brief Gapped X-drop extension (BLAST-style) from the start of both strings.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param s1_aligned The first aligned string (a prefix of s1 with gaps).
+ * @param s2_aligned The second aligned string (a prefix of s2 with gaps).
+ * @param X The drop-off: cells scoring more than X below the best score so far are pruned.
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param g The gap penalty.
+ * @return The best score of an alignment of a prefix of s1 with a prefix of s2.
+ * @note Same alignment as the alignment_result overload, expanded to gapped strings.
+ */
+int xdrop_extend(const std::string &s1, const std::string &s2, std::string &s1_aligned,
+                 std::string &s2_aligned, int X, int a = 1, int x = 1, int g = 1) {
+    alignment_result res;
+    xdrop_extend(s1, s2, res, X, a, x, g);
+    alignment_to_aligned(s1, s2, res, s1_aligned, s2_aligned);
+    return res.score;
+}
+
+}  // namespace alignment
+
+}  // namespace toolbox
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "toolbox/bioinfo/alignment/traceback.hpp"
+#include "toolbox/string/packed_dna.hpp"
+
+namespace toolbox {
+
+namespace alignment {
+
+namespace detail {
+
+/**
+ * @brief Layout of the cells |i - j| <= w of an (m + 1) x (n + 1) DP table.
+ * @note Row i keeps the 2w + 1 slots j = i - w .. i + w (those outside [0, n] are unused), so a
+ * banded table needs (m + 1)(2w + 1) entries instead of (m + 1)(n + 1).
+ */
+struct band_layout {
+    int m, n, w;
+
+    band_layout(int rows, int cols, int width) : m(rows), n(cols), w(width) {}
+
+    int lo(int i) const { return std::max(0, i - w); }
+    int hi(int i) const { return std::min(n, i + w); }
+    std::size_t index(int i, int j) const {
+        return static_cast<std::size_t>(i) * (2 * w + 1) + (j - i + w);
+    }
+    std::size_t size() const { return static_cast<std::size_t>(m + 1) * (2 * w + 1); }
+};
+
+/**
+ * @brief needleman_wunsch_banded on any sequence type with size() and operator[].
+ */
+template <typename Seq>
+int nw_banded_kernel(const Seq &s1, const Seq &s2, alignment_result &res, int w, int a, int x,
+                     int g) {
+    const int m = static_cast<int>(s1.size());
+    const int n = static_cast<int>(s2.size());
+    const band_layout band(m, n, std::max(w, std::abs(m - n)));
+    packed_traceback<2> tb(band.size());
+    std::vector<int> prev(n + 1), cur(n + 1);
+    for (int i = 0; i <= m; i++) {
+        const int lo = band.lo(i);
+        const int hi = band.hi(i);
+        for (int j = lo; j <= hi; j++) {
+            if (i == 0 && j == 0) {
+                cur[0] = 0;
+                continue;
+            }
+            int best = 1 << 30;
+            uint8_t from = TB_DIAG;
+            if (i > 0 && j > 0) {
+                best = prev[j - 1] + (s1[i - 1] == s2[j - 1] ? a : x);
+            }
+            if (i > 0 && j <= i - 1 + band.w && prev[j] + g < best) {
+                best = prev[j] + g;
+                from = TB_UP;
+            }
+            if (j > lo && cur[j - 1] + g < best) {
+                best = cur[j - 1] + g;
+                from = TB_LEFT;
+            }
+            cur[j] = best;
+            tb.set(band.index(i, j), from);
+        }
+        prev.swap(cur);
+    }
+    res.ops.clear();
+    int i = m;
+    int j = n;
+    while (i > 0 || j > 0) {
+        const uint8_t from = tb.get(band.index(i, j));
+        if (from == TB_DIAG) {
+            cigar_push(res.ops, 'M');
+            i--;
+            j--;
+        } else if (from == TB_UP) {
+            cigar_push(res.ops, 'D');
+            i--;
+        } else {
+            cigar_push(res.ops, 'I');
+            j--;
+        }
+    }
+    cigar_finish(res.ops);
+    finish_result(res, prev[n], 0, 0);
+    return res.score;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Banded Needleman-Wunsch algorithm for global alignment.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment (score and CIGAR).
+ * @param w The band width: only cells with |i - j| <= w are computed.
+ * @param a The match cost.
+ * @param x The mismatch cost.
+ * @param g The gap cost.
+ * @return The minimum cost of an alignment that stays inside the band.
+ * @note min-cost alignment. w is widened to |m - n| if needed so that the band contains the end
+ * cell. The result equals needleman_wunsch_all whenever an optimal alignment stays within the
+ * band, e.g. when w >= the number of gaps it needs.
+ * @note The DP keeps two rolling rows of scores and 2 traceback bits per band cell.
+ * @note [Complexity]: O(w(m + n)) time complexity and O(w m + n) space complexity.
+ */
+int needleman_wunsch_banded(const std::string &s1, const std::string &s2, alignment_result &res,
+                            int w, int a = 0, int x = 1, int g = 1) {
+    return detail::nw_banded_kernel(s1, s2, res, w, a, x, g);
+}
+
+/**
+ * @brief Banded Needleman-Wunsch algorithm for global alignment.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param s1_aligned The first aligned string.
+ * @param s2_aligned The second aligned string.
+ * @param w The band width: only cells with |i - j| <= w are computed.
+ * @param a The match cost.
+ * @param x The mismatch cost.
+ * @param g The gap cost.
+ * @return The minimum cost of an alignment that stays inside the band.
+ * @note Same alignment as the alignment_result overload, expanded to gapped strings.
+ */
+int needleman_wunsch_banded(const std::string &s1, const std::string &s2, std::string &s1_aligned,
+                            std::string &s2_aligned, int w, int a = 0, int x = 1, int g = 1) {
+    alignment_result res;
+    needleman_wunsch_banded(s1, s2, res, w, a, x, g);
+    alignment_to_aligned(s1, s2, res, s1_aligned, s2_aligned);
+    return res.score;
+}
+
+/**
+ * @brief Banded Needleman-Wunsch algorithm for global alignment of packed DNA sequences.
+ * @param s1 The first sequence.
+ * @param s2 The second sequence.
+ * @param res The alignment (score and CIGAR).
+ * @param w The band width: only cells with |i - j| <= w are computed.
+ * @param a The match cost.
+ * @param x The mismatch cost.
+ * @param g The gap cost.
+ * @return The same cost and alignment as for the unpacked strings.
+ * @note The bases are read from the 2-bit words in place.
+ * @note [Complexity]: O(w(m + n)) time complexity and O(w m + n) space complexity.
+ */
+int needleman_wunsch_banded(const string::packed_dna &s1, const string::packed_dna &s2,
+                            alignment_result &res, int w, int a = 0, int x = 1, int g = 1) {
+    return detail::nw_banded_kernel(s1, s2, res, w, a, x, g);
+}
+
+/**
+ * @brief Banded Needleman-Wunsch-Gotoh algorithm for global alignment with affine gaps.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment (score and CIGAR).
+ * @param w The band width: only cells with |i - j| <= w are computed.
+ * @param a The match cost.
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @return The minimum cost of an alignment that stays inside the band.
+ * @note min-cost alignment with the same M / D / I recurrences as needleman_wunsch_gotoh_dp.
+ * w is widened to |m - n| if needed so that the band contains the end cell.
+ * @note The DP keeps rolling rows of M, D and I and 4 traceback bits per band cell (the source
+ * of M, and whether D and I extend or open a gap).
+ * @note [Complexity]: O(w(m + n)) time complexity and O(w m + n) space complexity.
+ */
+int needleman_wunsch_gotoh_banded(const std::string &s1, const std::string &s2,
+                                  alignment_result &res, int w, int a = 0, int x = 1, int o = 0,
+                                  int e = 1) {
+    const int m = static_cast<int>(s1.size());
+    const int n = static_cast<int>(s2.size());
+    const int INF = 1 << 29;
+    const detail::band_layout band(m, n, std::max(w, std::abs(m - n)));
+    detail::packed_traceback<4> tb(band.size());
+    std::vector<int> pM(n + 1), pD(n + 1), cM(n + 1), cD(n + 1), cI(n + 1);
+    for (int i = 0; i <= m; i++) {
+        const int lo = band.lo(i);
+        const int hi = band.hi(i);
+        for (int j = lo; j <= hi; j++) {
+            if (i == 0 && j == 0) {
+                cM[0] = 0;
+                cD[0] = cI[0] = INF;
+                continue;
+            }
+            uint8_t from = 0;
+            int d = INF;
+            if (i > 0 && j <= i - 1 + band.w) {
+                d = pM[j] + o + e;
+                if (pD[j] + e < d) {
+                    d = pD[j] + e;
+                    from |= detail::TB_D_EXTEND;
+                }
+            }
+            int ins = INF;
+            if (j > lo) {
+                ins = cM[j - 1] + o + e;
+                if (cI[j - 1] + e < ins) {
+                    ins = cI[j - 1] + e;
+                    from |= detail::TB_I_EXTEND;
+                }
+            }
+            int best = INF;
+            uint8_t src = detail::TB_DIAG;
+            if (i > 0 && j > 0) {
+                best = pM[j - 1] + (s1[i - 1] == s2[j - 1] ? a : x);
+            }
+            if (d < best) {
+                best = d;
+                src = detail::TB_UP;
+            }
+            if (ins < best) {
+                best = ins;
+                src = detail::TB_LEFT;
+            }
+            cM[j] = best;
+            cD[j] = d;
+            cI[j] = ins;
+            tb.set(band.index(i, j), from | src);
+        }
+        pM.swap(cM);
+        pD.swap(cD);
+    }
+    res.ops.clear();
+    int i = m;
+    int j = n;
+    uint8_t state = detail::TB_DIAG;
+    while (i > 0 || j > 0) {
+        const uint8_t t = tb.get(band.index(i, j));
+        if (state == detail::TB_DIAG) {
+            state = t & 3;
+            if (state == detail::TB_DIAG) {
+                detail::cigar_push(res.ops, 'M');
+                i--;
+                j--;
+            }
+        } else if (state == detail::TB_UP) {
+            detail::cigar_push(res.ops, 'D');
+            i--;
+            state = (t & detail::TB_D_EXTEND) ? detail::TB_UP : detail::TB_DIAG;
+        } else {
+            detail::cigar_push(res.ops, 'I');
+            j--;
+            state = (t & detail::TB_I_EXTEND) ? detail::TB_LEFT : detail::TB_DIAG;
+        }
+    }
+    detail::cigar_finish(res.ops);
+    detail::finish_result(res, pM[n], 0, 0);
+    return res.score;
+}
+
+/**
+ * @brief Banded Needleman-Wunsch-Gotoh algorithm for global alignment with affine gaps.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param s1_aligned The first aligned string.
+ * @param s2_aligned The second aligned string.
+ * @param w The band width: only cells with |i - j| <= w are computed.
+ * @param a The match cost.
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @return The minimum cost of an alignment that stays inside the band.
+ * @note Same alignment as the alignment_result overload, expanded to gapped strings.
+ */
+int needleman_wunsch_gotoh_banded(const std::string &s1, const std::string &s2,
+                                  std::string &s1_aligned, std::string &s2_aligned, int w,
+                                  int a = 0, int x = 1, int o = 0, int e = 1) {
+    alignment_result res;
+    needleman_wunsch_gotoh_banded(s1, s2, res, w, a, x, o, e);
+    alignment_to_aligned(s1, s2, res, s1_aligned, s2_aligned);
+    return res.score;
+}
+
+}  // namespace alignment
+
+}  // namespace toolbox
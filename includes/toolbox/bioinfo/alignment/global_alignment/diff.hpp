@@ -6,6 +6,9 @@
 #include <utility>
 #include <vector>
 
+#include "toolbox/bioinfo/alignment/global_alignment/myers_bitvector.hpp"
+#include "toolbox/bioinfo/alignment/traceback.hpp"
+
 namespace toolbox {
 
 namespace alignment {
@@ -70,14 +73,13 @@ int diff_dp(const std::string &s1, const std::string &s2, std::vector<std::vecto
  * @param s1 The first string.
  * @param s2 The second string.
  * @param M The DP table.
- * @param s1_aligned The first aligned string.
- * @param s2_aligned The second aligned string.
+ * @param ops The CIGAR of the alignment (s1 plays the reference).
  * @param x The mismatch cost.
  * @param g The gap cost.
  * @note O(m) time complexity.
  */
 void diff_traceback(const std::string &s1, const std::string &s2, std::vector<std::vector<int>> &M,
-                    std::string &s1_aligned, std::string &s2_aligned, int x = 1, int g = 1) {
+                    cigar &ops, int x = 1, int g = 1) {
     const int m = static_cast<int>(s1.size());
     const int n = static_cast<int>(s2.size());
     int d;
@@ -118,26 +120,52 @@ void diff_traceback(const std::string &s1, const std::string &s2, std::vector<st
         path.push_back(std::make_pair(M[d][d + k] - k, M[d][d + k]));
     }
     path.push_back(std::make_pair(0, 0));
+    detail::diagonal_path_to_cigar(path, ops);
+}
 
-    int i;
-    int j;
-    int i_prev;
-    int j_prev;
-    s1_aligned = "";
-    s2_aligned = "";
-    for (d = path.size() - 1; d >= 0; d--) {
-        i = path[d].first;
-        j = path[d].second;
-        i_prev = (d == static_cast<int>(path.size()) - 1) ? 0 : path[d + 1].first;
-        j_prev = (d == static_cast<int>(path.size()) - 1) ? 0 : path[d + 1].second;
-        if (j - i == j_prev - i_prev - 1) {
-            s2_aligned += "-";
-        } else if (j - i == j_prev - i_prev + 1) {
-            s1_aligned += "-";
-        }
-        s1_aligned += s1.substr(i_prev, i - i_prev);
-        s2_aligned += s2.substr(j_prev, j - j_prev);
+/**
+ * @brief Diff traceback.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param M The DP table.
+ * @param s1_aligned The first aligned string.
+ * @param s2_aligned The second aligned string.
+ * @param x The mismatch cost.
+ * @param g The gap cost.
+ * @note O(m) time complexity.
+ */
+void diff_traceback(const std::string &s1, const std::string &s2, std::vector<std::vector<int>> &M,
+                    std::string &s1_aligned, std::string &s2_aligned, int x = 1, int g = 1) {
+    cigar ops;
+    diff_traceback(s1, s2, M, ops, x, g);
+    cigar_to_aligned(s1, s2, ops, s1_aligned, s2_aligned);
+}
+
+/**
+ * @brief Diff algorithm for global alignment.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment (score and CIGAR).
+ * @param x The mismatch cost.
+ * @param g The gap cost.
+ * @return The difference between the two strings.
+ * @note min-cost alignment.
+ * @note O(nd) time complexity and O(d^2) space complexity.
+ * @note Unit-cost instances (x = g) are delegated to myers_bitvector_all, whose O(m + n) memory
+ * does not grow with the distance d. Its alignment has the same cost but may break ties
+ * differently from the gapped-string overload.
+ */
+int diff_all(const std::string &s1, const std::string &s2, alignment_result &res, int x = 1,
+             int g = 1) {
+    if (x == g && g > 0) {
+        res.score = g * myers_bitvector_all(s1, s2, res);
+        return (res.score);
     }
+    std::vector<std::vector<int>> M;
+    int diff = diff_dp(s1, s2, M, x, g);
+    diff_traceback(s1, s2, M, res.ops, x, g);
+    detail::finish_result(res, diff, 0, 0);
+    return (diff);
 }
 
 /**
@@ -149,7 +177,8 @@ void diff_traceback(const std::string &s1, const std::string &s2, std::vector<st
  * @param x The mismatch cost.
  * @param g The gap cost.
  * @return The difference between the two strings.
- * @note min-cost alignment.
+ * @note min-cost alignment, always by diff_dp and diff_traceback, so that the gapped strings do
+ * not depend on whether the costs are unit costs.
  * @note O(nd) time complexity and O(d^2) space complexity.
  */
 int diff_all(const std::string &s1, const std::string &s2, std::string &s1_aligned,
@@ -0,0 +1,385 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "toolbox/bioinfo/alignment/traceback.hpp"
+
+namespace toolbox {
+
+namespace alignment {
+
+namespace detail {
+
+const int HIRSCHBERG_INF = 1 << 29;
+
+/**
+ * @brief Last row of the linear-gap Needleman-Wunsch table in O(n) space.
+ * @note row[j] is the cost of aligning s1[0..m) with s2[0..j). With reverse, both strings are
+ * read back to front, i.e. row[j] aligns the last m characters of s1 with the last j of s2.
+ */
+inline void nw_last_row(const char *s1, int m, const char *s2, int n, bool reverse, int a, int x,
+                        int g, std::vector<int> &row) {
+    row.resize(n + 1);
+    for (int j = 0; j <= n; j++) {
+        row[j] = j * g;
+    }
+    for (int i = 1; i <= m; i++) {
+        const char c1 = reverse ? s1[m - i] : s1[i - 1];
+        int diag = row[0];
+        row[0] = i * g;
+        for (int j = 1; j <= n; j++) {
+            const char c2 = reverse ? s2[n - j] : s2[j - 1];
+            const int up = row[j];
+            row[j] = std::min(diag + (c1 == c2 ? a : x), std::min(up + g, row[j - 1] + g));
+            diag = up;
+        }
+    }
+}
+
+/**
+ * @brief Full-table Needleman-Wunsch on a small block, appending the alignment to ops.
+ */
+inline void nw_block(const char *s1, int m, const char *s2, int n, int a, int x, int g,
+                     cigar &ops) {
+    const int w = n + 1;
+    std::vector<int> dp((m + 1) * w);
+    for (int i = 0; i <= m; i++) {
+        for (int j = 0; j <= n; j++) {
+            if (i == 0 || j == 0) {
+                dp[i * w + j] = (i + j) * g;
+            } else {
+                dp[i * w + j] = std::min(dp[(i - 1) * w + j - 1] + (s1[i - 1] == s2[j - 1] ? a : x),
+                                         std::min(dp[(i - 1) * w + j], dp[i * w + j - 1]) + g);
+            }
+        }
+    }
+    cigar rev;
+    int i = m;
+    int j = n;
+    while (i > 0 || j > 0) {
+        if (i > 0 && j > 0 &&
+            dp[i * w + j] == dp[(i - 1) * w + j - 1] + (s1[i - 1] == s2[j - 1] ? a : x)) {
+            cigar_push(rev, 'M');
+            i--;
+            j--;
+        } else if (i > 0 && dp[i * w + j] == dp[(i - 1) * w + j] + g) {
+            cigar_push(rev, 'D');
+            i--;
+        } else {
+            cigar_push(rev, 'I');
+            j--;
+        }
+    }
+    cigar_finish(rev);
+    cigar_append(ops, rev);
+}
+
+inline void nw_hirschberg(const char *s1, int m, const char *s2, int n, int a, int x, int g,
+                          std::size_t cutoff, cigar &ops) {
+    if (m <= 1 || n == 0 ||
+        static_cast<std::size_t>(m + 1) * static_cast<std::size_t>(n + 1) <= cutoff) {
+        nw_block(s1, m, s2, n, a, x, g, ops);
+        return;
+    }
+    const int mid = m / 2;
+    std::vector<int> fwd, rev;
+    nw_last_row(s1, mid, s2, n, false, a, x, g, fwd);
+    nw_last_row(s1 + mid, m - mid, s2, n, true, a, x, g, rev);
+    int split = 0;
+    for (int j = 1; j <= n; j++) {
+        if (fwd[j] + rev[n - j] < fwd[split] + rev[n - split]) {
+            split = j;
+        }
+    }
+    nw_hirschberg(s1, mid, s2, split, a, x, g, cutoff, ops);
+    nw_hirschberg(s1 + mid, m - mid, s2 + split, n - split, a, x, g, cutoff, ops);
+}
+
+/**
+ * @brief Last rows (CC: any state, DD: ending in a deletion) of the Gotoh table in O(n) space.
+ * @param tb The open cost charged to a deletion that starts in the top-left corner: o for a
+ * fresh gap, 0 when the gap continues one that was already paid for above the block.
+ * @note Forward and reverse passes of Myers and Miller's linear-space Gotoh algorithm.
+ */
+inline void gotoh_last_rows(const char *s1, int m, const char *s2, int n, bool reverse, int a,
+                            int x, int o, int e, int tb, std::vector<int> &CC,
+                            std::vector<int> &DD) {
+    // Sized from a non-negative n, so that the compiler sees CC[0] exists.
+    const std::size_t cols = static_cast<std::size_t>(std::max(n, 0)) + 1;
+    CC.resize(cols);
+    DD.resize(cols);
+    CC[0] = 0;
+    int t = o;
+    for (int j = 1; j <= n; j++) {
+        t += e;
+        CC[j] = t;
+        DD[j] = t + o;
+    }
+    t = tb;
+    for (int i = 1; i <= m; i++) {
+        const char c1 = reverse ? s1[m - i] : s1[i - 1];
+        int diag = CC[0];
+        t += e;
+        int c = t;
+        CC[0] = c;
+        int ins = t + o;
+        for (int j = 1; j <= n; j++) {
+            const char c2 = reverse ? s2[n - j] : s2[j - 1];
+            ins = std::min(ins, c + o) + e;
+            const int del = std::min(DD[j], CC[j] + o) + e;
+            c = std::min(diag + (c1 == c2 ? a : x), std::min(del, ins));
+            diag = CC[j];
+            CC[j] = c;
+            DD[j] = del;
+        }
+    }
+    DD[0] = CC[0];
+}
+
+/**
+ * @brief Full-table Gotoh on a small block with boundary gap-open costs tb / te.
+ * @note A deletion touching the top-left (bottom-right) corner is charged tb (te) instead of o,
+ * so that a gap split across two blocks by the recursion is only opened once.
+ */
+inline void gotoh_block(const char *s1, int m, const char *s2, int n, int a, int x, int o, int e,
+                        int tb, int te, cigar &ops) {
+    if (n == 0) {
+        cigar_append(ops, 'D', m);
+        return;
+    }
+    if (m == 0) {
+        cigar_append(ops, 'I', n);
+        return;
+    }
+    const int w = n + 1;
+    std::vector<int> M((m + 1) * w), D((m + 1) * w), I((m + 1) * w);
+    M[0] = 0;
+    D[0] = I[0] = HIRSCHBERG_INF;
+    for (int i = 1; i <= m; i++) {
+        M[i * w] = D[i * w] = tb + e * i;
+        I[i * w] = HIRSCHBERG_INF;
+    }
+    for (int j = 1; j <= n; j++) {
+        M[j] = I[j] = o + e * j;
+        D[j] = HIRSCHBERG_INF;
+    }
+    for (int i = 1; i <= m; i++) {
+        for (int j = 1; j <= n; j++) {
+            const int k = i * w + j;
+            D[k] = std::min(M[k - w] + o + e, D[k - w] + e);
+            I[k] = std::min(M[k - 1] + o + e, I[k - 1] + e);
+            M[k] = std::min(M[k - w - 1] + (s1[i - 1] == s2[j - 1] ? a : x), std::min(D[k], I[k]));
+        }
+    }
+    enum table { dp_M, dp_I, dp_D };
+    enum table table_id = D[m * w + n] - o + te < M[m * w + n] ? table::dp_D : table::dp_M;
+    cigar rev;
+    int i = m;
+    int j = n;
+    while (i > 0 || j > 0) {
+        const int k = i * w + j;
+        if (table_id == table::dp_M) {
+            if (i > 0 && j > 0 && M[k] == M[k - w - 1] + (s1[i - 1] == s2[j - 1] ? a : x)) {
+                cigar_push(rev, 'M');
+                i--;
+                j--;
+            } else if (j == 0 || (i > 0 && M[k] == D[k])) {
+                table_id = table::dp_D;
+            } else {
+                table_id = table::dp_I;
+            }
+        } else if (table_id == table::dp_D) {
+            if (j > 0 && D[k] != D[k - w] + e) {
+                table_id = table::dp_M;
+            }
+            cigar_push(rev, 'D');
+            i--;
+        } else {
+            if (i > 0 && I[k] != I[k - 1] + e) {
+                table_id = table::dp_M;
+            }
+            cigar_push(rev, 'I');
+            j--;
+        }
+    }
+    cigar_finish(rev);
+    cigar_append(ops, rev);
+}
+
+inline void gotoh_myers_miller(const char *s1, int m, const char *s2, int n, int a, int x, int o,
+                               int e, int tb, int te, std::size_t cutoff, cigar &ops) {
+    if (n == 0 || m == 0 ||
+        static_cast<std::size_t>(m + 1) * static_cast<std::size_t>(n + 1) <= cutoff) {
+        gotoh_block(s1, m, s2, n, a, x, o, e, tb, te, ops);
+        return;
+    }
+    if (m == 1) {
+        // Either s1[0] is deleted (next to whichever boundary makes the gap cheaper) and all of
+        // s2 is inserted, or s1[0] is aligned to some s2[j - 1] with insertions on both sides.
+        auto gap = [o, e](int k) { return k == 0 ? 0 : o + e * k; };
+        int best = std::min(tb, te) + e + gap(n);
+        int best_j = 0;
+        for (int j = 1; j <= n; j++) {
+            const int c = gap(j - 1) + (s1[0] == s2[j - 1] ? a : x) + gap(n - j);
+            if (c < best) {
+                best = c;
+                best_j = j;
+            }
+        }
+        if (best_j == 0 && tb <= te) {
+            cigar_append(ops, 'D', 1);
+            cigar_append(ops, 'I', n);
+        } else if (best_j == 0) {
+            cigar_append(ops, 'I', n);
+            cigar_append(ops, 'D', 1);
+        } else {
+            cigar_append(ops, 'I', best_j - 1);
+            cigar_append(ops, 'M', 1);
+            cigar_append(ops, 'I', n - best_j);
+        }
+        return;
+    }
+    const int mid = m / 2;
+    std::vector<int> CC, DD, RR, SS;
+    gotoh_last_rows(s1, mid, s2, n, false, a, x, o, e, tb, CC, DD);
+    gotoh_last_rows(s1 + mid, m - mid, s2, n, true, a, x, o, e, te, RR, SS);
+    int split = 0;
+    int best = CC[0] + RR[n];
+    bool through_gap = false;
+    for (int j = 0; j <= n; j++) {
+        if (CC[j] + RR[n - j] < best) {
+            best = CC[j] + RR[n - j];
+            split = j;
+            through_gap = false;
+        }
+        if (DD[j] + SS[n - j] - o < best) {
+            best = DD[j] + SS[n - j] - o;
+            split = j;
+            through_gap = true;
+        }
+    }
+    if (!through_gap) {
+        gotoh_myers_miller(s1, mid, s2, split, a, x, o, e, tb, o, cutoff, ops);
+        gotoh_myers_miller(s1 + mid, m - mid, s2 + split, n - split, a, x, o, e, o, te, cutoff,
+                           ops);
+    } else {
+        // The optimal path crosses the middle row inside a deletion: s1[mid - 1] and s1[mid]
+        // are both deleted, and the gap continues into both halves without a second open.
+        gotoh_myers_miller(s1, mid - 1, s2, split, a, x, o, e, tb, 0, cutoff, ops);
+        cigar_append(ops, 'D', 2);
+        gotoh_myers_miller(s1 + mid + 1, m - mid - 1, s2 + split, n - split, a, x, o, e, 0, te,
+                           cutoff, ops);
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Needleman-Wunsch algorithm with Hirschberg's linear-space traceback.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment (score and CIGAR).
+ * @param a The match cost.
+ * @param x The mismatch cost.
+ * @param g The gap cost.
+ * @param cutoff Subproblems with at most this many DP cells are solved with a full table.
+ * @return The difference between the two strings.
+ * @note min-cost alignment with the same score as needleman_wunsch_all. The alignment is an
+ * optimal one, but where several are optimal it may pick a different one than the full table.
+ * @note O(nm) time complexity (about twice the full-table fill) and O(m + n + cutoff) space
+ * complexity.
+ */
+int needleman_wunsch_hirschberg(const std::string &s1, const std::string &s2,
+                                alignment_result &res, int a = 1, int x = 1, int g = 1,
+                                std::size_t cutoff = 1 << 16) {
+    const int m = static_cast<int>(s1.size());
+    const int n = static_cast<int>(s2.size());
+    std::vector<int> row;
+    detail::nw_last_row(s1.data(), m, s2.data(), n, false, a, x, g, row);
+    res.ops.clear();
+    detail::nw_hirschberg(s1.data(), m, s2.data(), n, a, x, g, cutoff, res.ops);
+    detail::finish_result(res, row[n], 0, 0);
+    return res.score;
+}
+
+/**
+ * @brief Needleman-Wunsch algorithm with Hirschberg's linear-space traceback.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param s1_aligned The first aligned string.
+ * @param s2_aligned The second aligned string.
+ * @param a The match cost.
+ * @param x The mismatch cost.
+ * @param g The gap cost.
+ * @param cutoff Subproblems with at most this many DP cells are solved with a full table.
+ * @return The difference between the two strings.
+ * @note Same alignment as the alignment_result overload, expanded to gapped strings.
+ */
+int needleman_wunsch_hirschberg(const std::string &s1, const std::string &s2,
+                                std::string &s1_aligned, std::string &s2_aligned, int a = 1,
+                                int x = 1, int g = 1, std::size_t cutoff = 1 << 16) {
+    alignment_result res;
+    needleman_wunsch_hirschberg(s1, s2, res, a, x, g, cutoff);
+    alignment_to_aligned(s1, s2, res, s1_aligned, s2_aligned);
+    return res.score;
+}
+
+/**
+ * @brief Needleman-Wunsch-Gotoh algorithm with Myers and Miller's linear-space traceback.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment (score and CIGAR).
+ * @param a The match cost.
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @param cutoff Subproblems with at most this many DP cells are solved with a full table.
+ * @return The difference between the two strings.
+ * @note min-cost alignment with the same score as needleman_wunsch_gotoh_all.
+ * @note The middle row is crossed either at a cell (both halves are independent) or inside a
+ * deletion spanning it (both halves continue the same gap, so its open cost is charged once).
+ * @note O(nm) time complexity and O(m + n + cutoff) space complexity.
+ */
+int needleman_wunsch_gotoh_hirschberg(const std::string &s1, const std::string &s2,
+                                      alignment_result &res, int a = 1, int x = 1, int o = 0,
+                                      int e = 1, std::size_t cutoff = 1 << 16) {
+    const int m = static_cast<int>(s1.size());
+    const int n = static_cast<int>(s2.size());
+    std::vector<int> CC, DD;
+    detail::gotoh_last_rows(s1.data(), m, s2.data(), n, false, a, x, o, e, o, CC, DD);
+    res.ops.clear();
+    detail::gotoh_myers_miller(s1.data(), m, s2.data(), n, a, x, o, e, o, o, cutoff, res.ops);
+    detail::finish_result(res, CC[n], 0, 0);
+    return res.score;
+}
+
+/**
+ * @brief Needleman-Wunsch-Gotoh algorithm with Myers and Miller's linear-space traceback.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param s1_aligned The first aligned string.
+ * @param s2_aligned The second aligned string.
+ * @param a The match cost.
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @param cutoff Subproblems with at most this many DP cells are solved with a full table.
+ * @return The difference between the two strings.
+ * @note Same alignment as the alignment_result overload, expanded to gapped strings.
+ */
+int needleman_wunsch_gotoh_hirschberg(const std::string &s1, const std::string &s2,
+                                      std::string &s1_aligned, std::string &s2_aligned,
+                                      int a = 1, int x = 1, int o = 0, int e = 1,
+                                      std::size_t cutoff = 1 << 16) {
+    alignment_result res;
+    needleman_wunsch_gotoh_hirschberg(s1, s2, res, a, x, o, e, cutoff);
+    alignment_to_aligned(s1, s2, res, s1_aligned, s2_aligned);
+    return res.score;
+}
+
+}  // namespace alignment
+
+}  // namespace toolbox
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "toolbox/bioinfo/alignment/traceback.hpp"
+
+namespace toolbox {
+
+namespace alignment {
+
+namespace detail {
+
+/**
+ * @brief Pattern-match bit masks for Myers' bit-vector algorithm.
+ * @note Bit t of block b of eq(c) is set iff pattern[64 * b + t] == c. Only the characters that
+ * occur in the pattern get their own masks; every other character maps to an all-zero row.
+ */
+struct myers_peq {
+    std::size_t blocks;
+    std::array<int, 256> row;
+    std::vector<uint64_t> masks;
+
+    myers_peq(const char *p, std::size_t n, bool reverse) : blocks((n + 63) / 64) {
+        row.fill(0);
+        masks.assign(blocks, 0);  // row 0: characters absent from the pattern
+        int distinct = 0;
+        for (std::size_t t = 0; t < n; t++) {
+            unsigned char c = static_cast<unsigned char>(reverse ? p[n - 1 - t] : p[t]);
+            if (row[c] == 0) {
+                row[c] = ++distinct;
+                masks.resize(masks.size() + blocks, 0);
+            }
+            masks[row[c] * blocks + t / 64] |= uint64_t(1) << (t % 64);
+        }
+    }
+
+    const uint64_t *eq(char c) const {
+        return masks.data() + row[static_cast<unsigned char>(c)] * blocks;
+    }
+};
+
+/**
+ * @brief Advances one 64-bit block of Myers' bit-vector DP by one text character.
+ * @param pv The positive vertical delta bits (updated in place).
+ * @param mv The negative vertical delta bits (updated in place).
+ * @param eq The pattern-match mask of the text character.
+ * @param hin The horizontal delta entering the block from above (-1, 0 or +1).
+ * @param out_bit The bit whose horizontal delta is returned (63 except for the last block).
+ * @return The horizontal delta leaving the block at out_bit.
+ * @note Hyyro's formulation of Myers' algorithm with explicit carry between blocks.
+ */
+inline int myers_advance_block(uint64_t &pv, uint64_t &mv, uint64_t eq, int hin, int out_bit) {
+    const uint64_t hin_neg = hin < 0 ? 1 : 0;
+    const uint64_t hin_pos = hin > 0 ? 1 : 0;
+    uint64_t xv = eq | mv;
+    eq |= hin_neg;
+    uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+    uint64_t ph = mv | ~(xh | pv);
+    uint64_t mh = pv & xh;
+    int hout = static_cast<int>((ph >> out_bit) & 1) - static_cast<int>((mh >> out_bit) & 1);
+    ph = (ph << 1) | hin_pos;
+    mh = (mh << 1) | hin_neg;
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+    return hout;
+}
+
+/**
+ * @brief Computes the last row of the unit-cost edit distance table with Myers' algorithm.
+ * @param p The pattern (its characters index the columns of the row).
+ * @param n The pattern length.
+ * @param t The text (its characters are consumed as rows).
+ * @param len The text length.
+ * @param reverse Whether both sequences are read back to front.
+ * @param row The output row: row[j] is the distance between t[0..len) and p[0..j).
+ * @note O(ceil(n / 64) len) time complexity and O(n) space complexity.
+ */
+inline void myers_last_row(const char *p, std::size_t n, const char *t, std::size_t len,
+                           bool reverse, std::vector<int> &row) {
+    row.assign(n + 1, 0);
+    row[0] = static_cast<int>(len);
+    if (n == 0) {
+        return;
+    }
+    const myers_peq peq(p, n, reverse);
+    std::vector<uint64_t> pv(peq.blocks, ~uint64_t(0));
+    std::vector<uint64_t> mv(peq.blocks, 0);
+    for (std::size_t i = 0; i < len; i++) {
+        const uint64_t *eq = peq.eq(reverse ? t[len - 1 - i] : t[i]);
+        int carry = 1;
+        for (std::size_t b = 0; b < peq.blocks; b++) {
+            carry = myers_advance_block(pv[b], mv[b], eq[b], carry, 63);
+        }
+    }
+    for (std::size_t j = 1; j <= n; j++) {
+        const std::size_t b = (j - 1) / 64;
+        const uint64_t bit = uint64_t(1) << ((j - 1) % 64);
+        row[j] = row[j - 1] + ((pv[b] & bit) ? 1 : 0) - ((mv[b] & bit) ? 1 : 0);
+    }
+}
+
+/**
+ * @brief Unit-cost global alignment of two short substrings with a full DP table.
+ * @note Used as the base case of the Hirschberg recursion in myers_bitvector_all, so the table
+ * never exceeds the cutoff passed to it.
+ */
+inline void myers_base_case(const char *s1, int m, const char *s2, int n, cigar &ops) {
+    std::vector<int> dp((m + 1) * (n + 1));
+    for (int i = 0; i <= m; i++) {
+        for (int j = 0; j <= n; j++) {
+            if (i == 0 || j == 0) {
+                dp[i * (n + 1) + j] = i + j;
+            } else {
+                dp[i * (n + 1) + j] =
+                    std::min({dp[(i - 1) * (n + 1) + j - 1] + (s1[i - 1] == s2[j - 1] ? 0 : 1),
+                              dp[(i - 1) * (n + 1) + j] + 1, dp[i * (n + 1) + j - 1] + 1});
+            }
+        }
+    }
+    cigar rev;
+    int i = m;
+    int j = n;
+    while (i > 0 || j > 0) {
+        if (i > 0 && j > 0 &&
+            dp[i * (n + 1) + j] ==
+                dp[(i - 1) * (n + 1) + j - 1] + (s1[i - 1] == s2[j - 1] ? 0 : 1)) {
+            cigar_push(rev, 'M');
+            i--;
+            j--;
+        } else if (i > 0 && dp[i * (n + 1) + j] == dp[(i - 1) * (n + 1) + j] + 1) {
+            cigar_push(rev, 'D');
+            i--;
+        } else {
+            cigar_push(rev, 'I');
+            j--;
+        }
+    }
+    cigar_finish(rev);
+    cigar_append(ops, rev);
+}
+
+inline void myers_hirschberg(const char *s1, int m, const char *s2, int n, cigar &ops,
+                             std::size_t cutoff) {
+    if (m <= 1 || n == 0 ||
+        static_cast<std::size_t>(m + 1) * static_cast<std::size_t>(n + 1) <= cutoff) {
+        myers_base_case(s1, m, s2, n, ops);
+        return;
+    }
+    const int mid = m / 2;
+    std::vector<int> fwd, rev;
+    myers_last_row(s2, n, s1, mid, false, fwd);
+    myers_last_row(s2, n, s1 + mid, m - mid, true, rev);
+    int split = 0;
+    for (int j = 1; j <= n; j++) {
+        if (fwd[j] + rev[n - j] < fwd[split] + rev[n - split]) {
+            split = j;
+        }
+    }
+    myers_hirschberg(s1, mid, s2, split, ops, cutoff);
+    myers_hirschberg(s1 + mid, m - mid, s2 + split, n - split, ops, cutoff);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Myers' bit-vector algorithm for the unit-cost edit distance.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @return The Levenshtein distance between the two strings.
+ * @note min-cost alignment with match cost 0 and mismatch / gap cost 1, i.e. the same score as
+ * needleman_wunsch_dp(s1, s2, dp, 0, 1, 1) and diff_dp(s1, s2, M, 1, 1).
+ * @note The shorter string is packed into 64-bit words, so one text character advances 64 DP
+ * cells with a handful of word operations.
+ * @note O(ceil(min(m, n) / 64) max(m, n)) time complexity and O(min(m, n)) space complexity.
+ */
+int myers_bitvector_dp(const std::string &s1, const std::string &s2) {
+    const std::string &p = s1.size() <= s2.size() ? s1 : s2;
+    const std::string &t = s1.size() <= s2.size() ? s2 : s1;
+    const std::size_t n = p.size();
+    if (n == 0) {
+        return static_cast<int>(t.size());
+    }
+    const detail::myers_peq peq(p.data(), n, false);
+    std::vector<uint64_t> pv(peq.blocks, ~uint64_t(0));
+    std::vector<uint64_t> mv(peq.blocks, 0);
+    const int last_bit = static_cast<int>((n - 1) % 64);
+    int score = static_cast<int>(n);
+    for (std::size_t i = 0; i < t.size(); i++) {
+        const uint64_t *eq = peq.eq(t[i]);
+        int carry = 1;
+        for (std::size_t b = 0; b + 1 < peq.blocks; b++) {
+            carry = detail::myers_advance_block(pv[b], mv[b], eq[b], carry, 63);
+        }
+        score += detail::myers_advance_block(pv[peq.blocks - 1], mv[peq.blocks - 1],
+                                             eq[peq.blocks - 1], carry, last_bit);
+    }
+    return score;
+}
+
+/**
+ * @brief Myers' bit-vector algorithm with Hirschberg traceback for the unit-cost alignment.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment (score and CIGAR).
+ * @param cutoff Subproblems with at most this many DP cells are solved with a full table.
+ * @return The Levenshtein distance between the two strings.
+ * @note min-cost alignment with match cost 0 and mismatch / gap cost 1.
+ * @note Each level of the recursion splits s1 in half and finds the column where an optimal
+ * path crosses the middle row from a forward and a reverse bit-vector pass, so only O(n) words
+ * are alive at any time.
+ * @note O(ceil(n / 64) m) time complexity (about three times the score-only pass) and O(m + n)
+ * space complexity.
+ */
+int myers_bitvector_all(const std::string &s1, const std::string &s2, alignment_result &res,
+                        std::size_t cutoff = 1 << 12) {
+    res.ops.clear();
+    detail::myers_hirschberg(s1.data(), static_cast<int>(s1.size()), s2.data(),
+                             static_cast<int>(s2.size()), res.ops, cutoff);
+    detail::finish_result(res, myers_bitvector_dp(s1, s2), 0, 0);
+    return res.score;
+}
+
+/**
+ * @brief Myers' bit-vector algorithm with Hirschberg traceback for the unit-cost alignment.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param s1_aligned The first aligned string.
+ * @param s2_aligned The second aligned string.
+ * @param cutoff Subproblems with at most this many DP cells are solved with a full table.
+ * @return The Levenshtein distance between the two strings.
+ * @note Same alignment as the alignment_result overload, expanded to gapped strings.
+ */
+int myers_bitvector_all(const std::string &s1, const std::string &s2, std::string &s1_aligned,
+                        std::string &s2_aligned, std::size_t cutoff = 1 << 12) {
+    alignment_result res;
+    myers_bitvector_all(s1, s2, res, cutoff);
+    alignment_to_aligned(s1, s2, res, s1_aligned, s2_aligned);
+    return res.score;
+}
+
+}  // namespace alignment
+
+}  // namespace toolbox
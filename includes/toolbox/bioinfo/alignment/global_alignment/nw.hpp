@@ -1,9 +1,16 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <vector>
 
+#include "toolbox/bioinfo/alignment/global_alignment/myers_bitvector.hpp"
+#include "toolbox/bioinfo/alignment/tiled_dp.hpp"
+#include "toolbox/bioinfo/alignment/traceback.hpp"
+
 namespace toolbox {
 
 namespace alignment {
@@ -59,25 +66,106 @@ void needleman_wunsch_traceback(const std::string &s1, const std::string &s2,
     const int n = static_cast<int>(s2.size());
     int i = m;
     int j = n;
-    s1_aligned = "";
-    s2_aligned = "";
+    std::string r1, r2;
     while (i > 0 || j > 0) {
         if (i > 0 && (dp[i][j] == dp[i - 1][j] + g || j == 0)) {
-            s1_aligned = s1[i - 1] + s1_aligned;
-            s2_aligned = "-" + s2_aligned;
-            i--;
+            detail::tb_emit(r1, r2, s1[--i], '-');
         } else if (j > 0 && (dp[i][j] == dp[i][j - 1] + g || i == 0)) {
-            s1_aligned = "-" + s1_aligned;
-            s2_aligned = s2[j - 1] + s2_aligned;
-            j--;
+            detail::tb_emit(r1, r2, '-', s2[--j]);
         } else if (i > 0 && j > 0 &&
                    dp[i][j] == dp[i - 1][j - 1] + (s1[i - 1] == s2[j - 1] ? a : x)) {
-            s1_aligned = s1[i - 1] + s1_aligned;
-            s2_aligned = s2[j - 1] + s2_aligned;
+            detail::tb_emit(r1, r2, s1[--i], s2[--j]);
+        }
+    }
+    detail::tb_finish(r1, r2, s1_aligned, s2_aligned);
+}
+
+/**
+ * @brief Needleman-Wunsch algorithm for global alignment, returning the alignment as a CIGAR.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param ops The CIGAR of the alignment (s1 plays the reference).
+ * @param a The match cost.
+ * @param x The mismatch cost.
+ * @param g The gap cost.
+ * @return The difference between the two strings.
+ * @note min-cost alignment. The move of every cell is recorded in a 2-bit packed traceback while
+ * the table is filled (ties go up, left, diagonal, as in needleman_wunsch_traceback), so the
+ * scores only need two rolling rows and the traceback never re-derives a move from the scores.
+ * @note [Complexity]: O(nm) time complexity, O(n) space for the scores and nm / 4 bytes for the
+ * traceback (16x less than an int table). The walk back is O(m + n).
+ */
+int needleman_wunsch_cigar(const std::string &s1, const std::string &s2, cigar &ops, int a = 0,
+                           int x = 1, int g = 1) {
+    const int m = static_cast<int>(s1.size());
+    const int n = static_cast<int>(s2.size());
+    const std::size_t width = n + 1;
+    detail::packed_traceback<2> tb((m + 1) * width);
+    std::vector<int> prev(n + 1), cur(n + 1);
+    for (int j = 0; j <= n; j++) {
+        cur[j] = j * g;
+        tb.set(j, detail::TB_LEFT);
+    }
+    for (int i = 1; i <= m; i++) {
+        prev.swap(cur);
+        cur[0] = i * g;
+        tb.set(i * width, detail::TB_UP);
+        for (int j = 1; j <= n; j++) {
+            const int diag = prev[j - 1] + (s1[i - 1] == s2[j - 1] ? a : x);
+            const int up = prev[j] + g;
+            const int left = cur[j - 1] + g;
+            const int best = std::min(diag, std::min(up, left));
+            cur[j] = best;
+            tb.set(i * width + j, up == best     ? detail::TB_UP
+                                  : left == best ? detail::TB_LEFT
+                                                 : detail::TB_DIAG);
+        }
+    }
+    ops.clear();
+    int i = m;
+    int j = n;
+    while (i > 0 || j > 0) {
+        const uint8_t from = tb.get(i * width + j);
+        if (from == detail::TB_DIAG) {
+            detail::cigar_push(ops, 'M');
             i--;
             j--;
+        } else if (from == detail::TB_UP) {
+            detail::cigar_push(ops, 'D');
+            i--;
+        } else {
+            detail::cigar_push(ops, 'I');
+            j--;
         }
     }
+    detail::cigar_finish(ops);
+    return cur[n];
+}
+
+/**
+ * @brief Needleman-Wunsch algorithm for global alignment.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment (score and CIGAR).
+ * @param a The match cost.
+ * @param x The mismatch cost.
+ * @param g The gap cost.
+ * @return The difference between the two strings.
+ * @note min-cost alignment, computed by needleman_wunsch_cigar.
+ * @note O(nm) time complexity and O(n) + nm / 4 bytes space complexity.
+ * @note Unit-cost instances (a = 0, x = g > 0) are plain Levenshtein distances scaled by g, and
+ * are delegated to myers_bitvector_all: O(ceil(n / 64) m) time and O(m + n) space. Its
+ * alignment has the same cost but may break ties differently from the gapped-string overload.
+ */
+int needleman_wunsch_all(const std::string &s1, const std::string &s2, alignment_result &res,
+                         int a = 1, int x = 1, int g = 1) {
+    if (a == 0 && x == g && g > 0) {
+        res.score = g * myers_bitvector_all(s1, s2, res);
+        return (res.score);
+    }
+    const int diff = needleman_wunsch_cigar(s1, s2, res.ops, a, x, g);
+    detail::finish_result(res, diff, 0, 0);
+    return (diff);
 }
 
 /**
@@ -90,17 +178,68 @@ void needleman_wunsch_traceback(const std::string &s1, const std::string &s2,
  * @param x The mismatch cost.
  * @param g The gap cost.
  * @return The difference between the two strings.
- * @note min-cost alignment.
- * @note O(nm) time complexity and O(nm) space complexity.
+ * @note min-cost alignment, computed by needleman_wunsch_cigar for all costs, so that ties go
+ * up, left, diagonal as in needleman_wunsch_traceback and the gapped strings are those of
+ * needleman_wunsch_dp followed by needleman_wunsch_traceback.
+ * @note O(nm) time complexity and O(n) + nm / 4 bytes space complexity.
  */
 int needleman_wunsch_all(const std::string &s1, const std::string &s2, std::string &s1_aligned,
                          std::string &s2_aligned, int a = 1, int x = 1, int g = 1) {
-    std::vector<std::vector<int>> dp;
-    int diff = needleman_wunsch_dp(s1, s2, dp, a, x, g);
-    needleman_wunsch_traceback(s1, s2, dp, s1_aligned, s2_aligned, a, x, g);
+    alignment_result res;
+    const int diff = needleman_wunsch_cigar(s1, s2, res.ops, a, x, g);
+    detail::finish_result(res, diff, 0, 0);
+    alignment_to_aligned(s1, s2, res, s1_aligned, s2_aligned);
     return (diff);
 }
 
+namespace detail {
+
+/**
+ * @brief Cell-update policy of needleman_wunsch_dp for tiled_dp (the cost is negated, since
+ * tiled_dp maximizes).
+ */
+struct nw_cells {
+    typedef int cell;
+    const std::string &s1;
+    const std::string &s2;
+    int a, x, g;
+
+    int boundary_row(int j) const { return j * g; }
+    int boundary_col(int i) const { return i * g; }
+    int update(int i, int j, int diag, int up, int left) const {
+        return std::min(diag + (s1[i - 1] == s2[j - 1] ? a : x), std::min(up + g, left + g));
+    }
+    int value(int c, int i, int j) const {
+        return i == static_cast<int>(s1.size()) && j == static_cast<int>(s2.size())
+                   ? -c
+                   : std::numeric_limits<int>::min();
+    }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Needleman-Wunsch algorithm for global alignment, score only, on several threads.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param a The match cost.
+ * @param x The mismatch cost.
+ * @param g The gap cost.
+ * @param tile The side of a tile of the DP table, in cells.
+ * @param pool The thread pool.
+ * @return The same cost as needleman_wunsch_dp.
+ * @note The table is filled by tiled_dp: the tiles of an anti-diagonal run in parallel, and only
+ * the tile boundaries are kept.
+ * @note [Complexity]: O(nm / p) time complexity with p threads and O(m + n) space complexity.
+ */
+int needleman_wunsch_tiled(const std::string &s1, const std::string &s2, int a = 0, int x = 1,
+                           int g = 1, int tile = 256,
+                           parallel::thread_pool &pool = parallel::default_thread_pool()) {
+    const detail::nw_cells policy{s1, s2, a, x, g};
+    return -tiled_dp(policy, static_cast<int>(s1.size()), static_cast<int>(s2.size()), tile,
+                     pool);
+}
+
 }  // namespace alignment
 
 }  // namespace toolbox
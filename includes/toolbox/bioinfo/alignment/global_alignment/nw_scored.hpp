@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "toolbox/bioinfo/alignment/scoring.hpp"
+#include "toolbox/bioinfo/alignment/traceback.hpp"
+
+namespace toolbox {
+
+namespace alignment {
+
+namespace detail {
+
+/**
+ * @brief The affine-gap global DP of needleman_wunsch_scored over a substitution score by
+ * position: score(i, j) scores column i of the first sequence against column j of the second.
+ * @note Shared by needleman_wunsch_scored (one sequence against another) and profile_align
+ * (one alignment against another).
+ */
+template <typename Score>
+int nwg_kernel(int m, int n, Score score, alignment_result &res, int o, int e) {
+    const int NEG = -(1 << 29);
+    const std::size_t width = n + 1;
+    packed_traceback<4> tb((m + 1) * width);
+    std::vector<int> pM(n + 1, NEG), cM(n + 1), pD(n + 1, NEG), cD(n + 1);
+    for (int i = 0; i <= m; i++) {
+        const std::size_t row = i * width;
+        int ins = NEG;
+        for (int j = 0; j <= n; j++) {
+            if (i == 0 && j == 0) {
+                cM[0] = 0;
+                cD[0] = NEG;
+                continue;
+            }
+            uint8_t from = 0;
+            int d = NEG;
+            if (i > 0) {
+                d = pM[j] - o - e;
+                if (pD[j] - e > d) {
+                    d = pD[j] - e;
+                    from |= TB_D_EXTEND;
+                }
+            }
+            if (j > 0) {
+                if (ins - e > cM[j - 1] - o - e) {
+                    ins -= e;
+                    from |= TB_I_EXTEND;
+                } else {
+                    ins = cM[j - 1] - o - e;
+                }
+            }
+            int best = NEG;
+            uint8_t src = TB_DIAG;
+            if (i > 0 && j > 0) {
+                best = pM[j - 1] + score(i - 1, j - 1);
+            }
+            if (d > best) {
+                best = d;
+                src = TB_UP;
+            }
+            if (ins > best) {
+                best = ins;
+                src = TB_LEFT;
+            }
+            cM[j] = best;
+            cD[j] = d;
+            tb.set(row + j, from | src);
+        }
+        pM.swap(cM);
+        pD.swap(cD);
+    }
+    res.ops.clear();
+    int i = m;
+    int j = n;
+    uint8_t state = TB_DIAG;
+    while (i > 0 || j > 0) {
+        const uint8_t t = tb.get(i * width + j);
+        if (state == TB_DIAG) {
+            state = t & 3;
+            if (state == TB_DIAG) {
+                cigar_push(res.ops, 'M');
+                i--;
+                j--;
+            }
+        } else if (state == TB_UP) {
+            cigar_push(res.ops, 'D');
+            i--;
+            state = (t & TB_D_EXTEND) ? TB_UP : TB_DIAG;
+        } else {
+            cigar_push(res.ops, 'I');
+            j--;
+            state = (t & TB_I_EXTEND) ? TB_LEFT : TB_DIAG;
+        }
+    }
+    cigar_finish(res.ops);
+    finish_result(res, pM[n], 0, 0);
+    return res.score;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Needleman-Wunsch algorithm with affine gaps under a scoring policy.
+ * @param s1 The first sequence, encoded (see alphabet).
+ * @param s2 The second sequence, encoded with the same alphabet.
+ * @param scoring The scoring policy (match_mismatch_scoring, matrix_scoring or profile_scoring).
+ * @param res The alignment (score and CIGAR).
+ * @param o The gap open penalty.
+ * @param e The gap extension penalty.
+ * @return The best global alignment score.
+ * @note max-score alignment, unlike needleman_wunsch_gotoh_all: substitution matrices are
+ * similarities. A gap of length k costs o + k * e, so with match_mismatch_scoring(0, x) the
+ * score is -needleman_wunsch_gotoh_all(s1, s2, ..., 0, x, o, e).
+ * @note Scoring is a template parameter, so the substitution score is an inlined comparison or
+ * table lookup. The DP keeps rolling rows of M and D and 4 traceback bits per cell.
+ * @note [Complexity]: O(nm) time complexity and O(n) + nm/2 bytes of space.
+ */
+template <typename Scoring>
+int needleman_wunsch_scored(const encoded_sequence &s1, const encoded_sequence &s2,
+                            const Scoring &scoring, alignment_result &res, int o = 0, int e = 1) {
+    return detail::nwg_kernel(
+        static_cast<int>(s1.size()), static_cast<int>(s2.size()),
+        [&](int i, int j) { return scoring.score(i, s1[i], s2[j]); }, res, o, e);
+}
+
+}  // namespace alignment
+
+}  // namespace toolbox
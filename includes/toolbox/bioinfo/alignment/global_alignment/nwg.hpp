@@ -1,9 +1,15 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <vector>
 
+#include "toolbox/bioinfo/alignment/tiled_dp.hpp"
+#include "toolbox/bioinfo/alignment/traceback.hpp"
+
 namespace toolbox {
 
 namespace alignment {
@@ -82,37 +88,152 @@ void needleman_wunsch_gotoh_traceback(const std::string &s1, const std::string &
     int j;
     enum table { dp_M, dp_I, dp_D };
 
-    s1_aligned = s2_aligned = "";
+    std::string r1, r2;
     i = m, j = n;
     enum table table_id = table::dp_M;
     while (i > 0 || j > 0) {
         if (table_id == table::dp_M) {
             if (i > 0 && j > 0 && M[i][j] == M[i - 1][j - 1] + (s1[i - 1] == s2[j - 1] ? a : x)) {
-                s1_aligned = s1[i - 1] + s1_aligned;
-                s2_aligned = s2[j - 1] + s2_aligned;
-                i--;
-                j--;
+                detail::tb_emit(r1, r2, s1[--i], s2[--j]);
             } else if (M[i][j] == D[i][j]) {
                 table_id = table::dp_D;
-            } else if (M[i][j] == I[i][j]) {
+            } else {
                 table_id = table::dp_I;
             }
-        } else if (i > 0 && table_id == table::dp_D) {
-            s1_aligned = s1[i - 1] + s1_aligned;
-            s2_aligned = "-" + s2_aligned;
-            i--;
-            if (i > 0 && D[i][j] == M[i - 1][j] + o + e) {
+        } else if (table_id == table::dp_D) {
+            // The gap was opened here iff D[i][j] came from M one row up.
+            const bool open = D[i][j] == M[i - 1][j] + o + e;
+            detail::tb_emit(r1, r2, s1[--i], '-');
+            if (open) {
                 table_id = table::dp_M;
             }
-        } else if (j > 0 && table_id == table::dp_I) {
-            s1_aligned = "-" + s1_aligned;
-            s2_aligned = s2[j - 1] + s2_aligned;
-            j--;
-            if (j > 0 && I[i][j] == M[i][j - 1] + o + e) {
+        } else {
+            const bool open = I[i][j] == M[i][j - 1] + o + e;
+            detail::tb_emit(r1, r2, '-', s2[--j]);
+            if (open) {
                 table_id = table::dp_M;
             }
         }
     }
+    detail::tb_finish(r1, r2, s1_aligned, s2_aligned);
+}
+
+/**
+ * @brief Needleman-Wunsch-Gotoh algorithm for global alignment, returning the alignment as a
+ * CIGAR.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param ops The CIGAR of the alignment (s1 plays the reference).
+ * @param a The match cost.
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @return The difference between the two strings.
+ * @note min-cost alignment with the same recurrences as needleman_wunsch_gotoh_dp. Each cell
+ * records 4 traceback bits during the fill (the source of M, and whether D and I extend or open
+ * a gap), so M, D and I only need rolling rows.
+ * @note [Complexity]: O(nm) time complexity, O(n) space for the scores and nm / 2 bytes for the
+ * traceback (24x less than three int tables). The walk back is O(m + n).
+ */
+int needleman_wunsch_gotoh_cigar(const std::string &s1, const std::string &s2, cigar &ops,
+                                 int a = 0, int x = 1, int o = 0, int e = 1) {
+    const int m = static_cast<int>(s1.size());
+    const int n = static_cast<int>(s2.size());
+    const int INF = 1 << 29;
+    const std::size_t width = n + 1;
+    detail::packed_traceback<4> tb((m + 1) * width);
+    std::vector<int> pM(n + 1), pD(n + 1), cM(n + 1), cD(n + 1), cI(n + 1);
+    for (int i = 0; i <= m; i++) {
+        for (int j = 0; j <= n; j++) {
+            if (i == 0 && j == 0) {
+                cM[0] = 0;
+                cD[0] = cI[0] = INF;
+                continue;
+            }
+            uint8_t from = 0;
+            int d = INF;
+            if (i > 0) {
+                d = pM[j] + o + e;
+                if (pD[j] + e < d) {
+                    d = pD[j] + e;
+                    from |= detail::TB_D_EXTEND;
+                }
+            }
+            int ins = INF;
+            if (j > 0) {
+                ins = cM[j - 1] + o + e;
+                if (cI[j - 1] + e < ins) {
+                    ins = cI[j - 1] + e;
+                    from |= detail::TB_I_EXTEND;
+                }
+            }
+            int best = INF;
+            uint8_t src = detail::TB_DIAG;
+            if (i > 0 && j > 0) {
+                best = pM[j - 1] + (s1[i - 1] == s2[j - 1] ? a : x);
+            }
+            if (d < best) {
+                best = d;
+                src = detail::TB_UP;
+            }
+            if (ins < best) {
+                best = ins;
+                src = detail::TB_LEFT;
+            }
+            cM[j] = best;
+            cD[j] = d;
+            cI[j] = ins;
+            tb.set(i * width + j, from | src);
+        }
+        pM.swap(cM);
+        pD.swap(cD);
+    }
+    ops.clear();
+    int i = m;
+    int j = n;
+    uint8_t state = detail::TB_DIAG;
+    while (i > 0 || j > 0) {
+        const uint8_t t = tb.get(i * width + j);
+        if (state == detail::TB_DIAG) {
+            state = t & 3;
+            if (state == detail::TB_DIAG) {
+                detail::cigar_push(ops, 'M');
+                i--;
+                j--;
+            }
+        } else if (state == detail::TB_UP) {
+            detail::cigar_push(ops, 'D');
+            i--;
+            state = (t & detail::TB_D_EXTEND) ? detail::TB_UP : detail::TB_DIAG;
+        } else {
+            detail::cigar_push(ops, 'I');
+            j--;
+            state = (t & detail::TB_I_EXTEND) ? detail::TB_LEFT : detail::TB_DIAG;
+        }
+    }
+    detail::cigar_finish(ops);
+    return pM[n];
+}
+
+/**
+ * @brief Needleman-Wunsch-Gotoh algorithm for global alignment.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment (score and CIGAR).
+ * @param a The match score.
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @return The difference between the two strings.
+ * @note min-cost alignment, computed by needleman_wunsch_gotoh_cigar.
+ * @note O(nm) time complexity and O(n) + nm / 2 bytes space complexity.
+ */
+int needleman_wunsch_gotoh_all(const std::string &s1, const std::string &s2,
+                               alignment_result &res, int a = 1, int x = 1, int o = 0,
+                               int e = 1) {
+    const int diff = needleman_wunsch_gotoh_cigar(s1, s2, res.ops, a, x, o, e);
+    detail::finish_result(res, diff, 0, 0);
+    return (diff);
 }
 
 /**
@@ -126,15 +247,77 @@ void needleman_wunsch_gotoh_traceback(const std::string &s1, const std::string &
  * @param o The gap open cost.
  * @param e The gap extension cost.
  * @return The difference between the two strings.
- * @note O(m + n) time complexity.
+ * @note Same alignment as the alignment_result overload, expanded to gapped strings.
  */
 int needleman_wunsch_gotoh_all(const std::string &s1, const std::string &s2,
                                std::string &s1_aligned, std::string &s2_aligned, int a = 1,
                                int x = 1, int o = 0, int e = 1) {
-    std::vector<std::vector<int>> M, D, I;
-    int diff = needleman_wunsch_gotoh_dp(s1, s2, M, D, I, a, x, o, e);
-    needleman_wunsch_gotoh_traceback(s1, s2, M, D, I, s1_aligned, s2_aligned, a, x, o, e);
-    return (diff);
+    alignment_result res;
+    needleman_wunsch_gotoh_all(s1, s2, res, a, x, o, e);
+    alignment_to_aligned(s1, s2, res, s1_aligned, s2_aligned);
+    return (res.score);
+}
+
+namespace detail {
+
+// One cell of the M / D / I tables of needleman_wunsch_gotoh_dp.
+struct nwg_cell {
+    int M, D, I;
+};
+
+/**
+ * @brief Cell-update policy of needleman_wunsch_gotoh_dp for tiled_dp (the cost is negated,
+ * since tiled_dp maximizes).
+ */
+struct nwg_cells {
+    typedef nwg_cell cell;
+    const std::string &s1;
+    const std::string &s2;
+    int a, x, o, e;
+
+    nwg_cell boundary_row(int j) const {
+        return j == 0 ? nwg_cell{0, 1 << 30, 1 << 30} : nwg_cell{o + e * j, 1 << 30, o + e * j};
+    }
+    nwg_cell boundary_col(int i) const { return nwg_cell{o + e * i, o + e * i, 1 << 30}; }
+    nwg_cell update(int i, int j, const nwg_cell &diag, const nwg_cell &up,
+                    const nwg_cell &left) const {
+        nwg_cell c;
+        c.D = std::min(up.M + o + e, up.D + e);
+        c.I = std::min(left.M + o + e, left.I + e);
+        c.M = std::min(diag.M + (s1[i - 1] == s2[j - 1] ? a : x), std::min(c.D, c.I));
+        return c;
+    }
+    int value(const nwg_cell &c, int i, int j) const {
+        return i == static_cast<int>(s1.size()) && j == static_cast<int>(s2.size())
+                   ? -c.M
+                   : std::numeric_limits<int>::min();
+    }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Needleman-Wunsch-Gotoh algorithm for global alignment, score only, on several threads.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param a The match cost.
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @param tile The side of a tile of the DP table, in cells.
+ * @param pool The thread pool.
+ * @return The same cost as needleman_wunsch_gotoh_dp.
+ * @note The table is filled by tiled_dp: the tiles of an anti-diagonal run in parallel, and only
+ * the tile boundaries are kept, so two 1 Mbp sequences can be scored on all cores in O(m + n)
+ * memory.
+ * @note [Complexity]: O(nm / p) time complexity with p threads and O(m + n) space complexity.
+ */
+int needleman_wunsch_gotoh_tiled(const std::string &s1, const std::string &s2, int a = 0,
+                                 int x = 1, int o = 0, int e = 1, int tile = 256,
+                                 parallel::thread_pool &pool = parallel::default_thread_pool()) {
+    const detail::nwg_cells policy{s1, s2, a, x, o, e};
+    return -tiled_dp(policy, static_cast<int>(s1.size()), static_cast<int>(s2.size()), tile,
+                     pool);
 }
 
 }  // namespace alignment
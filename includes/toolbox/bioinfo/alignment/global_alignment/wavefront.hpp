@@ -5,6 +5,8 @@
 #include <utility>
 #include <vector>
 
+#include "toolbox/bioinfo/alignment/global_alignment/wavefront_compact.hpp"
+
 namespace toolbox {
 
 namespace alignment {
@@ -90,8 +92,7 @@ int wavefront_dp(const std::string &s1, const std::string &s2, std::vector<std::
  * @param M The DP table for matches.
  * @param I The DP table for insertions.
  * @param D The DP table for deletions.
- * @param s1_aligned The first aligned string.
- * @param s2_aligned The second aligned string.
+ * @param ops The CIGAR of the alignment (s1 plays the reference).
  * @param x The mismatch cost.
  * @param o The gap open cost.
  * @param e The gap extension cost.
@@ -100,11 +101,11 @@ int wavefront_dp(const std::string &s1, const std::string &s2, std::vector<std::
 void wavefront_traceback(const std::string &s1, const std::string &s2,
                          const std::vector<std::vector<int>> &M,
                          const std::vector<std::vector<int>> &I,
-                         const std::vector<std::vector<int>> &D, std::string &s1_aligned,
-                         std::string &s2_aligned, int x = 1, int o = 0, int e = 1) {
+                         const std::vector<std::vector<int>> &D, cigar &ops, int x = 1,
+                         int o = 0, int e = 1) {
     const int m = static_cast<int>(s1.size());
     const int n = static_cast<int>(s2.size());
-    int i, j, s, k, i_prev, j_prev;
+    int s, k;
     enum table { dp_M, dp_I, dp_D };
 
     s = M.size() - 1;
@@ -157,20 +158,51 @@ void wavefront_traceback(const std::string &s1, const std::string &s2,
         }
     }
     path.push_back(std::make_pair(0, 0));
-    s1_aligned = s2_aligned = "";
-    for (s = path.size() - 1; s >= 0; s--) {
-        i = path[s].first;
-        j = path[s].second;
-        i_prev = (s == static_cast<int>(path.size()) - 1) ? 0 : path[s + 1].first;
-        j_prev = (s == static_cast<int>(path.size()) - 1) ? 0 : path[s + 1].second;
-        if (j - i == j_prev - i_prev - 1) {
-            s2_aligned += "-";
-        } else if (j - i == j_prev - i_prev + 1) {
-            s1_aligned += "-";
-        }
-        s1_aligned += s1.substr(i_prev, i - i_prev);
-        s2_aligned += s2.substr(j_prev, j - j_prev);
-    }
+    detail::diagonal_path_to_cigar(path, ops);
+}
+
+/**
+ * @brief Wavefront traceback.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param M The DP table for matches.
+ * @param I The DP table for insertions.
+ * @param D The DP table for deletions.
+ * @param s1_aligned The first aligned string.
+ * @param s2_aligned The second aligned string.
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @note O(m) time complexity.
+ */
+void wavefront_traceback(const std::string &s1, const std::string &s2,
+                         const std::vector<std::vector<int>> &M,
+                         const std::vector<std::vector<int>> &I,
+                         const std::vector<std::vector<int>> &D, std::string &s1_aligned,
+                         std::string &s2_aligned, int x = 1, int o = 0, int e = 1) {
+    cigar ops;
+    wavefront_traceback(s1, s2, M, I, D, ops, x, o, e);
+    cigar_to_aligned(s1, s2, ops, s1_aligned, s2_aligned);
+}
+
+/**
+ * @brief Wavefront algorithm for global alignment.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment (score and CIGAR).
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @return The difference between the two strings.
+ * @note min-cost alignment, computed by wavefront_bialign (the tables of wavefront_dp are not
+ * built), so long reads can be aligned as well.
+ * @note Requires x > 0, o >= 0 and e > 0 (a free edit would leave the wavefronts stuck): other
+ * costs are rejected with -1 and no alignment.
+ * @note O(nd log d) time complexity and O(d) space complexity.
+ */
+int wavefront_all(const std::string &s1, const std::string &s2, alignment_result &res, int x = 1,
+                  int o = 0, int e = 1) {
+    return wavefront_bialign(s1, s2, res, x, o, e);
 }
 
 /**
@@ -183,15 +215,11 @@ void wavefront_traceback(const std::string &s1, const std::string &s2,
  * @param o The gap open cost.
  * @param e The gap extension cost.
  * @return The difference between the two strings.
- * @note min-cost alignment.
- * @note O(nd) time complexity and O(d^2) space complexity.
+ * @note Same alignment as the alignment_result overload, expanded to gapped strings.
  */
 int wavefront_all(const std::string &s1, const std::string &s2, std::string &s1_aligned,
                   std::string &s2_aligned, int x = 1, int o = 0, int e = 1) {
-    std::vector<std::vector<int>> M, I, D;
-    int diff = wavefront_dp(s1, s2, M, I, D, x, o, e);
-    wavefront_traceback(s1, s2, M, I, D, s1_aligned, s2_aligned, x, o, e);
-    return (diff);
+    return wavefront_bialign(s1, s2, s1_aligned, s2_aligned, x, o, e);
 }
 
 }  // namespace alignment
@@ -0,0 +1,660 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "toolbox/bioinfo/alignment/traceback.hpp"
+#include "toolbox/string/packed_dna.hpp"
+
+namespace toolbox {
+
+namespace alignment {
+
+namespace detail {
+
+// Offset of a diagonal that no alignment of the given score reaches.
+const int WFA_NULL = -(1 << 29);
+
+// Components of a wavefront (the M / I / D tables of wavefront_dp).
+enum { WFA_M = 0, WFA_I = 1, WFA_D = 2 };
+
+/**
+ * @brief Length of the common prefix of a[0..la) and b[0..lb).
+ * @note Compares 8 bytes per step: the first differing byte is found from the trailing (or, on a
+ * big-endian target, leading) zero bits of the XOR of the two words.
+ */
+inline int wfa_match_length(const char *a, int la, const char *b, int lb) {
+    const int limit = std::min(la, lb);
+    int len = 0;
+    while (len + 8 <= limit) {
+        uint64_t wa, wb;
+        std::memcpy(&wa, a + len, 8);
+        std::memcpy(&wb, b + len, 8);
+        const uint64_t diff = wa ^ wb;
+        if (diff != 0) {
+            if constexpr (std::endian::native == std::endian::big) {
+                return len + std::countl_zero(diff) / 8;
+            } else {
+                return len + std::countr_zero(diff) / 8;
+            }
+        }
+        len += 8;
+    }
+    while (len < limit && a[len] == b[len]) {
+        len++;
+    }
+    return len;
+}
+
+/**
+ * @brief Length of the common prefix of two packed sequences from the iterator positions.
+ * @note 32 bases per step (string::common_prefix).
+ */
+inline int wfa_match_length(string::packed_dna::const_iterator a, int la,
+                            string::packed_dna::const_iterator b, int lb) {
+    return static_cast<int>(string::common_prefix(a.sequence(), a.position(), b.sequence(),
+                                                  b.position(), std::min(la, lb)));
+}
+
+/**
+ * @brief Whether the wavefront engine can run with these costs: every edit must cost something,
+ * or the wavefront of a score never grows past the one before it.
+ */
+inline bool wfa_costs_valid(int x, int o, int e) { return x > 0 && o >= 0 && e > 0; }
+
+/**
+ * @brief One wavefront: the M / I / D offsets of diagonals klo .. klo + width - 1.
+ * @note lo .. hi is the live range (diagonals outside it are null in all three components). lo >
+ * hi marks a null wavefront, i.e. a score no alignment has.
+ */
+struct wfa_front {
+    int lo, hi;
+    int klo, width;
+    std::size_t base;
+};
+
+/**
+ * @brief Gap-affine wavefront engine with the recurrences of wavefront_dp.
+ * @note Only the live diagonal range of each wavefront is stored. With keep_all every wavefront
+ * is appended to one arena (for the traceback); otherwise only the last max(x, o + e) + 1
+ * wavefronts are kept in a ring of reused buffers, which is all the recurrences look at.
+ * @note begin / end select the component the alignment starts and ends in: starting in I or D
+ * means a gap is already open (extending it costs only e), ending in I or D means the alignment
+ * has to finish inside a gap. Both are WFA_M for an ordinary global alignment. With
+ * begin_forced the first operation has to be of component begin, which is how the end condition
+ * looks from the reverse engine of BiWFA.
+ * @note Text is the position type of the sequences: const char * for std::string, the iterator
+ * for packed_dna. It is advanced with + and passed to wfa_match_length.
+ */
+template <typename Text>
+class wfa_engine {
+ public:
+    wfa_engine(Text s1, int m, Text s2, int n, int x, int o, int e, int begin,
+               int end, bool keep_all, bool begin_forced = false)
+        : _s1(s1), _s2(s2), _m(m), _n(n), _x(x), _o(o), _e(e), _end(end), _keep_all(keep_all),
+          _scope(std::max(x, o + e)), _s(0), _reached(false), _stuck(false), _max_ad(0) {
+        assert(x > 0 && o >= 0 && e > 0);
+        if (!_keep_all) {
+            _ring.resize(_scope + 1);
+            _fronts.resize(_scope + 1);
+        }
+        wfa_front &f = alloc(0, 0, 0);
+        int *M = data(0);
+        M[0] = begin == WFA_M || !begin_forced ? 0 : WFA_NULL;
+        M[1] = begin == WFA_I ? 0 : WFA_NULL;
+        M[2] = begin == WFA_D ? 0 : WFA_NULL;
+        finish(f, M);
+    }
+
+    int score() const { return _s; }
+    bool reached() const { return _reached; }
+    // No wavefront is alive within reach of the next score: the end cannot be reached.
+    bool stuck() const { return _stuck; }
+    int scope() const { return _scope; }
+    // Largest antidiagonal i + j reached so far.
+    int max_antidiagonal() const { return _max_ad; }
+
+    /**
+     * @brief The wavefront of score s, or nullptr if it is null or no longer kept.
+     */
+    const wfa_front *front(int s) const {
+        if (s < 0 || s > _s || (!_keep_all && s < _s - _scope)) {
+            return nullptr;
+        }
+        const wfa_front &f = _fronts[slot(s)];
+        return f.lo <= f.hi ? &f : nullptr;
+    }
+
+    /**
+     * @brief Offset of component c on diagonal k in the wavefront of score s (WFA_NULL if none).
+     */
+    int offset(int s, int c, int k) const {
+        const wfa_front *f = front(s);
+        if (f == nullptr || k < f->lo || k > f->hi) {
+            return WFA_NULL;
+        }
+        return data(s)[c * f->width + (k - f->klo)];
+    }
+
+    /**
+     * @brief Computes and extends the wavefront of the next score.
+     */
+    void next() {
+        const int s = ++_s;
+        int lo = INT_MAX;
+        int hi = INT_MIN;
+        if (const wfa_front *f = front(s - _x)) {
+            lo = std::min(lo, f->lo);
+            hi = std::max(hi, f->hi);
+        }
+        for (const int t : {s - _o - _e, s - _e}) {
+            if (const wfa_front *f = front(t)) {
+                lo = std::min(lo, f->lo - 1);
+                hi = std::max(hi, f->hi + 1);
+            }
+        }
+        lo = std::max(lo, -_m);
+        hi = std::min(hi, _n);
+        if (lo > hi) {
+            alloc(s, 0, -1);
+            _stuck = true;
+            for (int t = s - 1; t > s - _scope; t--) {
+                _stuck &= front(t) == nullptr;
+            }
+            return;
+        }
+        wfa_front &f = alloc(s, lo, hi);
+        // Sources are looked up after alloc, which may move the arena.
+        const source mis(*this, s - _x);
+        const source opn(*this, s - _o - _e);
+        const source ext(*this, s - _e);
+        int *M = data(s);
+        int *I = M + f.width;
+        int *D = I + f.width;
+        for (int k = lo; k <= hi; k++) {
+            const int ins = std::max(opn.get(WFA_M, k - 1), ext.get(WFA_I, k - 1)) + 1;
+            const int del = std::max(opn.get(WFA_M, k + 1), ext.get(WFA_D, k + 1));
+            I[k - lo] = bound(ins, k);
+            D[k - lo] = bound(del, k);
+            M[k - lo] = std::max(bound(mis.get(WFA_M, k) + 1, k), std::max(I[k - lo], D[k - lo]));
+        }
+        finish(f, M);
+    }
+
+    // Drops offsets that run past either string.
+    int bound(int h, int k) const { return h < 0 || h > _n || h - k > _m ? WFA_NULL : h; }
+
+ private:
+    Text _s1, _s2;
+    int _m, _n, _x, _o, _e, _end;
+    bool _keep_all;
+    int _scope;
+    int _s;
+    bool _reached, _stuck;
+    int _max_ad;
+    std::vector<wfa_front> _fronts;
+    std::vector<int> _arena;
+    std::vector<std::vector<int>> _ring;
+
+    // The offsets of one source wavefront, hoisted out of the loop over diagonals.
+    struct source {
+        const int *p;
+        int lo, hi, klo, width;
+
+        source(const wfa_engine &w, int s) : p(nullptr), lo(0), hi(-1), klo(0), width(0) {
+            if (const wfa_front *f = w.front(s)) {
+                p = w.data(s);
+                lo = f->lo;
+                hi = f->hi;
+                klo = f->klo;
+                width = f->width;
+            }
+        }
+        int get(int c, int k) const {
+            return k >= lo && k <= hi ? p[c * width + (k - klo)] : WFA_NULL;
+        }
+    };
+
+    std::size_t slot(int s) const { return _keep_all ? s : s % (_scope + 1); }
+
+    int *data(int s) {
+        return _keep_all ? _arena.data() + _fronts[s].base : _ring[slot(s)].data();
+    }
+    const int *data(int s) const {
+        return _keep_all ? _arena.data() + _fronts[s].base : _ring[slot(s)].data();
+    }
+
+    wfa_front &alloc(int s, int lo, int hi) {
+        const int width = hi - lo + 1;
+        const std::size_t size = 3 * static_cast<std::size_t>(width);
+        if (_keep_all) {
+            _fronts.push_back(wfa_front{lo, hi, lo, width, _arena.size()});
+            _arena.resize(_arena.size() + size);
+        } else {
+            _fronts[slot(s)] = wfa_front{lo, hi, lo, width, 0};
+            _ring[slot(s)].resize(size);
+        }
+        return _fronts[slot(s)];
+    }
+
+    // Extends M along matches, trims the null ends and checks for the end cell.
+    void finish(wfa_front &f, int *M) {
+        int *I = M + f.width;
+        int *D = I + f.width;
+        for (int k = f.lo; k <= f.hi; k++) {
+            int &h = M[k - f.klo];
+            if (h >= 0) {
+                h += wfa_match_length(_s1 + (h - k), _m - (h - k), _s2 + h, _n - h);
+                _max_ad = std::max(_max_ad, 2 * h - k);
+            }
+        }
+        while (f.lo <= f.hi && M[f.lo - f.klo] < 0 && I[f.lo - f.klo] < 0 &&
+               D[f.lo - f.klo] < 0) {
+            f.lo++;
+        }
+        while (f.hi >= f.lo && M[f.hi - f.klo] < 0 && I[f.hi - f.klo] < 0 &&
+               D[f.hi - f.klo] < 0) {
+            f.hi--;
+        }
+        const int k_end = _n - _m;
+        _reached = k_end >= f.lo && k_end <= f.hi && M[_end * f.width + (k_end - f.klo)] == _n;
+    }
+};
+
+/**
+ * @brief Runs e until it reaches the end cell; returns false if it never can.
+ */
+template <typename Text>
+bool wfa_run(wfa_engine<Text> &e) {
+    while (!e.reached()) {
+        if (e.stuck()) {
+            return false;
+        }
+        e.next();
+    }
+    return true;
+}
+
+/**
+ * @brief Traceback of a wfa_engine run with keep_all, from the end cell back to (0, 0).
+ * @note The operations are pushed to rev back to front (see cigar_push).
+ */
+template <typename Text>
+void wfa_backtrace(const wfa_engine<Text> &w, int m, int n, int x, int o, int e, int end,
+                          cigar &rev) {
+    int s = w.score();
+    int k = n - m;
+    int h = n;
+    int c = end;
+    while (true) {
+        if (c == WFA_M) {
+            int src = 0;
+            if (s > 0) {
+                src = std::max(w.bound(w.offset(s - x, WFA_M, k) + 1, k),
+                               std::max(w.offset(s, WFA_I, k), w.offset(s, WFA_D, k)));
+            }
+            for (; h > src; h--) {
+                cigar_push(rev, 'M');
+            }
+            if (s == 0) {
+                return;
+            }
+            if (w.offset(s, WFA_I, k) == src) {
+                c = WFA_I;
+            } else if (w.offset(s, WFA_D, k) == src) {
+                c = WFA_D;
+            } else {
+                cigar_push(rev, 'M');
+                h--;
+                s -= x;
+            }
+        } else if (s == 0) {
+            return;  // started inside this gap
+        } else if (c == WFA_I) {
+            cigar_push(rev, 'I');
+            h--;
+            k--;
+            if (w.offset(s - o - e, WFA_M, k) == h) {
+                s -= o + e;
+                c = WFA_M;
+            } else {
+                s -= e;
+            }
+        } else {
+            cigar_push(rev, 'D');
+            k++;
+            if (w.offset(s - o - e, WFA_M, k) == h) {
+                s -= o + e;
+                c = WFA_M;
+            } else {
+                s -= e;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Aligns s1[0..m) with s2[0..n) with the whole wavefront history kept.
+ * @return The cost, or -1 if !wfa_costs_valid(x, o, e); the operations are appended to ops
+ * front to back.
+ */
+template <typename Text>
+int wfa_align(Text s1, int m, Text s2, int n, int x, int o, int e, int begin, int end,
+              cigar &ops) {
+    if (!wfa_costs_valid(x, o, e)) {
+        return -1;
+    }
+    wfa_engine<Text> w(s1, m, s2, n, x, o, e, begin, end, true);
+    const bool ok = wfa_run(w);
+    assert(ok);
+    static_cast<void>(ok);
+    cigar rev;
+    wfa_backtrace(w, m, n, x, o, e, end, rev);
+    cigar_finish(rev);
+    cigar_append(ops, rev);
+    return w.score();
+}
+
+/**
+ * @brief A split point of BiWFA: forward cell (h - k, h) in component c.
+ */
+struct wfa_breakpoint {
+    int score;
+    int k, h, c;
+};
+
+/**
+ * @brief Looks for a meeting point between the wavefront of score sa of engine a and the last
+ * wavefronts of engine b.
+ * @note The forward diagonal k meets the reverse diagonal (n - m) - k, and the two overlap once
+ * their offsets add up to n. Meeting inside a gap counts its opening cost o on both sides, so it
+ * is subtracted once.
+ */
+template <typename Text>
+void wfa_overlap(const wfa_engine<Text> &a, const wfa_engine<Text> &b, bool a_forward, int m, int n,
+                        int o, wfa_breakpoint &bp) {
+    const int sa = a.score();
+    const wfa_front *fa = a.front(sa);
+    if (fa == nullptr) {
+        return;
+    }
+    for (int sb = b.score(); sb >= 0 && sb > b.score() - b.scope(); sb--) {
+        const wfa_front *fb = b.front(sb);
+        if (fb == nullptr) {
+            continue;
+        }
+        const int lo = std::max(fa->lo, (n - m) - fb->hi);
+        const int hi = std::min(fa->hi, (n - m) - fb->lo);
+        for (int c = WFA_M; c <= WFA_D; c++) {
+            const int score = sa + sb - (c == WFA_M ? 0 : o);
+            for (int k = lo; k <= hi && score < bp.score; k++) {
+                const int ha = a.offset(sa, c, k);
+                const int hb = b.offset(sb, c, (n - m) - k);
+                if (ha >= 0 && hb >= 0 && ha + hb >= n) {
+                    bp.score = score;
+                    bp.k = a_forward ? k : (n - m) - k;
+                    bp.h = a_forward ? ha : hb;
+                    bp.c = c;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief BiWFA: aligns s1[0..m) with s2[0..n) in memory linear in the score.
+ * @param r1 s1[0..m) reversed (or reverse complemented: only base equality is looked at).
+ * @param r2 s2[0..n) reversed likewise.
+ * @param cutoff Subproblems whose cost is at most cutoff are aligned with wfa_align.
+ * @return The cost, or -1 if !wfa_costs_valid(x, o, e); the operations are appended to ops
+ * front to back.
+ * @note A forward and a reverse wavefront engine (each keeping only its last wavefronts) are
+ * advanced in turn until they meet; the meeting point splits the problem in two, and each half is
+ * aligned recursively.
+ */
+template <typename Text>
+int wfa_bialign(Text s1, int m, Text s2, int n, Text r1, Text r2, int x, int o, int e, int begin,
+                int end, int cutoff, cigar &ops) {
+    if (!wfa_costs_valid(x, o, e)) {
+        return -1;
+    }
+    wfa_breakpoint bp{INT_MAX, 0, 0, WFA_M};
+    if (m > 0 && n > 0) {
+        wfa_engine<Text> fwd(s1, m, s2, n, x, o, e, begin, end, false);
+        wfa_engine<Text> rev(r1, m, r2, n, x, o, e, end, begin, false, true);
+        const int slack = std::max(x, o + e) + o;
+        if (fwd.max_antidiagonal() + rev.max_antidiagonal() >= m + n) {
+            wfa_overlap(fwd, rev, true, m, n, o, bp);
+        }
+        bool turn = false;
+        // Later meetings cost at least fwd + rev + 2 - slack, so stop once none can beat bp.
+        while (bp.score == INT_MAX || bp.score > fwd.score() + rev.score() + 2 - slack) {
+            if (fwd.stuck() && rev.stuck()) {
+                break;
+            }
+            wfa_engine<Text> &a = turn ? fwd : rev;
+            if (!a.stuck()) {
+                a.next();
+                if (fwd.max_antidiagonal() + rev.max_antidiagonal() >= m + n) {
+                    wfa_overlap(a, turn ? rev : fwd, turn, m, n, o, bp);
+                }
+            }
+            turn = !turn;
+        }
+    }
+    const int bi = bp.h - bp.k;
+    const int bj = bp.h;
+    if (bp.score <= cutoff || (bi == 0 && bj == 0) || (bi == m && bj == n)) {
+        return wfa_align(s1, m, s2, n, x, o, e, begin, end, ops);
+    }
+    const int left = wfa_bialign(s1, bi, s2, bj, r1 + (m - bi), r2 + (n - bj), x, o, e, begin,
+                                 bp.c, cutoff, ops);
+    const int right = wfa_bialign(s1 + bi, m - bi, s2 + bj, n - bj, r1, r2, x, o, e, bp.c, end,
+                                  cutoff, ops);
+    return left + right;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Wavefront alignment cost without traceback, in memory independent of the score.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @return The same cost as wavefront_dp.
+ * @note min-cost alignment. Requires x > 0, o >= 0 and e > 0; other costs return -1. Only the
+ * last max(x, o + e) + 1 wavefronts are kept (in reused buffers), and each stores only its live
+ * diagonal range.
+ * @note [Complexity]: O((m + n)s) time complexity and O(s) space complexity.
+ */
+int wavefront_score(const std::string &s1, const std::string &s2, int x = 1, int o = 0,
+                    int e = 1) {
+    if (!detail::wfa_costs_valid(x, o, e)) {
+        return -1;
+    }
+    detail::wfa_engine<const char *> w(s1.data(), static_cast<int>(s1.size()), s2.data(),
+                         static_cast<int>(s2.size()), x, o, e, detail::WFA_M, detail::WFA_M,
+                         false);
+    detail::wfa_run(w);
+    return w.score();
+}
+
+/**
+ * @brief Wavefront algorithm for global alignment with a compact wavefront store.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment (score and CIGAR).
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @return The same cost as wavefront_all.
+ * @note min-cost alignment. Requires x > 0, o >= 0 and e > 0; other costs return -1 with no
+ * alignment. Each wavefront stores only its live diagonal range, all of them in one arena, and
+ * matches are extended 8 bytes at a time.
+ * @note [Complexity]: O((m + n)s) time complexity and O(s^2) space complexity in the worst case.
+ */
+int wavefront_compact_all(const std::string &s1, const std::string &s2, alignment_result &res,
+                          int x = 1, int o = 0, int e = 1) {
+    res.ops.clear();
+    const int cost = detail::wfa_align(s1.data(), static_cast<int>(s1.size()), s2.data(),
+                                       static_cast<int>(s2.size()), x, o, e, detail::WFA_M,
+                                       detail::WFA_M, res.ops);
+    detail::finish_result(res, cost, 0, 0);
+    return cost;
+}
+
+/**
+ * @brief Wavefront algorithm for global alignment with a compact wavefront store.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param s1_aligned The first aligned string.
+ * @param s2_aligned The second aligned string.
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @return The same cost as wavefront_all.
+ * @note Same alignment as the alignment_result overload, expanded to gapped strings.
+ */
+int wavefront_compact_all(const std::string &s1, const std::string &s2, std::string &s1_aligned,
+                          std::string &s2_aligned, int x = 1, int o = 0, int e = 1) {
+    alignment_result res;
+    wavefront_compact_all(s1, s2, res, x, o, e);
+    alignment_to_aligned(s1, s2, res, s1_aligned, s2_aligned);
+    return res.score;
+}
+
+/**
+ * @brief Bidirectional wavefront algorithm (BiWFA) for global alignment.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment (score and CIGAR).
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @param cutoff Subproblems of cost at most cutoff are aligned by wavefront_compact_all instead of
+ * being split further.
+ * @return The same cost as wavefront_all.
+ * @note min-cost alignment. Requires x > 0, o >= 0 and e > 0; other costs return -1 with no
+ * alignment. The problem is split where a forward and a reverse wavefront meet, so only the last
+ * max(x, o + e) + 1 wavefronts of either direction are kept. This makes long reads (tens of kbp
+ * with thousands of differences) alignable.
+ * @note [Complexity]: O((m + n)s log s) time complexity and O(s + cutoff^2) space complexity.
+ */
+int wavefront_bialign(const std::string &s1, const std::string &s2, alignment_result &res,
+                      int x = 1, int o = 0, int e = 1, int cutoff = 256) {
+    const std::string r1(s1.rbegin(), s1.rend());
+    const std::string r2(s2.rbegin(), s2.rend());
+    res.ops.clear();
+    const int cost = detail::wfa_bialign(s1.data(), static_cast<int>(s1.size()), s2.data(),
+                                         static_cast<int>(s2.size()), r1.data(), r2.data(), x, o,
+                                         e, detail::WFA_M, detail::WFA_M, cutoff, res.ops);
+    detail::finish_result(res, cost, 0, 0);
+    return cost;
+}
+
+/**
+ * @brief Bidirectional wavefront algorithm (BiWFA) for global alignment.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param s1_aligned The first aligned string.
+ * @param s2_aligned The second aligned string.
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @param cutoff Subproblems of cost at most cutoff are aligned by wavefront_compact_all instead of
+ * being split further.
+ * @return The same cost as wavefront_all.
+ * @note Same alignment as the alignment_result overload, expanded to gapped strings.
+ */
+int wavefront_bialign(const std::string &s1, const std::string &s2, std::string &s1_aligned,
+                      std::string &s2_aligned, int x = 1, int o = 0, int e = 1,
+                      int cutoff = 256) {
+    alignment_result res;
+    wavefront_bialign(s1, s2, res, x, o, e, cutoff);
+    alignment_to_aligned(s1, s2, res, s1_aligned, s2_aligned);
+    return res.score;
+}
+
+/**
+ * @brief Wavefront alignment cost of two packed DNA sequences, without traceback.
+ * @param s1 The first sequence.
+ * @param s2 The second sequence.
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @return The same cost as wavefront_score of the unpacked strings.
+ * @note Matches are extended 32 bases per word comparison, on a quarter of the memory.
+ * @note [Complexity]: O((m + n)s) time complexity and O(s) space complexity.
+ */
+int wavefront_score(const string::packed_dna &s1, const string::packed_dna &s2, int x = 1,
+                    int o = 0, int e = 1) {
+    if (!detail::wfa_costs_valid(x, o, e)) {
+        return -1;
+    }
+    detail::wfa_engine<string::packed_dna::const_iterator> w(
+        s1.begin(), static_cast<int>(s1.size()), s2.begin(), static_cast<int>(s2.size()), x, o,
+        e, detail::WFA_M, detail::WFA_M, false);
+    detail::wfa_run(w);
+    return w.score();
+}
+
+/**
+ * @brief Wavefront alignment of two packed DNA sequences with a compact wavefront store.
+ * @param s1 The first sequence.
+ * @param s2 The second sequence.
+ * @param res The alignment (score and CIGAR).
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @return The same cost as wavefront_compact_all of the unpacked strings.
+ * @note Same alignment as the std::string overload; matches are extended 32 bases at a time.
+ */
+int wavefront_compact_all(const string::packed_dna &s1, const string::packed_dna &s2,
+                          alignment_result &res, int x = 1, int o = 0, int e = 1) {
+    res.ops.clear();
+    const int cost = detail::wfa_align(s1.begin(), static_cast<int>(s1.size()), s2.begin(),
+                                       static_cast<int>(s2.size()), x, o, e, detail::WFA_M,
+                                       detail::WFA_M, res.ops);
+    detail::finish_result(res, cost, 0, 0);
+    return cost;
+}
+
+/**
+ * @brief BiWFA alignment of two packed DNA sequences.
+ * @param s1 The first sequence.
+ * @param s2 The second sequence.
+ * @param res The alignment (score and CIGAR).
+ * @param x The mismatch cost.
+ * @param o The gap open cost.
+ * @param e The gap extension cost.
+ * @param cutoff Subproblems of cost at most cutoff are aligned without being split further.
+ * @return The same cost as wavefront_bialign of the unpacked strings.
+ * @note The reverse engine runs on the reverse complements, which string::packed_dna builds a
+ * word at a time and which match exactly where the reversed sequences do.
+ * @note [Complexity]: O((m + n)s log s) time complexity and O(s + cutoff^2) space complexity.
+ */
+int wavefront_bialign(const string::packed_dna &s1, const string::packed_dna &s2,
+                      alignment_result &res, int x = 1, int o = 0, int e = 1, int cutoff = 256) {
+    const string::packed_dna r1 = s1.reverse_complement();
+    const string::packed_dna r2 = s2.reverse_complement();
+    res.ops.clear();
+    const int cost = detail::wfa_bialign(s1.begin(), static_cast<int>(s1.size()), s2.begin(),
+                                         static_cast<int>(s2.size()), r1.begin(), r2.begin(), x,
+                                         o, e, detail::WFA_M, detail::WFA_M, cutoff, res.ops);
+    detail::finish_result(res, cost, 0, 0);
+    return cost;
+}
+
+}  // namespace alignment
+
+}  // namespace toolbox
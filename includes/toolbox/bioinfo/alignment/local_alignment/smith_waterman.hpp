@@ -1,9 +1,15 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <vector>
 
+#include "toolbox/bioinfo/alignment/tiled_dp.hpp"
+#include "toolbox/bioinfo/alignment/traceback.hpp"
+
 namespace toolbox {
 
 namespace alignment {
@@ -75,24 +81,117 @@ void smith_waterman_traceback(const std::string &s1, const std::string &s2,
     }
     int i = bi;
     int j = bj;
-    s1_aligned = "";
-    s2_aligned = "";
+    std::string r1, r2;
     while (i > 0 && j > 0 && dp[i][j] > 0) {
         if (dp[i][j] == dp[i - 1][j - 1] + (s1[i - 1] == s2[j - 1] ? a : -x)) {
-            s1_aligned = s1[i - 1] + s1_aligned;
-            s2_aligned = s2[j - 1] + s2_aligned;
+            detail::tb_emit(r1, r2, s1[--i], s2[--j]);
+        } else if (dp[i][j] == dp[i - 1][j] - g) {
+            detail::tb_emit(r1, r2, s1[--i], '-');
+        } else {
+            detail::tb_emit(r1, r2, '-', s2[--j]);
+        }
+    }
+    detail::tb_finish(r1, r2, s1_aligned, s2_aligned);
+}
+
+/**
+ * @brief Smith-Waterman algorithm for local alignment, returning the alignment as a CIGAR.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param ops The CIGAR of the alignment (s1 plays the reference).
+ * @param begin1 The position in s1 the alignment starts at.
+ * @param begin2 The position in s2 the alignment starts at.
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param g The gap penalty.
+ * @return The best local alignment score.
+ * @note max-score alignment. The move of every cell (diagonal, up, left, or stop where the score
+ * is floored at 0) is recorded in a 2-bit packed traceback during the fill, so the scores only
+ * need two rolling rows. Ties are broken as in smith_waterman_traceback.
+ * @note [Complexity]: O(nm) time complexity, O(n) space for the scores and nm / 4 bytes for the
+ * traceback. The walk back is O(m + n).
+ */
+int smith_waterman_cigar(const std::string &s1, const std::string &s2, cigar &ops,
+                         std::size_t &begin1, std::size_t &begin2, int a = 1, int x = 1,
+                         int g = 1) {
+    const int m = static_cast<int>(s1.size());
+    const int n = static_cast<int>(s2.size());
+    const std::size_t width = n + 1;
+    detail::packed_traceback<2> tb((m + 1) * width);
+    std::vector<int> prev(n + 1, 0), cur(n + 1, 0);
+    int best = 0;
+    int bi = 0;
+    int bj = 0;
+    for (int i = 1; i <= m; i++) {
+        prev.swap(cur);
+        for (int j = 1; j <= n; j++) {
+            int h = prev[j - 1] + (s1[i - 1] == s2[j - 1] ? a : -x);
+            uint8_t from = detail::TB_DIAG;
+            if (prev[j] - g > h) {
+                h = prev[j] - g;
+                from = detail::TB_UP;
+            }
+            if (cur[j - 1] - g > h) {
+                h = cur[j - 1] - g;
+                from = detail::TB_LEFT;
+            }
+            if (h <= 0) {
+                h = 0;
+                from = detail::TB_STOP;
+            }
+            cur[j] = h;
+            tb.set(i * width + j, from);
+            if (h > best) {
+                best = h;
+                bi = i;
+                bj = j;
+            }
+        }
+    }
+    ops.clear();
+    int i = bi;
+    int j = bj;
+    while (i > 0 && j > 0) {
+        const uint8_t from = tb.get(i * width + j);
+        if (from == detail::TB_DIAG) {
+            detail::cigar_push(ops, 'M');
             i--;
             j--;
-        } else if (dp[i][j] == dp[i - 1][j] - g) {
-            s1_aligned = s1[i - 1] + s1_aligned;
-            s2_aligned = "-" + s2_aligned;
+        } else if (from == detail::TB_UP) {
+            detail::cigar_push(ops, 'D');
             i--;
-        } else {
-            s1_aligned = "-" + s1_aligned;
-            s2_aligned = s2[j - 1] + s2_aligned;
+        } else if (from == detail::TB_LEFT) {
+            detail::cigar_push(ops, 'I');
             j--;
+        } else {
+            break;
         }
     }
+    detail::cigar_finish(ops);
+    begin1 = i;
+    begin2 = j;
+    return best;
+}
+
+/**
+ * @brief Smith-Waterman algorithm for local alignment.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment (score, coordinates and CIGAR).
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param g The gap penalty.
+ * @return The best local alignment score.
+ * @note max-score alignment, computed by smith_waterman_cigar.
+ * @note [Complexity]: O(nm) time complexity and O(n) + nm / 4 bytes space complexity.
+ */
+int smith_waterman_all(const std::string &s1, const std::string &s2, alignment_result &res,
+                       int a = 1, int x = 1, int g = 1) {
+    std::size_t begin1 = 0;
+    std::size_t begin2 = 0;
+    const int score = smith_waterman_cigar(s1, s2, res.ops, begin1, begin2, a, x, g);
+    detail::finish_result(res, score, begin1, begin2);
+    return score;
 }
 
 /**
@@ -105,15 +204,56 @@ void smith_waterman_traceback(const std::string &s1, const std::string &s2,
  * @param x The mismatch penalty.
  * @param g The gap penalty.
  * @return The best local alignment score.
- * @note max-score alignment.
- * @note [Complexity]: O(nm) time complexity and O(nm) space complexity.
+ * @note Same alignment as the alignment_result overload, expanded to gapped strings.
  */
 int smith_waterman_all(const std::string &s1, const std::string &s2, std::string &s1_aligned,
                        std::string &s2_aligned, int a = 1, int x = 1, int g = 1) {
-    std::vector<std::vector<int>> dp;
-    int score = smith_waterman_dp(s1, s2, dp, a, x, g);
-    smith_waterman_traceback(s1, s2, dp, s1_aligned, s2_aligned, a, x, g);
-    return score;
+    alignment_result res;
+    smith_waterman_all(s1, s2, res, a, x, g);
+    alignment_to_aligned(s1, s2, res, s1_aligned, s2_aligned);
+    return res.score;
+}
+
+namespace detail {
+
+/**
+ * @brief Cell-update policy of smith_waterman_dp for tiled_dp.
+ */
+struct sw_cells {
+    typedef int cell;
+    const std::string &s1;
+    const std::string &s2;
+    int a, x, g;
+
+    int boundary_row(int) const { return 0; }
+    int boundary_col(int) const { return 0; }
+    int update(int i, int j, int diag, int up, int left) const {
+        return std::max({0, diag + (s1[i - 1] == s2[j - 1] ? a : -x), up - g, left - g});
+    }
+    int value(int c, int, int) const { return c; }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Smith-Waterman algorithm for local alignment, score only, on several threads.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param g The gap penalty.
+ * @param tile The side of a tile of the DP table, in cells.
+ * @param pool The thread pool.
+ * @return The same score as smith_waterman_dp.
+ * @note The table is filled by tiled_dp: the tiles of an anti-diagonal run in parallel, and only
+ * the tile boundaries are kept.
+ * @note [Complexity]: O(nm / p) time complexity with p threads and O(m + n) space complexity.
+ */
+int smith_waterman_tiled(const std::string &s1, const std::string &s2, int a = 1, int x = 1,
+                         int g = 1, int tile = 256,
+                         parallel::thread_pool &pool = parallel::default_thread_pool()) {
+    const detail::sw_cells policy{s1, s2, a, x, g};
+    return tiled_dp(policy, static_cast<int>(s1.size()), static_cast<int>(s2.size()), tile, pool);
 }
 
 }  // namespace alignment
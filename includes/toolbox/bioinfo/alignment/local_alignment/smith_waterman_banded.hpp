@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "toolbox/bioinfo/alignment/global_alignment/banded.hpp"
+
+namespace toolbox {
+
+namespace alignment {
+
+/**
+ * @brief Banded Smith-Waterman algorithm for local alignment.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment (score, coordinates and CIGAR).
+ * @param w The band width: only cells with |i - j| <= w are computed.
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param g The gap penalty.
+ * @return The best score of a local alignment that stays inside the band.
+ * @note max-score alignment. Ties are broken as in smith_waterman_traceback (first best cell in
+ * row-major order, then diagonal, up, left), so the result equals smith_waterman_all whenever
+ * the best local alignment stays within the band.
+ * @note The DP keeps two rolling rows of scores and 2 traceback bits per band cell.
+ * @note [Complexity]: O(w m) time complexity and O(w m + n) space complexity.
+ */
+int smith_waterman_banded(const std::string &s1, const std::string &s2, alignment_result &res,
+                          int w, int a = 1, int x = 1, int g = 1) {
+    const int m = static_cast<int>(s1.size());
+    const int n = static_cast<int>(s2.size());
+    const detail::band_layout band(m, n, std::max(w, 0));
+    detail::packed_traceback<2> tb(band.size());
+    std::vector<int> prev(n + 1, 0), cur(n + 1, 0);
+    int best = 0;
+    int bi = 0;
+    int bj = 0;
+    for (int i = 1; i <= m; i++) {
+        const int lo = band.lo(i);
+        const int hi = band.hi(i);
+        if (lo > hi) {
+            break;  // the band has left the table
+        }
+        cur[lo] = 0;
+        for (int j = std::max(lo, 1); j <= hi; j++) {
+            int h = prev[j - 1] + (s1[i - 1] == s2[j - 1] ? a : -x);
+            uint8_t from = detail::TB_DIAG;
+            if (j <= i - 1 + band.w && prev[j] - g > h) {
+                h = prev[j] - g;
+                from = detail::TB_UP;
+            }
+            if (j > lo && cur[j - 1] - g > h) {
+                h = cur[j - 1] - g;
+                from = detail::TB_LEFT;
+            }
+            if (h <= 0) {
+                h = 0;
+                from = detail::TB_STOP;
+            }
+            cur[j] = h;
+            tb.set(band.index(i, j), from);
+            if (h > best) {
+                best = h;
+                bi = i;
+                bj = j;
+            }
+        }
+        prev.swap(cur);
+    }
+    res.ops.clear();
+    int i = bi;
+    int j = bj;
+    while (i > 0 && j > 0) {
+        const uint8_t from = tb.get(band.index(i, j));
+        if (from == detail::TB_DIAG) {
+            detail::cigar_push(res.ops, 'M');
+            i--;
+            j--;
+        } else if (from == detail::TB_UP) {
+            detail::cigar_push(res.ops, 'D');
+            i--;
+        } else if (from == detail::TB_LEFT) {
+            detail::cigar_push(res.ops, 'I');
+            j--;
+        } else {
+            break;
+        }
+    }
+    detail::cigar_finish(res.ops);
+    detail::finish_result(res, best, i, j);
+    return best;
+}
+
+/**
+ * @brief Banded Smith-Waterman algorithm for local alignment.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param s1_aligned The first aligned string.
+ * @param s2_aligned The second aligned string.
+ * @param w The band width: only cells with |i - j| <= w are computed.
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param g The gap penalty.
+ * @return The best score of a local alignment that stays inside the band.
+ * @note Same alignment as the alignment_result overload, expanded to gapped strings.
+ */
+int smith_waterman_banded(const std::string &s1, const std::string &s2, std::string &s1_aligned,
+                          std::string &s2_aligned, int w, int a = 1, int x = 1, int g = 1) {
+    alignment_result res;
+    smith_waterman_banded(s1, s2, res, w, a, x, g);
+    alignment_to_aligned(s1, s2, res, s1_aligned, s2_aligned);
+    return res.score;
+}
+
+}  // namespace alignment
+
+}  // namespace toolbox
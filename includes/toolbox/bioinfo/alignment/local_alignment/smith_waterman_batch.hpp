@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "toolbox/bioinfo/alignment/local_alignment/smith_waterman_striped.hpp"
+#include "toolbox/parallel/thread_pool/thread_pool.hpp"
+
+namespace toolbox {
+
+namespace alignment {
+
+/**
+ * @brief One hit of smith_waterman_batch_top_k.
+ */
+struct batch_hit {
+    int score;
+    std::size_t target;
+};
+
+namespace detail {
+
+// Better hit first: higher score, then lower target index (so that top-k is deterministic).
+inline bool batch_hit_better(const batch_hit &l, const batch_hit &r) {
+    return l.score != r.score ? l.score > r.score : l.target < r.target;
+}
+
+/**
+ * @brief Query characters compressed to profile rows, shared by every batch.
+ * @note Row 0 stands for every character absent from the query.
+ */
+struct batch_query {
+    std::vector<int> qrow;
+    std::string chars;
+
+    explicit batch_query(const std::string &query) : qrow(query.size()) {
+        std::array<int, 256> row;
+        row.fill(0);
+        for (std::size_t i = 0; i < query.size(); i++) {
+            const unsigned char c = static_cast<unsigned char>(query[i]);
+            if (row[c] == 0) {
+                chars += query[i];
+                row[c] = static_cast<int>(chars.size());
+            }
+            qrow[i] = row[c];
+        }
+    }
+};
+
+#if defined(__AVX2__) || defined(__SSE2__)
+
+/**
+ * @brief Inter-sequence Smith-Waterman: one query against up to V::lanes targets at once.
+ * @param targets The targets, one per lane.
+ * @param count The number of targets (at most V::lanes).
+ * @param scores The output scores, one per target.
+ * @param overflow Set for the targets whose score saturated the lanes.
+ * @note Lane k holds the DP column of targets[k], so the lanes never depend on each other and no
+ * lazy-F correction is needed. Shorter targets are padded with characters that mismatch
+ * everything, which can never raise a local score. The score profile of each target column
+ * (one vector per query character) is rebuilt as the column is consumed.
+ */
+template <typename V>
+void batch_kernel(const batch_query &q, const std::string *const *targets, int count, int a,
+                  int x, int o, int e, int bias, int *scores, bool *overflow) {
+    typedef typename V::vec vec;
+    typedef typename V::elem elem;
+    const int L = V::lanes;
+    const int m = static_cast<int>(q.qrow.size());
+    const int num_rows = static_cast<int>(q.chars.size()) + 1;
+    std::size_t n = 0;
+    for (int k = 0; k < count; k++) {
+        n = std::max(n, targets[k]->size());
+    }
+    std::vector<elem> H(m * L, 0), E(m * L, 0);
+    std::vector<elem> prof(num_rows * L, static_cast<elem>(bias - x));
+    const vec gap_o = V::set1(o + e);
+    const vec gap_e = V::set1(e);
+    const vec vbias = V::set1(bias);
+    // Raw pointers: stores through elem (possibly a char type) would otherwise force the vector
+    // internals to be reloaded on every cell.
+    elem *h_ptr = H.data();
+    elem *e_ptr = E.data();
+    elem *p_ptr = prof.data();
+    const int *qrow = q.qrow.data();
+    vec best = V::zero();
+    for (std::size_t j = 0; j < n; j++) {
+        for (int k = 0; k < count; k++) {
+            const bool inside = j < targets[k]->size();
+            const char c = inside ? (*targets[k])[j] : 0;
+            for (int r = 1; r < num_rows; r++) {
+                const bool match = inside && c == q.chars[r - 1];
+                p_ptr[r * L + k] = static_cast<elem>(bias + (match ? a : -x));
+            }
+        }
+        vec F = V::zero();
+        vec diag = V::zero();
+        for (int i = 0; i < m; i++) {
+            const vec up = V::load(h_ptr + i * L);
+            const vec e_i = V::max(V::subs(V::load(e_ptr + i * L), gap_e), V::subs(up, gap_o));
+            vec h = V::add_score(diag, V::load(p_ptr + qrow[i] * L), vbias);
+            h = V::max(h, e_i);
+            h = V::max(h, F);
+            best = V::max(best, h);
+            V::store(e_ptr + i * L, e_i);
+            V::store(h_ptr + i * L, h);
+            F = V::max(V::subs(F, gap_e), V::subs(h, gap_o));
+            diag = up;
+        }
+    }
+    elem lanes[V::lanes];
+    V::store(lanes, best);
+    for (int k = 0; k < count; k++) {
+        scores[k] = lanes[k];
+        overflow[k] = lanes[k] + bias >= V::limit;
+    }
+}
+
+#endif
+
+/**
+ * @brief Scores one batch of targets: 8-bit lanes first, then 16-bit lanes and the scalar kernel
+ * for the targets that saturate.
+ */
+inline void batch_align(const std::string &query, const batch_query &q,
+                        const std::vector<std::string> &targets, const std::size_t *ids, int count,
+                        int a, int x, int o, int e, int *scores) {
+    std::vector<const std::string *> ptrs(count);
+    std::vector<bool> todo(count, true);
+    for (int k = 0; k < count; k++) {
+        ptrs[k] = &targets[ids[k]];
+    }
+#if defined(__AVX2__) || defined(__SSE2__)
+    if (e > 0 && o >= 0 && a >= 0 && x >= 0) {
+        bool overflow[striped_u8::lanes];
+        if (a + x < 255 && o + e < 255) {
+            batch_kernel<striped_u8>(q, ptrs.data(), count, a, x, o, e, x, scores, overflow);
+            for (int k = 0; k < count; k++) {
+                todo[k] = overflow[k];
+            }
+        }
+        if (a + x < 32767 && o + e < 32767) {
+            std::vector<const std::string *> rest;
+            std::vector<int> where;
+            for (int k = 0; k < count; k++) {
+                if (todo[k]) {
+                    rest.push_back(ptrs[k]);
+                    where.push_back(k);
+                }
+            }
+            int rest_scores[striped_i16::lanes];
+            for (std::size_t b = 0; b < rest.size(); b += striped_i16::lanes) {
+                const int c = static_cast<int>(std::min<std::size_t>(striped_i16::lanes,
+                                                                     rest.size() - b));
+                batch_kernel<striped_i16>(q, rest.data() + b, c, a, x, o, e, 0, rest_scores,
+                                          overflow);
+                for (int k = 0; k < c; k++) {
+                    scores[where[b + k]] = rest_scores[k];
+                    todo[where[b + k]] = overflow[k];
+                }
+            }
+        }
+    }
+#endif
+    for (int k = 0; k < count; k++) {
+        if (todo[k]) {
+            scores[k] = smith_waterman_affine_score(query, *ptrs[k], a, x, o, e);
+        }
+    }
+}
+
+// Number of targets per batch: one per 8-bit lane.
+inline int batch_width() {
+#if defined(__AVX2__) || defined(__SSE2__)
+    return striped_u8::lanes;
+#else
+    return 16;
+#endif
+}
+
+/**
+ * @brief Splits the targets into batches of similar length and scores each batch in parallel.
+ * @param emit Called as emit(batch, ids, scores, count) once per batch, possibly concurrently.
+ * @note Targets are grouped by length (longest first) so that little of each batch is padding
+ * and the longest batches are started first.
+ */
+template <typename Emit>
+void batch_for_each(const std::string &query, const std::vector<std::string> &targets, int a,
+                    int x, int o, int e, parallel::thread_pool &pool, Emit emit) {
+    const batch_query q(query);
+    std::vector<std::size_t> order(targets.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t l, std::size_t r) {
+        return targets[l].size() > targets[r].size();
+    });
+    const std::size_t width = batch_width();
+    const std::size_t batches = (targets.size() + width - 1) / width;
+    pool.parallel_for(0, batches, [&](std::size_t b) {
+        const int count = static_cast<int>(std::min(width, targets.size() - b * width));
+        std::vector<int> scores(count);
+        batch_align(query, q, targets, order.data() + b * width, count, a, x, o, e, scores.data());
+        emit(b, order.data() + b * width, scores.data(), count);
+    });
+}
+
+}  // namespace detail
+
+/**
+ * @brief Smith-Waterman scores of one query against many targets (inter-sequence SIMD).
+ * @param query The query string.
+ * @param targets The target strings.
+ * @param scores The output scores; must already have targets.size() elements.
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param o The gap open penalty.
+ * @param e The gap extension penalty.
+ * @param pool The threads the batches are spread over.
+ * @note Same scores as smith_waterman_striped(query, targets[t], a, x, o, e) for every t. Each
+ * SIMD lane scores a different target (16 or 32 targets per register with 8-bit lanes), so the
+ * throughput does not depend on the query length being a multiple of the register width.
+ * @note [Complexity]: O(|query| * sum |targets| / lanes / threads) time complexity and
+ * O(|query| * lanes) space complexity per thread.
+ */
+void smith_waterman_batch(const std::string &query, const std::vector<std::string> &targets,
+                          std::vector<int> &scores, int a = 1, int x = 1, int o = 0, int e = 1,
+                          parallel::thread_pool &pool = parallel::default_thread_pool()) {
+    assert(scores.size() == targets.size());
+    detail::batch_for_each(query, targets, a, x, o, e, pool,
+                           [&](std::size_t, const std::size_t *ids, const int *s, int count) {
+                               for (int k = 0; k < count; k++) {
+                                   scores[ids[k]] = s[k];
+                               }
+                           });
+}
+
+/**
+ * @brief The k best Smith-Waterman hits of one query against many targets.
+ * @param query The query string.
+ * @param targets The target strings.
+ * @param k The number of hits to keep.
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param o The gap open penalty.
+ * @param e The gap extension penalty.
+ * @param pool The threads the batches are spread over.
+ * @return The min(k, targets.size()) best hits, best first (ties broken by target index).
+ * @note Every batch keeps its own heap of at most k hits, and the heaps are merged at the end,
+ * so no score vector of all targets is materialised.
+ */
+std::vector<batch_hit> smith_waterman_batch_top_k(
+    const std::string &query, const std::vector<std::string> &targets, std::size_t k, int a = 1,
+    int x = 1, int o = 0, int e = 1,
+    parallel::thread_pool &pool = parallel::default_thread_pool()) {
+    const std::size_t width = detail::batch_width();
+    std::vector<std::vector<batch_hit>> heaps((targets.size() + width - 1) / width);
+    detail::batch_for_each(
+        query, targets, a, x, o, e, pool,
+        [&](std::size_t b, const std::size_t *ids, const int *s, int count) {
+            std::vector<batch_hit> &heap = heaps[b];
+            for (int t = 0; t < count && k > 0; t++) {
+                const batch_hit hit = {s[t], ids[t]};
+                if (heap.size() < k) {
+                    heap.push_back(hit);
+                    std::push_heap(heap.begin(), heap.end(), detail::batch_hit_better);
+                } else if (detail::batch_hit_better(hit, heap.front())) {
+                    std::pop_heap(heap.begin(), heap.end(), detail::batch_hit_better);
+                    heap.back() = hit;
+                    std::push_heap(heap.begin(), heap.end(), detail::batch_hit_better);
+                }
+            }
+        });
+    std::vector<batch_hit> hits;
+    for (const std::vector<batch_hit> &heap : heaps) {
+        hits.insert(hits.end(), heap.begin(), heap.end());
+    }
+    const std::size_t keep = std::min(k, hits.size());
+    std::partial_sort(hits.begin(), hits.begin() + keep, hits.end(), detail::batch_hit_better);
+    hits.resize(keep);
+    return hits;
+}
+
+}  // namespace alignment
+
+}  // namespace toolbox
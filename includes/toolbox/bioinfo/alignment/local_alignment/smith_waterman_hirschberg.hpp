@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "toolbox/bioinfo/alignment/global_alignment/hirschberg.hpp"
+
+namespace toolbox {
+
+namespace alignment {
+
+/**
+ * @brief Smith-Waterman algorithm with a linear-space traceback.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment (score, coordinates and CIGAR).
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param g The gap penalty.
+ * @param cutoff Subproblems with at most this many DP cells are solved with a full table.
+ * @return The best local alignment score.
+ * @note max-score alignment with the same score and end cell as smith_waterman_all.
+ * @note Three passes, each keeping a single row: a forward Smith-Waterman pass finds the best
+ * score and its end cell, a reverse pass anchored at that cell finds a start cell reaching the
+ * same score, and the two substrings in between are aligned globally with Hirschberg's algorithm
+ * (costs -a / x / g, whose minimum is exactly -score).
+ * @note O(nm) time complexity and O(m + n + cutoff) space complexity.
+ */
+int smith_waterman_hirschberg(const std::string &s1, const std::string &s2, alignment_result &res,
+                              int a = 1, int x = 1, int g = 1, std::size_t cutoff = 1 << 16) {
+    const int m = static_cast<int>(s1.size());
+    const int n = static_cast<int>(s2.size());
+    std::vector<int> row(n + 1, 0);
+    int best = 0;
+    int bi = 0;
+    int bj = 0;
+    for (int i = 1; i <= m; i++) {
+        int diag = 0;
+        for (int j = 1; j <= n; j++) {
+            const int up = row[j];
+            row[j] =
+                std::max({0, diag + (s1[i - 1] == s2[j - 1] ? a : -x), up - g, row[j - 1] - g});
+            diag = up;
+            if (row[j] > best) {
+                best = row[j];
+                bi = i;
+                bj = j;
+            }
+        }
+    }
+    res.ops.clear();
+    if (best == 0) {
+        detail::finish_result(res, best, 0, 0);
+        return best;
+    }
+    // Walk back from (bi, bj) without the 0 floor until some cell reaches the best score.
+    int si = bi;
+    int sj = bj;
+    row.assign(bj + 1, 0);
+    for (int j = 1; j <= bj; j++) {
+        row[j] = -j * g;
+    }
+    for (int i = 1; i <= bi && si == bi; i++) {
+        int diag = row[0];
+        row[0] = -i * g;
+        for (int j = 1; j <= bj; j++) {
+            const int up = row[j];
+            row[j] =
+                std::max({diag + (s1[bi - i] == s2[bj - j] ? a : -x), up - g, row[j - 1] - g});
+            diag = up;
+            if (row[j] == best) {
+                si = bi - i;
+                sj = bj - j;
+                break;
+            }
+        }
+    }
+    detail::nw_hirschberg(s1.data() + si, bi - si, s2.data() + sj, bj - sj, -a, x, g, cutoff,
+                          res.ops);
+    detail::finish_result(res, best, si, sj);
+    return best;
+}
+
+/**
+ * @brief Smith-Waterman algorithm with a linear-space traceback.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param s1_aligned The first aligned string.
+ * @param s2_aligned The second aligned string.
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param g The gap penalty.
+ * @param cutoff Subproblems with at most this many DP cells are solved with a full table.
+ * @return The best local alignment score.
+ * @note Same alignment as the alignment_result overload, expanded to gapped strings.
+ */
+int smith_waterman_hirschberg(const std::string &s1, const std::string &s2,
+                              std::string &s1_aligned, std::string &s2_aligned, int a = 1,
+                              int x = 1, int g = 1, std::size_t cutoff = 1 << 16) {
+    alignment_result res;
+    smith_waterman_hirschberg(s1, s2, res, a, x, g, cutoff);
+    alignment_to_aligned(s1, s2, res, s1_aligned, s2_aligned);
+    return res.score;
+}
+
+}  // namespace alignment
+
+}  // namespace toolbox
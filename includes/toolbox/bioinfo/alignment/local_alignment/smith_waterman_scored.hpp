@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "toolbox/bioinfo/alignment/scoring.hpp"
+#include "toolbox/bioinfo/alignment/traceback.hpp"
+
+namespace toolbox {
+
+namespace alignment {
+
+/**
+ * @brief Smith-Waterman algorithm with affine gaps under a scoring policy.
+ * @param s1 The first sequence, encoded (see alphabet).
+ * @param s2 The second sequence, encoded with the same alphabet.
+ * @param scoring The scoring policy (match_mismatch_scoring, matrix_scoring or profile_scoring).
+ * @param res The best local alignment (score, coordinates and CIGAR).
+ * @param o The gap open penalty.
+ * @param e The gap extension penalty.
+ * @return The best local alignment score.
+ * @note max-score alignment. A gap of length k costs o + k * e, so o = 0, e = g with
+ * match_mismatch_scoring(a, x) gives smith_waterman_all(s1, s2, res, a, x, g).
+ * @note Scoring is a template parameter, so the substitution score is an inlined comparison or
+ * table lookup. The DP keeps rolling rows of H and D and 4 traceback bits per cell.
+ * @note [Complexity]: O(nm) time complexity and O(n) + nm/2 bytes of space.
+ */
+template <typename Scoring>
+int smith_waterman_scored(const encoded_sequence &s1, const encoded_sequence &s2,
+                          const Scoring &scoring, alignment_result &res, int o = 0, int e = 1) {
+    const int m = static_cast<int>(s1.size());
+    const int n = static_cast<int>(s2.size());
+    const int NEG = -(1 << 29);
+    const std::size_t width = n + 1;
+    detail::packed_traceback<4> tb((m + 1) * width);
+    std::vector<int> pH(n + 1, 0), cH(n + 1, 0), pD(n + 1, NEG), cD(n + 1, NEG);
+    int best = 0;
+    int bi = 0;
+    int bj = 0;
+    for (int i = 1; i <= m; i++) {
+        const std::size_t row = i * width;
+        cH[0] = 0;
+        int ins = NEG;
+        for (int j = 1; j <= n; j++) {
+            uint8_t from = 0;
+            int d = pH[j] - o - e;
+            if (pD[j] - e > d) {
+                d = pD[j] - e;
+                from |= detail::TB_D_EXTEND;
+            }
+            if (ins - e > cH[j - 1] - o - e) {
+                ins -= e;
+                from |= detail::TB_I_EXTEND;
+            } else {
+                ins = cH[j - 1] - o - e;
+            }
+            int h = pH[j - 1] + scoring.score(i - 1, s1[i - 1], s2[j - 1]);
+            uint8_t src = detail::TB_DIAG;
+            if (d > h) {
+                h = d;
+                src = detail::TB_UP;
+            }
+            if (ins > h) {
+                h = ins;
+                src = detail::TB_LEFT;
+            }
+            if (h <= 0) {
+                h = 0;
+                src = detail::TB_STOP;
+            }
+            cH[j] = h;
+            cD[j] = d;
+            tb.set(row + j, from | src);
+            if (h > best) {
+                best = h;
+                bi = i;
+                bj = j;
+            }
+        }
+        pH.swap(cH);
+        pD.swap(cD);
+    }
+    res.ops.clear();
+    int i = bi;
+    int j = bj;
+    uint8_t state = detail::TB_DIAG;
+    while (i > 0 && j > 0) {
+        const uint8_t t = tb.get(i * width + j);
+        if (state == detail::TB_DIAG) {
+            state = t & 3;
+            if (state == detail::TB_STOP) {
+                break;
+            }
+            if (state == detail::TB_DIAG) {
+                detail::cigar_push(res.ops, 'M');
+                i--;
+                j--;
+            }
+        } else if (state == detail::TB_UP) {
+            detail::cigar_push(res.ops, 'D');
+            i--;
+            state = (t & detail::TB_D_EXTEND) ? detail::TB_UP : detail::TB_DIAG;
+        } else {
+            detail::cigar_push(res.ops, 'I');
+            j--;
+            state = (t & detail::TB_I_EXTEND) ? detail::TB_LEFT : detail::TB_DIAG;
+        }
+    }
+    detail::cigar_finish(res.ops);
+    detail::finish_result(res, best, i, j);
+    return best;
+}
+
+}  // namespace alignment
+
+}  // namespace toolbox
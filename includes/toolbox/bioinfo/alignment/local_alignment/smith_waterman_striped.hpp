@@ -0,0 +1,407 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "toolbox/bioinfo/alignment/scoring.hpp"
+
+namespace toolbox {
+
+namespace alignment {
+
+namespace detail {
+
+/**
+ * @brief Scalar affine-gap Smith-Waterman score in O(n) space.
+ * @note Reference kernel for the SIMD implementations, used by smith_waterman_batch when no SIMD
+ * instruction set is available, when the 16-bit lanes would overflow, or when e <= 0.
+ */
+inline int smith_waterman_affine_score(const std::string &s1, const std::string &s2, int a, int x,
+                                       int o, int e) {
+    const int m = static_cast<int>(s1.size());
+    const int n = static_cast<int>(s2.size());
+    const int NEG = -(1 << 29);
+    std::vector<int> H(m + 1, 0), E(m + 1, NEG);
+    int best = 0;
+    for (int j = 1; j <= n; j++) {
+        int diag = 0;
+        int F = NEG;
+        H[0] = 0;
+        for (int i = 1; i <= m; i++) {
+            E[i] = std::max(E[i] - e, H[i] - o - e);
+            F = std::max(F - e, H[i - 1] - o - e);
+            const int h = std::max({0, diag + (s1[i - 1] == s2[j - 1] ? a : -x), E[i], F});
+            diag = H[i];
+            H[i] = h;
+            best = std::max(best, h);
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Scalar affine-gap Smith-Waterman score of a query profile against a target.
+ * @note Fallback of smith_waterman_profile, used when no SIMD instruction set is available, when
+ * the 16-bit lanes would overflow, or when e <= 0 (the lazy-F loop relies on gaps getting
+ * strictly worse as they grow). row_of maps a target character to its profile code.
+ */
+template <typename Seq, typename Row>
+int smith_waterman_profile_score(const profile_scoring &profile, const Seq &target, Row row_of,
+                                 int o, int e) {
+    const int m = static_cast<int>(profile.length());
+    const int NEG = -(1 << 29);
+    std::vector<int> H(m + 1, 0), E(m + 1, NEG);
+    int best = 0;
+    for (std::size_t j = 0; j < target.size(); j++) {
+        const uint8_t c = static_cast<uint8_t>(row_of(target[j]));
+        int diag = 0;
+        int F = NEG;
+        H[0] = 0;
+        for (int i = 1; i <= m; i++) {
+            E[i] = std::max(E[i] - e, H[i] - o - e);
+            F = std::max(F - e, H[i - 1] - o - e);
+            const int h = std::max({0, diag + profile.score(i - 1, 0, c), E[i], F});
+            diag = H[i];
+            H[i] = h;
+            best = std::max(best, h);
+        }
+    }
+    return best;
+}
+
+#if defined(__AVX2__)
+
+// 32 unsigned 8-bit lanes. Scores are stored with a bias so that the unsigned saturation at 0
+// doubles as the local-alignment floor.
+struct striped_u8 {
+    typedef __m256i vec;
+    typedef uint8_t elem;
+    static const int lanes = 32;
+    static const int limit = 255;
+    static vec zero() { return _mm256_setzero_si256(); }
+    static vec set1(int v) { return _mm256_set1_epi8(static_cast<char>(v)); }
+    static vec load(const elem *p) { return _mm256_loadu_si256(reinterpret_cast<const vec *>(p)); }
+    static void store(elem *p, vec v) { _mm256_storeu_si256(reinterpret_cast<vec *>(p), v); }
+    static vec subs(vec a, vec b) { return _mm256_subs_epu8(a, b); }
+    static vec max(vec a, vec b) { return _mm256_max_epu8(a, b); }
+    static vec add_score(vec h, vec p, vec bias) {
+        return _mm256_subs_epu8(_mm256_adds_epu8(h, p), bias);
+    }
+    static vec shift(vec a) {
+        return _mm256_alignr_epi8(a, _mm256_permute2x128_si256(a, a, 0x08), 15);
+    }
+    static bool any_gt(vec a, vec b) {
+        return _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_subs_epu8(a, b), zero())) != -1;
+    }
+};
+
+// 16 16-bit lanes, used when the 8-bit lanes saturate. Gaps are subtracted with unsigned
+// saturation as well, so that every lane stays in [0, 32767] and E and F never go negative.
+struct striped_i16 {
+    typedef __m256i vec;
+    typedef int16_t elem;
+    static const int lanes = 16;
+    static const int limit = 32767;
+    static vec zero() { return _mm256_setzero_si256(); }
+    static vec set1(int v) { return _mm256_set1_epi16(static_cast<int16_t>(v)); }
+    static vec load(const elem *p) { return _mm256_loadu_si256(reinterpret_cast<const vec *>(p)); }
+    static void store(elem *p, vec v) { _mm256_storeu_si256(reinterpret_cast<vec *>(p), v); }
+    static vec subs(vec a, vec b) { return _mm256_subs_epu16(a, b); }
+    static vec max(vec a, vec b) { return _mm256_max_epi16(a, b); }
+    static vec add_score(vec h, vec p, vec) {
+        return _mm256_max_epi16(_mm256_adds_epi16(h, p), zero());
+    }
+    static vec shift(vec a) {
+        return _mm256_alignr_epi8(a, _mm256_permute2x128_si256(a, a, 0x08), 14);
+    }
+    static bool any_gt(vec a, vec b) { return _mm256_movemask_epi8(_mm256_cmpgt_epi16(a, b)) != 0; }
+};
+
+#elif defined(__SSE2__)
+
+// 16 unsigned 8-bit lanes. Scores are stored with a bias so that the unsigned saturation at 0
+// doubles as the local-alignment floor.
+struct striped_u8 {
+    typedef __m128i vec;
+    typedef uint8_t elem;
+    static const int lanes = 16;
+    static const int limit = 255;
+    static vec zero() { return _mm_setzero_si128(); }
+    static vec set1(int v) { return _mm_set1_epi8(static_cast<char>(v)); }
+    static vec load(const elem *p) { return _mm_loadu_si128(reinterpret_cast<const vec *>(p)); }
+    static void store(elem *p, vec v) { _mm_storeu_si128(reinterpret_cast<vec *>(p), v); }
+    static vec subs(vec a, vec b) { return _mm_subs_epu8(a, b); }
+    static vec max(vec a, vec b) { return _mm_max_epu8(a, b); }
+    static vec add_score(vec h, vec p, vec bias) {
+        return _mm_subs_epu8(_mm_adds_epu8(h, p), bias);
+    }
+    static vec shift(vec a) { return _mm_slli_si128(a, 1); }
+    static bool any_gt(vec a, vec b) {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_subs_epu8(a, b), zero())) != 0xFFFF;
+    }
+};
+
+// 8 16-bit lanes, used when the 8-bit lanes saturate. Gaps are subtracted with unsigned
+// saturation as well, so that every lane stays in [0, 32767] and E and F never go negative.
+struct striped_i16 {
+    typedef __m128i vec;
+    typedef int16_t elem;
+    static const int lanes = 8;
+    static const int limit = 32767;
+    static vec zero() { return _mm_setzero_si128(); }
+    static vec set1(int v) { return _mm_set1_epi16(static_cast<int16_t>(v)); }
+    static vec load(const elem *p) { return _mm_loadu_si128(reinterpret_cast<const vec *>(p)); }
+    static void store(elem *p, vec v) { _mm_storeu_si128(reinterpret_cast<vec *>(p), v); }
+    static vec subs(vec a, vec b) { return _mm_subs_epu16(a, b); }
+    static vec max(vec a, vec b) { return _mm_max_epi16(a, b); }
+    static vec add_score(vec h, vec p, vec) { return _mm_max_epi16(_mm_adds_epi16(h, p), zero()); }
+    static vec shift(vec a) { return _mm_slli_si128(a, 2); }
+    static bool any_gt(vec a, vec b) { return _mm_movemask_epi8(_mm_cmpgt_epi16(a, b)) != 0; }
+};
+
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+
+/**
+ * @brief Striped query profile for one lane width.
+ * @note Query position l * seg_len + t lives in lane l of vector t, so that the vertical
+ * dependency between consecutive positions becomes a dependency between consecutive vectors.
+ * rows[r] holds seg_len vectors of scores (plus bias) for every target character mapped to r.
+ */
+template <typename V>
+struct striped_profile {
+    int seg_len;
+    int bias;
+    std::vector<std::vector<typename V::elem>> rows;
+
+    striped_profile() : seg_len(0), bias(0) {}
+
+    template <typename Score>
+    void build(int m, int num_rows, int score_bias, Score score) {
+        seg_len = (m + V::lanes - 1) / V::lanes;
+        bias = score_bias;
+        rows.assign(num_rows, std::vector<typename V::elem>(seg_len * V::lanes));
+        for (int r = 0; r < num_rows; r++) {
+            for (int t = 0; t < seg_len; t++) {
+                for (int l = 0; l < V::lanes; l++) {
+                    const int q = l * seg_len + t;
+                    const int s = (q < m ? score(q, r) : 0) + bias;
+                    rows[r][t * V::lanes + l] = static_cast<typename V::elem>(s);
+                }
+            }
+        }
+    }
+};
+
+/**
+ * @brief Farrar's striped Smith-Waterman with affine gaps, score only.
+ * @param overflow Set when the best score does not fit in the lanes and must be recomputed.
+ * @note The inner loop ignores the vertical (F) dependency; the lazy-F loop afterwards
+ * propagates it across segment boundaries, and usually stops after a segment or two.
+ */
+template <typename V, typename Seq, typename Row>
+int striped_kernel(const striped_profile<V> &profile, const Seq &target, Row row_of, int o, int e,
+                   bool &overflow) {
+    typedef typename V::vec vec;
+    const int seg_len = profile.seg_len;
+    overflow = false;
+    if (seg_len == 0) {
+        return 0;
+    }
+    const vec gap_o = V::set1(o + e);
+    const vec gap_e = V::set1(e);
+    const vec bias = V::set1(profile.bias);
+    // Vectors are kept as raw lanes: std::vector<__m128i> would drop the alignment attribute.
+    typedef typename V::elem elem;
+    const int L = V::lanes;
+    std::vector<elem> h_store(seg_len * L, 0), h_load(seg_len * L, 0), E(seg_len * L, 0);
+    vec best = V::zero();
+    for (std::size_t j = 0; j < target.size(); j++) {
+        const elem *p = profile.rows[row_of(target[j])].data();
+        vec F = V::zero();
+        vec h = V::shift(V::load(h_store.data() + (seg_len - 1) * L));
+        h_store.swap(h_load);
+        elem *hs = h_store.data();
+        const elem *hl = h_load.data();
+        elem *pe = E.data();
+        for (int i = 0; i < seg_len; i++) {
+            vec e_i = V::load(pe + i * L);
+            h = V::add_score(h, V::load(p + i * L), bias);
+            h = V::max(h, e_i);
+            h = V::max(h, F);
+            best = V::max(best, h);
+            V::store(hs + i * L, h);
+            h = V::subs(h, gap_o);
+            V::store(pe + i * L, V::max(V::subs(e_i, gap_e), h));
+            F = V::max(V::subs(F, gap_e), h);
+            h = V::load(hl + i * L);
+        }
+        // Lazy-F loop: carry the vertical gaps across the segment boundary.
+        F = V::shift(F);
+        int i = 0;
+        while (V::any_gt(F, V::subs(V::load(hs + i * L), gap_o))) {
+            h = V::max(V::load(hs + i * L), F);
+            V::store(hs + i * L, h);
+            V::store(pe + i * L, V::max(V::load(pe + i * L), V::subs(h, gap_o)));
+            F = V::subs(F, gap_e);
+            if (++i == seg_len) {
+                i = 0;
+                F = V::shift(F);
+            }
+        }
+    }
+    elem lanes[V::lanes];
+    V::store(lanes, best);
+    const int score = *std::max_element(lanes, lanes + L);
+    overflow = score + profile.bias >= V::limit;
+    return score;
+}
+
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief Reusable striped query profile for Smith-Waterman database search.
+ * @note Builds the query profile once (8-bit and 16-bit lanes) so that aligning the same query
+ * against many targets only pays for the DP itself. Scoring and gaps are as in
+ * smith_waterman_striped.
+ */
+class smith_waterman_profile {
+ public:
+    smith_waterman_profile(const std::string &query, int a = 1, int x = 1, int o = 0, int e = 1)
+        : _profile(0, 0), _o(o), _e(e) {
+        std::string chars;
+        std::array<int, 256> seen;
+        seen.fill(-1);
+        for (char c : query) {
+            if (seen[static_cast<unsigned char>(c)] < 0) {
+                seen[static_cast<unsigned char>(c)] = static_cast<int>(chars.size());
+                chars += c;
+            }
+        }
+        // Row k = chars.size() stands for every character absent from the query.
+        const int k = static_cast<int>(chars.size());
+        for (int c = 0; c < 256; c++) {
+            _row[c] = static_cast<uint8_t>(seen[c] < 0 ? k : seen[c]);
+        }
+        _profile = profile_scoring(query.size(), std::min(k + 1, 256));
+        for (std::size_t q = 0; q < query.size(); q++) {
+            for (int r = 0; r < _profile.size(); r++) {
+                const int s = r < k && query[q] == chars[r] ? a : -x;
+                _profile.set(q, static_cast<uint8_t>(r), s);
+            }
+        }
+        build();
+    }
+
+    /**
+     * @brief Builds the profile of an encoded query under a scoring policy.
+     * @param query The query, encoded (see alphabet).
+     * @param size The alphabet size.
+     * @param scoring The scoring policy, e.g. blosum62().
+     * @param o The gap open penalty.
+     * @param e The gap extension penalty.
+     * @note Targets are then aligned with align(const encoded_sequence &).
+     */
+    template <typename Scoring>
+    smith_waterman_profile(const encoded_sequence &query, int size, const Scoring &scoring,
+                           int o = 0, int e = 1)
+        : _profile(query, size, scoring), _o(o), _e(e) {
+        for (int c = 0; c < 256; c++) {
+            _row[c] = static_cast<uint8_t>(c < size ? c : 0);
+        }
+        build();
+    }
+
+    /**
+     * @brief Best local alignment score of the query against a target.
+     * @param target The target string.
+     * @return The best local alignment score.
+     * @note Runs the 8-bit kernel first and falls back to 16-bit lanes, then to the scalar
+     * kernel, only when the score saturates.
+     */
+    int align(const std::string &target) const { return align_codes(target); }
+
+    /**
+     * @brief Best local alignment score of the query against an encoded target.
+     */
+    int align(const encoded_sequence &target) const { return align_codes(target); }
+
+ private:
+    void build() {
+        _bias = std::max(0, -_profile.min_score());
+        _range = _profile.max_score() + _bias;
+#if defined(__AVX2__) || defined(__SSE2__)
+        auto score = [this](int q, int r) {
+            return _profile.score(q, 0, static_cast<uint8_t>(r));
+        };
+        const int m = static_cast<int>(_profile.length());
+        _u8.build(m, _profile.size(), _bias, score);
+        _i16.build(m, _profile.size(), 0, score);
+#endif
+    }
+
+    template <typename Seq>
+    int align_codes(const Seq &target) const {
+        auto row_of = [this](char c) { return _row[static_cast<unsigned char>(c)]; };
+#if defined(__AVX2__) || defined(__SSE2__)
+        if (_e > 0 && _o >= 0) {
+            bool overflow = true;
+            int score = 0;
+            if (_range < 255 && _o + _e < 255) {
+                score = detail::striped_kernel(_u8, target, row_of, _o, _e, overflow);
+            }
+            if (overflow && _range < 32767 && _o + _e < 32767) {
+                score = detail::striped_kernel(_i16, target, row_of, _o, _e, overflow);
+            }
+            if (!overflow) {
+                return score;
+            }
+        }
+#endif
+        return detail::smith_waterman_profile_score(_profile, target, row_of, _o, _e);
+    }
+
+    profile_scoring _profile;
+    int _o, _e;
+    int _bias, _range;
+    std::array<uint8_t, 256> _row;
+#if defined(__AVX2__) || defined(__SSE2__)
+    detail::striped_profile<detail::striped_u8> _u8;
+    detail::striped_profile<detail::striped_i16> _i16;
+#endif
+};
+
+/**
+ * @brief Striped SIMD Smith-Waterman algorithm (Farrar), score only.
+ * @param s1 The first string (the query, laid out across SIMD lanes).
+ * @param s2 The second string (the target, streamed one character at a time).
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param o The gap open penalty.
+ * @param e The gap extension penalty.
+ * @return The best local alignment score.
+ * @note max-score alignment. A gap of length k costs o + k * e, so o = 0, e = g gives the same
+ * score as smith_waterman_dp with gap penalty g.
+ * @note No DP table is kept: only O(m) vectors for the current column. Scores are computed in
+ * saturating 8-bit lanes (16 per SSE2 / 32 per AVX2 register) and recomputed in 16-bit lanes
+ * only if they saturate.
+ * @note [Complexity]: O(nm / lanes) time complexity in practice and O(m) space complexity.
+ */
+int smith_waterman_striped(const std::string &s1, const std::string &s2, int a = 1, int x = 1,
+                           int o = 0, int e = 1) {
+    return smith_waterman_profile(s1, a, x, o, e).align(s2);
+}
+
+}  // namespace alignment
+
+}  // namespace toolbox
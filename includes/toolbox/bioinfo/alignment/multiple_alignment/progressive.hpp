@@ -0,0 +1,309 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "toolbox/bioinfo/alignment/global_alignment/myers_bitvector.hpp"
+#include "toolbox/bioinfo/alignment/global_alignment/nw_scored.hpp"
+#include "toolbox/bioinfo/alignment/scoring.hpp"
+#include "toolbox/bioinfo/alignment/traceback.hpp"
+#include "toolbox/parallel/thread_pool/thread_pool.hpp"
+
+namespace toolbox {
+
+namespace alignment {
+
+/**
+ * @brief A node of a guide tree.
+ * @note Leaves have left = right = -1 and height 0.
+ */
+struct guide_node {
+    int left;
+    int right;
+    double height;
+    int size;
+};
+
+/**
+ * @brief A rooted binary guide tree over n sequences.
+ * @note Nodes 0 .. n - 1 are the leaves (node k is sequence k) and nodes n .. 2n - 2 the merges
+ * in the order they were made, so children come before their parent and the root is the last
+ * node.
+ */
+typedef std::vector<guide_node> guide_tree;
+
+namespace detail {
+
+// Profile scores are averages over pairs of sequences; they are kept as integers in units of
+// 1 / PROFILE_SCALE so that the integer DP kernel can be reused.
+const int PROFILE_SCALE = 64;
+
+/**
+ * @brief The residues of each column of an alignment, as (code, count) pairs.
+ * @note Columns are usually dominated by one or two residues, so a sparse list makes a
+ * column-against-column score a few multiplications instead of a pass over the alphabet.
+ */
+struct column_residues {
+    std::vector<std::size_t> begin;  // column c is entries[begin[c] .. begin[c + 1])
+    std::vector<std::pair<uint8_t, int>> entries;
+};
+
+inline column_residues count_residues(const std::vector<std::string> &rows,
+                                      const alphabet &abc) {
+    const std::size_t columns = rows.empty() ? 0 : rows[0].size();
+    column_residues res;
+    std::vector<int> count(abc.size(), 0);
+    res.begin.push_back(0);
+    for (std::size_t c = 0; c < columns; c++) {
+        for (const std::string &row : rows) {
+            if (row[c] != '-') {
+                count[abc.encode(row[c])]++;
+            }
+        }
+        for (int x = 0; x < abc.size(); x++) {
+            if (count[x] != 0) {
+                res.entries.push_back(std::make_pair(static_cast<uint8_t>(x), count[x]));
+                count[x] = 0;
+            }
+        }
+        res.begin.push_back(res.entries.size());
+    }
+    return res;
+}
+
+/**
+ * @brief The rows of a and b merged along the CIGAR of a profile_align of a against b.
+ */
+inline std::vector<std::string> merge_alignments(const std::vector<std::string> &a,
+                                                 const std::vector<std::string> &b,
+                                                 const cigar &ops) {
+    std::vector<std::string> rows(a.size() + b.size());
+    for (std::size_t r = 0; r < rows.size(); r++) {
+        const bool from_a = r < a.size();
+        const std::string &src = from_a ? a[r] : b[r - a.size()];
+        std::string &dst = rows[r];
+        std::size_t pos = 0;
+        for (const cigar_op &c : ops) {
+            const std::size_t len = c.len;
+            // 'D' columns come from a only, 'I' columns from b only.
+            if (c.op == 'M' || (c.op == 'D') == from_a) {
+                dst.append(src, pos, len);
+                pos += len;
+            } else {
+                dst.append(len, '-');
+            }
+        }
+    }
+    return rows;
+}
+
+}  // namespace detail
+
+/**
+ * @brief All-pairs distances of a set of sequences.
+ * @param seqs The sequences.
+ * @param pool The threads the rows of the matrix are shared between.
+ * @return d[i][j] = edit distance / max(|seqs[i]|, |seqs[j]|), in [0, 1].
+ * @note The edit distances are computed by myers_bitvector_dp, in time O(ceil(L / 64) L) per pair
+ * whatever the distance, so divergent sequences cost no more than close ones. Rows are handed
+ * out to the pool one at a time.
+ * @note [Complexity]: O(n^2 ceil(L / 64) L) time complexity and O(n^2) space complexity, for n
+ * sequences of length about L.
+ */
+std::vector<std::vector<double>> pairwise_distances(
+    const std::vector<std::string> &seqs,
+    parallel::thread_pool &pool = parallel::default_thread_pool()) {
+    const std::size_t n = seqs.size();
+    std::vector<std::vector<double>> d(n, std::vector<double>(n, 0.0));
+    pool.parallel_for(0, n, [&](std::size_t i) {
+        for (std::size_t j = i + 1; j < n; j++) {
+            const std::size_t len = std::max(seqs[i].size(), seqs[j].size());
+            const double dist =
+                len == 0 ? 0.0 : static_cast<double>(myers_bitvector_dp(seqs[i], seqs[j])) / len;
+            d[i][j] = dist;
+            d[j][i] = dist;
+        }
+    });
+    return d;
+}
+
+/**
+ * @brief UPGMA (average linkage) guide tree of a distance matrix.
+ * @param dist A symmetric distance matrix.
+ * @return The guide tree; a merge at distance d has height d / 2.
+ * @note Nearest-neighbour chain: follow nearest neighbours until two clusters are each other's
+ * nearest neighbour and merge them; average linkage is reducible, so the chain stays valid after
+ * a merge and the tree is the one of the classic O(n^3) UPGMA (up to ties). Distances to a merged
+ * cluster are the size-weighted average (Lance-Williams) and reuse the row of one of its halves.
+ * @note [Complexity]: O(n^2) time complexity and O(n^2) space complexity.
+ */
+guide_tree upgma_tree(const std::vector<std::vector<double>> &dist) {
+    const int n = static_cast<int>(dist.size());
+    guide_tree tree(n, guide_node{-1, -1, 0.0, 1});
+    std::vector<std::vector<double>> d = dist;
+    std::vector<int> node(n), size(n, 1);
+    std::vector<bool> alive(n, true);
+    for (int k = 0; k < n; k++) {
+        node[k] = k;
+    }
+    std::vector<int> chain;
+    for (int merges = 0; merges + 1 < n; merges++) {
+        if (chain.empty()) {
+            chain.push_back(static_cast<int>(std::find(alive.begin(), alive.end(), true) -
+                                             alive.begin()));
+        }
+        int a, b;
+        while (true) {
+            a = chain.back();
+            // Prefer the previous link on ties, so that the chain cannot cycle.
+            b = chain.size() >= 2 ? chain[chain.size() - 2] : -1;
+            for (int c = 0; c < n; c++) {
+                if (alive[c] && c != a && (b < 0 || d[a][c] < d[a][b])) {
+                    b = c;
+                }
+            }
+            if (chain.size() >= 2 && b == chain[chain.size() - 2]) {
+                break;
+            }
+            chain.push_back(b);
+        }
+        chain.pop_back();
+        chain.pop_back();
+        tree.push_back(guide_node{node[a], node[b], d[a][b] / 2, size[a] + size[b]});
+        for (int c = 0; c < n; c++) {
+            if (alive[c] && c != a && c != b) {
+                d[a][c] = d[c][a] = (size[a] * d[a][c] + size[b] * d[b][c]) / (size[a] + size[b]);
+            }
+        }
+        alive[b] = false;
+        node[a] = static_cast<int>(tree.size()) - 1;
+        size[a] += size[b];
+    }
+    return tree;
+}
+
+/**
+ * @brief Global alignment of two alignments (profiles) with affine gaps.
+ * @param a The rows of the first alignment (equal lengths, gaps as '-').
+ * @param b The rows of the second alignment.
+ * @param abc The alphabet the residues are encoded with.
+ * @param scoring The scoring policy over abc (match_mismatch_scoring or matrix_scoring; the
+ * position argument is not used).
+ * @param res The alignment of the columns of a (s1) with the columns of b (s2).
+ * @param o The gap open penalty.
+ * @param e The gap extension penalty.
+ * @return The best score in units of 1/64.
+ * @note max-score alignment. Two columns score the average of scoring over the pairs of residues
+ * of a and b (pairs with a gap score 0), and a gap of k columns costs o + k * e. With one row on
+ * each side this is needleman_wunsch_scored. The DP is the kernel of needleman_wunsch_scored;
+ * for each cell the residues of the column of a are looked up in a per-column table of b.
+ * @note [Complexity]: O(m n r) time complexity with r distinct residues per column, and
+ * O(n sigma) + nm/2 bytes of space.
+ */
+template <typename Scoring>
+int profile_align(const std::vector<std::string> &a, const std::vector<std::string> &b,
+                  const alphabet &abc, const Scoring &scoring, alignment_result &res, int o = 0,
+                  int e = 1) {
+    const int m = a.empty() ? 0 : static_cast<int>(a[0].size());
+    const int n = b.empty() ? 0 : static_cast<int>(b[0].size());
+    const int sigma = abc.size();
+    const detail::column_residues ra = detail::count_residues(a, abc);
+    const detail::column_residues rb = detail::count_residues(b, abc);
+    // w[j * sigma + x]: the total score of residue x against column j of b.
+    std::vector<long long> w(static_cast<std::size_t>(n) * sigma, 0);
+    for (int j = 0; j < n; j++) {
+        for (std::size_t t = rb.begin[j]; t < rb.begin[j + 1]; t++) {
+            for (int x = 0; x < sigma; x++) {
+                w[j * sigma + x] += static_cast<long long>(rb.entries[t].second) *
+                                    scoring.score(0, static_cast<uint8_t>(x), rb.entries[t].first);
+            }
+        }
+    }
+    const double factor =
+        static_cast<double>(detail::PROFILE_SCALE) / (static_cast<double>(a.size()) * b.size());
+    return detail::nwg_kernel(
+        m, n,
+        [&](int i, int j) {
+            long long sum = 0;
+            const long long *wj = w.data() + static_cast<std::size_t>(j) * sigma;
+            for (std::size_t t = ra.begin[i]; t < ra.begin[i + 1]; t++) {
+                sum += ra.entries[t].second * wj[ra.entries[t].first];
+            }
+            return static_cast<int>(std::lround(sum * factor));
+        },
+        res, o * detail::PROFILE_SCALE, e * detail::PROFILE_SCALE);
+}
+
+namespace detail {
+
+/**
+ * @brief Aligns the sequences below node of tree; rows are returned in the order of members.
+ * @note The two subtrees are independent and are aligned in parallel (parallel_for may nest).
+ */
+template <typename Scoring>
+std::vector<std::string> align_subtree(const std::vector<std::string> &seqs,
+                                       const guide_tree &tree, int node, const alphabet &abc,
+                                       const Scoring &scoring, int o, int e,
+                                       parallel::thread_pool &pool, std::vector<int> &members) {
+    const guide_node &v = tree[node];
+    if (v.left < 0) {
+        members.assign(1, node);
+        return std::vector<std::string>(1, seqs[node]);
+    }
+    std::vector<std::string> rows[2];
+    std::vector<int> sub[2];
+    const int child[2] = {v.left, v.right};
+    pool.parallel_for(0, 2, [&](std::size_t c) {
+        rows[c] = align_subtree(seqs, tree, child[c], abc, scoring, o, e, pool, sub[c]);
+    });
+    alignment_result res;
+    profile_align(rows[0], rows[1], abc, scoring, res, o, e);
+    members = sub[0];
+    members.insert(members.end(), sub[1].begin(), sub[1].end());
+    return merge_alignments(rows[0], rows[1], res.ops);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Progressive multiple sequence alignment.
+ * @param seqs The sequences (without '-').
+ * @param abc The alphabet of the sequences.
+ * @param scoring The scoring policy over abc (match_mismatch_scoring or matrix_scoring).
+ * @param o The gap open penalty.
+ * @param e The gap extension penalty.
+ * @param pool The threads the distances and the independent subtrees are shared between.
+ * @return The aligned rows, in the order of seqs, all of the same length ('-' for gaps).
+ * @note pairwise_distances (edit distances by myers_bitvector_dp), upgma_tree, then profile_align
+ * from the leaves up: each internal node aligns the alignments of its two subtrees. Gaps, once
+ * inserted, are never removed ("once a gap, always a gap"). The result does not depend on the
+ * number of threads.
+ * @note [Complexity]: O(n^2) pairwise distances and n - 1 profile alignments of O(L^2 r) each,
+ * for n sequences of length about L.
+ */
+template <typename Scoring>
+std::vector<std::string> progressive_align(
+    const std::vector<std::string> &seqs, const alphabet &abc, const Scoring &scoring,
+    int o = 0, int e = 1, parallel::thread_pool &pool = parallel::default_thread_pool()) {
+    if (seqs.empty()) {
+        return std::vector<std::string>();
+    }
+    const guide_tree tree = upgma_tree(pairwise_distances(seqs, pool));
+    std::vector<int> members;
+    std::vector<std::string> rows = detail::align_subtree(
+        seqs, tree, static_cast<int>(tree.size()) - 1, abc, scoring, o, e, pool, members);
+    std::vector<std::string> aligned(seqs.size());
+    for (std::size_t r = 0; r < rows.size(); r++) {
+        aligned[members[r]].swap(rows[r]);
+    }
+    return aligned;
+}
+
+}  // namespace alignment
+
+}  // namespace toolbox
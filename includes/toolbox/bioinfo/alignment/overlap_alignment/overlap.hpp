@@ -1,9 +1,15 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <vector>
 
+#include "toolbox/bioinfo/alignment/tiled_dp.hpp"
+#include "toolbox/bioinfo/alignment/traceback.hpp"
+
 namespace toolbox {
 
 namespace alignment {
@@ -83,24 +89,114 @@ void overlap_traceback(const std::string &s1, const std::string &s2,
     }
     int i = m;
     int j = j_star;
-    s1_aligned = "";
-    s2_aligned = "";
+    std::string r1, r2;
     while (j > 0) {
         if (i > 0 && dp[i][j] == dp[i - 1][j - 1] + (s1[i - 1] == s2[j - 1] ? a : -x)) {
-            s1_aligned = s1[i - 1] + s1_aligned;
-            s2_aligned = s2[j - 1] + s2_aligned;
+            detail::tb_emit(r1, r2, s1[--i], s2[--j]);
+        } else if (i > 0 && dp[i][j] == dp[i - 1][j] - g) {
+            detail::tb_emit(r1, r2, s1[--i], '-');
+        } else {
+            detail::tb_emit(r1, r2, '-', s2[--j]);
+        }
+    }
+    detail::tb_finish(r1, r2, s1_aligned, s2_aligned);
+}
+
+/**
+ * @brief Overlap alignment returning the alignment as a CIGAR.
+ * @param s1 The first string (a suffix of it forms one side of the alignment).
+ * @param s2 The second string (a prefix of it forms the other side of the alignment).
+ * @param ops The CIGAR of the alignment (s1 plays the reference).
+ * @param begin1 The position in s1 the suffix starts at (the prefix of s2 always starts at 0).
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param g The gap penalty.
+ * @return The best overlap alignment score.
+ * @note max-score alignment with the same recurrences as overlap_dp. The move of every cell is
+ * recorded in a 2-bit packed traceback during the fill, so the scores only need two rolling
+ * rows. Ties are broken as in overlap_traceback.
+ * @note [Complexity]: O(nm) time complexity, O(n) space for the scores and nm / 4 bytes for the
+ * traceback. The walk back is O(m + n).
+ */
+int overlap_cigar(const std::string &s1, const std::string &s2, cigar &ops, std::size_t &begin1,
+                  int a = 1, int x = 1, int g = 1) {
+    const int m = static_cast<int>(s1.size());
+    const int n = static_cast<int>(s2.size());
+    const std::size_t width = n + 1;
+    detail::packed_traceback<2> tb((m + 1) * width);
+    std::vector<int> prev(n + 1), cur(n + 1);
+    for (int j = 0; j <= n; j++) {
+        cur[j] = -j * g;
+        tb.set(j, detail::TB_LEFT);
+    }
+    for (int i = 1; i <= m; i++) {
+        prev.swap(cur);
+        cur[0] = 0;
+        tb.set(i * width, detail::TB_STOP);
+        for (int j = 1; j <= n; j++) {
+            int h = prev[j - 1] + (s1[i - 1] == s2[j - 1] ? a : -x);
+            uint8_t from = detail::TB_DIAG;
+            if (prev[j] - g > h) {
+                h = prev[j] - g;
+                from = detail::TB_UP;
+            }
+            if (cur[j - 1] - g > h) {
+                h = cur[j - 1] - g;
+                from = detail::TB_LEFT;
+            }
+            cur[j] = h;
+            tb.set(i * width + j, from);
+        }
+    }
+    int j_star = 0;
+    int best = cur[0];
+    for (int j = 1; j <= n; j++) {
+        if (cur[j] > best) {
+            best = cur[j];
+            j_star = j;
+        }
+    }
+    ops.clear();
+    int i = m;
+    int j = j_star;
+    while (j > 0) {
+        const uint8_t from = tb.get(i * width + j);
+        if (from == detail::TB_DIAG) {
+            detail::cigar_push(ops, 'M');
             i--;
             j--;
-        } else if (i > 0 && dp[i][j] == dp[i - 1][j] - g) {
-            s1_aligned = s1[i - 1] + s1_aligned;
-            s2_aligned = "-" + s2_aligned;
+        } else if (from == detail::TB_UP) {
+            detail::cigar_push(ops, 'D');
             i--;
         } else {
-            s1_aligned = "-" + s1_aligned;
-            s2_aligned = s2[j - 1] + s2_aligned;
+            detail::cigar_push(ops, 'I');
             j--;
         }
     }
+    detail::cigar_finish(ops);
+    begin1 = i;
+    return best;
+}
+
+/**
+ * @brief Overlap alignment: the best-scoring global alignment between some suffix of s1 and
+ * some prefix of s2.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment (score, coordinates and CIGAR).
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param g The gap penalty.
+ * @return The best overlap alignment score.
+ * @note max-score alignment, computed by overlap_cigar.
+ * @note [Complexity]: O(nm) time complexity and O(n) + nm / 4 bytes space complexity.
+ */
+int overlap_all(const std::string &s1, const std::string &s2, alignment_result &res, int a = 1,
+                int x = 1, int g = 1) {
+    std::size_t begin1 = 0;
+    const int score = overlap_cigar(s1, s2, res.ops, begin1, a, x, g);
+    detail::finish_result(res, score, begin1, 0);
+    return score;
 }
 
 /**
@@ -114,15 +210,57 @@ void overlap_traceback(const std::string &s1, const std::string &s2,
  * @param x The mismatch penalty.
  * @param g The gap penalty.
  * @return The best overlap alignment score.
- * @note max-score alignment.
- * @note [Complexity]: O(nm) time complexity and O(nm) space complexity.
+ * @note Same alignment as the alignment_result overload, expanded to gapped strings.
  */
 int overlap_all(const std::string &s1, const std::string &s2, std::string &s1_aligned,
                 std::string &s2_aligned, int a = 1, int x = 1, int g = 1) {
-    std::vector<std::vector<int>> dp;
-    int score = overlap_dp(s1, s2, dp, a, x, g);
-    overlap_traceback(s1, s2, dp, s1_aligned, s2_aligned, a, x, g);
-    return score;
+    alignment_result res;
+    overlap_all(s1, s2, res, a, x, g);
+    alignment_to_aligned(s1, s2, res, s1_aligned, s2_aligned);
+    return res.score;
+}
+
+namespace detail {
+
+/**
+ * @brief Cell-update policy of overlap_dp for tiled_dp.
+ */
+struct overlap_cells {
+    typedef int cell;
+    const std::string &s1;
+    const std::string &s2;
+    int a, x, g;
+
+    int boundary_row(int j) const { return -j * g; }
+    int boundary_col(int) const { return 0; }
+    int update(int i, int j, int diag, int up, int left) const {
+        return std::max({diag + (s1[i - 1] == s2[j - 1] ? a : -x), up - g, left - g});
+    }
+    int value(int c, int i, int) const {
+        return i == static_cast<int>(s1.size()) ? c : std::numeric_limits<int>::min();
+    }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Overlap alignment, score only, on several threads.
+ * @param s1 The first string (a suffix of it forms one side of the alignment).
+ * @param s2 The second string (a prefix of it forms the other side of the alignment).
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param g The gap penalty.
+ * @param tile The side of a tile of the DP table, in cells.
+ * @param pool The thread pool.
+ * @return The same score as overlap_dp.
+ * @note The table is filled by tiled_dp: the tiles of an anti-diagonal run in parallel, and only
+ * the tile boundaries are kept.
+ * @note [Complexity]: O(nm / p) time complexity with p threads and O(m + n) space complexity.
+ */
+int overlap_tiled(const std::string &s1, const std::string &s2, int a = 1, int x = 1, int g = 1,
+                  int tile = 256, parallel::thread_pool &pool = parallel::default_thread_pool()) {
+    const detail::overlap_cells policy{s1, s2, a, x, g};
+    return tiled_dp(policy, static_cast<int>(s1.size()), static_cast<int>(s2.size()), tile, pool);
 }
 
 }  // namespace alignment
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "toolbox/bioinfo/alignment/global_alignment/hirschberg.hpp"
+
+namespace toolbox {
+
+namespace alignment {
+
+/**
+ * @brief Overlap alignment with a linear-space traceback.
+ * @param s1 The first string (a suffix of it forms one side of the alignment).
+ * @param s2 The second string (a prefix of it forms the other side of the alignment).
+ * @param res The alignment (score, coordinates and CIGAR).
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param g The gap penalty.
+ * @param cutoff Subproblems with at most this many DP cells are solved with a full table.
+ * @return The best overlap alignment score.
+ * @note max-score alignment with the same score and end column as overlap_all.
+ * @note A forward pass keeps one row to find the best column j* of the last row, a reverse pass
+ * anchored at (m, j*) finds the row where s1's suffix starts, and the suffix / prefix pair is
+ * aligned globally with Hirschberg's algorithm (costs -a / x / g).
+ * @note O(nm) time complexity and O(m + n + cutoff) space complexity.
+ */
+int overlap_hirschberg(const std::string &s1, const std::string &s2, alignment_result &res,
+                       int a = 1, int x = 1, int g = 1, std::size_t cutoff = 1 << 16) {
+    const int m = static_cast<int>(s1.size());
+    const int n = static_cast<int>(s2.size());
+    // Sized from a non-negative n, so that the compiler sees row[0] exists.
+    std::vector<int> row(static_cast<std::size_t>(std::max(n, 0)) + 1);
+    for (int j = 0; j <= n; j++) {
+        row[j] = -j * g;
+    }
+    for (int i = 1; i <= m; i++) {
+        int diag = row[0];
+        row[0] = 0;
+        for (int j = 1; j <= n; j++) {
+            const int up = row[j];
+            row[j] = std::max({diag + (s1[i - 1] == s2[j - 1] ? a : -x), up - g, row[j - 1] - g});
+            diag = up;
+        }
+    }
+    int j_star = 0;
+    for (int j = 1; j <= n; j++) {
+        if (row[j] > row[j_star]) {
+            j_star = j;
+        }
+    }
+    const int best = row[j_star];
+    res.ops.clear();
+    if (j_star == 0) {
+        detail::finish_result(res, best, m, 0);
+        return best;
+    }
+    // Walk back from (m, j*) until the full prefix s2[0..j*) is used with the best score.
+    int si = m;
+    row.resize(j_star + 1);
+    for (int j = 0; j <= j_star; j++) {
+        row[j] = -j * g;
+    }
+    for (int i = 1; i <= m; i++) {
+        int diag = row[0];
+        row[0] = -i * g;
+        for (int j = 1; j <= j_star; j++) {
+            const int up = row[j];
+            row[j] = std::max(
+                {diag + (s1[m - i] == s2[j_star - j] ? a : -x), up - g, row[j - 1] - g});
+            diag = up;
+        }
+        if (row[j_star] == best) {
+            si = m - i;
+            break;
+        }
+    }
+    detail::nw_hirschberg(s1.data() + si, m - si, s2.data(), j_star, -a, x, g, cutoff, res.ops);
+    detail::finish_result(res, best, si, 0);
+    return best;
+}
+
+/**
+ * @brief Overlap alignment with a linear-space traceback.
+ * @param s1 The first string (a suffix of it forms one side of the alignment).
+ * @param s2 The second string (a prefix of it forms the other side of the alignment).
+ * @param s1_aligned The first aligned string.
+ * @param s2_aligned The second aligned string.
+ * @param a The match score.
+ * @param x The mismatch penalty.
+ * @param g The gap penalty.
+ * @param cutoff Subproblems with at most this many DP cells are solved with a full table.
+ * @return The best overlap alignment score.
+ * @note Same alignment as the alignment_result overload, expanded to gapped strings.
+ */
+int overlap_hirschberg(const std::string &s1, const std::string &s2, std::string &s1_aligned,
+                       std::string &s2_aligned, int a = 1, int x = 1, int g = 1,
+                       std::size_t cutoff = 1 << 16) {
+    alignment_result res;
+    overlap_hirschberg(s1, s2, res, a, x, g, cutoff);
+    alignment_to_aligned(s1, s2, res, s1_aligned, s2_aligned);
+    return res.score;
+}
+
+}  // namespace alignment
+
+}  // namespace toolbox
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace toolbox {
+
+namespace alignment {
+
+/**
+ * @brief A sequence encoded with an alphabet: one small integer code per character.
+ */
+typedef std::vector<uint8_t> encoded_sequence;
+
+/**
+ * @brief Maps characters to the codes 0 .. size() - 1 used by the scoring policies.
+ * @note Lowercase letters get the code of their uppercase symbol, and characters outside the
+ * alphabet get the code of the wildcard. Sequences are encoded once, so that the DP inner loops
+ * index a table instead of comparing characters.
+ */
+class alphabet {
+ public:
+    /**
+     * @brief Constructs an alphabet.
+     * @param symbols The symbols; the k-th one gets code k.
+     * @param wildcard The symbol that characters outside the alphabet are mapped to.
+     */
+    alphabet(const std::string &symbols, char wildcard) : _symbols(symbols) {
+        assert(!symbols.empty() && symbols.size() <= 256);
+        assert(symbols.find(wildcard) != std::string::npos);
+        _code.fill(static_cast<uint8_t>(symbols.find(wildcard)));
+        for (std::size_t k = 0; k < symbols.size(); k++) {
+            _code[std::tolower(static_cast<unsigned char>(symbols[k]))] = static_cast<uint8_t>(k);
+        }
+        for (std::size_t k = 0; k < symbols.size(); k++) {
+            _code[static_cast<unsigned char>(symbols[k])] = static_cast<uint8_t>(k);
+        }
+    }
+
+    /**
+     * @brief Encodes c (and its lowercase form) as the code of symbol.
+     */
+    void alias(char c, char symbol) {
+        _code[static_cast<unsigned char>(c)] = encode(symbol);
+        _code[std::tolower(static_cast<unsigned char>(c))] = encode(symbol);
+    }
+
+    int size() const { return static_cast<int>(_symbols.size()); }
+    uint8_t encode(char c) const { return _code[static_cast<unsigned char>(c)]; }
+    char symbol(uint8_t code) const { return _symbols[code]; }
+
+    /**
+     * @brief Encodes a whole sequence.
+     * @note [Complexity]: O(n) time complexity.
+     */
+    encoded_sequence encode(const std::string &s) const {
+        encoded_sequence codes(s.size());
+        for (std::size_t i = 0; i < s.size(); i++) {
+            codes[i] = encode(s[i]);
+        }
+        return codes;
+    }
+
+ private:
+    std::string _symbols;
+    std::array<uint8_t, 256> _code;
+};
+
+/**
+ * @brief DNA alphabet ACGTN (U is read as T, anything else as N).
+ */
+alphabet dna_alphabet() {
+    alphabet abc("ACGTN", 'N');
+    abc.alias('U', 'T');
+    return abc;
+}
+
+/**
+ * @brief DNA alphabet with the IUPAC ambiguity codes ACGTRYSWKMBDHVN (U is read as T).
+ */
+alphabet iupac_alphabet() {
+    alphabet abc("ACGTRYSWKMBDHVN", 'N');
+    abc.alias('U', 'T');
+    return abc;
+}
+
+/**
+ * @brief Protein alphabet in the order of the NCBI matrices: ARNDCQEGHILKMFPSTWYVBZX*.
+ * @note Characters outside it are read as X.
+ */
+alphabet protein_alphabet() { return alphabet("ARNDCQEGHILKMFPSTWYVBZX*", 'X'); }
+
+/**
+ * @brief The identity encoding of all 256 byte values.
+ * @note Scoring with a matrix over this alphabet uses a full 256 x 256 table.
+ */
+alphabet byte_alphabet() {
+    std::string symbols(256, '\0');
+    for (int c = 0; c < 256; c++) {
+        symbols[c] = static_cast<char>(c);
+    }
+    alphabet abc(symbols, '\0');
+    return abc;
+}
+
+// Scoring policies. The aligners are templates over the policy, which provides
+//     int score(std::size_t i, uint8_t c1, uint8_t c2) const
+// the similarity of code c1 at position i of s1 with code c2 (higher is better), so that each
+// policy is inlined into the DP inner loop.
+
+/**
+ * @brief Scoring policy: a for equal codes, -x otherwise.
+ */
+class match_mismatch_scoring {
+ public:
+    explicit match_mismatch_scoring(int a = 1, int x = 1) : _a(a), _x(x) {}
+
+    int score(std::size_t, uint8_t c1, uint8_t c2) const { return c1 == c2 ? _a : -_x; }
+
+ private:
+    int _a, _x;
+};
+
+/**
+ * @brief Scoring policy: a substitution matrix over an alphabet of size codes.
+ */
+class matrix_scoring {
+ public:
+    /**
+     * @brief Constructs a matrix from its size x size entries in row-major order.
+     */
+    matrix_scoring(int size, const std::vector<int> &table) : _n(size), _table(table) {
+        assert(table.size() == static_cast<std::size_t>(size) * size);
+    }
+
+    /**
+     * @brief Constructs the matrix with a on the diagonal and -x elsewhere.
+     */
+    matrix_scoring(const alphabet &abc, int a, int x)
+        : _n(abc.size()), _table(static_cast<std::size_t>(_n) * _n, -x) {
+        for (int c = 0; c < _n; c++) {
+            _table[c * _n + c] = a;
+        }
+    }
+
+    int size() const { return _n; }
+    int score(std::size_t, uint8_t c1, uint8_t c2) const { return _table[c1 * _n + c2]; }
+    void set(uint8_t c1, uint8_t c2, int s) { _table[c1 * _n + c2] = s; }
+
+ private:
+    int _n;
+    std::vector<int> _table;
+};
+
+/**
+ * @brief The BLOSUM62 matrix over protein_alphabet.
+ */
+matrix_scoring blosum62() {
+    static const int table[24 * 24] = {
+         4, -1, -2, -2,  0, -1, -1,  0, -2, -1, -1, -1,  // A
+        -1, -2, -1,  1,  0, -3, -2,  0, -2, -1,  0, -4,
+        -1,  5,  0, -2, -3,  1,  0, -2,  0, -3, -2,  2,  // R
+        -1, -3, -2, -1, -1, -3, -2, -3, -1,  0, -1, -4,
+        -2,  0,  6,  1, -3,  0,  0,  0,  1, -3, -3,  0,  // N
+        -2, -3, -2,  1,  0, -4, -2, -3,  3,  0, -1, -4,
+        -2, -2,  1,  6, -3,  0,  2, -1, -1, -3, -4, -1,  // D
+        -3, -3, -1,  0, -1, -4, -3, -3,  4,  1, -1, -4,
+         0, -3, -3, -3,  9, -3, -4, -3, -3, -1, -1, -3,  // C
+        -1, -2, -3, -1, -1, -2, -2, -1, -3, -3, -2, -4,
+        -1,  1,  0,  0, -3,  5,  2, -2,  0, -3, -2,  1,  // Q
+         0, -3, -1,  0, -1, -2, -1, -2,  0,  3, -1, -4,
+        -1,  0,  0,  2, -4,  2,  5, -2,  0, -3, -3,  1,  // E
+        -2, -3, -1,  0, -1, -3, -2, -2,  1,  4, -1, -4,
+         0, -2,  0, -1, -3, -2, -2,  6, -2, -4, -4, -2,  // G
+        -3, -3, -2,  0, -2, -2, -3, -3, -1, -2, -1, -4,
+        -2,  0,  1, -1, -3,  0,  0, -2,  8, -3, -3, -1,  // H
+        -2, -1, -2, -1, -2, -2,  2, -3,  0,  0, -1, -4,
+        -1, -3, -3, -3, -1, -3, -3, -4, -3,  4,  2, -3,  // I
+         1,  0, -3, -2, -1, -3, -1,  3, -3, -3, -1, -4,
+        -1, -2, -3, -4, -1, -2, -3, -4, -3,  2,  4, -2,  // L
+         2,  0, -3, -2, -1, -2, -1,  1, -4, -3, -1, -4,
+        -1,  2,  0, -1, -3,  1,  1, -2, -1, -3, -2,  5,  // K
+        -1, -3, -1,  0, -1, -3, -2, -2,  0,  1, -1, -4,
+        -1, -1, -2, -3, -1,  0, -2, -3, -2,  1,  2, -1,  // M
+         5,  0, -2, -1, -1, -1, -1,  1, -3, -1, -1, -4,
+        -2, -3, -3, -3, -2, -3, -3, -3, -1,  0,  0, -3,  // F
+         0,  6, -4, -2, -2,  1,  3, -1, -3, -3, -1, -4,
+        -1, -2, -2, -1, -3, -1, -1, -2, -2, -3, -3, -1,  // P
+        -2, -4,  7, -1, -1, -4, -3, -2, -2, -1, -2, -4,
+         1, -1,  1,  0, -1,  0,  0,  0, -1, -2, -2,  0,  // S
+        -1, -2, -1,  4,  1, -3, -2, -2,  0,  0,  0, -4,
+         0, -1,  0, -1, -1, -1, -1, -2, -2, -1, -1, -1,  // T
+        -1, -2, -1,  1,  5, -2, -2,  0, -1, -1,  0, -4,
+        -3, -3, -4, -4, -2, -2, -3, -2, -2, -3, -2, -3,  // W
+        -1,  1, -4, -3, -2, 11,  2, -3, -4, -3, -2, -4,
+        -2, -2, -2, -3, -2, -1, -2, -3,  2, -1, -1, -2,  // Y
+        -1,  3, -3, -2, -2,  2,  7, -1, -3, -2, -1, -4,
+         0, -3, -3, -3, -1, -2, -2, -3, -3,  3,  1, -2,  // V
+         1, -1, -2, -2,  0, -3, -1,  4, -3, -2, -1, -4,
+        -2, -1,  3,  4, -3,  0,  1, -1,  0, -3, -4,  0,  // B
+        -3, -3, -2,  0, -1, -4, -3, -3,  4,  1, -1, -4,
+        -1,  0,  0,  1, -3,  3,  4, -2,  0, -3, -3,  1,  // Z
+        -1, -3, -1,  0, -1, -3, -2, -2,  1,  4, -1, -4,
+         0, -1, -1, -1, -2, -1, -1, -1, -1, -1, -1, -1,  // X
+        -1, -1, -2,  0,  0, -2, -1, -1, -1, -1, -1, -4,
+        -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,  // *
+        -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,  1,
+    };
+    return matrix_scoring(24, std::vector<int>(table, table + 24 * 24));
+}
+
+/**
+ * @brief Match / mismatch matrix over iupac_alphabet that understands ambiguity codes.
+ * @param a The score of two codes that can stand for a common base (e.g. A and R, or N and C).
+ * @param x The penalty of two codes that cannot.
+ */
+matrix_scoring iupac_scoring(int a = 1, int x = 1) {
+    // Bases (A = 1, C = 2, G = 4, T = 8) each code of iupac_alphabet can stand for.
+    static const int bases[15] = {1, 2, 4, 8, 5, 10, 6, 9, 12, 3, 14, 13, 11, 7, 15};
+    std::vector<int> table(15 * 15);
+    for (int c1 = 0; c1 < 15; c1++) {
+        for (int c2 = 0; c2 < 15; c2++) {
+            table[c1 * 15 + c2] = (bases[c1] & bases[c2]) != 0 ? a : -x;
+        }
+    }
+    return matrix_scoring(15, table);
+}
+
+/**
+ * @brief Scoring policy: a position-specific profile, one row of scores per position of s1.
+ * @note score(i, c1, c2) ignores c1. Built from a query and another policy, this is the query
+ * profile of the SIMD kernels.
+ */
+class profile_scoring {
+ public:
+    /**
+     * @brief Constructs an all-zero profile of length positions over size codes.
+     */
+    profile_scoring(std::size_t length, int size)
+        : _length(length), _n(size), _table(length * size, 0) {}
+
+    /**
+     * @brief Constructs the query profile of query under scoring.
+     */
+    template <typename Scoring>
+    profile_scoring(const encoded_sequence &query, int size, const Scoring &scoring)
+        : profile_scoring(query.size(), size) {
+        for (std::size_t i = 0; i < _length; i++) {
+            for (int c = 0; c < _n; c++) {
+                _table[i * _n + c] = scoring.score(i, query[i], static_cast<uint8_t>(c));
+            }
+        }
+    }
+
+    std::size_t length() const { return _length; }
+    int size() const { return _n; }
+    int score(std::size_t i, uint8_t, uint8_t c2) const { return _table[i * _n + c2]; }
+    void set(std::size_t i, uint8_t c, int s) { _table[i * _n + c] = s; }
+
+    int min_score() const {
+        return _table.empty() ? 0 : *std::min_element(_table.begin(), _table.end());
+    }
+    int max_score() const {
+        return _table.empty() ? 0 : *std::max_element(_table.begin(), _table.end());
+    }
+
+ private:
+    std::size_t _length;
+    int _n;
+    std::vector<int> _table;
+};
+
+}  // namespace alignment
+
+}  // namespace toolbox
@@ -0,0 +1,415 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "toolbox/parallel/thread_pool/thread_pool.hpp"
+#include "toolbox/string/packed_dna.hpp"
+
+namespace toolbox {
+
+namespace alignment {
+
+/**
+ * @brief A (w, k)-minimizer: the k-mer of smallest hash among w consecutive k-mers.
+ * @note hash is the hash of the canonical k-mer (the smaller of the k-mer and its reverse
+ * complement, 2 bits per base), pos the position of its first base and rev 1 if the canonical
+ * form is the reverse complement.
+ */
+struct minimizer {
+    uint64_t hash;
+    uint32_t pos;
+    uint32_t rev;
+};
+
+/**
+ * @brief One occurrence of a minimizer in the indexed targets.
+ * @note pos_rev = pos << 1 | rev. 16 bytes, no padding: the hit array is written to disk and
+ * mapped back as is.
+ */
+struct kmer_hit {
+    uint64_t hash;
+    uint32_t target;
+    uint32_t pos_rev;
+};
+
+namespace detail {
+
+/**
+ * @brief 2-bit code of a nucleotide (A 0, C 1, G 2, T/U 3), 4 for anything else.
+ */
+inline int nucleotide_code(char c) {
+    switch (c) {
+        case 'A':
+        case 'a':
+            return 0;
+        case 'C':
+        case 'c':
+            return 1;
+        case 'G':
+        case 'g':
+            return 2;
+        case 'T':
+        case 't':
+        case 'U':
+        case 'u':
+            return 3;
+        default:
+            return 4;
+    }
+}
+
+inline int nucleotide_code(const std::string &s, std::size_t i) { return nucleotide_code(s[i]); }
+inline int nucleotide_code(const string::packed_dna &s, std::size_t i) { return s.code(i); }
+
+/**
+ * @brief Invertible integer hash of a 2k-bit key (Thomas Wang's 64-bit mix, masked).
+ * @note Plain lexicographic order would make poly-A k-mers the minimizers of every window; a
+ * bijection keeps the minimizers distinct and spread out.
+ */
+inline uint64_t kmer_hash(uint64_t key, uint64_t mask) {
+    key = (~key + (key << 21)) & mask;
+    key = key ^ key >> 24;
+    key = ((key + (key << 3)) + (key << 8)) & mask;
+    key = key ^ key >> 14;
+    key = ((key + (key << 2)) + (key << 4)) & mask;
+    key = key ^ key >> 28;
+    key = (key + (key << 31)) & mask;
+    return key;
+}
+
+/**
+ * @brief Number of (w, k) windows of a sequence of length n.
+ * @note A sequence with fewer than w k-mers still has one window (all of its k-mers).
+ */
+inline std::size_t window_count(std::size_t n, int k, int w) {
+    if (n < static_cast<std::size_t>(k)) {
+        return 0;
+    }
+    const std::size_t kmers = n - k + 1;
+    return kmers >= static_cast<std::size_t>(w) ? kmers - w + 1 : 1;
+}
+
+/**
+ * @brief Appends the minimizers of windows first .. last - 1 of s, without repeating a
+ * minimizer shared by consecutive windows.
+ * @note Window t holds the k-mers starting at t .. t + w - 1. The k-mers are rolled 2 bits at a
+ * time (forward and reverse complement together) and the window minimum is kept in a monotone
+ * deque, so each base costs O(1) amortised. k-mers with a non-ACGT base and k-mers equal to
+ * their reverse complement (no strand) are skipped.
+ */
+template <typename Seq>
+void sketch_windows(const Seq &s, int k, int w, std::size_t first, std::size_t last,
+                    std::vector<minimizer> &out) {
+    const std::size_t kmers = s.size() - k + 1;
+    const std::size_t end = std::min(kmers, last + w - 1);  // k-mer starts first .. end - 1
+    const uint64_t mask = k == 32 ? ~0ULL : (1ULL << (2 * k)) - 1;
+    const int shift = 2 * (k - 1);
+    uint64_t fwd = 0;
+    uint64_t rev = 0;
+    int valid = 0;  // bases since the last non-ACGT
+    std::deque<minimizer> window;
+    std::size_t next_window = first;
+    for (std::size_t p = first; p < end + k - 1; p++) {
+        const int c = nucleotide_code(s, p);
+        if (c > 3) {
+            valid = 0;
+        } else {
+            fwd = ((fwd << 2) | c) & mask;
+            rev = (rev >> 2) | (static_cast<uint64_t>(3 - c) << shift);
+            valid++;
+        }
+        if (p + 1 < first + k) {
+            continue;
+        }
+        const std::size_t start = p + 1 - k;  // the k-mer s[start..p]
+        if (valid >= k && fwd != rev) {
+            const minimizer m{kmer_hash(std::min(fwd, rev), mask), static_cast<uint32_t>(start),
+                              rev < fwd ? 1u : 0u};
+            while (!window.empty() && window.back().hash > m.hash) {
+                window.pop_back();
+            }
+            window.push_back(m);
+        }
+        // Window t is complete once its last k-mer (or the last k-mer of s) is in.
+        const std::size_t t = next_window;
+        if (t < last && start == std::min(t + w - 1, kmers - 1)) {
+            while (!window.empty() && window.front().pos < t) {
+                window.pop_front();
+            }
+            if (!window.empty() && (out.empty() || out.back().pos != window.front().pos ||
+                                    out.back().hash != window.front().hash)) {
+                out.push_back(window.front());
+            }
+            next_window++;
+        }
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief The (w, k)-minimizers of a DNA sequence, in order of position.
+ * @param s The sequence (ACGT; U reads as T, other characters break k-mers).
+ * @param k The k-mer length (1 .. 32).
+ * @param w The number of consecutive k-mers per window.
+ * @return The minimizers, each reported once even if it is the minimum of several windows.
+ * @note Every run of w consecutive k-mers contains at least one of them, so two sequences
+ * sharing a stretch of w + k - 1 bases share a minimizer.
+ * @note [Complexity]: O(n) time complexity.
+ */
+std::vector<minimizer> compute_minimizers(const std::string &s, int k = 15, int w = 10) {
+    std::vector<minimizer> out;
+    const std::size_t windows = detail::window_count(s.size(), k, w);
+    if (windows != 0) {
+        detail::sketch_windows(s, k, w, 0, windows, out);
+    }
+    return out;
+}
+
+/**
+ * @brief The (w, k)-minimizers of a packed DNA sequence (N breaks k-mers).
+ * @note Same minimizers as for the unpacked string.
+ * @note [Complexity]: O(n) time complexity.
+ */
+std::vector<minimizer> compute_minimizers(const string::packed_dna &s, int k = 15, int w = 10) {
+    std::vector<minimizer> out;
+    const std::size_t windows = detail::window_count(s.size(), k, w);
+    if (windows != 0) {
+        detail::sketch_windows(s, k, w, 0, windows, out);
+    }
+    return out;
+}
+
+/**
+ * @brief Minimizer index of a set of DNA targets for seed lookup.
+ * @note The hits are a flat array sorted by (hash, target, pos), so the occurrences of a
+ * minimizer are one contiguous range found by binary search, and the whole index is two plain
+ * arrays. save writes them to a file that map reads back with mmap, without parsing or copying.
+ */
+class kmer_index {
+ public:
+    kmer_index() : _k(0), _w(0), _hits(nullptr), _count(0), _map(nullptr), _map_size(0) {}
+
+    /**
+     * @brief Indexes targets.
+     * @param targets The target sequences (each shorter than 2^31).
+     * @param k The k-mer length (1 .. 32).
+     * @param w The window length in k-mers.
+     * @param pool The threads the sketching is shared between.
+     * @note Targets are cut into chunks of 2^20 windows that are sketched in parallel; a
+     * minimizer shared by the last window of a chunk and the first of the next is dropped once,
+     * so the result equals a serial pass.
+     * @note [Complexity]: O(L + h log h) time complexity for L bases and h hits.
+     */
+    explicit kmer_index(const std::vector<std::string> &targets, int k = 15, int w = 10,
+                        parallel::thread_pool &pool = parallel::default_thread_pool())
+        : _k(k), _w(w), _hits(nullptr), _count(0), _map(nullptr), _map_size(0) {
+        build(targets, pool);
+    }
+
+    /**
+     * @brief Indexes packed targets; the same index as for the unpacked strings.
+     * @note The k-mers are rolled from the 2-bit codes in place.
+     */
+    explicit kmer_index(const std::vector<string::packed_dna> &targets, int k = 15, int w = 10,
+                        parallel::thread_pool &pool = parallel::default_thread_pool())
+        : _k(k), _w(w), _hits(nullptr), _count(0), _map(nullptr), _map_size(0) {
+        build(targets, pool);
+    }
+
+    kmer_index(const kmer_index &) = delete;
+    kmer_index &operator=(const kmer_index &) = delete;
+
+    kmer_index(kmer_index &&other) noexcept : kmer_index() { swap(other); }
+    kmer_index &operator=(kmer_index &&other) noexcept {
+        kmer_index tmp(std::move(other));
+        swap(tmp);
+        return *this;
+    }
+
+    ~kmer_index() { unmap(); }
+
+    int k() const { return _k; }
+    int w() const { return _w; }
+    std::size_t size() const { return _count; }
+    std::size_t target_count() const { return _lengths.size(); }
+    uint64_t target_length(std::size_t t) const { return _lengths[t]; }
+    const kmer_hit *begin() const { return _hits; }
+    const kmer_hit *end() const { return _hits + _count; }
+
+    /**
+     * @brief The occurrences of a minimizer hash, as a range of hits.
+     * @note [Complexity]: O(log h) time complexity.
+     */
+    std::pair<const kmer_hit *, const kmer_hit *> find(uint64_t hash) const {
+        const kmer_hit *lo = std::lower_bound(
+            begin(), end(), hash, [](const kmer_hit &h, uint64_t x) { return h.hash < x; });
+        const kmer_hit *hi = lo;
+        while (hi != end() && hi->hash == hash) {
+            hi++;
+        }
+        return std::make_pair(lo, hi);
+    }
+
+    /**
+     * @brief Writes the index to path.
+     * @return false if the file cannot be written.
+     * @note Layout: a 48-byte header (magic, k, w, target count, hit count), the target lengths
+     * (uint64) and the hits, all in native byte order.
+     */
+    bool save(const std::string &path) const {
+        std::FILE *f = std::fopen(path.c_str(), "wb");
+        if (f == nullptr) {
+            return false;
+        }
+        const uint64_t header[HEADER_WORDS] = {MAGIC,
+                                               static_cast<uint64_t>(_k),
+                                               static_cast<uint64_t>(_w),
+                                               _lengths.size(),
+                                               _count,
+                                               0};
+        bool ok = std::fwrite(header, sizeof(header), 1, f) == 1;
+        ok = ok && std::fwrite(_lengths.data(), sizeof(uint64_t), _lengths.size(), f) ==
+                       _lengths.size();
+        ok = ok && std::fwrite(_hits, sizeof(kmer_hit), _count, f) == _count;
+        return std::fclose(f) == 0 && ok;
+    }
+
+    /**
+     * @brief Replaces the index by the one saved at path, mapped read-only into memory.
+     * @return false if the file cannot be mapped or is not an index.
+     * @note The hits are used in place from the mapping: loading costs no parsing and the pages
+     * are shared between processes mapping the same file.
+     */
+    bool map(const std::string &path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        void *p = MAP_FAILED;
+        if (::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= HEADER_BYTES) {
+            p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            return false;
+        }
+        const std::size_t bytes = st.st_size;
+        uint64_t header[HEADER_WORDS];
+        std::memcpy(header, p, HEADER_BYTES);
+        const std::size_t targets = header[3];
+        const std::size_t hits = header[4];
+        if (header[0] != MAGIC ||
+            bytes != HEADER_BYTES + targets * sizeof(uint64_t) + hits * sizeof(kmer_hit)) {
+            ::munmap(p, bytes);
+            return false;
+        }
+        unmap();
+        _owned.clear();
+        _k = static_cast<int>(header[1]);
+        _w = static_cast<int>(header[2]);
+        const char *base = static_cast<const char *>(p);
+        _lengths.resize(targets);
+        std::memcpy(_lengths.data(), base + HEADER_BYTES, targets * sizeof(uint64_t));
+        _hits =
+            reinterpret_cast<const kmer_hit *>(base + HEADER_BYTES + targets * sizeof(uint64_t));
+        _count = hits;
+        _map = p;
+        _map_size = bytes;
+        return true;
+    }
+
+ private:
+    static const uint64_t MAGIC = 0x31584449524d4b54ULL;  // "TKMRIDX1"
+    static const std::size_t HEADER_WORDS = 6;
+    static const std::size_t HEADER_BYTES = HEADER_WORDS * sizeof(uint64_t);
+
+    int _k, _w;
+    std::vector<uint64_t> _lengths;
+    std::vector<kmer_hit> _owned;
+    const kmer_hit *_hits;
+    std::size_t _count;
+    void *_map;
+    std::size_t _map_size;
+
+    template <typename Seq>
+    void build(const std::vector<Seq> &targets, parallel::thread_pool &pool) {
+        struct chunk {
+            uint32_t target;
+            std::size_t first, last;
+        };
+        const std::size_t CHUNK = 1 << 20;
+        std::vector<chunk> chunks;
+        for (std::size_t t = 0; t < targets.size(); t++) {
+            _lengths.push_back(targets[t].size());
+            const std::size_t windows = detail::window_count(targets[t].size(), _k, _w);
+            for (std::size_t first = 0; first < windows; first += CHUNK) {
+                chunks.push_back(
+                    chunk{static_cast<uint32_t>(t), first, std::min(windows, first + CHUNK)});
+            }
+        }
+        std::vector<std::vector<minimizer>> sketches(chunks.size());
+        pool.parallel_for(0, chunks.size(), [&](std::size_t c) {
+            detail::sketch_windows(targets[chunks[c].target], _k, _w, chunks[c].first,
+                                   chunks[c].last, sketches[c]);
+        });
+        for (std::size_t c = 0; c < chunks.size(); c++) {
+            const minimizer *last = nullptr;
+            if (c > 0 && chunks[c - 1].target == chunks[c].target &&
+                !sketches[c - 1].empty()) {
+                last = &sketches[c - 1].back();
+            }
+            for (const minimizer &m : sketches[c]) {
+                if (last != nullptr && m.pos == last->pos && m.hash == last->hash) {
+                    continue;
+                }
+                last = nullptr;
+                _owned.push_back(kmer_hit{m.hash, chunks[c].target, m.pos << 1 | m.rev});
+            }
+        }
+        std::sort(_owned.begin(), _owned.end(), [](const kmer_hit &a, const kmer_hit &b) {
+            return a.hash != b.hash ? a.hash < b.hash
+                                    : a.target != b.target ? a.target < b.target
+                                                           : a.pos_rev < b.pos_rev;
+        });
+        _hits = _owned.data();
+        _count = _owned.size();
+    }
+
+    void unmap() {
+        if (_map != nullptr) {
+            ::munmap(_map, _map_size);
+            _map = nullptr;
+            _map_size = 0;
+        }
+    }
+
+    void swap(kmer_index &other) {
+        std::swap(_k, other._k);
+        std::swap(_w, other._w);
+        _lengths.swap(other._lengths);
+        _owned.swap(other._owned);
+        std::swap(_hits, other._hits);
+        std::swap(_count, other._count);
+        std::swap(_map, other._map);
+        std::swap(_map_size, other._map_size);
+    }
+};
+
+}  // namespace alignment
+
+}  // namespace toolbox
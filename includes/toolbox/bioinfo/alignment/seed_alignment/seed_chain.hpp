@@ -0,0 +1,312 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "toolbox/bioinfo/alignment/global_alignment/banded.hpp"
+#include "toolbox/bioinfo/alignment/seed_alignment/kmer_index.hpp"
+#include "toolbox/bioinfo/alignment/traceback.hpp"
+
+namespace toolbox {
+
+namespace alignment {
+
+/**
+ * @brief A minimizer shared by the query and a target.
+ * @note On the reverse strand (rev = 1) qpos is a position of the reverse complement of the
+ * query, so that on both strands the anchors of one alignment have increasing qpos and tpos.
+ * Both positions are the first base of the k-mer.
+ */
+struct seed_anchor {
+    uint32_t target;
+    uint32_t rev;
+    uint32_t tpos;
+    uint32_t qpos;
+};
+
+/**
+ * @brief A colinear chain of anchors: query [qbegin, qend) against target [tbegin, tend).
+ */
+struct seed_chain {
+    uint32_t target;
+    uint32_t rev;
+    int score;
+    int anchors;
+    uint32_t qbegin, qend;
+    uint32_t tbegin, tend;
+};
+
+/**
+ * @brief A query aligned to a target window found by chaining.
+ * @note aln aligns the whole query (its reverse complement if rev) with target
+ * [aln.begin2, aln.end2): s1 is the query and s2 the target, and aln.score is the edit distance
+ * of needleman_wunsch_banded.
+ */
+struct seed_mapping {
+    uint32_t target;
+    uint32_t rev;
+    int chain_score;
+    alignment_result aln;
+};
+
+/**
+ * @brief Parameters of seed-and-extend mapping.
+ */
+struct seed_options {
+    // Minimizers with more occurrences in the index are repeats and are not used as seeds.
+    std::size_t max_occ = 500;
+    // Two anchors are chained only if they are at most max_gap apart on both sequences ...
+    int max_gap = 5000;
+    // ... and among the max_skip anchors preceding the later one.
+    int max_skip = 50;
+    // Chains scoring less are dropped (an anchor scores up to k).
+    int min_score = 40;
+    // Band width of the extension, on top of the length difference of query and window.
+    int band = 32;
+    // At most this many mappings per query, best chains first.
+    int max_mappings = 5;
+};
+
+namespace detail {
+
+// Bases of either case are complemented to upper case, as the packed overload reads them back, so
+// a soft-masked (lowercase) query is extended the same way on both.
+inline std::string reverse_complement(const std::string &s) {
+    std::string r(s.rbegin(), s.rend());
+    for (char &c : r) {
+        const uint8_t code = string::detail::packed_dna_code(c);
+        if (code < 4) {
+            c = string::detail::PACKED_DNA_SYMBOLS[3 - code];
+        }
+    }
+    return r;
+}
+
+inline string::packed_dna reverse_complement(const string::packed_dna &s) {
+    return s.reverse_complement();
+}
+
+// The bases of either case (and U) as the upper-case ACGT the packed overload reads back; other
+// symbols are kept.
+inline std::string upper_bases(const std::string &s) {
+    std::string r(s);
+    for (char &c : r) {
+        const uint8_t code = string::detail::packed_dna_code(c);
+        if (code < 4) {
+            c = string::detail::PACKED_DNA_SYMBOLS[code];
+        }
+    }
+    return r;
+}
+
+template <typename Seq>
+std::vector<seed_anchor> collect_anchors(const kmer_index &index, const Seq &query,
+                                         std::size_t max_occ) {
+    const uint32_t qlen = static_cast<uint32_t>(query.size());
+    const uint32_t k = static_cast<uint32_t>(index.k());
+    std::vector<seed_anchor> anchors;
+    for (const minimizer &m : compute_minimizers(query, index.k(), index.w())) {
+        const std::pair<const kmer_hit *, const kmer_hit *> hits = index.find(m.hash);
+        if (static_cast<std::size_t>(hits.second - hits.first) > max_occ) {
+            continue;
+        }
+        for (const kmer_hit *h = hits.first; h != hits.second; h++) {
+            const uint32_t rev = (h->pos_rev & 1) ^ m.rev;
+            anchors.push_back(seed_anchor{h->target, rev, h->pos_rev >> 1,
+                                          rev ? qlen - m.pos - k : m.pos});
+        }
+    }
+    std::sort(anchors.begin(), anchors.end(), [](const seed_anchor &a, const seed_anchor &b) {
+        if (a.target != b.target) {
+            return a.target < b.target;
+        }
+        if (a.rev != b.rev) {
+            return a.rev < b.rev;
+        }
+        return a.tpos != b.tpos ? a.tpos < b.tpos : a.qpos < b.qpos;
+    });
+    return anchors;
+}
+
+}  // namespace detail
+
+/**
+ * @brief The anchors of a query: its minimizers looked up in the index.
+ * @param index The minimizer index of the targets.
+ * @param query The query sequence.
+ * @param max_occ Minimizers occurring more often in the index are skipped.
+ * @return The anchors, sorted by (target, rev, tpos, qpos).
+ * @note [Complexity]: O(q log h + a log a) time complexity for a anchors.
+ */
+std::vector<seed_anchor> collect_anchors(const kmer_index &index, const std::string &query,
+                                         std::size_t max_occ = 500) {
+    return detail::collect_anchors(index, query, max_occ);
+}
+
+/**
+ * @brief The anchors of a packed query; the same as for the unpacked string.
+ * @note [Complexity]: O(q log h + a log a) time complexity for a anchors.
+ */
+std::vector<seed_anchor> collect_anchors(const kmer_index &index, const string::packed_dna &query,
+                                         std::size_t max_occ = 500) {
+    return detail::collect_anchors(index, query, max_occ);
+}
+
+/**
+ * @brief Colinear chaining of sorted anchors.
+ * @param anchors The anchors, sorted as collect_anchors returns them.
+ * @param k The k-mer length of the index.
+ * @param options max_gap, max_skip and min_score are used.
+ * @return The chains, best score first.
+ * @note f(i) = max(k, f(j) + min(dq, dt, k) - gap(|dq - dt|)) over the max_skip anchors j before
+ * i on the same target and strand with 0 < dq, dt <= max_gap, where gap(l) = k l / 100 +
+ * log2(l) / 2 as in minimap2. Chains are then read back from the best end down, each anchor in
+ * at most one chain; a chain running into an anchor already used keeps only its own part.
+ * @note [Complexity]: O(a * max_skip) time complexity.
+ */
+std::vector<seed_chain> chain_anchors(const std::vector<seed_anchor> &anchors, int k,
+                                      const seed_options &options = seed_options()) {
+    const int a = static_cast<int>(anchors.size());
+    std::vector<int> f(a), parent(a, -1);
+    for (int i = 0, group = 0; i < a; i++) {
+        if (anchors[i].target != anchors[group].target || anchors[i].rev != anchors[group].rev) {
+            group = i;
+        }
+        f[i] = k;
+        for (int j = i - 1; j >= group && j >= i - options.max_skip; j--) {
+            const long long dt = static_cast<long long>(anchors[i].tpos) - anchors[j].tpos;
+            const long long dq = static_cast<long long>(anchors[i].qpos) - anchors[j].qpos;
+            if (dt > options.max_gap) {
+                break;  // sorted by tpos: the earlier anchors are farther still
+            }
+            if (dt <= 0 || dq <= 0 || dq > options.max_gap) {
+                continue;
+            }
+            const long long l = std::llabs(dq - dt);
+            const int gap = l == 0 ? 0
+                                   : static_cast<int>(k * l / 100) +
+                                         static_cast<int>(std::bit_width(
+                                             static_cast<unsigned long long>(l))) /
+                                             2;
+            const int s = f[j] + static_cast<int>(std::min<long long>(std::min(dq, dt), k)) - gap;
+            if (s > f[i]) {
+                f[i] = s;
+                parent[i] = j;
+            }
+        }
+    }
+    std::vector<int> order(a);
+    for (int i = 0; i < a; i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(),
+              [&f](int x, int y) { return f[x] != f[y] ? f[x] > f[y] : x < y; });
+    std::vector<bool> used(a, false);
+    std::vector<seed_chain> chains;
+    for (int end : order) {
+        if (used[end]) {
+            continue;
+        }
+        int first = end;
+        int count = 0;
+        int i = end;
+        while (i >= 0 && !used[i]) {
+            used[i] = true;
+            first = i;
+            count++;
+            i = parent[i];
+        }
+        const int score = f[end] - (i >= 0 ? f[i] : 0);
+        if (score < options.min_score) {
+            continue;
+        }
+        const seed_anchor &s = anchors[first];
+        const seed_anchor &t = anchors[end];
+        chains.push_back(seed_chain{s.target, s.rev, score, count, s.qpos, t.qpos + k, s.tpos,
+                                    t.tpos + k});
+    }
+    std::stable_sort(chains.begin(), chains.end(),
+                     [](const seed_chain &x, const seed_chain &y) { return x.score > y.score; });
+    return chains;
+}
+
+namespace detail {
+
+template <typename Seq>
+std::vector<seed_mapping> map_query(const kmer_index &index, const std::vector<Seq> &targets,
+                                    const Seq &query, const seed_options &options) {
+    const std::vector<seed_chain> chains =
+        chain_anchors(collect_anchors(index, query, options.max_occ), index.k(), options);
+    std::vector<seed_mapping> mappings;
+    Seq rc;
+    for (const seed_chain &c : chains) {
+        if (static_cast<int>(mappings.size()) >= options.max_mappings) {
+            break;
+        }
+        if (c.rev && rc.empty()) {
+            rc = reverse_complement(query);
+        }
+        const Seq &q = c.rev ? rc : query;
+        const Seq &target = targets[c.target];
+        const long long qlen = static_cast<long long>(q.size());
+        const long long tbegin = std::max(0LL, static_cast<long long>(c.tbegin) - c.qbegin);
+        const long long tend = std::min(static_cast<long long>(target.size()),
+                                        static_cast<long long>(c.tend) + (qlen - c.qend));
+        seed_mapping m;
+        m.target = c.target;
+        m.rev = c.rev;
+        m.chain_score = c.score;
+        const int band = options.band + static_cast<int>(std::llabs(qlen - (tend - tbegin)));
+        needleman_wunsch_banded(q, target.substr(tbegin, tend - tbegin), m.aln, band);
+        m.aln.begin2 += tbegin;
+        m.aln.end2 += tbegin;
+        mappings.push_back(m);
+    }
+    return mappings;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Seed-and-extend mapping of a query against indexed targets.
+ * @param index The minimizer index of targets.
+ * @param targets The indexed sequences.
+ * @param query The query sequence.
+ * @param options The seeding, chaining and extension parameters.
+ * @return Up to options.max_mappings mappings, best chain first.
+ * @note collect_anchors, chain_anchors, then each chain is projected to the window of the target
+ * the whole query would cover (the chain extended by the unchained query ends) and the query is
+ * aligned to that window by needleman_wunsch_banded, so only O(band * |query|) cells are filled
+ * per candidate instead of a full DP against the target.
+ * @note A soft-masked (lowercase) query is upper-cased first, so it maps as its upper-case read
+ * does on both strands.
+ * @note [Complexity]: O(q log h + a * max_skip + mappings * band * q) time complexity.
+ */
+std::vector<seed_mapping> map_query(const kmer_index &index,
+                                    const std::vector<std::string> &targets,
+                                    const std::string &query,
+                                    const seed_options &options = seed_options()) {
+    return detail::map_query(index, targets, detail::upper_bases(query), options);
+}
+
+/**
+ * @brief Seed-and-extend mapping of a packed query against packed targets.
+ * @note The same mappings as for the unpacked strings; the windows are cut from the 2-bit words
+ * and aligned by the packed needleman_wunsch_banded, so the targets are never unpacked.
+ * @note [Complexity]: O(q log h + a * max_skip + mappings * band * q) time complexity.
+ */
+std::vector<seed_mapping> map_query(const kmer_index &index,
+                                    const std::vector<string::packed_dna> &targets,
+                                    const string::packed_dna &query,
+                                    const seed_options &options = seed_options()) {
+    return detail::map_query(index, targets, query, options);
+}
+
+}  // namespace alignment
+
+}  // namespace toolbox
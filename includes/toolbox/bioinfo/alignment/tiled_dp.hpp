@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "toolbox/parallel/thread_pool/thread_pool.hpp"
+
+namespace toolbox {
+
+namespace alignment {
+
+// Cell-update policies. tiled_dp fills an (m + 1) x (n + 1) DP table whose cells depend on their
+// upper-left, upper and left neighbours; the policy provides
+//     typedef ... cell;                       the DP state of one cell
+//     cell boundary_row(int j) const;         cell (0, j)
+//     cell boundary_col(int i) const;         cell (i, 0), i >= 1
+//     cell update(int i, int j, const cell &diag, const cell &up, const cell &left) const;
+//     int value(const cell &c, int i, int j) const;
+// and tiled_dp returns the maximum of value over all cells (e.g. the last cell only for a global
+// alignment, every cell for a local one).
+
+namespace detail {
+
+/**
+ * @brief Fills one tile of tiled_dp.
+ * @note The tile reads the bottom row of the tile above from row, the right column of the tile
+ * to its left from col, and its upper-left corner from corner, then overwrites all three with
+ * its own boundary. Tiles of one anti-diagonal touch disjoint parts of them.
+ */
+template <typename Policy>
+int tiled_dp_tile(const Policy &policy, int ti, int tj, int tile, int m, int n,
+                  std::vector<typename Policy::cell> &row, std::vector<typename Policy::cell> &col,
+                  std::vector<typename Policy::cell> &corner) {
+    typedef typename Policy::cell cell;
+    const int top = ti * tile + 1;
+    const int bottom = std::min(m, top + tile - 1);
+    const int left = tj * tile + 1;
+    const int right = std::min(n, left + tile - 1);
+    const int w = right - left + 1;
+    // A tile holds at least one column; sized so that the compiler sees prev[0] exists.
+    const std::size_t cells = static_cast<std::size_t>(std::max(w, 0)) + 1;
+    std::vector<cell> prev(cells), cur(cells);
+    prev[0] = corner[tj];
+    std::copy(row.begin() + left, row.begin() + right + 1, prev.begin() + 1);
+    // Cell (bottom, left - 1) is the upper-left corner of the next tile of this column.
+    corner[tj] = col[bottom];
+    int best = std::numeric_limits<int>::min();
+    for (int i = top; i <= bottom; i++) {
+        cur[0] = col[i];
+        for (int k = 1; k <= w; k++) {
+            const int j = left + k - 1;
+            cur[k] = policy.update(i, j, prev[k - 1], prev[k], cur[k - 1]);
+            best = std::max(best, policy.value(cur[k], i, j));
+        }
+        col[i] = cur[w];
+        prev.swap(cur);
+    }
+    std::copy(prev.begin() + 1, prev.end(), row.begin() + left);
+    return best;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Fills a rectangular DP table tile by tile, one anti-diagonal of tiles at a time.
+ * @param policy The cell-update policy (see above).
+ * @param m The number of rows after row 0.
+ * @param n The number of columns after column 0.
+ * @param tile The side of a tile, in cells.
+ * @param pool The thread pool the tiles of an anti-diagonal are spread over.
+ * @return The maximum of policy.value over all cells.
+ * @note A tile only depends on the tiles above, to the left and upper-left of it, so all tiles
+ * of an anti-diagonal are independent. Only one row and one column of cells are kept (the tile
+ * boundaries), so the table is never stored and the score of two 1 Mbp sequences needs O(m + n)
+ * memory. Tiles should fit in the L1 / L2 cache: 256 x 256 cells touch two rows of 256 cells.
+ * @note [Complexity]: O(nm / p) time complexity with p threads (as long as most anti-diagonals
+ * have at least p tiles) and O(m + n) space complexity.
+ */
+template <typename Policy>
+int tiled_dp(const Policy &policy, int m, int n, int tile = 256,
+             parallel::thread_pool &pool = parallel::default_thread_pool()) {
+    typedef typename Policy::cell cell;
+    assert(tile > 0);
+    std::vector<cell> row(n + 1), col(m + 1);
+    int best = std::numeric_limits<int>::min();
+    for (int j = 0; j <= n; j++) {
+        row[j] = policy.boundary_row(j);
+        best = std::max(best, policy.value(row[j], 0, j));
+    }
+    for (int i = 1; i <= m; i++) {
+        col[i] = policy.boundary_col(i);
+        best = std::max(best, policy.value(col[i], i, 0));
+    }
+    const int rows = (m + tile - 1) / tile;
+    const int cols = (n + tile - 1) / tile;
+    if (rows == 0 || cols == 0) {
+        return best;
+    }
+    std::vector<cell> corner(cols);
+    for (int tj = 0; tj < cols; tj++) {
+        corner[tj] = row[tj * tile];
+    }
+    std::vector<int> tile_best(std::min(rows, cols));
+    for (int d = 0; d < rows + cols - 1; d++) {
+        const int lo = std::max(0, d - cols + 1);
+        const int hi = std::min(rows - 1, d);
+        pool.parallel_for(lo, hi + 1, [&](std::size_t ti) {
+            const int t = static_cast<int>(ti);
+            tile_best[t - lo] =
+                detail::tiled_dp_tile(policy, t, d - t, tile, m, n, row, col, corner);
+        });
+        for (int t = lo; t <= hi; t++) {
+            best = std::max(best, tile_best[t - lo]);
+        }
+    }
+    return best;
+}
+
+}  // namespace alignment
+
+}  // namespace toolbox
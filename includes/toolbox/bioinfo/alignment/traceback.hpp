@@ -0,0 +1,282 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace toolbox {
+
+namespace alignment {
+
+/**
+ * @brief One run of a CIGAR string: len columns of operation op.
+ * @note op is 'M' (s1[i] aligned to s2[j], match or mismatch), 'I' (a character of s2 against a
+ * gap) or 'D' (a character of s1 against a gap), i.e. s1 plays the reference. The extended form
+ * (see cigar_to_extended) splits 'M' into '=' (match) and 'X' (mismatch).
+ */
+struct cigar_op {
+    char op;
+    int len;
+};
+
+typedef std::vector<cigar_op> cigar;
+
+/**
+ * @brief An alignment of s1[begin1..end1) with s2[begin2..end2), as produced by the aligners.
+ * @note Global aligners cover both strings entirely; local, overlap and extension aligners
+ * report the aligned substrings through the coordinates. No gapped strings are built: use
+ * alignment_to_aligned for that form.
+ */
+struct alignment_result {
+    int score = 0;
+    std::size_t begin1 = 0;
+    std::size_t end1 = 0;
+    std::size_t begin2 = 0;
+    std::size_t end2 = 0;
+    cigar ops;
+};
+
+namespace detail {
+
+// Traceback directions of the DP aligners (2 bits per cell).
+enum : uint8_t { TB_DIAG = 0, TB_UP = 1, TB_LEFT = 2, TB_STOP = 3 };
+// Needleman-Wunsch-Gotoh: D / I was entered by extending a gap rather than opening one (4 bits
+// per cell together with the source of M).
+enum : uint8_t { TB_D_EXTEND = 4, TB_I_EXTEND = 8 };
+
+/**
+ * @brief Traceback matrix packing one Bits-bit code per cell (Bits = 2 or 4).
+ * @note Each cell is written once while the DP is filled, so the score table itself can be
+ * reduced to rolling rows: 2 bits instead of an int per cell is a 16x smaller table.
+ */
+template <int Bits>
+class packed_traceback {
+    static_assert(Bits == 2 || Bits == 4, "packed_traceback: Bits must be 2 or 4");
+
+ public:
+    explicit packed_traceback(std::size_t cells) : _data((cells * Bits + 7) / 8, 0) {}
+
+    void set(std::size_t cell, uint8_t code) {
+        const std::size_t bit = cell * Bits;
+        _data[bit / 8] |= static_cast<uint8_t>(code << (bit % 8));
+    }
+    uint8_t get(std::size_t cell) const {
+        const std::size_t bit = cell * Bits;
+        return (_data[bit / 8] >> (bit % 8)) & ((1 << Bits) - 1);
+    }
+
+ private:
+    std::vector<uint8_t> _data;
+};
+
+/**
+ * @brief Appends one column of a traceback walked from the end of the alignment.
+ * @note The aligned strings are built back to front and reversed once at the end, instead of
+ * prepending a character per step.
+ */
+inline void tb_emit(std::string &r1, std::string &r2, char c1, char c2) {
+    r1 += c1;
+    r2 += c2;
+}
+
+inline void tb_finish(std::string &r1, std::string &r2, std::string &s1_aligned,
+                      std::string &s2_aligned) {
+    s1_aligned.assign(r1.rbegin(), r1.rend());
+    s2_aligned.assign(r2.rbegin(), r2.rend());
+}
+
+/**
+ * @brief Appends one operation to a CIGAR built back to front (see cigar_finish).
+ */
+inline void cigar_push(cigar &ops, char op) {
+    if (!ops.empty() && ops.back().op == op) {
+        ops.back().len++;
+    } else {
+        ops.push_back(cigar_op{op, 1});
+    }
+}
+
+inline void cigar_finish(cigar &ops) { std::reverse(ops.begin(), ops.end()); }
+
+/**
+ * @brief Appends len columns of op to a CIGAR built front to back.
+ */
+inline void cigar_append(cigar &ops, char op, int len) {
+    if (len == 0) {
+        return;
+    }
+    if (!ops.empty() && ops.back().op == op) {
+        ops.back().len += len;
+    } else {
+        ops.push_back(cigar_op{op, len});
+    }
+}
+
+inline void cigar_append(cigar &ops, const cigar &tail) {
+    for (const cigar_op &c : tail) {
+        cigar_append(ops, c.op, c.len);
+    }
+}
+
+/**
+ * @brief Converts a diagonal-transition path into a CIGAR.
+ * @param path The cells (i, j) where the path leaves a diagonal, from the end cell back to
+ * (0, 0), as collected by diff_traceback and wavefront_traceback.
+ * @note Between two consecutive cells the path takes one gap (if the diagonal j - i changes) and
+ * then runs along the diagonal.
+ */
+inline void diagonal_path_to_cigar(const std::vector<std::pair<int, int>> &path, cigar &ops) {
+    ops.clear();
+    for (std::size_t t = path.size() - 1; t-- > 0;) {
+        const int i = path[t].first;
+        const int j = path[t].second;
+        const int i_prev = path[t + 1].first;
+        const int j_prev = path[t + 1].second;
+        if (j - i == j_prev - i_prev - 1) {
+            cigar_append(ops, 'D', 1);
+            cigar_append(ops, 'M', j - j_prev);
+        } else if (j - i == j_prev - i_prev + 1) {
+            cigar_append(ops, 'I', 1);
+            cigar_append(ops, 'M', i - i_prev);
+        } else {
+            cigar_append(ops, 'M', i - i_prev);
+        }
+    }
+}
+
+/**
+ * @brief Fills in the score and coordinates of res once res.ops holds the alignment.
+ */
+inline void finish_result(alignment_result &res, int score, std::size_t begin1,
+                          std::size_t begin2) {
+    res.score = score;
+    res.begin1 = res.end1 = begin1;
+    res.begin2 = res.end2 = begin2;
+    for (const cigar_op &c : res.ops) {
+        if (c.op != 'I') {
+            res.end1 += c.len;
+        }
+        if (c.op != 'D') {
+            res.end2 += c.len;
+        }
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Formats a CIGAR, e.g. "5M1I3M".
+ */
+std::string cigar_to_string(const cigar &ops) {
+    std::string s;
+    for (const cigar_op &c : ops) {
+        s += std::to_string(c.len);
+        s += c.op;
+    }
+    return s;
+}
+
+/**
+ * @brief Expands a CIGAR into the gapped-string form of the *_all functions.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param ops The CIGAR.
+ * @param s1_aligned The first aligned string.
+ * @param s2_aligned The second aligned string.
+ * @param begin1 The position in s1 the alignment starts at.
+ * @param begin2 The position in s2 the alignment starts at.
+ * @note [Complexity]: O(L) time complexity for an alignment of L columns.
+ */
+void cigar_to_aligned(const std::string &s1, const std::string &s2, const cigar &ops,
+                      std::string &s1_aligned, std::string &s2_aligned, std::size_t begin1 = 0,
+                      std::size_t begin2 = 0) {
+    std::size_t i = begin1;
+    std::size_t j = begin2;
+    s1_aligned.clear();
+    s2_aligned.clear();
+    for (const cigar_op &c : ops) {
+        const std::size_t len = c.len;
+        if (c.op == 'I') {
+            s1_aligned.append(len, '-');
+        } else {
+            s1_aligned.append(s1, i, len);
+            i += len;
+        }
+        if (c.op == 'D') {
+            s2_aligned.append(len, '-');
+        } else {
+            s2_aligned.append(s2, j, len);
+            j += len;
+        }
+    }
+}
+
+/**
+ * @brief Expands an alignment_result into the gapped-string form of the *_all functions.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param res The alignment.
+ * @param s1_aligned The first aligned string.
+ * @param s2_aligned The second aligned string.
+ */
+void alignment_to_aligned(const std::string &s1, const std::string &s2,
+                          const alignment_result &res, std::string &s1_aligned,
+                          std::string &s2_aligned) {
+    cigar_to_aligned(s1, s2, res.ops, s1_aligned, s2_aligned, res.begin1, res.begin2);
+}
+
+/**
+ * @brief Splits the 'M' runs of a CIGAR into '=' (match) and 'X' (mismatch) runs.
+ * @param s1 The first string.
+ * @param s2 The second string.
+ * @param ops The CIGAR.
+ * @param begin1 The position in s1 the alignment starts at.
+ * @param begin2 The position in s2 the alignment starts at.
+ * @return The extended CIGAR.
+ */
+cigar cigar_to_extended(const std::string &s1, const std::string &s2, const cigar &ops,
+                        std::size_t begin1 = 0, std::size_t begin2 = 0) {
+    cigar ext;
+    std::size_t i = begin1;
+    std::size_t j = begin2;
+    for (const cigar_op &c : ops) {
+        if (c.op == 'I') {
+            ext.push_back(c);
+            j += c.len;
+        } else if (c.op == 'D') {
+            ext.push_back(c);
+            i += c.len;
+        } else {
+            for (int t = 0; t < c.len; t++, i++, j++) {
+                detail::cigar_append(ext, s1[i] == s2[j] ? '=' : 'X', 1);
+            }
+        }
+    }
+    return ext;
+}
+
+/**
+ * @brief Parses the gapped-string form back into a CIGAR ('M' for aligned pairs).
+ * @param s1_aligned The first aligned string.
+ * @param s2_aligned The second aligned string.
+ * @return The CIGAR.
+ */
+cigar aligned_to_cigar(const std::string &s1_aligned, const std::string &s2_aligned) {
+    cigar ops;
+    for (std::size_t t = 0; t < s1_aligned.size() && t < s2_aligned.size(); t++) {
+        const bool gap1 = s1_aligned[t] == '-';
+        const bool gap2 = s2_aligned[t] == '-';
+        if (gap1 && gap2) {
+            continue;
+        }
+        detail::cigar_append(ops, gap1 ? 'I' : gap2 ? 'D' : 'M', 1);
+    }
+    return ops;
+}
+
+}  // namespace alignment
+
+}  // namespace toolbox
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace toolbox {
+
+namespace rna_2d {
+
+namespace detail {
+
+/**
+ * @brief Bases as 0 A, 1 C, 2 G, 3 U and 4 for anything else.
+ */
+inline int base_code(char c) {
+    switch (c) {
+        case 'A':
+            return 0;
+        case 'C':
+            return 1;
+        case 'G':
+            return 2;
+        case 'U':
+            return 3;
+        default:
+            return 4;
+    }
+}
+
+/**
+ * @brief Pair type of two base codes: 1 CG, 2 GC, 3 GU, 4 UG, 5 AU, 6 UA, 0 no pair.
+ */
+const int PAIR_TYPES[5][5] = {
+    // A  C  G  U  N
+    {0, 0, 0, 5, 0},  // A
+    {0, 0, 1, 0, 0},  // C
+    {0, 2, 0, 3, 0},  // G
+    {6, 0, 4, 0, 0},  // U
+    {0, 0, 0, 0, 0},  // N
+};
+
+inline int pair_type(char a, char b) { return PAIR_TYPES[base_code(a)][base_code(b)]; }
+
+/**
+ * @brief The base codes of a sequence, so that pair tests are two table lookups.
+ */
+inline std::vector<uint8_t> encode_rna(const std::string &seq) {
+    std::vector<uint8_t> code(seq.size());
+    for (std::size_t k = 0; k < seq.size(); k++) {
+        code[k] = static_cast<uint8_t>(base_code(seq[k]));
+    }
+    return code;
+}
+
+/**
+ * @brief For each position i, the positions that can pair with seq[i], in ascending order.
+ * @note One list per base (A pairs with U, C with G, G with C and U, U with A and G), so the
+ * lists take O(n) space in total and the partners of i after some position are a suffix of
+ * the list of seq[i].
+ */
+class pair_candidates {
+ public:
+    explicit pair_candidates(const std::vector<uint8_t> &code) : _code(code) {
+        for (int k = 0; k < static_cast<int>(code.size()); k++) {
+            for (int b = 0; b < 4; b++) {
+                if (PAIR_TYPES[b][code[k]] != 0) {
+                    _lists[b].push_back(k);
+                }
+            }
+        }
+    }
+
+    // The partners p >= from of position i, up to end(i).
+    const int *begin(int i, int from) const {
+        const std::vector<int> &l = _lists[_code[i]];
+        return std::lower_bound(l.data(), l.data() + l.size(), from);
+    }
+    const int *end(int i) const {
+        const std::vector<int> &l = _lists[_code[i]];
+        return l.data() + l.size();
+    }
+
+ private:
+    const std::vector<uint8_t> &_code;
+    std::vector<int> _lists[5];
+};
+
+}  // namespace detail
+
+/**
+ * @brief Whether a and b form a base pair (AU, CG or GU, in either order).
+ */
+bool is_base_pair(char a, char b) { return detail::pair_type(a, b) != 0; }
+
+}  // namespace rna_2d
+
+}  // namespace toolbox
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "toolbox/parallel/thread_pool/thread_pool.hpp"
+
+namespace toolbox {
+
+namespace rna_2d {
+
+namespace detail {
+
+/**
+ * @brief Upper triangle (i <= j) of an n x n folding table, stored row-major and transposed.
+ * @note row(i) holds the cells (i, i..n-1) and col(j) the cells (0..j, j), each contiguously,
+ * so that a bifurcation T[i][l] + T[l+1][j] over l = i..j-1 reads two contiguous arrays. Each
+ * cell is written to both copies. 2 * n(n+1)/2 cells in total instead of the n^2 of a
+ * vector<vector<>>, with no per-row allocation.
+ */
+template <typename T>
+class fold_table {
+ public:
+    explicit fold_table(int n, T fill = T())
+        : _n(n),
+          _row(static_cast<std::size_t>(n) * (n + 1) / 2, fill),
+          _col(static_cast<std::size_t>(n) * (n + 1) / 2, fill) {}
+
+    int size() const { return _n; }
+    T get(int i, int j) const { return _row[row_offset(i) + j]; }
+    void set(int i, int j, T v) {
+        _row[row_offset(i) + j] = v;
+        _col[col_offset(j) + i] = v;
+    }
+    // row(i)[j] = T[i][j] for j >= i, col(j)[i] = T[i][j] for i <= j.
+    const T *row(int i) const { return _row.data() + row_offset(i); }
+    const T *col(int j) const { return _col.data() + col_offset(j); }
+
+ private:
+    int _n;
+    std::vector<T> _row, _col;
+
+    // Row i starts at i * n - i(i - 1) / 2 and is indexed by j (offset by -i).
+    std::size_t row_offset(int i) const {
+        return static_cast<std::size_t>(i) * _n - static_cast<std::size_t>(i) * (i + 1) / 2;
+    }
+    std::size_t col_offset(int j) const { return static_cast<std::size_t>(j) * (j + 1) / 2; }
+};
+
+/**
+ * @brief max(init, max over k < len of a[k] + b[k]) for 16-bit values.
+ * @note The bifurcation of the Nussinov recurrence. 16 (AVX2) or 8 (SSE2) lanes at a time.
+ */
+inline int16_t max_plus(const int16_t *a, const int16_t *b, int len, int16_t init) {
+    int k = 0;
+    int best = init;
+#if defined(__AVX2__)
+    __m256i acc = _mm256_set1_epi16(init);
+    for (; k + 16 <= len; k += 16) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + k));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + k));
+        acc = _mm256_max_epi16(acc, _mm256_add_epi16(va, vb));
+    }
+    int16_t lanes[16];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), acc);
+    best = *std::max_element(lanes, lanes + 16);
+#elif defined(__SSE2__)
+    __m128i acc = _mm_set1_epi16(init);
+    for (; k + 8 <= len; k += 8) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + k));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + k));
+        acc = _mm_max_epi16(acc, _mm_add_epi16(va, vb));
+    }
+    int16_t lanes[8];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    best = *std::max_element(lanes, lanes + 8);
+#endif
+    for (; k < len; k++) {
+        best = std::max(best, a[k] + b[k]);
+    }
+    return static_cast<int16_t>(best);
+}
+
+/**
+ * @brief min(init, min over k < len of a[k] + b[k]) for 32-bit values.
+ * @note The multiloop bifurcation of the Zuker recurrence. 8 (AVX2) or 4 (SSE4.1) lanes at a
+ * time; a[k] + b[k] must not overflow.
+ */
+inline int min_plus(const int *a, const int *b, int len, int init) {
+    int k = 0;
+    int best = init;
+#if defined(__AVX2__)
+    __m256i acc = _mm256_set1_epi32(init);
+    for (; k + 8 <= len; k += 8) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + k));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + k));
+        acc = _mm256_min_epi32(acc, _mm256_add_epi32(va, vb));
+    }
+    int lanes[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), acc);
+    best = *std::min_element(lanes, lanes + 8);
+#elif defined(__SSE4_1__)
+    __m128i acc = _mm_set1_epi32(init);
+    for (; k + 4 <= len; k += 4) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + k));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + k));
+        acc = _mm_min_epi32(acc, _mm_add_epi32(va, vb));
+    }
+    int lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    best = *std::min_element(lanes, lanes + 4);
+#endif
+    for (; k < len; k++) {
+        best = std::min(best, a[k] + b[k]);
+    }
+    return best;
+}
+
+/**
+ * @brief Calls f(i, i + k) for every span k = min_span .. n - 1, one diagonal after another.
+ * @note The cells of one diagonal only depend on shorter spans, so each diagonal is split into
+ * chunks that run in parallel on the pool. Short diagonals (little work) run on the caller.
+ */
+template <typename F>
+void for_each_diagonal(int n, int min_span, parallel::thread_pool &pool, F f) {
+    const std::size_t threads = pool.size();
+    for (int k = std::max(min_span, 0); k < n; k++) {
+        const int cells = n - k;
+        // About k operations per cell: below ~64k operations a diagonal is not worth sharing.
+        if (threads == 1 || static_cast<long long>(cells) * (k + 16) < (1 << 16)) {
+            for (int i = 0; i < cells; i++) {
+                f(i, i + k);
+            }
+            continue;
+        }
+        const int chunk = std::max(1, cells / static_cast<int>(4 * threads));
+        const int chunks = (cells + chunk - 1) / chunk;
+        pool.parallel_for(0, chunks, [&](std::size_t c) {
+            const int begin = static_cast<int>(c) * chunk;
+            const int end = std::min(cells, begin + chunk);
+            for (int i = begin; i < end; i++) {
+                f(i, i + k);
+            }
+        });
+    }
+}
+
+}  // namespace detail
+
+}  // namespace rna_2d
+
+}  // namespace toolbox
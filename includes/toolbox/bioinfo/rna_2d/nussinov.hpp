@@ -1,56 +1,37 @@
 #pragma once
 
 #include <algorithm>
+#include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <stack>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "toolbox/bioinfo/rna_2d/base_pair.hpp"
+#include "toolbox/bioinfo/rna_2d/fold_table.hpp"
+#include "toolbox/parallel/thread_pool/thread_pool.hpp"
+
 namespace toolbox {
 
 namespace rna_2d {
 
-bool is_base_pair(char a, char b) {
-    if (a > b) {
-        std::swap(a, b);
-    }
-    return ((a == 'A' && b == 'U') || (a == 'C' && b == 'G') || (a == 'G' && b == 'U'));
-}
-
-/**
- * @brief Nussinov algorithm for RNA secondary structure prediction.
- * @param seq The RNA sequence.
- * @param dp The DP table.
- * @return The maximum number of base pairs.
- * @note O(n^3) time complexity and O(n^2) space complexity.
- */
-int nussinov_dp(const std::string &seq, std::vector<std::vector<int>> &dp) {
-    int n = seq.size();
-    dp.resize(n, std::vector<int>(n, 0));
-    for (int k = 1; k < n; k++) {
-        for (int i = 0; i < n - k; i++) {
-            int j = i + k;
-            dp[i][j] = dp[i + 1][j - 1] + is_base_pair(seq[i], seq[j]);
-            for (int l = i; l < j; l++) {
-                dp[i][j] = std::max(dp[i][j], dp[i][l] + dp[l + 1][j]);
-            }
-        }
-    }
-    return dp[0][n - 1];
-}
+namespace detail {
 
 /**
- * @brief Nussinov traceback.
+ * @brief Nussinov traceback over any table layout.
  * @param seq The RNA sequence.
- * @param dp The DP table.
+ * @param dp dp(i, j) for i <= j; it is also called with i = j + 1 and must return 0 there.
+ * @param min_loop The minimum number of unpaired bases enclosed by a pair.
  * @return The RNA secondary structure.
- * @note O(n^2) time complexity.
  */
-std::string nussinov_traceback(const std::string &seq, const std::vector<std::vector<int>> &dp) {
+template <typename Table>
+std::string nussinov_walk(const std::string &seq, Table dp, int min_loop) {
     std::string structure;
     int n = seq.size();
     structure.resize(n, '.');
+    const std::vector<uint8_t> code = encode_rna(seq);
     std::stack<std::pair<int, int>> st;
     st.push({0, n - 1});
     while (!st.empty()) {
@@ -60,15 +41,17 @@ std::string nussinov_traceback(const std::string &seq, const std::vector<std::ve
         if (left >= right) {
             continue;
         }
-        if (dp[left][right] == dp[left + 1][right - 1] + is_base_pair(seq[left], seq[right])) {
-            if (is_base_pair(seq[left], seq[right])) {
+        const bool paired =
+            right - left > min_loop && PAIR_TYPES[code[left]][code[right]] != 0;
+        if (dp(left, right) == dp(left + 1, right - 1) + paired) {
+            if (paired) {
                 structure[left] = '(';
                 structure[right] = ')';
             }
             st.push({left + 1, right - 1});
         } else {
             for (int mid = left; mid < right; mid++) {
-                if (dp[left][right] == dp[left][mid] + dp[mid + 1][right]) {
+                if (dp(left, right) == dp(left, mid) + dp(mid + 1, right)) {
                     st.push({mid + 1, right});
                     st.push({left, mid});
                     break;
@@ -79,16 +62,111 @@ std::string nussinov_traceback(const std::string &seq, const std::vector<std::ve
     return structure;
 }
 
+}  // namespace detail
+
 /**
  * @brief Nussinov algorithm for RNA secondary structure prediction.
  * @param seq The RNA sequence.
+ * @param dp The DP table.
+ * @param min_loop The minimum number of unpaired bases enclosed by a pair (hairpin loop length;
+ * 3 is the usual biological value).
+ * @return The maximum number of base pairs.
+ * @note dp[i][j] = max(dp[i + 1][j], dp[i + 1][p - 1] + 1 + dp[p + 1][j]) over the positions p
+ * that can pair with i: the same values as the classic max over all split points, but only the
+ * partners of i are visited (detail::pair_candidates, about 3/8 of a random sequence). The
+ * rows are filled from the bottom up, so each partner updates row i from row p + 1 with one
+ * contiguous (vectorisable) pass instead of reading a column per cell.
+ * @note O(n^3) time complexity and O(n^2) space complexity.
+ */
+int nussinov_dp(const std::string &seq, std::vector<std::vector<int>> &dp, int min_loop = 0) {
+    int n = seq.size();
+    dp.assign(n, std::vector<int>(n, 0));
+    if (n == 0) {
+        return 0;
+    }
+    const std::vector<uint8_t> code = detail::encode_rna(seq);
+    const detail::pair_candidates partners(code);
+    // Rows from the bottom up: every term of row i comes from the rows below it.
+    for (int i = n - 2; i >= 0; i--) {
+        std::vector<int> &row = dp[i];
+        const std::vector<int> &below = dp[i + 1];
+        // i unpaired.
+        std::copy(below.begin() + i + 1, below.end(), row.begin() + i + 1);
+        const int *last = partners.end(i);
+        for (const int *it = partners.begin(i, i + min_loop + 1); it != last; it++) {
+            // i paired with p: dp[i + 1][p - 1] + 1 + dp[p + 1][j] for every j >= p, a
+            // contiguous row update (dp[i + 1][i] and dp[p + 1][p] are lower-triangle zeros).
+            const int p = *it;
+            const int c = below[p - 1] + 1;
+            row[p] = std::max(row[p], c);
+            if (p + 1 < n) {
+                const std::vector<int> &after = dp[p + 1];
+                for (int j = p + 1; j < n; j++) {
+                    row[j] = std::max(row[j], c + after[j]);
+                }
+            }
+        }
+    }
+    return dp[0][n - 1];
+}
+
+/**
+ * @brief Nussinov traceback.
+ * @param seq The RNA sequence.
+ * @param dp The DP table.
+ * @param min_loop The minimum number of unpaired bases enclosed by a pair.
+ * @return The RNA secondary structure.
+ * @note O(n^2) time complexity.
+ */
+std::string nussinov_traceback(const std::string &seq, const std::vector<std::vector<int>> &dp,
+                               int min_loop = 0) {
+    return detail::nussinov_walk(seq, [&dp](int i, int j) { return dp[i][j]; }, min_loop);
+}
+
+/**
+ * @brief Nussinov algorithm for RNA secondary structure prediction.
+ * @param seq The RNA sequence.
+ * @param min_loop The minimum number of unpaired bases enclosed by a pair.
  * @return The RNA secondary structure.
  * @note O(n^3) time complexity and O(n^2) space complexity.
  */
-std::string nussinov_all(const std::string &seq) {
+std::string nussinov_all(const std::string &seq, int min_loop = 0) {
     std::vector<std::vector<int>> dp;
-    nussinov_dp(seq, dp);
-    return nussinov_traceback(seq, dp);
+    nussinov_dp(seq, dp, min_loop);
+    return nussinov_traceback(seq, dp, min_loop);
+}
+
+/**
+ * @brief Nussinov algorithm with a cache-friendly table, parallel over diagonals.
+ * @param seq The RNA sequence (at most 65535 bases).
+ * @param structure The RNA secondary structure.
+ * @param min_loop The minimum number of unpaired bases enclosed by a pair.
+ * @param pool The threads the cells of each diagonal are shared between.
+ * @return The maximum number of base pairs.
+ * @note Same recurrence, value and structure as nussinov_dp and nussinov_traceback. The table is
+ * a 16-bit detail::fold_table (the triangle plus its transpose), so the bifurcation max over l
+ * of dp[i][l] + dp[l + 1][j] is a vectorised reduction of two contiguous arrays, and the cells
+ * of one diagonal are computed in parallel. The dense reduction is kept here: a SIMD pass over
+ * all split points is cheaper than a scalar gather over the pair candidates.
+ * @note [Complexity]: O(n^3) time complexity and O(n^2) space complexity (two triangles of 2-byte
+ * cells, about 2n^2 bytes: half the n x n int table of nussinov_dp).
+ */
+int nussinov_fold(const std::string &seq, std::string &structure, int min_loop = 0,
+                  parallel::thread_pool &pool = parallel::default_thread_pool()) {
+    const int n = static_cast<int>(seq.size());
+    assert(n <= 65535);
+    const std::vector<uint8_t> code = detail::encode_rna(seq);
+    detail::fold_table<int16_t> dp(n);
+    detail::for_each_diagonal(n, 1, pool, [&](int i, int j) {
+        const int16_t inner = j - i >= 2 ? dp.get(i + 1, j - 1) : 0;
+        const bool paired = j - i > min_loop && detail::PAIR_TYPES[code[i]][code[j]] != 0;
+        // dp[i][l] for l = i..j-1 and dp[l + 1][j] for l + 1 = i + 1..j.
+        dp.set(i, j, detail::max_plus(dp.row(i) + i, dp.col(j) + i + 1, j - i, inner + paired));
+    });
+    structure = detail::nussinov_walk(
+        seq, [&dp](int i, int j) { return i < j ? static_cast<int>(dp.get(i, j)) : 0; },
+        min_loop);
+    return n == 0 ? 0 : dp.get(0, n - 1);
 }
 
 }  // namespace rna_2d
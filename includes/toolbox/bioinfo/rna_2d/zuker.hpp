@@ -0,0 +1,367 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "toolbox/bioinfo/rna_2d/base_pair.hpp"
+#include "toolbox/bioinfo/rna_2d/fold_table.hpp"
+#include "toolbox/parallel/thread_pool/thread_pool.hpp"
+
+namespace toolbox {
+
+namespace rna_2d {
+
+/**
+ * @brief Parameters of the nearest-neighbour energy model of zuker_fold, in dcal/mol
+ * (-340 = -3.4 kcal/mol).
+ * @note The defaults are the Turner 2004 stacking energies and hairpin / bulge / interior loop
+ * initiation energies at 37 C, with the Turner 1999 multiloop parameters. The model is
+ * simplified: dangles, terminal mismatches, special hairpins and the 1x1 / 1x2 / 2x2 interior
+ * loop tables are not included (1x1 and 1x2 loops take the size-4 initiation energy).
+ */
+struct energy_model {
+    // Pair types: 1 CG, 2 GC, 3 GU, 4 UG, 5 AU, 6 UA, 0 no pair. stack[t1][t2] is the stack of
+    // the pair (i, j) of type t1 on the pair (i + 1, j - 1), whose type t2 is read from j - 1
+    // to i + 1 (e.g. 5'-CG-3' / 3'-GC-5' is stack[CG][CG]).
+    int stack[7][7] = {
+        {0, 0, 0, 0, 0, 0, 0},
+        //    CG    GC    GU    UG    AU    UA
+        {0, -240, -330, -210, -140, -210, -210},  // CG
+        {0, -330, -340, -250, -150, -220, -240},  // GC
+        {0, -210, -250, 130, -50, -140, -130},    // GU
+        {0, -140, -150, -50, 30, -60, -100},      // UG
+        {0, -210, -220, -140, -60, -110, -90},    // AU
+        {0, -210, -240, -130, -100, -90, -130},   // UA
+    };
+    // Initiation energies by the number of unpaired bases (0..30). The sizes that cannot occur
+    // are never read.
+    int hairpin[31] = {0,   0,   0,   540, 560, 570, 540, 600, 550, 640, 650,
+                       660, 670, 678, 686, 694, 701, 707, 713, 719, 725, 730,
+                       735, 740, 744, 749, 753, 757, 761, 765, 769};
+    int bulge[31] = {0,   380, 280, 320, 360, 400, 440, 459, 470, 480, 490,
+                     500, 510, 519, 527, 534, 541, 548, 554, 560, 565, 571,
+                     576, 580, 585, 589, 594, 598, 602, 605, 609};
+    int interior[31] = {0,   0,   110, 110, 110, 200, 200, 210, 230, 240, 250,
+                        260, 270, 280, 290, 290, 300, 310, 310, 320, 330, 330,
+                        340, 340, 350, 350, 350, 360, 360, 370, 370};
+    // Loops longer than 30 unpaired bases: table[30] + lxc * ln(size / 30).
+    double lxc = 107.856;
+    // Interior loop asymmetry: min(max_ninio, ninio * |u1 - u2|).
+    int ninio = 60;
+    int max_ninio = 300;
+    // Penalty of an AU or GU pair closing a helix (exterior, multi, bulge and triloop ends).
+    int terminal_au = 50;
+    // Multiloop: ml_closing + ml_intern per branch (closing pair included) + ml_base per
+    // unpaired base.
+    int ml_closing = 340;
+    int ml_intern = 40;
+    int ml_base = 0;
+};
+
+namespace detail {
+
+// Energies of impossible structures; twice this value still fits an int.
+const int ENERGY_INF = 10000000;
+// The longest bulge or interior loop (unpaired bases on both sides) considered by zuker_fold.
+const int MAX_LOOP = 30;
+// The smallest hairpin loop.
+const int MIN_HAIRPIN = 3;
+
+inline int terminal_penalty(const energy_model &model, int type) {
+    return type > 2 ? model.terminal_au : 0;
+}
+
+inline int loop_initiation(const energy_model &model, const int (&table)[31], int size) {
+    if (size <= MAX_LOOP) {
+        return table[size];
+    }
+    return table[MAX_LOOP] +
+           static_cast<int>(model.lxc * std::log(static_cast<double>(size) / MAX_LOOP));
+}
+
+/**
+ * @brief Energy of the hairpin loop closed by a pair of type type with size unpaired bases.
+ */
+inline int hairpin_energy(const energy_model &model, int type, int size) {
+    if (size < MIN_HAIRPIN) {
+        return ENERGY_INF;
+    }
+    int e = loop_initiation(model, model.hairpin, size);
+    if (size == MIN_HAIRPIN) {
+        e += terminal_penalty(model, type);
+    }
+    return e;
+}
+
+/**
+ * @brief Energy of the stack, bulge or interior loop between the outer pair (i, j) of type
+ * type and the inner pair (p, q) of reversed type inner, with u1 = p - i - 1 and
+ * u2 = j - q - 1 unpaired bases.
+ */
+inline int interior_energy(const energy_model &model, int type, int inner, int u1, int u2) {
+    if (u1 == 0 && u2 == 0) {
+        return model.stack[type][inner];
+    }
+    if (u1 == 0 || u2 == 0) {
+        const int size = u1 + u2;
+        int e = loop_initiation(model, model.bulge, size);
+        if (size == 1) {
+            e += model.stack[type][inner];
+        } else {
+            e += terminal_penalty(model, type) + terminal_penalty(model, inner);
+        }
+        return e;
+    }
+    return loop_initiation(model, model.interior, u1 + u2) +
+           std::min(model.max_ninio, model.ninio * std::abs(u1 - u2));
+}
+
+}  // namespace detail
+
+/**
+ * @brief Free energy of an RNA secondary structure under the model of zuker_fold.
+ * @param seq The RNA sequence.
+ * @param structure The RNA secondary structure (dot-bracket, balanced, canonical pairs).
+ * @param model The energy parameters.
+ * @return The free energy in dcal/mol (>= detail::ENERGY_INF for a hairpin shorter than 3).
+ * @note Sum of the loop energies: exterior loop, hairpins, stacks, bulges, interior loops and
+ * multiloops. zuker_fold returns the minimum of this function over all structures without
+ * bulges or interior loops longer than 30 unpaired bases.
+ * @note [Complexity]: O(n) time complexity.
+ */
+int structure_energy(const std::string &seq, const std::string &structure,
+                     const energy_model &model = energy_model()) {
+    const int n = static_cast<int>(seq.size());
+    assert(structure.size() == seq.size());
+    std::vector<int> partner(n, -1);
+    std::stack<int> open;
+    for (int k = 0; k < n; k++) {
+        if (structure[k] == '(') {
+            open.push(k);
+        } else if (structure[k] == ')') {
+            assert(!open.empty());
+            partner[k] = open.top();
+            partner[open.top()] = k;
+            open.pop();
+        }
+    }
+    assert(open.empty());
+    int e = 0;
+    for (int k = 0; k < n; k = partner[k] > k ? partner[k] + 1 : k + 1) {
+        if (partner[k] > k) {
+            e += detail::terminal_penalty(model, detail::pair_type(seq[k], seq[partner[k]]));
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        const int j = partner[i];
+        if (j < i) {
+            continue;
+        }
+        const int type = detail::pair_type(seq[i], seq[j]);
+        assert(type != 0);
+        int branches = 0;
+        int unpaired = 0;
+        int stems = 0;
+        int p = -1;
+        for (int k = i + 1; k < j; k = partner[k] > k ? partner[k] + 1 : k + 1) {
+            if (partner[k] > k) {
+                branches++;
+                p = k;
+                stems += detail::terminal_penalty(model,
+                                                  detail::pair_type(seq[k], seq[partner[k]]));
+            } else {
+                unpaired++;
+            }
+        }
+        if (branches == 0) {
+            e += detail::hairpin_energy(model, type, j - i - 1);
+        } else if (branches == 1) {
+            const int q = partner[p];
+            e += detail::interior_energy(model, type, detail::pair_type(seq[q], seq[p]),
+                                         p - i - 1, j - q - 1);
+        } else {
+            e += model.ml_closing + model.ml_intern * (branches + 1) + model.ml_base * unpaired +
+                 detail::terminal_penalty(model, type) + stems;
+        }
+    }
+    return e;
+}
+
+/**
+ * @brief Zuker algorithm: minimum free energy RNA secondary structure.
+ * @param seq The RNA sequence.
+ * @param structure The RNA secondary structure of minimum free energy.
+ * @param model The energy parameters.
+ * @param pool The threads the cells of each diagonal are shared between.
+ * @return The minimum free energy in dcal/mol (0 for the open chain).
+ * @note V[i][j] is the best energy of [i, j] closed by the pair (i, j): a hairpin, a stack /
+ * bulge / interior loop on an inner pair (at most 30 unpaired bases), or a multiloop. WM[i][j]
+ * is the best energy of [i, j] as part of a multiloop (at least one branch). Both live in
+ * detail::fold_table, so the multiloop bifurcation min over u of WM[i][u] + WM[u + 1][j] is a
+ * vectorised reduction of two contiguous arrays, and the cells of one diagonal are computed in
+ * parallel as in nussinov_fold. The exterior loop is a final O(n^2) pass.
+ * @note [Complexity]: O(n^3 + 30^2 n^2) time complexity and O(n^2) space complexity.
+ */
+int zuker_fold(const std::string &seq, std::string &structure,
+               const energy_model &model = energy_model(),
+               parallel::thread_pool &pool = parallel::default_thread_pool()) {
+    const int n = static_cast<int>(seq.size());
+    const int INF = detail::ENERGY_INF;
+    detail::fold_table<int> V(n, INF), WM(n, INF);
+    const std::vector<uint8_t> code = detail::encode_rna(seq);
+    const auto closed = [&](int i, int j, int type) {
+        int e = detail::hairpin_energy(model, type, j - i - 1);
+        // No branch on whether (p, q) pairs: V[p][q] is INF then and the loop energies of a
+        // non-pair (stack[type][0] = 0, initiations) are not negative, so it never wins.
+        for (int p = i + 1; p <= std::min(i + 1 + detail::MAX_LOOP, j - 2 - detail::MIN_HAIRPIN);
+             p++) {
+            const int u1 = p - i - 1;
+            const int *vp = V.row(p);
+            const int cp = code[p];
+            for (int q = j - 1; q > p + detail::MIN_HAIRPIN && u1 + j - q - 1 <= detail::MAX_LOOP;
+                 q--) {
+                const int inner = detail::PAIR_TYPES[code[q]][cp];
+                e = std::min(e, vp[q] + detail::interior_energy(model, type, inner, u1, j - q - 1));
+            }
+        }
+        // Two branches of at least MIN_HAIRPIN + 2 bases each.
+        if (j - i - 1 >= 2 * (detail::MIN_HAIRPIN + 2)) {
+            const int split = detail::min_plus(WM.row(i + 1) + i + 1, WM.col(j - 1) + i + 2,
+                                               j - i - 2, INF);
+            if (split < INF) {
+                e = std::min(e, split + model.ml_closing + model.ml_intern +
+                                    detail::terminal_penalty(model, type));
+            }
+        }
+        return e;
+    };
+    detail::for_each_diagonal(n, detail::MIN_HAIRPIN + 1, pool, [&](int i, int j) {
+        const int type = detail::pair_type(seq[i], seq[j]);
+        int wm = std::min(WM.get(i + 1, j), WM.get(i, j - 1)) + model.ml_base;
+        if (type != 0) {
+            const int v = closed(i, j, type);
+            V.set(i, j, v);
+            if (v < INF) {
+                wm = std::min(wm, v + model.ml_intern + detail::terminal_penalty(model, type));
+            }
+        }
+        wm = detail::min_plus(WM.row(i) + i, WM.col(j) + i + 1, j - i, wm);
+        WM.set(i, j, std::min(wm, INF));
+    });
+    // F[j]: the best energy of the prefix [0, j) as an exterior loop.
+    std::vector<int> F(n + 1, 0);
+    for (int j = 1; j <= n; j++) {
+        F[j] = F[j - 1];
+        for (int i = 0; i + detail::MIN_HAIRPIN + 1 < j; i++) {
+            if (V.get(i, j - 1) < INF) {
+                const int type = detail::pair_type(seq[i], seq[j - 1]);
+                F[j] = std::min(F[j], F[i] + V.get(i, j - 1) +
+                                          detail::terminal_penalty(model, type));
+            }
+        }
+    }
+
+    structure.assign(n, '.');
+    enum { LOOP_V, LOOP_WM };
+    struct segment {
+        int loop, i, j;
+    };
+    std::stack<segment> todo;
+    for (int j = n; j > 0;) {
+        if (F[j] == F[j - 1]) {
+            j--;
+            continue;
+        }
+        for (int i = 0; i + detail::MIN_HAIRPIN + 1 < j; i++) {
+            const int type = detail::pair_type(seq[i], seq[j - 1]);
+            if (V.get(i, j - 1) < INF &&
+                F[j] == F[i] + V.get(i, j - 1) + detail::terminal_penalty(model, type)) {
+                todo.push({LOOP_V, i, j - 1});
+                j = i;
+                break;
+            }
+        }
+    }
+    while (!todo.empty()) {
+        const segment s = todo.top();
+        todo.pop();
+        const int i = s.i;
+        const int j = s.j;
+        const int type = detail::pair_type(seq[i], seq[j]);
+        if (s.loop == LOOP_WM) {
+            const int e = WM.get(i, j);
+            if (type != 0 && e == V.get(i, j) + model.ml_intern +
+                                      detail::terminal_penalty(model, type)) {
+                todo.push({LOOP_V, i, j});
+            } else if (e == WM.get(i + 1, j) + model.ml_base) {
+                todo.push({LOOP_WM, i + 1, j});
+            } else if (e == WM.get(i, j - 1) + model.ml_base) {
+                todo.push({LOOP_WM, i, j - 1});
+            } else {
+                for (int u = i; u < j; u++) {
+                    if (e == WM.get(i, u) + WM.get(u + 1, j)) {
+                        todo.push({LOOP_WM, i, u});
+                        todo.push({LOOP_WM, u + 1, j});
+                        break;
+                    }
+                }
+            }
+            continue;
+        }
+        structure[i] = '(';
+        structure[j] = ')';
+        const int e = V.get(i, j);
+        if (e == detail::hairpin_energy(model, type, j - i - 1)) {
+            continue;
+        }
+        bool found = false;
+        for (int p = i + 1; !found && p <= j - 2 - detail::MIN_HAIRPIN; p++) {
+            const int u1 = p - i - 1;
+            for (int q = j - 1; q > p + detail::MIN_HAIRPIN && u1 + j - q - 1 <= detail::MAX_LOOP;
+                 q--) {
+                const int inner = detail::pair_type(seq[q], seq[p]);
+                if (inner != 0 && V.get(p, q) < INF &&
+                    e == V.get(p, q) + detail::interior_energy(model, type, inner, u1, j - q - 1)) {
+                    todo.push({LOOP_V, p, q});
+                    found = true;
+                    break;
+                }
+            }
+            if (u1 == detail::MAX_LOOP) {
+                break;
+            }
+        }
+        const int closing = model.ml_closing + model.ml_intern +
+                            detail::terminal_penalty(model, type);
+        for (int u = i + 1; !found && u < j - 1; u++) {
+            if (e == WM.get(i + 1, u) + WM.get(u + 1, j - 1) + closing) {
+                todo.push({LOOP_WM, i + 1, u});
+                todo.push({LOOP_WM, u + 1, j - 1});
+                found = true;
+            }
+        }
+    }
+    return F[n];
+}
+
+/**
+ * @brief Zuker algorithm: minimum free energy RNA secondary structure.
+ * @param seq The RNA sequence.
+ * @return The RNA secondary structure of minimum free energy.
+ * @note [Complexity]: O(n^3 + 30^2 n^2) time complexity and O(n^2) space complexity.
+ */
+std::string zuker_all(const std::string &seq) {
+    std::string structure;
+    zuker_fold(seq, structure);
+    return structure;
+}
+
+}  // namespace rna_2d
+
+}  // namespace toolbox
@@ -0,0 +1,2 @@
+#pragma once
+#include "toolbox/parallel/thread_pool/thread_pool.hpp"
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace toolbox {
+
+namespace parallel {
+
+/**
+ * @brief Fixed-size pool of worker threads sharing one job queue.
+ * @note parallel_for blocks until the whole range is done, and the calling thread takes part in
+ * the loop. A thread waiting for its own loop keeps running queued jobs instead of sleeping, so
+ * parallel_for may be called from inside another parallel_for without deadlocking.
+ */
+class thread_pool {
+ public:
+    /**
+     * @brief Starts the workers.
+     * @param num_threads The total number of threads taking part in a parallel_for, including
+     * the caller (0 means std::thread::hardware_concurrency()).
+     */
+    explicit thread_pool(std::size_t num_threads = 0) : _stop(false) {
+        if (num_threads == 0) {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (std::size_t t = 1; t < num_threads; t++) {
+            _workers.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _cv.notify_all();
+        for (std::thread &w : _workers) {
+            w.join();
+        }
+    }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    /**
+     * @brief The number of threads taking part in a parallel_for, including the caller.
+     */
+    std::size_t size() const { return _workers.size() + 1; }
+
+    /**
+     * @brief Calls f(i) for every i in [begin, end) and waits for all of them.
+     * @param begin The first index.
+     * @param end One past the last index.
+     * @param f The loop body. Calls with different indices may run concurrently.
+     * @note Indices are handed out one at a time from a shared counter, so uneven iterations are
+     * balanced automatically; make each iteration a chunk of work rather than a single element.
+     */
+    template <typename F>
+    void parallel_for(std::size_t begin, std::size_t end, F f) {
+        if (begin >= end) {
+            return;
+        }
+        if (_workers.empty() || end - begin == 1) {
+            for (std::size_t i = begin; i < end; i++) {
+                f(i);
+            }
+            return;
+        }
+        std::atomic<std::size_t> next(begin);
+        std::atomic<std::size_t> pending(0);
+        auto run = [&] {
+            for (std::size_t i = next++; i < end; i = next++) {
+                f(i);
+            }
+        };
+        const std::size_t helpers = std::min(_workers.size(), end - begin - 1);
+        pending = helpers;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (std::size_t h = 0; h < helpers; h++) {
+                _jobs.emplace_back([&] {
+                    run();
+                    if (--pending == 0) {
+                        std::lock_guard<std::mutex> done_lock(_mutex);
+                        _done.notify_all();
+                    }
+                });
+            }
+        }
+        _cv.notify_all();
+        run();
+        // Help with queued jobs (possibly our own helpers nobody has started yet) while waiting.
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (pending != 0) {
+            if (!_jobs.empty()) {
+                std::function<void()> job = std::move(_jobs.front());
+                _jobs.pop_front();
+                lock.unlock();
+                job();
+                lock.lock();
+            } else {
+                _done.wait(lock);
+            }
+        }
+    }
+
+ private:
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _jobs;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::condition_variable _done;
+    bool _stop;
+
+    void worker_loop() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true) {
+            _cv.wait(lock, [this] { return _stop || !_jobs.empty(); });
+            if (_jobs.empty()) {
+                return;
+            }
+            std::function<void()> job = std::move(_jobs.front());
+            _jobs.pop_front();
+            lock.unlock();
+            job();
+            lock.lock();
+        }
+    }
+};
+
+/**
+ * @brief The process-wide pool used by the parallel algorithms when no pool is given.
+ */
+inline thread_pool &default_thread_pool() {
+    static thread_pool pool;
+    return pool;
+}
+
+}  // namespace parallel
+
+}  // namespace toolbox
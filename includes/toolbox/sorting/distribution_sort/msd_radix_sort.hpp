@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "toolbox/sorting/insertion_sort/insertion_sort.hpp"
+
+namespace toolbox {
+namespace sorting {
+
+namespace detail {
+
+static const std::size_t MSD_RADIX_SMALL = 32;
+// Bucket 0 holds the strings that end at the current depth, bucket c + 1 those with byte c.
+static const std::size_t MSD_RADIX_BUCKETS = 257;
+
+struct MsdIdentity {
+    template <typename T>
+    const T &operator()(const T &x) const {
+        return x;
+    }
+};
+
+// Every string of a bucket at depth d shares its first d bytes, so only the suffixes differ.
+template <typename KeyFn>
+struct MsdSuffixLess {
+    KeyFn key;
+    std::size_t depth;
+    MsdSuffixLess(KeyFn k, std::size_t d) : key(k), depth(d) {}
+    template <typename T>
+    bool operator()(const T &a, const T &b) const {
+        decltype(auto) ka = key(a);
+        decltype(auto) kb = key(b);
+        return std::string_view(ka).substr(depth) < std::string_view(kb).substr(depth);
+    }
+};
+
+struct MsdRange {
+    std::size_t lo;
+    std::size_t hi;
+    std::size_t depth;
+};
+
+template <typename RandomIt, typename KeyFn>
+void msd_radix_sort_impl(RandomIt first, RandomIt last, KeyFn key) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    // The digit of each element at the current depth, so that the permutation below does not
+    // chase the string pointers again.
+    std::vector<uint16_t> digit(n);
+    // An explicit stack: long shared prefixes would otherwise recurse once per byte.
+    std::vector<MsdRange> stack(1, MsdRange{0, n, 0});
+    while (!stack.empty()) {
+        const MsdRange r = stack.back();
+        stack.pop_back();
+        if (r.hi - r.lo < MSD_RADIX_SMALL) {
+            insertion_sort(first + r.lo, first + r.hi, MsdSuffixLess<KeyFn>(key, r.depth));
+            continue;
+        }
+        std::size_t count[MSD_RADIX_BUCKETS] = {0};
+        for (std::size_t i = r.lo; i < r.hi; i++) {
+            decltype(auto) k = key(first[i]);
+            const std::string_view s(k);
+            digit[i] = r.depth < s.size()
+                           ? static_cast<uint16_t>(static_cast<unsigned char>(s[r.depth]) + 1)
+                           : uint16_t(0);
+            count[digit[i]]++;
+        }
+        if (count[digit[r.lo]] == r.hi - r.lo) {
+            if (digit[r.lo] != 0) {
+                stack.push_back(MsdRange{r.lo, r.hi, r.depth + 1});
+            }
+            continue;
+        }
+        // American flag sort: each element is swapped straight into the next free slot of its
+        // bucket, so the buckets are formed in place without a second buffer.
+        std::size_t head[MSD_RADIX_BUCKETS], tail[MSD_RADIX_BUCKETS];
+        std::size_t pos = r.lo;
+        for (std::size_t b = 0; b < MSD_RADIX_BUCKETS; b++) {
+            head[b] = pos;
+            pos += count[b];
+            tail[b] = pos;
+        }
+        for (std::size_t b = 0; b < MSD_RADIX_BUCKETS; b++) {
+            while (head[b] < tail[b]) {
+                const std::size_t c = digit[head[b]];
+                if (c == b) {
+                    head[b]++;
+                } else {
+                    std::iter_swap(first + head[b], first + head[c]);
+                    std::swap(digit[head[b]], digit[head[c]]);
+                    head[c]++;
+                }
+            }
+        }
+        for (std::size_t b = 1, lo = r.lo + count[0]; b < MSD_RADIX_BUCKETS; lo += count[b++]) {
+            if (count[b] > 1) {
+                stack.push_back(MsdRange{lo, lo + count[b], r.depth + 1});
+            }
+        }
+    }
+}
+
+}  // namespace detail
+
+template <typename RandomIt, typename KeyFn>
+void msd_radix_sort(RandomIt first, RandomIt last, KeyFn key) {
+    detail::msd_radix_sort_impl(first, last, key);
+}
+
+template <typename RandomIt>
+void msd_radix_sort(RandomIt first, RandomIt last) {
+    detail::msd_radix_sort_impl(first, last, detail::MsdIdentity());
+}
+
+}  // namespace sorting
+}  // namespace toolbox
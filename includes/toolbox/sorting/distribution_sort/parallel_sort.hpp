@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "toolbox/parallel/thread_pool/thread_pool.hpp"
+#include "toolbox/sorting/hybrid_sort/intro_sort.hpp"
+
+namespace toolbox {
+namespace sorting {
+
+namespace detail {
+
+// Ranges up to this size are left to intro_sort.
+static const std::size_t SAMPLE_SORT_BASE = 1 << 14;
+static const std::size_t SAMPLE_SORT_MAX_BUCKETS = 256;
+static const std::size_t SAMPLE_SORT_OVERSAMPLE = 16;
+static const int SAMPLE_SORT_MAX_DEPTH = 16;
+
+// Super scalar sample sort classifier: the k - 1 splitters are stored as an implicit binary
+// search tree, so a bucket is found with log2(k) comparisons and no unpredictable branches. An
+// element lands in bucket b = the number of splitters less than it. If the sample had
+// duplicates, each splitter also gets an equality bucket (2b + 1) for the elements equal to it,
+// which need no further sorting.
+template <typename T, typename Compare>
+class SampleSortClassifier {
+ public:
+    SampleSortClassifier(std::vector<T> &sorted_sample, std::size_t k, Compare comp)
+        : _k(k), _log_k(static_cast<std::size_t>(std::countr_zero(k))), _equality(false),
+          _comp(comp) {
+        const std::size_t step = sorted_sample.size() / k;
+        for (std::size_t i = 1; i < k; i++) {
+            _splitters.push_back(sorted_sample[i * step - 1]);
+        }
+        for (std::size_t i = 1; i < _splitters.size(); i++) {
+            _equality |= !comp(_splitters[i - 1], _splitters[i]);
+        }
+        _tree.resize(k, _splitters[0]);
+        build(1, 0, k - 1);
+    }
+
+    std::size_t buckets() const { return _equality ? 2 * _k : _k; }
+
+    bool is_equality_bucket(std::size_t b) const { return _equality && (b & 1); }
+
+    std::size_t operator()(const T &x) const {
+        std::size_t i = 1;
+        for (std::size_t l = 0; l < _log_k; l++) {
+            i = 2 * i + (_comp(_tree[i], x) ? 1 : 0);
+        }
+        const std::size_t b = i - _k;
+        if (!_equality) {
+            return b;
+        }
+        return 2 * b + (b + 1 < _k && !_comp(x, _splitters[b]) ? 1 : 0);
+    }
+
+ private:
+    std::size_t _k;
+    std::size_t _log_k;
+    bool _equality;
+    Compare _comp;
+    std::vector<T> _splitters;
+    std::vector<T> _tree;
+
+    void build(std::size_t node, std::size_t lo, std::size_t hi) {
+        if (lo >= hi) {
+            return;
+        }
+        const std::size_t mid = lo + (hi - lo) / 2;
+        _tree[node] = _splitters[mid];
+        build(2 * node, lo, mid);
+        build(2 * node + 1, mid + 1, hi);
+    }
+};
+
+// Storage for the n elements of the scatter buffer, left uninitialized: the scatter at depth 0
+// constructs every element of it, so T need not be default constructible. The elements are only
+// destroyed once the sort has returned and called set_constructed().
+template <typename T>
+class SampleSortBuffer {
+ public:
+    explicit SampleSortBuffer(std::size_t n)
+        : _n(n), _data(std::allocator<T>().allocate(n)), _constructed(false) {}
+    SampleSortBuffer(const SampleSortBuffer &) = delete;
+    SampleSortBuffer &operator=(const SampleSortBuffer &) = delete;
+    ~SampleSortBuffer() {
+        if (_constructed) {
+            std::destroy_n(_data, _n);
+        }
+        std::allocator<T>().deallocate(_data, _n);
+    }
+
+    T *data() const { return _data; }
+    void set_constructed() { _constructed = true; }
+
+ private:
+    std::size_t _n;
+    T *_data;
+    bool _constructed;
+};
+
+// Sorts [first, first + n) using buf[0, n) and oracle[0, n) as scratch; at depth 0, buf is
+// uninitialized. The scatter keeps the
+// input order within each bucket, and both the sample and the recursion depend only on the data,
+// so the result is the same for every number of threads.
+template <typename RandomIt, typename T, typename Compare>
+void sample_sort_impl(RandomIt first, std::size_t n, T *buf, uint16_t *oracle, Compare comp,
+                      parallel::thread_pool &pool, int depth) {
+    if (n <= SAMPLE_SORT_BASE || depth >= SAMPLE_SORT_MAX_DEPTH) {
+        intro_sort(first, first + n, comp);
+        return;
+    }
+    const std::size_t k = std::clamp<std::size_t>(std::bit_floor(n / 256), 2,
+                                                  SAMPLE_SORT_MAX_BUCKETS);
+    std::vector<T> sample;
+    sample.reserve(k * SAMPLE_SORT_OVERSAMPLE);
+    uint64_t state = n;
+    for (std::size_t i = 0; i < k * SAMPLE_SORT_OVERSAMPLE; i++) {
+        // splitmix64: a fixed pseudo-random sequence, so the splitters are reproducible.
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        sample.push_back(first[(z ^ (z >> 31)) % n]);
+    }
+    intro_sort(sample.begin(), sample.end(), comp);
+    const SampleSortClassifier<T, Compare> classify(sample, k, comp);
+    const std::size_t nb = classify.buckets();
+
+    const std::size_t stripes = std::max<std::size_t>(1, std::min(pool.size(),
+                                                                   n / SAMPLE_SORT_BASE));
+    const std::size_t stripe_len = (n + stripes - 1) / stripes;
+    std::vector<std::size_t> count(stripes * nb, 0);
+    pool.parallel_for(0, stripes, [&](std::size_t t) {
+        std::size_t *c = &count[t * nb];
+        for (std::size_t i = t * stripe_len, end = std::min(n, (t + 1) * stripe_len); i < end;
+             i++) {
+            const std::size_t b = classify(first[i]);
+            oracle[i] = static_cast<uint16_t>(b);
+            c[b]++;
+        }
+    });
+    // Bucket b of stripe t goes after bucket b of the stripes before it.
+    std::vector<std::size_t> bucket_start(nb + 1, 0);
+    for (std::size_t b = 0, sum = 0; b < nb; b++) {
+        bucket_start[b] = sum;
+        for (std::size_t t = 0; t < stripes; t++) {
+            const std::size_t c = count[t * nb + b];
+            count[t * nb + b] = sum;
+            sum += c;
+        }
+        bucket_start[b + 1] = sum;
+    }
+    pool.parallel_for(0, stripes, [&](std::size_t t) {
+        std::size_t *offset = &count[t * nb];
+        for (std::size_t i = t * stripe_len, end = std::min(n, (t + 1) * stripe_len); i < end;
+             i++) {
+            T *dst = buf + offset[oracle[i]]++;
+            if (depth == 0) {
+                std::construct_at(dst, std::move(first[i]));
+            } else {
+                *dst = std::move(first[i]);
+            }
+        }
+    });
+    // Buckets are handed out one at a time, so a thread done with small buckets takes the next
+    // one instead of waiting for the large ones.
+    pool.parallel_for(0, nb, [&](std::size_t b) {
+        const std::size_t lo = bucket_start[b];
+        const std::size_t size = bucket_start[b + 1] - lo;
+        if (size > SAMPLE_SORT_BASE && !classify.is_equality_bucket(b)) {
+            std::move(buf + lo, buf + lo + size, first + lo);
+            sample_sort_impl(first + lo, size, buf + lo, oracle + lo, comp, pool, depth + 1);
+            return;
+        }
+        if (!classify.is_equality_bucket(b)) {
+            intro_sort(buf + lo, buf + lo + size, comp);
+        }
+        std::move(buf + lo, buf + lo + size, first + lo);
+    });
+}
+
+}  // namespace detail
+
+template <typename RandomIt, typename Compare>
+void parallel_sort(RandomIt first, RandomIt last, Compare comp,
+                   parallel::thread_pool &pool = parallel::default_thread_pool()) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n <= detail::SAMPLE_SORT_BASE) {
+        intro_sort(first, last, comp);
+        return;
+    }
+    std::vector<uint16_t> oracle(n);
+    detail::SampleSortBuffer<T> buf(n);
+    detail::sample_sort_impl(first, n, buf.data(), oracle.data(), comp, pool, 0);
+    buf.set_constructed();
+}
+
+template <typename RandomIt>
+void parallel_sort(RandomIt first, RandomIt last) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    parallel_sort(first, last, std::less<T>());
+}
+
+}  // namespace sorting
+}  // namespace toolbox
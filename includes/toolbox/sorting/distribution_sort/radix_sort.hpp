@@ -0,0 +1,252 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "toolbox/sorting/insertion_sort/insertion_sort.hpp"
+
+namespace toolbox {
+namespace sorting {
+
+namespace detail {
+
+static const std::size_t RADIX_SMALL = 64;
+// Below this size the write-combining lines cost more than they save.
+static const std::size_t RADIX_WC_MIN = 4096;
+static const std::size_t RADIX_WC_BYTES = 64;
+
+// Maps a key to an unsigned integer with the same order, so that its digits can be sorted as
+// unsigned numbers: the sign bit of a signed integer is flipped, and an IEEE float has its sign bit
+// flipped if positive or all its bits flipped if negative.
+template <typename K, bool = std::is_floating_point<K>::value>
+struct RadixKey {
+    static_assert(std::is_integral<K>::value && !std::is_same<K, bool>::value,
+                  "radix_sort keys must be integers or floating point numbers");
+    typedef typename std::make_unsigned<K>::type U;
+    static const U SIGN = std::is_signed<K>::value ? static_cast<U>(U(1) << (sizeof(U) * 8 - 1))
+                                                   : U(0);
+
+    static U encode(K k) { return static_cast<U>(static_cast<U>(k) ^ SIGN); }
+    static K decode(U u) { return static_cast<K>(static_cast<U>(u ^ SIGN)); }
+};
+
+template <typename K>
+struct RadixKey<K, true> {
+    static_assert(std::numeric_limits<K>::is_iec559 && (sizeof(K) == 4 || sizeof(K) == 8),
+                  "radix_sort floating point keys must be IEEE binary32 or binary64");
+    typedef typename std::conditional<sizeof(K) == 4, uint32_t, uint64_t>::type U;
+    static const U SIGN = U(1) << (sizeof(U) * 8 - 1);
+
+    static U encode(K k) {
+        const U u = std::bit_cast<U>(k);
+        return (u & SIGN) ? ~u : (u | SIGN);
+    }
+    static K decode(U u) { return std::bit_cast<K>((u & SIGN) ? (u ^ SIGN) : ~u); }
+};
+
+template <typename U, typename Index>
+struct RadixEntry {
+    U key;
+    Index index;
+};
+
+struct RadixEntryKey {
+    template <typename U, typename Index>
+    U operator()(const RadixEntry<U, Index> &e) const {
+        return e.key;
+    }
+};
+
+struct RadixIdentity {
+    template <typename U>
+    U operator()(U u) const {
+        return u;
+    }
+};
+
+// Digits of 11 bits for keys of 4 bytes and more (3 passes for 32-bit keys, 6 for 64-bit ones
+// instead of 4 and 8); 8 bits for the narrower keys, which need only 1 or 2 passes either way.
+template <typename U>
+struct RadixDigit {
+    static const unsigned BITS = sizeof(U) >= 4 ? 11 : 8;
+    static const std::size_t BUCKETS = std::size_t(1) << BITS;
+    static const std::size_t MASK = BUCKETS - 1;
+    static const unsigned PASSES = (sizeof(U) * 8 + BITS - 1) / BITS;
+};
+
+template <typename U, typename T, typename GetKey>
+void radix_scatter(const T *src, T *dst, std::size_t n, unsigned shift, std::size_t *offset,
+                   std::vector<T> &lines, std::vector<unsigned char> &fill, GetKey get) {
+    typedef RadixDigit<U> D;
+    const std::size_t L = RADIX_WC_BYTES / sizeof(T);
+    // 256 output streams are handled by the hardware as well as by software buffers.
+    if (D::BUCKETS <= 256 || L < 2 || n < RADIX_WC_MIN) {
+        for (std::size_t i = 0; i < n; i++) {
+            dst[offset[(get(src[i]) >> shift) & D::MASK]++] = src[i];
+        }
+        return;
+    }
+    // Software write combining: each bucket collects a cache line of elements before it is
+    // written out, so the output streams are written in whole lines.
+    lines.resize(D::BUCKETS * L);
+    fill.assign(D::BUCKETS, 0);
+    for (std::size_t i = 0; i < n; i++) {
+        const std::size_t d = (get(src[i]) >> shift) & D::MASK;
+        T *line = &lines[d * L];
+        line[fill[d]++] = src[i];
+        if (fill[d] == L) {
+            std::memcpy(dst + offset[d], line, L * sizeof(T));
+            offset[d] += L;
+            fill[d] = 0;
+        }
+    }
+    for (std::size_t d = 0; d < D::BUCKETS; d++) {
+        if (fill[d] > 0) {
+            std::memcpy(dst + offset[d], &lines[d * L], fill[d] * sizeof(T));
+        }
+    }
+}
+
+// LSD passes, ping-ponging between a and b. The counts of every digit are taken in one read
+// pass, and a pass whose digit is the same for all keys is skipped. Returns the buffer that
+// holds the sorted keys.
+template <typename T, typename GetKey>
+T *radix_sort_lsd(T *a, T *b, std::size_t n, GetKey get) {
+    static_assert(std::is_trivially_copyable<T>::value, "radix buffers are copied bytewise");
+    typedef typename std::remove_cv<decltype(get(*a))>::type U;
+    typedef RadixDigit<U> D;
+    std::vector<std::size_t> count(D::PASSES * D::BUCKETS, 0);
+    for (std::size_t i = 0; i < n; i++) {
+        const U k = get(a[i]);
+        for (unsigned p = 0; p < D::PASSES; p++) {
+            count[p * D::BUCKETS + ((k >> (p * D::BITS)) & D::MASK)]++;
+        }
+    }
+    std::vector<T> lines;
+    std::vector<unsigned char> fill;
+    for (unsigned p = 0; p < D::PASSES; p++) {
+        std::size_t *c = &count[p * D::BUCKETS];
+        const unsigned shift = p * D::BITS;
+        if (c[(get(a[0]) >> shift) & D::MASK] == n) {
+            continue;
+        }
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < D::BUCKETS; i++) {
+            const std::size_t t = c[i];
+            c[i] = sum;
+            sum += t;
+        }
+        radix_scatter<U>(a, b, n, shift, c, lines, fill, get);
+        std::swap(a, b);
+    }
+    return a;
+}
+
+// Hints the cache to load every line of *p. The moves of a cycle hop through memory at random, so
+// the source of the next move is fetched while the current one is done.
+template <typename T>
+void prefetch_element(const T *p) {
+#if defined(__GNUC__)
+    for (std::size_t b = 0; b < sizeof(T); b += 64) {
+        __builtin_prefetch(reinterpret_cast<const char *>(p) + b);
+    }
+#else
+    static_cast<void>(p);
+#endif
+}
+
+// Rearranges [first, first + n) so that element i becomes the old element perm[i]. Every cycle
+// of the permutation is rotated through one temporary, so each element is moved once; perm is
+// overwritten with the identity to mark the positions already done.
+template <typename Index, typename RandomIt>
+void apply_permutation(RandomIt first, std::size_t n, Index *perm) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    for (std::size_t i = 0; i < n; i++) {
+        if (perm[i] == i) {
+            continue;
+        }
+        T tmp = std::move(first[i]);
+        std::size_t j = i;
+        while (perm[j] != i) {
+            const std::size_t k = perm[j];
+            prefetch_element(&first[perm[k]]);
+            first[j] = std::move(first[k]);
+            perm[j] = static_cast<Index>(j);
+            j = k;
+        }
+        first[j] = std::move(tmp);
+        perm[j] = static_cast<Index>(j);
+    }
+}
+
+template <typename Index, typename RandomIt, typename KeyFn>
+void radix_sort_records(RandomIt first, RandomIt last, KeyFn key) {
+    typedef typename std::decay<decltype(key(*first))>::type K;
+    typedef RadixEntry<typename RadixKey<K>::U, Index> E;
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    std::vector<Index> perm(n);
+    {
+        // The pair buffers are freed before the records move.
+        std::vector<E> a(n), b(n);
+        for (std::size_t i = 0; i < n; i++) {
+            a[i].key = RadixKey<K>::encode(key(first[i]));
+            a[i].index = static_cast<Index>(i);
+        }
+        const E *sorted = radix_sort_lsd(a.data(), b.data(), n, RadixEntryKey());
+        for (std::size_t i = 0; i < n; i++) {
+            perm[i] = sorted[i].index;
+        }
+    }
+    apply_permutation(first, n, perm.data());
+}
+
+}  // namespace detail
+
+template <typename RandomIt, typename KeyFn>
+void radix_sort(RandomIt first, RandomIt last, KeyFn key) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    typedef typename std::decay<decltype(key(*first))>::type K;
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n < detail::RADIX_SMALL) {
+        insertion_sort(first, last, [&key](const T &a, const T &b) {
+            return detail::RadixKey<K>::encode(key(a)) < detail::RadixKey<K>::encode(key(b));
+        });
+        return;
+    }
+    if (n <= std::numeric_limits<uint32_t>::max()) {
+        detail::radix_sort_records<uint32_t>(first, last, key);
+    } else {
+        detail::radix_sort_records<std::size_t>(first, last, key);
+    }
+}
+
+template <typename RandomIt>
+void radix_sort(RandomIt first, RandomIt last) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    typedef detail::RadixKey<T> Key;
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n < detail::RADIX_SMALL) {
+        insertion_sort(first, last,
+                       [](const T &a, const T &b) { return Key::encode(a) < Key::encode(b); });
+        return;
+    }
+    std::vector<typename Key::U> a(n), b(n);
+    for (std::size_t i = 0; i < n; i++) {
+        a[i] = Key::encode(first[i]);
+    }
+    const typename Key::U *sorted = detail::radix_sort_lsd(a.data(), b.data(), n,
+                                                           detail::RadixIdentity());
+    for (std::size_t i = 0; i < n; i++) {
+        first[i] = Key::decode(sorted[i]);
+    }
+}
+
+}  // namespace sorting
+}  // namespace toolbox
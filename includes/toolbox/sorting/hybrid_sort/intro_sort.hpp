@@ -8,6 +8,7 @@
 
 #include "toolbox/sorting/exchange_sort/quick_sort.hpp"
 #include "toolbox/sorting/insertion_sort/insertion_sort.hpp"
+#include "toolbox/sorting/network_sort/sorting_network.hpp"
 #include "toolbox/sorting/selection_sort/heap_sort.hpp"
 
 namespace toolbox {
@@ -36,7 +37,11 @@ void intro_sort_impl(RandomIt first, RandomIt last, std::size_t depth_limit, Com
     typedef typename std::iterator_traits<RandomIt>::value_type T;
     std::ptrdiff_t size = std::distance(first, last);
     if (size <= 32) {
-        insertion_sort(first, last, comp);
+        if constexpr (NetworkSortable<T, Compare>::value) {
+            network_sort(first, static_cast<std::size_t>(size), comp);
+        } else {
+            insertion_sort(first, last, comp);
+        }
         return;
     }
     if (depth_limit == 0) {
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "toolbox/sorting/network_sort/sorting_network.hpp"
+#include "toolbox/sorting/selection_sort/heap_sort.hpp"
+
+namespace toolbox {
+namespace sorting {
+
+namespace detail {
+
+static const std::ptrdiff_t PDQ_INSERTION_SORT_THRESHOLD = 24;
+static const std::ptrdiff_t PDQ_NINTHER_THRESHOLD = 128;
+static const std::ptrdiff_t PDQ_PARTIAL_INSERTION_SORT_LIMIT = 8;
+static const std::ptrdiff_t PDQ_BLOCK_SIZE = 64;
+
+// Block partitioning only pays off when a comparison is a single cheap instruction.
+template <typename T, typename Compare>
+struct PdqUseBranchless
+    : std::integral_constant<bool, std::is_arithmetic<T>::value &&
+                                       (std::is_same<Compare, std::less<T>>::value ||
+                                        std::is_same<Compare, std::greater<T>>::value ||
+                                        std::is_same<Compare, std::less<>>::value ||
+                                        std::is_same<Compare, std::greater<>>::value)> {};
+
+template <typename RandomIt, typename Compare>
+void pdq_insertion_sort(RandomIt first, RandomIt last, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    if (first == last) {
+        return;
+    }
+    for (RandomIt cur = first + 1; cur != last; ++cur) {
+        RandomIt sift = cur;
+        RandomIt sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            T tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (sift != first && comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// Requires *(first - 1) to be no greater than any element of the range, which stops the sift.
+template <typename RandomIt, typename Compare>
+void pdq_unguarded_insertion_sort(RandomIt first, RandomIt last, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    if (first == last) {
+        return;
+    }
+    for (RandomIt cur = first + 1; cur != last; ++cur) {
+        RandomIt sift = cur;
+        RandomIt sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            T tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// Insertion sort that gives up once more than PDQ_PARTIAL_INSERTION_SORT_LIMIT elements have
+// been moved. Returns whether the range was sorted.
+template <typename RandomIt, typename Compare>
+bool pdq_partial_insertion_sort(RandomIt first, RandomIt last, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    if (first == last) {
+        return true;
+    }
+    std::ptrdiff_t moved = 0;
+    for (RandomIt cur = first + 1; cur != last; ++cur) {
+        RandomIt sift = cur;
+        RandomIt sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            T tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (sift != first && comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+            moved += cur - sift;
+        }
+        if (moved > PDQ_PARTIAL_INSERTION_SORT_LIMIT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename RandomIt, typename Compare>
+void pdq_sort2(RandomIt a, RandomIt b, Compare comp) {
+    if (comp(*b, *a)) {
+        std::iter_swap(a, b);
+    }
+}
+
+template <typename RandomIt, typename Compare>
+void pdq_sort3(RandomIt a, RandomIt b, RandomIt c, Compare comp) {
+    pdq_sort2(a, b, comp);
+    pdq_sort2(b, c, comp);
+    pdq_sort2(a, b, comp);
+}
+
+// Exchanges the misplaced elements recorded in the offset buffers, pairwise or as one cycle of
+// 2 num + 1 moves.
+template <typename RandomIt>
+void pdq_swap_offsets(RandomIt first, RandomIt last, const unsigned char *offsets_l,
+                      const unsigned char *offsets_r, std::ptrdiff_t num, bool use_swaps) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    if (use_swaps) {
+        for (std::ptrdiff_t i = 0; i < num; i++) {
+            std::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+        }
+    } else if (num > 0) {
+        RandomIt l = first + offsets_l[0];
+        RandomIt r = last - offsets_r[0];
+        T tmp(std::move(*l));
+        *l = std::move(*r);
+        for (std::ptrdiff_t i = 1; i < num; i++) {
+            l = first + offsets_l[i];
+            *r = std::move(*l);
+            r = last - offsets_r[i];
+            *l = std::move(*r);
+        }
+        *r = std::move(tmp);
+    }
+}
+
+// Partitions [first, last) around the pivot *first: the elements less than it go left, the
+// others right. Returns the final position of the pivot and whether no element had to be moved.
+// Requires an element no less than the pivot in the range, which the pivot selection guarantees.
+template <typename RandomIt, typename Compare>
+std::pair<RandomIt, bool> pdq_partition_right(RandomIt begin, RandomIt end, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    T pivot(std::move(*begin));
+    RandomIt first = begin;
+    RandomIt last = end;
+    while (comp(*++first, pivot)) {
+    }
+    if (first - 1 == begin) {
+        while (first < last && !comp(*--last, pivot)) {
+        }
+    } else {
+        while (!comp(*--last, pivot)) {
+        }
+    }
+    const bool already_partitioned = first >= last;
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(*++first, pivot)) {
+        }
+        while (!comp(*--last, pivot)) {
+        }
+    }
+    RandomIt pivot_pos = first - 1;
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return std::make_pair(pivot_pos, already_partitioned);
+}
+
+// BlockQuicksort: the comparison results of a block of PDQ_BLOCK_SIZE elements from each end are
+// first written to offset buffers without branching, then the misplaced elements are swapped, so
+// the branch predictor never has to guess the outcome of a comparison.
+template <typename RandomIt, typename Compare>
+std::pair<RandomIt, bool> pdq_partition_right_branchless(RandomIt begin, RandomIt end,
+                                                         Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    T pivot(std::move(*begin));
+    RandomIt first = begin;
+    RandomIt last = end;
+    while (comp(*++first, pivot)) {
+    }
+    if (first - 1 == begin) {
+        while (first < last && !comp(*--last, pivot)) {
+        }
+    } else {
+        while (!comp(*--last, pivot)) {
+        }
+    }
+    const bool already_partitioned = first >= last;
+    if (!already_partitioned) {
+        std::iter_swap(first, last);
+        ++first;
+        alignas(64) unsigned char offsets_l[PDQ_BLOCK_SIZE];
+        alignas(64) unsigned char offsets_r[PDQ_BLOCK_SIZE];
+        RandomIt offsets_l_base = first;
+        RandomIt offsets_r_base = last;
+        std::ptrdiff_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+        while (first < last) {
+            // Fill the offset buffers that are empty; if both are, split the unknown elements.
+            const std::ptrdiff_t num_unknown = last - first;
+            const std::ptrdiff_t left_split =
+                num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+            const std::ptrdiff_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+            const std::ptrdiff_t left_count = std::min(left_split, PDQ_BLOCK_SIZE);
+            for (std::ptrdiff_t i = 0; i < left_count; i++) {
+                offsets_l[num_l] = static_cast<unsigned char>(i);
+                num_l += !comp(*first, pivot);
+                ++first;
+            }
+            const std::ptrdiff_t right_count = std::min(right_split, PDQ_BLOCK_SIZE);
+            for (std::ptrdiff_t i = 0; i < right_count;) {
+                offsets_r[num_r] = static_cast<unsigned char>(++i);
+                num_r += comp(*--last, pivot);
+            }
+            const std::ptrdiff_t num = std::min(num_l, num_r);
+            pdq_swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l,
+                             offsets_r + start_r, num, num_l == num_r);
+            num_l -= num;
+            num_r -= num;
+            start_l += num;
+            start_r += num;
+            if (num_l == 0) {
+                start_l = 0;
+                offsets_l_base = first;
+            }
+            if (num_r == 0) {
+                start_r = 0;
+                offsets_r_base = last;
+            }
+        }
+        // One buffer may still hold misplaced elements; move them to the boundary.
+        if (num_l) {
+            while (num_l--) {
+                std::iter_swap(offsets_l_base + offsets_l[start_l + num_l], --last);
+            }
+            first = last;
+        }
+        if (num_r) {
+            while (num_r--) {
+                std::iter_swap(offsets_r_base - offsets_r[start_r + num_r], first);
+                ++first;
+            }
+            last = first;
+        }
+    }
+    RandomIt pivot_pos = first - 1;
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return std::make_pair(pivot_pos, already_partitioned);
+}
+
+// Partitions around the pivot *first with the elements equal to it on the left. Used when the
+// pivot equals the element before the range, which is no greater than anything in it: the left
+// part is then all equal keys and is done.
+template <typename RandomIt, typename Compare>
+RandomIt pdq_partition_left(RandomIt begin, RandomIt end, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    T pivot(std::move(*begin));
+    RandomIt first = begin;
+    RandomIt last = end;
+    while (comp(pivot, *--last)) {
+    }
+    if (last + 1 == end) {
+        while (first < last && !comp(pivot, *++first)) {
+        }
+    } else {
+        while (!comp(pivot, *++first)) {
+        }
+    }
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(pivot, *--last)) {
+        }
+        while (!comp(pivot, *++first)) {
+        }
+    }
+    RandomIt pivot_pos = last;
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return pivot_pos;
+}
+
+template <bool Branchless, typename RandomIt, typename Compare>
+void pdq_sort_loop(RandomIt begin, RandomIt end, Compare comp, int bad_allowed, bool leftmost) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    while (true) {
+        const std::ptrdiff_t size = end - begin;
+        if constexpr (NetworkSortable<T, Compare>::value) {
+            if (size <= static_cast<std::ptrdiff_t>(SORT_N_MAX)) {
+                network_sort(begin, static_cast<std::size_t>(size), comp);
+                return;
+            }
+        }
+        if (size < PDQ_INSERTION_SORT_THRESHOLD) {
+            if (leftmost) {
+                pdq_insertion_sort(begin, end, comp);
+            } else {
+                pdq_unguarded_insertion_sort(begin, end, comp);
+            }
+            return;
+        }
+        // Ninther (median of three medians of three) for large ranges, median of three otherwise;
+        // either way the pivot ends up in *begin.
+        const std::ptrdiff_t s2 = size / 2;
+        if (size > PDQ_NINTHER_THRESHOLD) {
+            pdq_sort3(begin, begin + s2, end - 1, comp);
+            pdq_sort3(begin + 1, begin + (s2 - 1), end - 2, comp);
+            pdq_sort3(begin + 2, begin + (s2 + 1), end - 3, comp);
+            pdq_sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), comp);
+            std::iter_swap(begin, begin + s2);
+        } else {
+            pdq_sort3(begin + s2, begin, end - 1, comp);
+        }
+        // *(begin - 1) closes a previous left partition, so nothing here is less than it. A pivot
+        // equal to it means many equal keys: split them off instead of sorting them again.
+        if (!leftmost && !comp(*(begin - 1), *begin)) {
+            begin = pdq_partition_left(begin, end, comp) + 1;
+            continue;
+        }
+        const std::pair<RandomIt, bool> part = Branchless
+                                                   ? pdq_partition_right_branchless(begin, end,
+                                                                                    comp)
+                                                   : pdq_partition_right(begin, end, comp);
+        const RandomIt pivot_pos = part.first;
+        const std::ptrdiff_t l_size = pivot_pos - begin;
+        const std::ptrdiff_t r_size = end - (pivot_pos + 1);
+        if (l_size < size / 8 || r_size < size / 8) {
+            // A bad partition: after log2(n) of them the input is adversarial, so fall back to
+            // heap sort. Otherwise shuffle a few elements to break the pattern.
+            if (--bad_allowed == 0) {
+                heap_sort(begin, end, comp);
+                return;
+            }
+            if (l_size >= PDQ_INSERTION_SORT_THRESHOLD) {
+                std::iter_swap(begin, begin + l_size / 4);
+                std::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                if (l_size > PDQ_NINTHER_THRESHOLD) {
+                    std::iter_swap(begin + 1, begin + (l_size / 4 + 1));
+                    std::iter_swap(begin + 2, begin + (l_size / 4 + 2));
+                    std::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                    std::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                }
+            }
+            if (r_size >= PDQ_INSERTION_SORT_THRESHOLD) {
+                std::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                std::iter_swap(end - 1, end - r_size / 4);
+                if (r_size > PDQ_NINTHER_THRESHOLD) {
+                    std::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                    std::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                    std::iter_swap(end - 2, end - (1 + r_size / 4));
+                    std::iter_swap(end - 3, end - (2 + r_size / 4));
+                }
+            }
+        } else if (part.second && pdq_partial_insertion_sort(begin, pivot_pos, comp) &&
+                   pdq_partial_insertion_sort(pivot_pos + 1, end, comp)) {
+            // A balanced partition that moved nothing suggests presorted input: a few insertions
+            // may finish both sides.
+            return;
+        }
+        pdq_sort_loop<Branchless>(begin, pivot_pos, comp, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+}  // namespace detail
+
+template <typename RandomIt, typename Compare>
+void pdq_sort(RandomIt first, RandomIt last, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    const std::ptrdiff_t n = last - first;
+    if (n < 2) {
+        return;
+    }
+    // An input that is one run, non-descending or strictly descending, is done in one scan. If
+    // the run covers at least half of the input (a sorted batch with a few late arrivals), only
+    // the rest is sorted and then merged into it.
+    RandomIt run = first + 1;
+    const bool descending = comp(*run, *first);
+    if (descending) {
+        while (run != last && comp(*run, *(run - 1))) {
+            ++run;
+        }
+    } else {
+        while (run != last && !comp(*run, *(run - 1))) {
+            ++run;
+        }
+    }
+    if (run - first >= n / 2) {
+        if (descending) {
+            std::reverse(first, run);
+        }
+        if (run != last) {
+            pdq_sort(run, last, comp);
+            std::inplace_merge(first, run, last, comp);
+        }
+        return;
+    }
+    const int bad_allowed = static_cast<int>(std::bit_width(static_cast<std::size_t>(n)) - 1);
+    detail::pdq_sort_loop<detail::PdqUseBranchless<T, Compare>::value>(first, last, comp,
+                                                                       bad_allowed, true);
+}
+
+template <typename RandomIt>
+void pdq_sort(RandomIt first, RandomIt last) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    pdq_sort(first, last, std::less<T>());
+}
+
+}  // namespace sorting
+}  // namespace toolbox
@@ -4,9 +4,10 @@
 #include <cstddef>
 #include <functional>
 #include <iterator>
+#include <utility>
 #include <vector>
 
-#include "toolbox/sorting/insertion_sort/binary_insertion_sort.hpp"
+#include "toolbox/sorting/network_sort/sorting_network.hpp"
 
 namespace toolbox {
 namespace sorting {
@@ -16,9 +17,12 @@ namespace detail {
 struct TimRun {
     std::size_t start;
     std::size_t length;
+    // Depth of the boundary between this run and the next one in the powersort merge tree.
+    int power;
 };
 
 static const std::size_t TIM_MIN_MERGE = 32;
+static const std::size_t TIM_MIN_GALLOP = 7;
 
 inline std::size_t tim_min_run_length(std::size_t n) {
     std::size_t r = 0;
@@ -29,70 +33,230 @@ inline std::size_t tim_min_run_length(std::size_t n) {
     return n + r;
 }
 
-template <typename T, typename Compare>
-std::size_t count_run_and_make_ascending(std::vector<T> &v, std::size_t start, Compare comp) {
-    std::size_t size = v.size();
-    if (start >= size - 1) {
-        return size - start;
+// Powersort: the power of the boundary between the runs [s1, s1 + n1) and [s1 + n1, s1 + n1 + n2)
+// of a range of n elements is the first bit where the binary fractions of their midpoints, as
+// fractions of n, differ. Merging the boundaries in decreasing order of power gives a merge tree
+// within 2% of the optimum for the run lengths.
+inline int tim_node_power(std::size_t s1, std::size_t n1, std::size_t n2, std::size_t n) {
+    std::size_t a = 2 * s1 + n1;
+    std::size_t b = a + n1 + n2;
+    int power = 0;
+    while (true) {
+        ++power;
+        if (a >= n) {
+            a -= n;
+            b -= n;
+        } else if (b >= n) {
+            break;
+        }
+        a <<= 1;
+        b <<= 1;
+    }
+    return power;
+}
+
+template <typename Compare>
+struct TimReverseCompare {
+    Compare comp;
+    explicit TimReverseCompare(Compare c) : comp(c) {}
+    template <typename T>
+    bool operator()(const T &a, const T &b) const {
+        return comp(b, a);
     }
+};
 
-    std::size_t run_end = start + 2;
-    if (comp(v[start + 1], v[start])) {
-        // Descending run: extend and reverse
-        while (run_end < size && comp(v[run_end], v[run_end - 1])) {
+// Returns the length of the run starting at first, reversing it if it is strictly descending
+// (strictly, so that reversing keeps equal elements in order).
+template <typename RandomIt, typename Compare>
+std::size_t tim_count_run(RandomIt first, RandomIt last, Compare comp) {
+    RandomIt run_end = first + 1;
+    if (run_end == last) {
+        return 1;
+    }
+    if (comp(*run_end, *first)) {
+        while (run_end != last && comp(*run_end, *(run_end - 1))) {
             ++run_end;
         }
-        std::reverse(v.begin() + start, v.begin() + run_end);
+        std::reverse(first, run_end);
     } else {
-        // Ascending run: extend
-        while (run_end < size && !comp(v[run_end], v[run_end - 1])) {
+        while (run_end != last && !comp(*run_end, *(run_end - 1))) {
             ++run_end;
         }
     }
-    return run_end - start;
+    return static_cast<std::size_t>(run_end - first);
+}
+
+// Binary insertion of [sorted_end, last) into the sorted [first, sorted_end). Equal elements are
+// inserted after the ones already there, which keeps the sort stable.
+template <typename RandomIt, typename Compare>
+void tim_binary_insertion(RandomIt first, RandomIt sorted_end, RandomIt last, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    for (RandomIt it = sorted_end; it != last; ++it) {
+        RandomIt pos = std::upper_bound(first, it, *it, comp);
+        if (pos != it) {
+            T key = std::move(*it);
+            std::move_backward(pos, it, it + 1);
+            *pos = std::move(key);
+        }
+    }
+}
+
+// Exponential search from base[hint] followed by a binary search: the first position k in
+// base[0, n) with !comp(base[k], key). The cost is O(log d) for an answer d away from the hint.
+template <typename It, typename T, typename Compare>
+std::size_t tim_gallop_left(const T &key, It base, std::size_t n, std::size_t hint,
+                            Compare comp) {
+    std::size_t last_ofs = 0, ofs = 1, lo, hi;
+    if (comp(base[hint], key)) {
+        const std::size_t max_ofs = n - hint;
+        while (ofs < max_ofs && comp(base[hint + ofs], key)) {
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+        }
+        ofs = std::min(ofs, max_ofs);
+        lo = hint + last_ofs + 1;
+        hi = hint + ofs;
+    } else {
+        const std::size_t max_ofs = hint + 1;
+        while (ofs < max_ofs && !comp(base[hint - ofs], key)) {
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+        }
+        ofs = std::min(ofs, max_ofs);
+        lo = hint + 1 - ofs;
+        hi = hint - last_ofs;
+    }
+    return static_cast<std::size_t>(std::lower_bound(base + lo, base + hi, key, comp) - base);
 }
 
-template <typename T, typename Compare>
-void merge_at(std::vector<T> &v, std::vector<TimRun> &run_stack, std::size_t idx, Compare comp) {
-    TimRun &left = run_stack[idx];
-    TimRun &right = run_stack[idx + 1];
-    std::inplace_merge(v.begin() + left.start, v.begin() + right.start,
-                       v.begin() + right.start + right.length, comp);
-    left.length += right.length;
-    run_stack.erase(run_stack.begin() + idx + 1);
+// As tim_gallop_left, but the first position k with comp(key, base[k]).
+template <typename It, typename T, typename Compare>
+std::size_t tim_gallop_right(const T &key, It base, std::size_t n, std::size_t hint,
+                             Compare comp) {
+    std::size_t last_ofs = 0, ofs = 1, lo, hi;
+    if (!comp(key, base[hint])) {
+        const std::size_t max_ofs = n - hint;
+        while (ofs < max_ofs && !comp(key, base[hint + ofs])) {
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+        }
+        ofs = std::min(ofs, max_ofs);
+        lo = hint + last_ofs + 1;
+        hi = hint + ofs;
+    } else {
+        const std::size_t max_ofs = hint + 1;
+        while (ofs < max_ofs && comp(key, base[hint - ofs])) {
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+        }
+        ofs = std::min(ofs, max_ofs);
+        lo = hint + 1 - ofs;
+        hi = hint - last_ofs;
+    }
+    return static_cast<std::size_t>(std::upper_bound(base + lo, base + hi, key, comp) - base);
 }
 
-template <typename T, typename Compare>
-void merge_collapse(std::vector<T> &v, std::vector<TimRun> &run_stack, Compare comp) {
-    while (run_stack.size() > 1) {
-        std::size_t n = run_stack.size() - 1;
-        std::size_t lenX = run_stack[n].length;
-        std::size_t lenY = run_stack[n - 1].length;
-        std::size_t lenZ = (n >= 2) ? run_stack[n - 2].length : static_cast<std::size_t>(-1);
-
-        if (n >= 2 && lenZ <= lenY + lenX) {
-            if (lenZ < lenX) {
-                merge_at(v, run_stack, n - 2, comp);
+// Merges the runs [first, first + na) and [first + na, first + na + nb), moving the first one to
+// the buffer. Requires na, nb > 0, the first element of the second run to be less than the first
+// element of the first run and the last element of the first run to be greater than everything in
+// the second one (tim_merge_at trims the runs so). When one run has won TIM_MIN_GALLOP times in a
+// row the merge switches to galloping, which moves whole blocks found by exponential search;
+// min_gallop adapts, lower while galloping pays off and higher when it does not.
+template <typename RandomIt, typename T, typename Compare>
+void tim_merge_lo(RandomIt first, std::size_t na, std::size_t nb, std::vector<T> &buffer,
+                  std::size_t &min_gallop, Compare comp) {
+    buffer.assign(std::make_move_iterator(first), std::make_move_iterator(first + na));
+    typename std::vector<T>::iterator a = buffer.begin();
+    RandomIt b = first + na;
+    RandomIt dest = first;
+    *dest++ = std::move(*b++);
+    --nb;
+    while (nb > 0 && na > 1) {
+        std::size_t a_wins = 0, b_wins = 0;
+        while (nb > 0 && na > 1 && (a_wins | b_wins) < min_gallop) {
+            if (comp(*b, *a)) {
+                *dest++ = std::move(*b++);
+                --nb;
+                ++b_wins;
+                a_wins = 0;
             } else {
-                merge_at(v, run_stack, n - 1, comp);
+                *dest++ = std::move(*a++);
+                --na;
+                ++a_wins;
+                b_wins = 0;
             }
-        } else if (lenY <= lenX) {
-            merge_at(v, run_stack, n - 1, comp);
-        } else {
+        }
+        if (nb == 0 || na <= 1) {
             break;
         }
+        ++min_gallop;
+        do {
+            min_gallop -= min_gallop > 1;
+            a_wins = tim_gallop_right(*b, a, na, 0, comp);
+            dest = std::move(a, a + a_wins, dest);
+            a += a_wins;
+            na -= a_wins;
+            if (na <= 1) {
+                break;
+            }
+            *dest++ = std::move(*b++);
+            if (--nb == 0) {
+                break;
+            }
+            b_wins = tim_gallop_left(*a, b, nb, 0, comp);
+            dest = std::move(b, b + b_wins, dest);
+            b += b_wins;
+            nb -= b_wins;
+            if (nb == 0) {
+                break;
+            }
+            *dest++ = std::move(*a++);
+            if (--na == 1) {
+                break;
+            }
+        } while (a_wins >= TIM_MIN_GALLOP || b_wins >= TIM_MIN_GALLOP);
+        // Leaving galloping costs a penalty, so a merge that keeps alternating stops trying.
+        min_gallop += nb > 0 && na > 1;
+    }
+    // Either the second run is used up, or one element of the first run is left, which is
+    // greater than the rest of the second run.
+    if (nb > 0) {
+        dest = std::move(b, b + nb, dest);
     }
+    std::move(a, a + na, dest);
 }
 
-template <typename T, typename Compare>
-void merge_force_collapse(std::vector<T> &v, std::vector<TimRun> &run_stack, Compare comp) {
-    while (run_stack.size() > 1) {
-        std::size_t n = run_stack.size() - 1;
-        if (n >= 2 && run_stack[n - 2].length < run_stack[n].length) {
-            merge_at(v, run_stack, n - 2, comp);
-        } else {
-            merge_at(v, run_stack, n - 1, comp);
-        }
+template <typename RandomIt, typename T, typename Compare>
+void tim_merge_at(RandomIt first, std::vector<TimRun> &runs, std::vector<T> &buffer,
+                  std::size_t &min_gallop, Compare comp) {
+    TimRun &x = runs[runs.size() - 2];
+    const TimRun &y = runs.back();
+    RandomIt a = first + x.start;
+    RandomIt b = first + y.start;
+    std::size_t na = x.length;
+    std::size_t nb = y.length;
+    x.length += y.length;
+    runs.pop_back();
+    // The elements of the first run that are no greater than the head of the second, and those of
+    // the second that are no less than the tail of the first, are already in place.
+    const std::size_t k = tim_gallop_right(*b, a, na, 0, comp);
+    a += k;
+    na -= k;
+    if (na == 0) {
+        return;
+    }
+    nb = tim_gallop_left(*(a + (na - 1)), b, nb, nb - 1, comp);
+    if (nb == 0) {
+        return;
+    }
+    // Buffer the shorter run; the second one is merged from the back, as the first run of the
+    // reversed range under the reversed order.
+    if (na <= nb) {
+        tim_merge_lo(a, na, nb, buffer, min_gallop, comp);
+    } else {
+        typedef std::reverse_iterator<RandomIt> ReverseIt;
+        tim_merge_lo(ReverseIt(b + nb), nb, na, buffer, min_gallop,
+                     TimReverseCompare<Compare>(comp));
     }
 }
 
@@ -101,38 +265,45 @@ void merge_force_collapse(std::vector<T> &v, std::vector<TimRun> &run_stack, Com
 template <typename RandomIt, typename Compare>
 void tim_sort(RandomIt first, RandomIt last, Compare comp) {
     typedef typename std::iterator_traits<RandomIt>::value_type T;
-    std::ptrdiff_t n = std::distance(first, last);
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
     if (n <= 1) {
         return;
     }
-
-    // Copy to internal vector for efficient index access
-    std::vector<T> v(first, last);
-
-    const std::size_t min_run = detail::tim_min_run_length(static_cast<std::size_t>(n));
-    std::vector<detail::TimRun> run_stack;
-    run_stack.reserve(static_cast<std::size_t>(n) / detail::TIM_MIN_MERGE + 1);
-
+    const std::size_t min_run = detail::tim_min_run_length(n);
+    // Only the shorter of two runs is buffered, so n / 2 elements are enough for every merge.
+    std::vector<T> buffer;
+    if (n > min_run) {
+        buffer.reserve(n / 2);
+    }
+    std::vector<detail::TimRun> runs;
+    std::size_t min_gallop = detail::TIM_MIN_GALLOP;
     std::size_t start = 0;
-    while (start < static_cast<std::size_t>(n)) {
-        std::size_t run_len = detail::count_run_and_make_ascending(v, start, comp);
+    while (start < n) {
+        std::size_t run_len = detail::tim_count_run(first + start, last, comp);
         if (run_len < min_run) {
-            std::size_t forced = std::min(min_run, static_cast<std::size_t>(n) - start);
-            // Extend run using binary insertion sort
-            binary_insertion_sort(v.begin() + start, v.begin() + start + forced, comp);
+            const std::size_t forced = std::min(min_run, n - start);
+            if constexpr (detail::NetworkStable<T, Compare>::value) {
+                detail::network_sort(first + start, forced, comp);
+            } else {
+                detail::tim_binary_insertion(first + start, first + (start + run_len),
+                                             first + (start + forced), comp);
+            }
             run_len = forced;
         }
-        detail::TimRun new_run;
-        new_run.start = start;
-        new_run.length = run_len;
-        run_stack.push_back(new_run);
-        detail::merge_collapse(v, run_stack, comp);
+        if (!runs.empty()) {
+            const int power =
+                detail::tim_node_power(runs.back().start, runs.back().length, run_len, n);
+            while (runs.size() > 1 && runs[runs.size() - 2].power > power) {
+                detail::tim_merge_at(first, runs, buffer, min_gallop, comp);
+            }
+            runs.back().power = power;
+        }
+        runs.push_back(detail::TimRun{start, run_len, 0});
         start += run_len;
     }
-
-    detail::merge_force_collapse(v, run_stack, comp);
-
-    std::copy(v.begin(), v.end(), first);
+    while (runs.size() > 1) {
+        detail::tim_merge_at(first, runs, buffer, min_gallop, comp);
+    }
 }
 
 template <typename RandomIt>
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "toolbox/sorting/distribution_sort/radix_sort.hpp"
+#include "toolbox/sorting/merge_sort/merge_sort.hpp"
+
+namespace toolbox {
+namespace sorting {
+
+namespace detail {
+
+// Keys that radix_sort takes: integers other than bool, and IEEE binary32 or binary64.
+template <typename K>
+struct KeyRadixable
+    : std::integral_constant<bool, (std::is_integral<K>::value && !std::is_same<K, bool>::value) ||
+                                       (std::is_floating_point<K>::value &&
+                                        std::numeric_limits<K>::is_iec559 &&
+                                        (sizeof(K) == 4 || sizeof(K) == 8))> {};
+
+template <typename K, typename Compare>
+struct KeyAscending : std::integral_constant<bool, std::is_same<Compare, std::less<K>>::value ||
+                                                       std::is_same<Compare, std::less<>>::value> {
+};
+
+template <typename K, typename Compare>
+struct KeyDescending
+    : std::integral_constant<bool, std::is_same<Compare, std::greater<K>>::value ||
+                                       std::is_same<Compare, std::greater<>>::value> {};
+
+// Numeric keys under less or greater are radix sorted; a descending order sorts the complemented
+// keys, which keeps equal keys in order.
+template <typename K, typename Compare>
+struct KeyRadixSort
+    : std::integral_constant<bool, KeyRadixable<K>::value &&
+                                       (KeyAscending<K, Compare>::value ||
+                                        KeyDescending<K, Compare>::value)> {};
+
+template <typename K, typename Index>
+struct KeyIndex {
+    K key;
+    Index index;
+};
+
+// Writes to perm the indices of [first, first + n) in the stable order of key(first[i]) under
+// comp. The keys are extracted once and sorted as compact (key, index) pairs.
+template <typename Index, typename RandomIt, typename KeyFn, typename Compare>
+void key_permutation(RandomIt first, std::size_t n, KeyFn key, Compare comp, Index *perm) {
+    typedef typename std::decay<decltype(key(*first))>::type K;
+    if (n == 0) {
+        return;
+    }
+    if constexpr (KeyRadixSort<K, Compare>::value) {
+        typedef typename RadixKey<K>::U U;
+        typedef RadixEntry<U, Index> E;
+        const U flip = KeyDescending<K, Compare>::value ? static_cast<U>(~U(0)) : U(0);
+        std::vector<E> a(n), b(n);
+        for (std::size_t i = 0; i < n; i++) {
+            a[i].key = static_cast<U>(RadixKey<K>::encode(key(first[i])) ^ flip);
+            a[i].index = static_cast<Index>(i);
+        }
+        const E *sorted = radix_sort_lsd(a.data(), b.data(), n, RadixEntryKey());
+        for (std::size_t i = 0; i < n; i++) {
+            perm[i] = sorted[i].index;
+        }
+    } else {
+        std::vector<KeyIndex<K, Index>> e;
+        e.reserve(n);
+        for (std::size_t i = 0; i < n; i++) {
+            e.push_back(KeyIndex<K, Index>{key(first[i]), static_cast<Index>(i)});
+        }
+        merge_sort(e.begin(), e.end(),
+                   [&comp](const KeyIndex<K, Index> &a, const KeyIndex<K, Index> &b) {
+                       return comp(a.key, b.key);
+                   });
+        for (std::size_t i = 0; i < n; i++) {
+            perm[i] = e[i].index;
+        }
+    }
+}
+
+// Writes to perm the indices of [first, first + n) in the stable order of the elements under
+// comp, comparing the elements in place instead of copying them.
+template <typename Index, typename RandomIt, typename Compare>
+void value_permutation(RandomIt first, std::size_t n, Compare comp, Index *perm) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    if constexpr (KeyRadixSort<T, Compare>::value) {
+        key_permutation(first, n, [](const T &x) { return x; }, comp, perm);
+    } else {
+        std::iota(perm, perm + n, Index(0));
+        merge_sort(perm, perm + n,
+                   [&](Index a, Index b) { return comp(first[a], first[b]); });
+    }
+}
+
+template <typename Index, typename RandomIt, typename KeyFn, typename Compare>
+void sort_by_key_impl(RandomIt first, std::size_t n, KeyFn key, Compare comp) {
+    std::vector<Index> perm(n);
+    key_permutation(first, n, key, comp, perm.data());
+    apply_permutation(first, n, perm.data());
+}
+
+// Calls fill(perm) to compute a permutation of n indices, with 32-bit indices when they suffice:
+// they make the sorted pairs smaller.
+template <typename Fill>
+std::vector<std::size_t> compact_permutation(std::size_t n, Fill fill) {
+    std::vector<std::size_t> perm(n);
+    if (n <= std::numeric_limits<uint32_t>::max()) {
+        std::vector<uint32_t> perm32(n);
+        fill(perm32.data());
+        std::copy(perm32.begin(), perm32.end(), perm.begin());
+    } else {
+        fill(perm.data());
+    }
+    return perm;
+}
+
+}  // namespace detail
+
+template <typename RandomIt, typename KeyFn, typename Compare>
+void sort_by_key(RandomIt first, RandomIt last, KeyFn key, Compare comp) {
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+    if (n <= std::numeric_limits<uint32_t>::max()) {
+        detail::sort_by_key_impl<uint32_t>(first, n, key, comp);
+    } else {
+        detail::sort_by_key_impl<std::size_t>(first, n, key, comp);
+    }
+}
+
+template <typename RandomIt, typename KeyFn>
+void sort_by_key(RandomIt first, RandomIt last, KeyFn key) {
+    typedef typename std::decay<decltype(key(*first))>::type K;
+    sort_by_key(first, last, key, std::less<K>());
+}
+
+template <typename RandomIt, typename KeyFn, typename Compare>
+std::vector<std::size_t> argsort_by_key(RandomIt first, RandomIt last, KeyFn key, Compare comp) {
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+    return detail::compact_permutation(
+        n, [&](auto *perm) { detail::key_permutation(first, n, key, comp, perm); });
+}
+
+template <typename RandomIt, typename KeyFn>
+std::vector<std::size_t> argsort_by_key(RandomIt first, RandomIt last, KeyFn key) {
+    typedef typename std::decay<decltype(key(*first))>::type K;
+    return argsort_by_key(first, last, key, std::less<K>());
+}
+
+template <typename RandomIt, typename Compare>
+std::vector<std::size_t> argsort(RandomIt first, RandomIt last, Compare comp) {
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+    return detail::compact_permutation(
+        n, [&](auto *perm) { detail::value_permutation(first, n, comp, perm); });
+}
+
+template <typename RandomIt>
+std::vector<std::size_t> argsort(RandomIt first, RandomIt last) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    return argsort(first, last, std::less<T>());
+}
+
+}  // namespace sorting
+}  // namespace toolbox
@@ -3,42 +3,14 @@
 #include <algorithm>
 #include <functional>
 #include <iterator>
+#include <utility>
 #include <vector>
 
+#include "toolbox/sorting/merge_sort/kway_merge.hpp"
+
 namespace toolbox {
 namespace sorting {
 
-namespace detail {
-
-// k-way merge of piles: each pile is in descending order (top = smallest)
-template <typename T, typename Compare>
-std::vector<T> merge_piles(std::vector<std::vector<T>> piles, std::size_t n, Compare comp) {
-    std::vector<T> result;
-    result.reserve(n);
-    while (true) {
-        // Find the pile with the minimum top element
-        int min_index = -1;
-        for (std::size_t i = 0; i < piles.size(); ++i) {
-            if (!piles[i].empty()) {
-                if (min_index == -1 || comp(piles[i].back(), piles[min_index].back())) {
-                    min_index = static_cast<int>(i);
-                }
-            }
-        }
-        if (min_index == -1) {
-            break;
-        }
-        result.push_back(piles[min_index].back());
-        piles[min_index].pop_back();
-        if (piles[min_index].empty()) {
-            piles.erase(piles.begin() + min_index);
-        }
-    }
-    return result;
-}
-
-}  // namespace detail
-
 template <typename RandomIt, typename Compare>
 void patience_sort(RandomIt first, RandomIt last, Compare comp) {
     typedef typename std::iterator_traits<RandomIt>::value_type T;
@@ -47,29 +19,30 @@ void patience_sort(RandomIt first, RandomIt last, Compare comp) {
         return;
     }
 
+    // Each pile is in descending order (top = smallest), and the tops ascend from pile to pile,
+    // so the first pile whose top is greater than the element is found by binary search.
     std::vector<std::vector<T>> piles;
 
     for (RandomIt it = first; it != last; ++it) {
-        const T &val = *it;
-        if (piles.empty()) {
-            piles.push_back(std::vector<T>(1, val));
-        } else {
-            bool placed = false;
-            for (std::size_t j = 0; j < piles.size(); ++j) {
-                if (comp(val, piles[j].back())) {
-                    piles[j].push_back(val);
-                    placed = true;
-                    break;
-                }
-            }
-            if (!placed) {
-                piles.push_back(std::vector<T>(1, val));
-            }
+        auto pile = std::partition_point(piles.begin(), piles.end(), [&](const std::vector<T> &p) {
+            return !comp(*it, p.back());
+        });
+        if (pile == piles.end()) {
+            piles.emplace_back();
+            pile = piles.end() - 1;
         }
+        pile->push_back(std::move(*it));
     }
 
-    std::vector<T> sorted = detail::merge_piles(piles, static_cast<std::size_t>(n), comp);
-    std::copy(sorted.begin(), sorted.end(), first);
+    // k-way merge of the piles, read from their tops. Equal elements lie in piles in input order,
+    // and the merge takes them from the lower pile first.
+    typedef std::move_iterator<typename std::vector<T>::reverse_iterator> PileIt;
+    std::vector<std::pair<PileIt, PileIt>> ranges;
+    ranges.reserve(piles.size());
+    for (std::vector<T> &p : piles) {
+        ranges.emplace_back(std::make_move_iterator(p.rbegin()), std::make_move_iterator(p.rend()));
+    }
+    kway_merge(ranges.begin(), ranges.end(), first, comp);
 }
 
 template <typename RandomIt>
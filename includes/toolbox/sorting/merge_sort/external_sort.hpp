@@ -0,0 +1,605 @@
+#pragma once
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "toolbox/sorting/hybrid_sort/pdq_sort.hpp"
+#include "toolbox/sorting/merge_sort/kway_merge.hpp"
+
+namespace toolbox {
+namespace sorting {
+
+namespace detail {
+
+// Read and write blocks of the merge are between these sizes. The merge fans in as many runs as
+// the memory budget allows with blocks of the minimum size, and as the limit on open files
+// allows, and merges in several passes if there are more runs than that.
+static const std::size_t EXTERNAL_SORT_MIN_BLOCK = 1 << 16;
+static const std::size_t EXTERNAL_SORT_MAX_BLOCK = 1 << 22;
+static const std::size_t EXTERNAL_SORT_MIN_MEMORY = 8 * EXTERNAL_SORT_MIN_BLOCK;
+static const std::size_t EXTERNAL_SORT_STDIO_BUFFER = 1 << 20;
+// Temporary files open at once if the process has no limit on open files.
+static const std::size_t EXTERNAL_SORT_MAX_OPEN = 1 << 12;
+
+struct ExternalFileCloser {
+    void operator()(std::FILE *f) const { std::fclose(f); }
+};
+
+typedef std::unique_ptr<std::FILE, ExternalFileCloser> ExternalFile;
+
+// Creates a temporary file in $TMPDIR (or /tmp). It is unlinked right away, so it disappears
+// when closed, even if the sort fails.
+inline std::FILE *external_temp_file() {
+    const char *dir = std::getenv("TMPDIR");
+    std::string path = std::string(dir != nullptr && *dir != '\0' ? dir : "/tmp");
+    path += "/toolbox_external_sort_XXXXXX";
+    const int fd = ::mkstemp(path.data());
+    if (fd < 0) {
+        return nullptr;
+    }
+    ::unlink(path.c_str());
+    std::FILE *f = ::fdopen(fd, "w+b");
+    if (f == nullptr) {
+        ::close(fd);
+        return nullptr;
+    }
+    std::setvbuf(f, nullptr, _IOFBF, EXTERNAL_SORT_STDIO_BUFFER);
+    return f;
+}
+
+// The number of temporary files kept open at once: half the limit on open files of the process,
+// which leaves the other half to the input, the output and the caller.
+inline std::size_t external_max_open() {
+    struct rlimit limit;
+    if (::getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY) {
+        return EXTERNAL_SORT_MAX_OPEN;
+    }
+    return std::clamp<std::size_t>(static_cast<std::size_t>(limit.rlim_cur / 2), 4,
+                                   EXTERNAL_SORT_MAX_OPEN);
+}
+
+// The number of runs merged at once: as many as get a block of the minimum size, in and out,
+// within memory_bytes, and no more than half of max_open.
+inline std::size_t external_fan_in(std::size_t memory_bytes, std::size_t max_open) {
+    const std::size_t by_memory = memory_bytes / (2 * EXTERNAL_SORT_MIN_BLOCK) - 1;
+    return std::max<std::size_t>(2, std::min(by_memory, max_open / 2));
+}
+
+// Reads a file as blocks of elements of type E. The next block is read on another thread while
+// the current one is consumed.
+template <typename E>
+class ExternalReader {
+ public:
+    ExternalReader(std::FILE *f, std::size_t block) : _f(f), _next(block), _partial(false) {
+        fetch();
+    }
+
+    ~ExternalReader() {
+        if (_pending.valid()) {
+            _pending.wait();
+        }
+    }
+
+    ExternalReader(const ExternalReader &) = delete;
+    ExternalReader &operator=(const ExternalReader &) = delete;
+
+    // Replaces data by the next block. Returns false at the end of the file.
+    bool next(std::vector<E> &data) {
+        if (!_pending.valid()) {
+            return false;
+        }
+        const std::size_t bytes = _pending.get();
+        if (bytes % sizeof(E) != 0) {
+            _partial = true;
+        }
+        const std::size_t count = bytes / sizeof(E);
+        if (count == 0) {
+            return false;
+        }
+        const std::size_t block = _next.size();
+        data.swap(_next);
+        data.resize(count);
+        _next.resize(block);
+        if (count == block) {
+            fetch();
+        }
+        return true;
+    }
+
+    // Whether reading failed or the file ended in the middle of an element.
+    bool failed() const { return _partial || std::ferror(_f) != 0; }
+
+ private:
+    std::FILE *_f;
+    std::vector<E> _next;
+    std::future<std::size_t> _pending;
+    bool _partial;
+
+    void fetch() {
+        _pending = std::async(std::launch::async, [this] {
+            return std::fread(reinterpret_cast<char *>(_next.data()), 1, _next.size() * sizeof(E),
+                              _f);
+        });
+    }
+};
+
+// Buffers output in blocks. A full block is written on another thread while the next one fills.
+class ExternalWriter {
+ public:
+    ExternalWriter(std::FILE *f, std::size_t block) : _f(f), _block(block), _ok(true) {
+        _buf.reserve(block);
+        _spare.reserve(block);
+    }
+
+    ~ExternalWriter() { wait(); }
+
+    ExternalWriter(const ExternalWriter &) = delete;
+    ExternalWriter &operator=(const ExternalWriter &) = delete;
+
+    void put(const char *p, std::size_t n) {
+        while (n > 0) {
+            const std::size_t take = std::min(n, _block - _buf.size());
+            _buf.insert(_buf.end(), p, p + take);
+            p += take;
+            n -= take;
+            if (_buf.size() == _block) {
+                flush();
+            }
+        }
+    }
+
+    // Writes what is buffered and waits for it. Returns false if any write failed.
+    bool finish() {
+        flush();
+        wait();
+        return _ok;
+    }
+
+ private:
+    std::FILE *_f;
+    std::size_t _block;
+    std::vector<char> _buf;
+    std::vector<char> _spare;
+    std::future<bool> _pending;
+    bool _ok;
+
+    void wait() {
+        if (_pending.valid()) {
+            _ok = _pending.get() && _ok;
+        }
+    }
+
+    void flush() {
+        wait();
+        _buf.swap(_spare);
+        _buf.clear();
+        if (_spare.empty()) {
+            return;
+        }
+        _pending = std::async(std::launch::async, [this] {
+            return std::fwrite(_spare.data(), 1, _spare.size(), _f) == _spare.size();
+        });
+    }
+};
+
+// A run of fixed-size binary records, read back for the merge.
+template <typename T>
+class ExternalRecordSource {
+ public:
+    ExternalRecordSource(std::FILE *f, std::size_t block_bytes)
+        : _reader(f, std::max<std::size_t>(1, block_bytes / sizeof(T))), _pos(0) {
+        if (!_reader.next(_block)) {
+            _block.clear();
+        }
+    }
+
+    bool valid() const { return _pos < _block.size(); }
+
+    const T &current() const { return _block[_pos]; }
+
+    void advance() {
+        if (++_pos == _block.size()) {
+            _pos = 0;
+            if (!_reader.next(_block)) {
+                _block.clear();
+            }
+        }
+    }
+
+    bool failed() const { return _reader.failed(); }
+
+ private:
+    ExternalReader<T> _reader;
+    std::vector<T> _block;
+    std::size_t _pos;
+};
+
+// A run of newline-terminated lines, read back for the merge. The current line points into the
+// current block, or into a copy if it spans blocks.
+class ExternalLineSource {
+ public:
+    ExternalLineSource(std::FILE *f, std::size_t block_bytes)
+        : _reader(f, block_bytes), _pos(0), _valid(true) {
+        if (!_reader.next(_block)) {
+            _block.clear();
+        }
+        advance();
+    }
+
+    bool valid() const { return _valid; }
+
+    const std::string_view &current() const { return _line; }
+
+    void advance() {
+        const char *nl = find_newline(_pos);
+        if (nl != nullptr) {
+            _line = std::string_view(_block.data() + _pos, nl - (_block.data() + _pos));
+            _pos = nl - _block.data() + 1;
+            return;
+        }
+        _carry.assign(_block.data() + _pos, _block.size() - _pos);
+        _pos = 0;
+        while (_reader.next(_block)) {
+            nl = find_newline(0);
+            if (nl != nullptr) {
+                _carry.append(_block.data(), nl - _block.data());
+                _pos = nl - _block.data() + 1;
+                _line = _carry;
+                return;
+            }
+            _carry.append(_block.data(), _block.size());
+        }
+        _block.clear();
+        // The last line of a file without a final newline.
+        _valid = !_carry.empty();
+        _line = _carry;
+    }
+
+    bool failed() const { return _reader.failed(); }
+
+ private:
+    ExternalReader<char> _reader;
+    std::vector<char> _block;
+    std::size_t _pos;
+    bool _valid;
+    std::string _carry;
+    std::string_view _line;
+
+    const char *find_newline(std::size_t from) const {
+        if (from >= _block.size()) {
+            return nullptr;
+        }
+        return static_cast<const char *>(std::memchr(_block.data() + from, '\n',
+                                                     _block.size() - from));
+    }
+};
+
+// Fixed-size binary records of a trivially copyable type, in native byte order.
+template <typename T>
+class ExternalRecordFormat {
+ public:
+    typedef T value_type;
+    typedef std::vector<T> Chunk;
+    typedef ExternalRecordSource<T> Source;
+
+    explicit ExternalRecordFormat(std::size_t chunk_bytes)
+        : _capacity(std::max<std::size_t>(1, chunk_bytes / sizeof(T))), _eof(false),
+          _ok(true) {}
+
+    bool eof() const { return _eof; }
+
+    bool ok() const { return _ok; }
+
+    bool fill(std::FILE *f, Chunk &chunk) {
+        chunk.resize(_capacity);
+        const std::size_t want = _capacity * sizeof(T);
+        const std::size_t bytes = std::fread(reinterpret_cast<char *>(chunk.data()), 1, want, f);
+        _eof = bytes < want;
+        _ok = _ok && !std::ferror(f) && bytes % sizeof(T) == 0;
+        chunk.resize(bytes / sizeof(T));
+        return _ok;
+    }
+
+    static bool empty(const Chunk &chunk) { return chunk.empty(); }
+
+    template <typename Compare>
+    static void sort(Chunk &chunk, Compare comp) {
+        pdq_sort(chunk.begin(), chunk.end(), comp);
+    }
+
+    static bool write(std::FILE *f, const Chunk &chunk) {
+        return std::fwrite(chunk.data(), sizeof(T), chunk.size(), f) == chunk.size();
+    }
+
+    static void put(ExternalWriter &out, const T &x) {
+        out.put(reinterpret_cast<const char *>(&x), sizeof(T));
+    }
+
+ private:
+    std::size_t _capacity;
+    bool _eof;
+    bool _ok;
+};
+
+struct ExternalLineChunk {
+    std::vector<char> bytes;
+    std::vector<std::string_view> lines;
+};
+
+// Newline-delimited text. A chunk is a block of whole lines and the views of the lines in it,
+// which are what gets sorted; a line longer than a chunk grows it.
+class ExternalLineFormat {
+ public:
+    typedef std::string_view value_type;
+    typedef ExternalLineChunk Chunk;
+    typedef ExternalLineSource Source;
+
+    explicit ExternalLineFormat(std::size_t chunk_bytes)
+        : _capacity(std::max<std::size_t>(1, chunk_bytes)), _eof(false), _ok(true) {}
+
+    bool eof() const { return _eof; }
+
+    bool ok() const { return _ok; }
+
+    bool fill(std::FILE *f, Chunk &chunk) {
+        chunk.lines.clear();
+        chunk.bytes.assign(_carry.begin(), _carry.end());
+        _carry.clear();
+        std::size_t size = chunk.bytes.size();
+        std::size_t end = 0;
+        while (true) {
+            chunk.bytes.resize(std::max(2 * size, _capacity));
+            size += std::fread(chunk.bytes.data() + size, 1, chunk.bytes.size() - size, f);
+            _eof = size < chunk.bytes.size();
+            const char *data = chunk.bytes.data();
+            const char *last = data + size;
+            while (last != data && *(last - 1) != '\n') {
+                --last;
+            }
+            if (_eof || last != data) {
+                end = _eof ? size : static_cast<std::size_t>(last - data);
+                break;
+            }
+        }
+        _ok = _ok && !std::ferror(f);
+        _carry.assign(chunk.bytes.data() + end, size - end);
+        const char *p = chunk.bytes.data();
+        const char *stop = p + end;
+        while (p != stop) {
+            const char *nl = static_cast<const char *>(std::memchr(p, '\n', stop - p));
+            const char *line_end = nl != nullptr ? nl : stop;
+            chunk.lines.emplace_back(p, line_end - p);
+            p = nl != nullptr ? nl + 1 : stop;
+        }
+        return _ok;
+    }
+
+    static bool empty(const Chunk &chunk) { return chunk.lines.empty(); }
+
+    template <typename Compare>
+    static void sort(Chunk &chunk, Compare comp) {
+        pdq_sort(chunk.lines.begin(), chunk.lines.end(), comp);
+    }
+
+    static bool write(std::FILE *f, const Chunk &chunk) {
+        bool ok = true;
+        for (const std::string_view &line : chunk.lines) {
+            ok = ok && std::fwrite(line.data(), 1, line.size(), f) == line.size();
+            ok = ok && std::fputc('\n', f) != EOF;
+        }
+        return ok;
+    }
+
+    static void put(ExternalWriter &out, const std::string_view &line) {
+        out.put(line.data(), line.size());
+        out.put("\n", 1);
+    }
+
+ private:
+    std::size_t _capacity;
+    bool _eof;
+    bool _ok;
+    std::string _carry;
+};
+
+// Merges the runs into out through a loser tree, splitting the budget between one read block
+// per run and the output.
+template <typename Format, typename Compare>
+bool external_merge(std::vector<ExternalFile> &runs, std::FILE *out, std::size_t memory_bytes,
+                    Compare comp) {
+    typedef typename Format::Source Source;
+    const std::size_t block = std::clamp(memory_bytes / (2 * (runs.size() + 1)),
+                                         EXTERNAL_SORT_MIN_BLOCK, EXTERNAL_SORT_MAX_BLOCK);
+    std::vector<std::unique_ptr<Source>> sources;
+    for (ExternalFile &run : runs) {
+        sources.emplace_back(new Source(run.get(), block));
+    }
+    LoserTree<typename Format::value_type, Compare> tree(sources.size(), comp);
+    for (std::size_t i = 0; i < sources.size(); i++) {
+        if (sources[i]->valid()) {
+            tree.set(i, &sources[i]->current());
+        }
+    }
+    tree.build();
+    ExternalWriter writer(out, block);
+    while (!tree.empty()) {
+        Source &s = *sources[tree.top()];
+        Format::put(writer, s.current());
+        s.advance();
+        tree.replace_top(s.valid() ? &s.current() : nullptr);
+    }
+    bool ok = writer.finish();
+    for (const std::unique_ptr<Source> &s : sources) {
+        ok = ok && !s->failed();
+    }
+    return ok;
+}
+
+// Merges the first count runs of queue into a new run at its back.
+template <typename Format, typename Compare>
+bool external_merge_front(std::deque<ExternalFile> &queue, std::size_t count,
+                          std::size_t memory_bytes, Compare comp) {
+    std::vector<ExternalFile> group;
+    for (std::size_t i = 0; i < count; i++) {
+        group.push_back(std::move(queue.front()));
+        queue.pop_front();
+    }
+    ExternalFile merged(external_temp_file());
+    if (!merged || !external_merge<Format>(group, merged.get(), memory_bytes, comp) ||
+        std::fflush(merged.get()) != 0 || std::fseek(merged.get(), 0, SEEK_SET) != 0) {
+        return false;
+    }
+    queue.push_back(std::move(merged));
+    return true;
+}
+
+// Cuts the input into chunks, sorts each one and writes it to a temporary file. Two chunks are
+// used in turn: one is read on another thread while the other is sorted and written.
+//
+// At most max_open runs are open at once: when a new run and a merge output would go past that,
+// the oldest runs are merged first. The merge gets the half of the budget of the chunk already
+// written, which is freed; the other chunk holds the input read meanwhile.
+template <typename Format, typename Compare>
+bool external_make_runs(std::FILE *in, Format &format, Compare comp, std::size_t memory_bytes,
+                        std::size_t max_open, std::deque<ExternalFile> &runs) {
+    typename Format::Chunk chunks[2];
+    std::future<bool> filled =
+        std::async(std::launch::async, [&] { return format.fill(in, chunks[0]); });
+    std::future<bool> written;
+    bool ok = true;
+    for (int cur = 0;; cur ^= 1) {
+        ok = filled.get() && ok;
+        if (written.valid()) {
+            ok = written.get() && ok;
+        }
+        if (!ok || Format::empty(chunks[cur])) {
+            break;
+        }
+        if (runs.size() + 2 > max_open) {
+            chunks[cur ^ 1] = typename Format::Chunk();
+            const std::size_t half = memory_bytes / 2;
+            if (!external_merge_front<Format>(runs, external_fan_in(half, max_open), half, comp)) {
+                ok = false;
+                break;
+            }
+        }
+        const bool last = format.eof();
+        if (!last) {
+            filled = std::async(std::launch::async,
+                                [&format, in, &next = chunks[cur ^ 1]] {
+                                    return format.fill(in, next);
+                                });
+        }
+        Format::sort(chunks[cur], comp);
+        std::FILE *run = external_temp_file();
+        if (run == nullptr) {
+            ok = false;
+            if (filled.valid()) {
+                filled.wait();
+            }
+            break;
+        }
+        runs.emplace_back(run);
+        written = std::async(std::launch::async, [run, &chunk = chunks[cur]] {
+            return Format::write(run, chunk) && std::fflush(run) == 0 &&
+                   std::fseek(run, 0, SEEK_SET) == 0;
+        });
+        if (last) {
+            ok = written.get() && ok;
+            break;
+        }
+    }
+    return ok;
+}
+
+template <typename Format, typename Compare>
+bool external_sort_impl(const std::string &input, const std::string &output,
+                        std::size_t memory_bytes, Format format, Compare comp) {
+    memory_bytes = std::max(memory_bytes, EXTERNAL_SORT_MIN_MEMORY);
+    const std::size_t max_open = external_max_open();
+    std::deque<ExternalFile> queue;
+    {
+        ExternalFile in(std::fopen(input.c_str(), "rb"));
+        if (!in) {
+            return false;
+        }
+        const bool ok = external_make_runs(in.get(), format, comp, memory_bytes, max_open, queue);
+        if (!ok || !format.ok()) {
+            return false;
+        }
+    }
+    // With more runs than can be merged at once, the oldest runs are merged into longer ones
+    // first.
+    const std::size_t fan_in = external_fan_in(memory_bytes, max_open);
+    while (queue.size() > fan_in) {
+        if (!external_merge_front<Format>(queue, fan_in, memory_bytes, comp)) {
+            return false;
+        }
+    }
+    std::vector<ExternalFile> last;
+    for (ExternalFile &run : queue) {
+        last.push_back(std::move(run));
+    }
+    std::FILE *out = std::fopen(output.c_str(), "wb");
+    if (out == nullptr) {
+        return false;
+    }
+    const bool ok = external_merge<Format>(last, out, memory_bytes, comp);
+    return std::fclose(out) == 0 && ok;
+}
+
+}  // namespace detail
+
+// Sorts the file input of fixed-size records of type T into the file output, using about
+// memory_bytes of memory and temporary files in $TMPDIR (or /tmp). Returns false if a file
+// cannot be read or written, or the input is not a whole number of records.
+template <typename T, typename Compare>
+bool external_sort(const std::string &input, const std::string &output,
+                   std::size_t memory_bytes, Compare comp) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "external_sort records must be trivially copyable");
+    const std::size_t budget = std::max(memory_bytes, detail::EXTERNAL_SORT_MIN_MEMORY);
+    return detail::external_sort_impl(input, output, memory_bytes,
+                                      detail::ExternalRecordFormat<T>(budget / 2), comp);
+}
+
+template <typename T>
+bool external_sort(const std::string &input, const std::string &output,
+                   std::size_t memory_bytes) {
+    return external_sort<T>(input, output, memory_bytes, std::less<T>());
+}
+
+// Sorts the lines of the text file input into the file output, each followed by '\n'. comp
+// compares two std::string_view.
+template <typename Compare>
+bool external_sort_lines(const std::string &input, const std::string &output,
+                         std::size_t memory_bytes, Compare comp) {
+    // A chunk's lines take their bytes plus a std::string_view each, so a quarter of the budget
+    // per chunk in bytes leaves room for lines of 16 bytes or more on average.
+    const std::size_t budget = std::max(memory_bytes, detail::EXTERNAL_SORT_MIN_MEMORY);
+    return detail::external_sort_impl(input, output, memory_bytes,
+                                      detail::ExternalLineFormat(budget / 4), comp);
+}
+
+inline bool external_sort_lines(const std::string &input, const std::string &output,
+                                std::size_t memory_bytes) {
+    return external_sort_lines(input, output, memory_bytes, std::less<std::string_view>());
+}
+
+}  // namespace sorting
+}  // namespace toolbox
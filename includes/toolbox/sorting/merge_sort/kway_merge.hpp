@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace toolbox {
+namespace sorting {
+
+namespace detail {
+
+// Tournament tree of losers over k sources, stored as an implicit binary tree in one array: leaf
+// i is at k + i, node i > 0 holds the source that lost the match there and node 0 the overall
+// winner. Sources are compared through one pointer per source to its current value; a null
+// pointer is the sentinel of an exhausted source, which loses every match. After the winner's
+// source advances, only the matches on its path to the root are replayed, without branching on
+// their outcome. On equal values the lower source wins, so merges are stable.
+template <typename T, typename Compare>
+class LoserTree {
+ public:
+    LoserTree(std::size_t k, Compare comp)
+        : _k(k), _tree(std::max<std::size_t>(k, 1), 0), _keys(k, nullptr), _comp(comp) {}
+
+    // Sets the first value of source i (nullptr if it is empty). Call build() after the last.
+    void set(std::size_t i, const T *key) { _keys[i] = key; }
+
+    void build() {
+        // The matches are played bottom-up from the leaves k + i, keeping the winner of each
+        // node aside.
+        std::vector<std::size_t> winner(2 * _k);
+        for (std::size_t i = 0; i < _k; i++) {
+            winner[_k + i] = i;
+        }
+        for (std::size_t node = _k > 0 ? _k - 1 : 0; node > 0; node--) {
+            const std::size_t a = winner[2 * node];
+            const std::size_t b = winner[2 * node + 1];
+            const bool b_wins = wins(b, a);
+            _tree[node] = b_wins ? a : b;
+            winner[node] = b_wins ? b : a;
+        }
+        _tree[0] = _k > 1 ? winner[1] : 0;
+    }
+
+    // Whether every source is exhausted.
+    bool empty() const { return _k == 0 || _keys[_tree[0]] == nullptr; }
+
+    // The source of the smallest current value.
+    std::size_t top() const { return _tree[0]; }
+
+    // Replaces the value of source top() by key (nullptr if the source is exhausted).
+    void replace_top(const T *key) {
+        std::size_t winner = _tree[0];
+        _keys[winner] = key;
+        for (std::size_t node = (winner + _k) / 2; node > 0; node /= 2) {
+            // Swaps through a mask instead of a branch: which side wins is unpredictable.
+            const std::size_t loser = _tree[node];
+            const std::size_t mask = 0 - static_cast<std::size_t>(wins(loser, winner));
+            const std::size_t swap = (loser ^ winner) & mask;
+            _tree[node] = loser ^ swap;
+            winner ^= swap;
+        }
+        _tree[0] = winner;
+    }
+
+ private:
+    std::size_t _k;
+    std::vector<std::size_t> _tree;
+    std::vector<const T *> _keys;
+    Compare _comp;
+
+    // Whether source a goes before source b: ties go to the lower source.
+    bool wins(std::size_t a, std::size_t b) const {
+        const T *ka = _keys[a];
+        const T *kb = _keys[b];
+        if (ka == nullptr || kb == nullptr) {
+            return kb == nullptr && ka != nullptr;
+        }
+        if constexpr (std::is_arithmetic<T>::value) {
+            // Two comparisons of numbers cost less than a branch on the order of the operands.
+            return _comp(*ka, *kb) | (!_comp(*kb, *ka) & (a < b));
+        } else {
+            // With the lower source as a, a wins unless b is less: one comparison either way.
+            const bool a_lower = a < b;
+            return _comp(*(a_lower ? kb : ka), *(a_lower ? ka : kb)) != a_lower;
+        }
+    }
+};
+
+// The address of the element at it, which must be a reference into the range.
+template <typename It>
+const typename std::iterator_traits<It>::value_type *kway_key(It it) {
+    const typename std::iterator_traits<It>::value_type &ref = *it;
+    return &ref;
+}
+
+}  // namespace detail
+
+// Merges the sorted ranges [ranges[i].first, ranges[i].second) into out and returns the end of
+// the output. Equal elements keep the order of their ranges.
+template <typename RangeIt, typename OutputIt, typename Compare>
+OutputIt kway_merge(RangeIt first, RangeIt last, OutputIt out, Compare comp) {
+    typedef typename std::iterator_traits<RangeIt>::value_type Range;
+    typedef typename std::iterator_traits<typename Range::first_type>::value_type T;
+    std::vector<Range> ranges(first, last);
+    if (ranges.size() == 1) {
+        return std::copy(ranges[0].first, ranges[0].second, out);
+    }
+    detail::LoserTree<T, Compare> tree(ranges.size(), comp);
+    for (std::size_t i = 0; i < ranges.size(); i++) {
+        if (ranges[i].first != ranges[i].second) {
+            tree.set(i, detail::kway_key(ranges[i].first));
+        }
+    }
+    tree.build();
+    while (!tree.empty()) {
+        Range &r = ranges[tree.top()];
+        *out = *r.first;
+        ++out;
+        ++r.first;
+        tree.replace_top(r.first != r.second ? detail::kway_key(r.first) : nullptr);
+    }
+    return out;
+}
+
+template <typename RangeIt, typename OutputIt>
+OutputIt kway_merge(RangeIt first, RangeIt last, OutputIt out) {
+    typedef typename std::iterator_traits<RangeIt>::value_type Range;
+    typedef typename std::iterator_traits<typename Range::first_type>::value_type T;
+    return kway_merge(first, last, out, std::less<T>());
+}
+
+}  // namespace sorting
+}  // namespace toolbox
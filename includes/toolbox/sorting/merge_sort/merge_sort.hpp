@@ -1,38 +1,159 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
+#include <cstddef>
 #include <functional>
 #include <iterator>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "toolbox/sorting/network_sort/sorting_network.hpp"
+
 namespace toolbox {
 namespace sorting {
 
 namespace detail {
 
+// Ranges up to this size are sorted by merge_sort_small. Larger ones start from runs of
+// MERGE_SORT_RUN elements or twice that, whichever leaves an odd number of merge passes.
+static const std::size_t MERGE_SORT_SMALL = 32;
+static const std::size_t MERGE_SORT_RUN = 16;
+// The passes that merge runs shorter than this many bytes are done one tile at a time, while the
+// tile and its part of the buffer are in cache.
+static const std::size_t MERGE_SORT_TILE_BYTES = 1 << 17;
+
 template <typename RandomIt, typename Compare>
-void merge_sort_impl(RandomIt first, RandomIt last, Compare comp) {
+void merge_sort_insertion(RandomIt first, RandomIt last, Compare comp) {
     typedef typename std::iterator_traits<RandomIt>::value_type T;
-    std::ptrdiff_t n = std::distance(first, last);
-    if (n <= 1) {
+    if (first == last) {
         return;
     }
+    for (RandomIt it = first + 1; it != last; ++it) {
+        if (comp(*it, *(it - 1))) {
+            T tmp = std::move(*it);
+            RandomIt hole = it;
+            do {
+                *hole = std::move(*(hole - 1));
+                --hole;
+            } while (hole != first && comp(tmp, *(hole - 1)));
+            *hole = std::move(tmp);
+        }
+    }
+}
+
+// Merges the sorted [a, a_last) and [b, b_last) into out, taking the element of the first range on
+// ties, which keeps the sort stable. Every step moves one element, so min(remaining) steps can run
+// without checking for the end, and the side taken is advanced by the result of the comparison
+// instead of a branch on it.
+template <typename InIt, typename OutIt, typename Compare>
+OutIt merge_sort_merge(InIt a, InIt a_last, InIt b, InIt b_last, OutIt out, Compare comp) {
+    if (a != a_last && b != b_last && !comp(*b, *(a_last - 1))) {
+        out = std::move(a, a_last, out);
+        return std::move(b, b_last, out);
+    }
+    while (a != a_last && b != b_last) {
+        for (std::ptrdiff_t steps = std::min(a_last - a, b_last - b); steps > 0; --steps) {
+            typedef typename std::iterator_traits<InIt>::value_type T;
+            if constexpr (std::is_trivially_copyable<T>::value) {
+                const bool take_b = comp(*b, *a);
+                *out = std::move(take_b ? *b : *a);
+                b += take_b;
+                a += !take_b;
+            } else if (comp(*b, *a)) {
+                *out = std::move(*b++);
+            } else {
+                *out = std::move(*a++);
+            }
+            ++out;
+        }
+    }
+    out = std::move(a, a_last, out);
+    return std::move(b, b_last, out);
+}
 
-    RandomIt mid = first + n / 2;
-    std::vector<T> left(first, mid);
-    std::vector<T> right(mid, last);
+// Merges each pair of neighbouring runs of length width in src[0, n) into dst[0, n).
+template <typename SrcIt, typename DstIt, typename Compare>
+void merge_sort_pass(SrcIt src, DstIt dst, std::size_t n, std::size_t width, Compare comp) {
+    std::size_t i = 0;
+    for (; i + width < n; i += 2 * width) {
+        const std::size_t mid = i + width;
+        const std::size_t end = std::min(n, mid + width);
+        merge_sort_merge(src + i, src + mid, src + mid, src + end, dst + i, comp);
+    }
+    // A last run without a partner is moved as it is.
+    if (i < n) {
+        std::move(src + i, src + n, dst + i);
+    }
+}
 
-    merge_sort_impl(left.begin(), left.end(), comp);
-    merge_sort_impl(right.begin(), right.end(), comp);
+// Merges runs of length width into runs of length limit or more, alternating between buf and
+// [first, first + n) as source and destination. Returns whether the result is in buf.
+template <typename RandomIt, typename T, typename Compare>
+bool merge_sort_passes(RandomIt first, T *buf, std::size_t n, std::size_t width,
+                       std::size_t limit, bool in_buf, Compare comp) {
+    for (; width < limit; width *= 2) {
+        if (in_buf) {
+            merge_sort_pass(buf, first, n, width, comp);
+        } else {
+            merge_sort_pass(first, buf, n, width, comp);
+        }
+        in_buf = !in_buf;
+    }
+    return in_buf;
+}
 
-    std::merge(left.begin(), left.end(), right.begin(), right.end(), first, comp);
+template <typename RandomIt, typename Compare>
+void merge_sort_small(RandomIt first, std::size_t n, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    if constexpr (NetworkStable<T, Compare>::value) {
+        network_sort(first, n, comp);
+    } else {
+        merge_sort_insertion(first, first + n, comp);
+    }
+}
+
+template <typename RandomIt, typename Compare>
+void merge_sort_impl(RandomIt first, std::size_t n, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    if (n <= MERGE_SORT_SMALL) {
+        merge_sort_small(first, n, comp);
+        return;
+    }
+    std::size_t run = MERGE_SORT_RUN;
+    std::size_t passes = 0;
+    for (std::size_t w = run; w < n; w *= 2) {
+        passes++;
+    }
+    if (passes % 2 == 0) {
+        run *= 2;
+    }
+    // The only allocation. With the data moved into it, an odd number of passes ends back in the
+    // range.
+    std::vector<T> buffer(std::make_move_iterator(first), std::make_move_iterator(first + n));
+    T *buf = buffer.data();
+    for (std::size_t start = 0; start < n; start += run) {
+        merge_sort_small(buf + start, std::min(run, n - start), comp);
+    }
+    const std::size_t tile = std::max(run, std::bit_floor(MERGE_SORT_TILE_BYTES / sizeof(T)));
+    bool in_buf = true;
+    for (std::size_t start = 0; start < n; start += tile) {
+        // Every tile takes the same number of passes, so all of them end on the same side.
+        in_buf = merge_sort_passes(first + start, buf + start, std::min(tile, n - start), run,
+                                   std::min(tile, n), true, comp);
+    }
+    in_buf = merge_sort_passes(first, buf, n, tile, n, in_buf, comp);
+    if (in_buf) {
+        std::move(buf, buf + n, first);
+    }
 }
 
 }  // namespace detail
 
 template <typename RandomIt, typename Compare>
 void merge_sort(RandomIt first, RandomIt last, Compare comp) {
-    detail::merge_sort_impl(first, last, comp);
+    detail::merge_sort_impl(first, static_cast<std::size_t>(std::distance(first, last)), comp);
 }
 
 template <typename RandomIt>
@@ -0,0 +1,353 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace toolbox {
+namespace sorting {
+
+namespace detail {
+
+static const std::size_t SORT_N_MAX = 32;
+// Batcher's network for 32 elements has 191 comparators.
+static const std::size_t SORT_N_MAX_COMPARATORS = 191;
+
+struct SortingNetwork {
+    std::size_t size;
+    uint8_t lo[SORT_N_MAX_COMPARATORS];
+    uint8_t hi[SORT_N_MAX_COMPARATORS];
+};
+
+// Batcher's odd-even merge sort network for the next power of two P >= n. Every comparator puts
+// the smaller element at the lower index, so elements past n can be taken to be +infinity: they
+// never move, and the comparators that touch them are dropped.
+constexpr SortingNetwork make_sorting_network(std::size_t n) {
+    SortingNetwork net{};
+    const std::size_t p2 = std::bit_ceil(n);
+    for (std::size_t p = 1; p < p2; p *= 2) {
+        for (std::size_t k = p; k >= 1; k /= 2) {
+            for (std::size_t j = k % p; j + k < p2; j += 2 * k) {
+                for (std::size_t i = 0; i < k && i + j + k < n; i++) {
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                        net.lo[net.size] = static_cast<uint8_t>(i + j);
+                        net.hi[net.size] = static_cast<uint8_t>(i + j + k);
+                        net.size++;
+                    }
+                }
+            }
+        }
+    }
+    return net;
+}
+
+template <std::size_t N>
+inline constexpr SortingNetwork SORT_N_NETWORK = make_sorting_network(N);
+
+// Integers other than bool, float and double under std::less or std::greater. They are sorted as
+// signed integer keys of the same size (see network_key) with branch-free compare-exchanges, and
+// may be padded with the largest key.
+template <typename T, typename Compare>
+struct NetworkSortable
+    : std::integral_constant<bool, ((std::is_integral<T>::value &&
+                                     !std::is_same<T, bool>::value) ||
+                                    std::is_same<T, float>::value ||
+                                    std::is_same<T, double>::value) &&
+                                       (std::is_same<Compare, std::less<T>>::value ||
+                                        std::is_same<Compare, std::greater<T>>::value ||
+                                        std::is_same<Compare, std::less<>>::value ||
+                                        std::is_same<Compare, std::greater<>>::value)> {};
+
+// Networks are not stable, but equal integers cannot be told apart, so the stable sorts may use
+// them for integers (not for floating point numbers: -0.0 and 0.0 compare equal).
+template <typename T, typename Compare>
+struct NetworkStable
+    : std::integral_constant<bool, NetworkSortable<T, Compare>::value &&
+                                       std::is_integral<T>::value> {};
+
+template <typename T, typename Compare>
+struct NetworkDescending
+    : std::integral_constant<bool, std::is_same<Compare, std::greater<T>>::value ||
+                                       std::is_same<Compare, std::greater<>>::value> {};
+
+template <typename T>
+struct NetworkKey {
+    typedef typename std::conditional<std::is_floating_point<T>::value,
+                                      std::conditional<sizeof(T) == 4, int32_t, int64_t>,
+                                      std::make_signed<T>>::type::type type;
+};
+
+// A signed integer whose order is that of x. Unsigned integers have the top bit flipped. Negative
+// floating point numbers have the bits other than the sign flipped, which puts -0.0 before 0.0
+// and NaNs at the ends, so that every key compares and no key sorts after the padding.
+template <typename T>
+typename NetworkKey<T>::type network_key(T x) {
+    typedef typename NetworkKey<T>::type K;
+    if constexpr (std::is_floating_point<T>::value) {
+        const K bits = std::bit_cast<K>(x);
+        return bits ^ ((bits >> (8 * sizeof(K) - 1)) & std::numeric_limits<K>::max());
+    } else if constexpr (std::is_unsigned<T>::value) {
+        return static_cast<K>(x ^ static_cast<T>(T(1) << (8 * sizeof(T) - 1)));
+    } else {
+        return x;
+    }
+}
+
+template <typename T>
+T network_value(typename NetworkKey<T>::type key) {
+    typedef typename NetworkKey<T>::type K;
+    if constexpr (std::is_floating_point<T>::value) {
+        return std::bit_cast<T>(key ^ ((key >> (8 * sizeof(K) - 1)) &
+                                       std::numeric_limits<K>::max()));
+    } else if constexpr (std::is_unsigned<T>::value) {
+        return static_cast<T>(static_cast<T>(key) ^ static_cast<T>(T(1) << (8 * sizeof(T) - 1)));
+    } else {
+        return key;
+    }
+}
+
+template <typename T, typename Compare>
+inline void network_swap_if(T &a, T &b, Compare comp) {
+    if constexpr (std::is_integral<T>::value) {
+        const bool swap = comp(b, a);
+        const T lo = swap ? b : a;
+        b = swap ? a : b;
+        a = lo;
+    } else if (comp(b, a)) {
+        std::swap(a, b);
+    }
+}
+
+template <std::size_t N, typename It, typename Compare, std::size_t... I>
+void apply_sorting_network(It v, Compare comp, std::index_sequence<I...>) {
+    (network_swap_if(v[SORT_N_NETWORK<N>.lo[I]], v[SORT_N_NETWORK<N>.hi[I]], comp), ...);
+}
+
+template <std::size_t N, typename It, typename Compare>
+void apply_sorting_network(It v, Compare comp) {
+    apply_sorting_network<N>(v, comp, std::make_index_sequence<SORT_N_NETWORK<N>.size>());
+}
+
+#if defined(__AVX2__)
+
+// Kernel for 32-bit keys, eight to a register. A compare-exchange between two registers is done
+// lane by lane; within a register, exchange<J> pairs lane i with lane i ^ J and blend<M> takes the
+// larger value in the lanes set in M. (A kernel for 64-bit keys, which has no min and max and
+// needs a compare and two blends, measured slower than the scalar network.)
+struct SimdNetworkI32 {
+    typedef __m256i vec;
+    typedef int32_t elem;
+    static const int lanes = 8;
+    static vec load(const elem *p) { return _mm256_load_si256(reinterpret_cast<const vec *>(p)); }
+    static void store(elem *p, vec v) { _mm256_store_si256(reinterpret_cast<vec *>(p), v); }
+    static void minmax(vec &a, vec &b) {
+        const vec lo = _mm256_min_epi32(a, b);
+        b = _mm256_max_epi32(a, b);
+        a = lo;
+    }
+    static vec reverse(vec v) {
+        return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    }
+    template <int J>
+    static vec exchange(vec v) {
+        if constexpr (J == 1) {
+            return _mm256_shuffle_epi32(v, 0xb1);
+        } else if constexpr (J == 2) {
+            return _mm256_shuffle_epi32(v, 0x4e);
+        } else {
+            return _mm256_permute2x128_si256(v, v, 0x01);
+        }
+    }
+    template <int M>
+    static vec blend(vec lo, vec hi) {
+        return _mm256_blend_epi32(lo, hi, M);
+    }
+};
+
+// Lanes that take the larger value in the bitonic sort step that pairs lanes at distance j
+// within blocks of k: the upper lane of each pair, flipped in the blocks that sort downwards.
+constexpr int simd_network_mask(int k, int j) {
+    int mask = 0;
+    for (int i = 0; i < 8; i++) {
+        mask |= (((i & j) != 0) != ((i & k) != 0)) << i;
+    }
+    return mask;
+}
+
+template <typename S, int K, int J>
+typename S::vec simd_network_step(typename S::vec v) {
+    typename S::vec lo = v;
+    typename S::vec hi = S::template exchange<J>(v);
+    S::minmax(lo, hi);
+    return S::template blend<simd_network_mask(K, J)>(lo, hi);
+}
+
+// Sorts a register whose lanes form a bitonic sequence.
+template <typename S>
+typename S::vec simd_merge_lanes(typename S::vec v) {
+    v = simd_network_step<S, 8, 4>(v);
+    v = simd_network_step<S, 8, 2>(v);
+    return simd_network_step<S, 8, 1>(v);
+}
+
+template <typename S>
+typename S::vec simd_sort_lanes(typename S::vec v) {
+    v = simd_network_step<S, 2, 1>(v);
+    v = simd_network_step<S, 4, 2>(v);
+    v = simd_network_step<S, 4, 1>(v);
+    return simd_merge_lanes<S>(v);
+}
+
+// Bitonic sort of V registers: each register is sorted on its own, then runs of w registers are
+// merged pairwise. Reversing the second run of a pair makes the pair one bitonic sequence, which
+// compare-exchanges at distances w, w / 2, ..., 1 registers and then within registers sort.
+template <typename S, std::size_t V>
+void simd_sort_registers(typename S::elem *p) {
+    typename S::vec v[V];
+    for (std::size_t i = 0; i < V; i++) {
+        v[i] = simd_sort_lanes<S>(S::load(p + i * S::lanes));
+    }
+    for (std::size_t w = 1; w < V; w *= 2) {
+        for (std::size_t g = 0; g < V; g += 2 * w) {
+            for (std::size_t t = 0; t < w / 2; t++) {
+                std::swap(v[g + w + t], v[g + 2 * w - 1 - t]);
+            }
+            for (std::size_t t = 0; t < w; t++) {
+                v[g + w + t] = S::reverse(v[g + w + t]);
+            }
+            for (std::size_t d = w; d >= 1; d /= 2) {
+                for (std::size_t i = g; i < g + 2 * w; i++) {
+                    if (((i - g) & d) == 0) {
+                        S::minmax(v[i], v[i + d]);
+                    }
+                }
+            }
+            for (std::size_t i = g; i < g + 2 * w; i++) {
+                v[i] = simd_merge_lanes<S>(v[i]);
+            }
+        }
+    }
+    for (std::size_t i = 0; i < V; i++) {
+        S::store(p + i * S::lanes, v[i]);
+    }
+}
+
+#endif
+
+// The number of lanes of the AVX2 kernel for K, or 0 if there is none.
+template <typename K>
+constexpr std::size_t network_simd_lanes() {
+#if defined(__AVX2__)
+    if constexpr (std::is_same<K, int32_t>::value) {
+        return SimdNetworkI32::lanes;
+    }
+#endif
+    return 0;
+}
+
+// Sorts the keys v[0, k), k a power of two from 4 to SORT_N_MAX, with the AVX2 kernel for K if
+// there is one and k fills whole registers, and with Batcher's network otherwise.
+template <typename K>
+void network_sort_keys(K *v, std::size_t k) {
+#if defined(__AVX2__)
+    if constexpr (network_simd_lanes<K>() != 0) {
+        if (k >= network_simd_lanes<K>()) {
+            switch (k / network_simd_lanes<K>()) {
+                case 1:
+                    simd_sort_registers<SimdNetworkI32, 1>(v);
+                    return;
+                case 2:
+                    simd_sort_registers<SimdNetworkI32, 2>(v);
+                    return;
+                default:
+                    simd_sort_registers<SimdNetworkI32, 4>(v);
+                    return;
+            }
+        }
+    }
+#endif
+    switch (k) {
+        case 4:
+            apply_sorting_network<4>(v, std::less<K>());
+            break;
+        case 8:
+            apply_sorting_network<8>(v, std::less<K>());
+            break;
+        case 16:
+            apply_sorting_network<16>(v, std::less<K>());
+            break;
+        default:
+            apply_sorting_network<32>(v, std::less<K>());
+            break;
+    }
+}
+
+// Leaf sort of the hybrid sorts for NetworkSortable types: sorts n <= SORT_N_MAX elements with
+// the network for the next power of two, padded with the largest key, so that only a few
+// networks are instantiated.
+template <typename RandomIt, typename Compare>
+void network_sort(RandomIt first, std::size_t n, Compare) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    typedef typename NetworkKey<T>::type K;
+    if (n <= 1) {
+        return;
+    }
+    alignas(32) K v[SORT_N_MAX];
+    const std::size_t k = std::max<std::size_t>(4, std::bit_ceil(n));
+    for (std::size_t i = 0; i < n; i++) {
+        v[i] = network_key(first[i]);
+    }
+    std::fill(v + n, v + k, std::numeric_limits<K>::max());
+    network_sort_keys(v, k);
+    for (std::size_t i = 0; i < n; i++) {
+        first[i] = network_value<T>(v[NetworkDescending<T, Compare>::value ? n - 1 - i : i]);
+    }
+}
+
+}  // namespace detail
+
+template <std::size_t N, typename RandomIt, typename Compare>
+void sort_n(RandomIt first, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    static_assert(N <= detail::SORT_N_MAX, "sort_n sorts at most 32 elements");
+    if constexpr (N <= 1) {
+        static_cast<void>(first);
+        static_cast<void>(comp);
+    } else if constexpr (detail::NetworkSortable<T, Compare>::value) {
+        typedef typename detail::NetworkKey<T>::type K;
+        if constexpr (detail::network_simd_lanes<K>() != 0) {
+            detail::network_sort(first, N, comp);
+        } else {
+            K v[N];
+            for (std::size_t i = 0; i < N; i++) {
+                v[i] = detail::network_key(first[i]);
+            }
+            detail::apply_sorting_network<N>(v, std::less<K>());
+            for (std::size_t i = 0; i < N; i++) {
+                first[i] = detail::network_value<T>(
+                    v[detail::NetworkDescending<T, Compare>::value ? N - 1 - i : i]);
+            }
+        }
+    } else {
+        detail::apply_sorting_network<N>(first, comp);
+    }
+}
+
+template <std::size_t N, typename RandomIt>
+void sort_n(RandomIt first) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    sort_n<N>(first, std::less<T>());
+}
+
+}  // namespace sorting
+}  // namespace toolbox
@@ -1,12 +1,54 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <iterator>
+#include <utility>
 
 namespace toolbox {
 namespace sorting {
 
+namespace detail {
+
+// Replaces the top of the heap [first, first + n) by value and sifts it down: one pass instead of
+// the two of pop_heap and push_heap.
+template <typename RandomIt, typename T, typename Compare>
+void heap_replace_top(RandomIt first, std::ptrdiff_t n, T &&value, Compare comp) {
+    std::ptrdiff_t hole = 0;
+    std::ptrdiff_t child = 1;
+    while (child < n) {
+        if (child + 1 < n && comp(first[child], first[child + 1])) {
+            child++;
+        }
+        if (!comp(value, first[child])) {
+            break;
+        }
+        first[hole] = std::move(first[child]);
+        hole = child;
+        child = 2 * hole + 1;
+    }
+    first[hole] = std::forward<T>(value);
+}
+
+// Moves the middle - first smallest elements of [first, last) to [first, middle), as a heap with
+// the largest of them at first.
+template <typename RandomIt, typename Compare>
+void heap_select(RandomIt first, RandomIt middle, RandomIt last, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    std::make_heap(first, middle, comp);
+    const std::ptrdiff_t k = middle - first;
+    for (RandomIt it = middle; it < last; ++it) {
+        if (comp(*it, *first)) {
+            T value = std::move(*it);
+            *it = std::move(*first);
+            heap_replace_top(first, k, std::move(value), comp);
+        }
+    }
+}
+
+}  // namespace detail
+
 template <typename RandomIt, typename Compare>
 void heap_sort(RandomIt first, RandomIt last, Compare comp) {
     std::make_heap(first, last, comp);
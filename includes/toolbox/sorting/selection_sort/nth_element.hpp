@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "toolbox/sorting/insertion_sort/insertion_sort.hpp"
+#include "toolbox/sorting/selection_sort/heap_sort.hpp"
+
+namespace toolbox {
+namespace sorting {
+
+namespace detail {
+
+static const std::ptrdiff_t SELECT_INSERTION_SORT_THRESHOLD = 16;
+static const std::ptrdiff_t SELECT_SAMPLE_THRESHOLD = 600;
+
+// Floyd-Rivest selection of the k-th element of a[left, right]. A large range first selects k
+// within a subrange of about n^(2/3) elements around k, which makes a[k] a pivot close to the k-th
+// element of the whole range, so that the partition leaves only a small range around k. After
+// depth partitions the range is finished by heap selection, which bounds the worst case by
+// O(n log n) as in introselect.
+template <typename RandomIt, typename Compare>
+void floyd_rivest_select(RandomIt a, std::ptrdiff_t left, std::ptrdiff_t right, std::ptrdiff_t k,
+                         Compare comp, int depth) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    while (right - left > SELECT_INSERTION_SORT_THRESHOLD) {
+        if (depth == 0) {
+            heap_select(a + left, a + k + 1, a + right + 1, comp);
+            std::iter_swap(a + left, a + k);
+            return;
+        }
+        depth--;
+        if (right - left > SELECT_SAMPLE_THRESHOLD) {
+            const double n = static_cast<double>(right - left + 1);
+            const double i = static_cast<double>(k - left + 1);
+            const double z = std::log(n);
+            const double s = 0.5 * std::exp(2.0 * z / 3.0);
+            const double sd = 0.5 * std::sqrt(z * s * (n - s) / n) * (i < n / 2 ? -1.0 : 1.0);
+            const std::ptrdiff_t sub_left = std::max(
+                left, static_cast<std::ptrdiff_t>(static_cast<double>(k) - i * s / n + sd));
+            const std::ptrdiff_t sub_right = std::min(
+                right, static_cast<std::ptrdiff_t>(static_cast<double>(k) + (n - i) * s / n + sd));
+            // The subrange is filled with elements taken at even steps across the range, so that
+            // it is a sample of the whole range even if the range is ordered in some pattern.
+            const std::ptrdiff_t m = sub_right - sub_left + 1;
+            const std::ptrdiff_t step = (right - left + 1) / m;
+            for (std::ptrdiff_t j = 0; j < m; j++) {
+                std::iter_swap(a + sub_left + j, a + left + j * step);
+            }
+            floyd_rivest_select(a, sub_left, sub_right, k, comp, depth);
+        }
+        // Hoare partition around t = a[k], with the pivot and an element on the other side of it
+        // at the two ends as sentinels. Elements equal to the pivot stop both scans, so many equal
+        // elements still split evenly.
+        const T t = a[k];
+        std::iter_swap(a + left, a + k);
+        const bool pivot_right = comp(t, a[right]);
+        if (pivot_right) {
+            std::iter_swap(a + left, a + right);
+        }
+        std::ptrdiff_t i = left;
+        std::ptrdiff_t j = right;
+        while (i < j) {
+            std::iter_swap(a + i, a + j);
+            i++;
+            j--;
+            while (comp(a[i], t)) {
+                i++;
+            }
+            while (comp(t, a[j])) {
+                j--;
+            }
+        }
+        // The first swap moved the pivot to the other end.
+        if (pivot_right) {
+            std::iter_swap(a + left, a + j);
+        } else {
+            j++;
+            std::iter_swap(a + j, a + right);
+        }
+        if (j <= k) {
+            left = j + 1;
+        }
+        if (k <= j) {
+            right = j - 1;
+        }
+    }
+    if (left < right) {
+        insertion_sort(a + left, a + right + 1, comp);
+    }
+}
+
+}  // namespace detail
+
+// Rearranges [first, last) so that *nth is the element that would be there if the range were
+// sorted, with no element after it less than any element before it.
+template <typename RandomIt, typename Compare>
+void nth_element(RandomIt first, RandomIt nth, RandomIt last, Compare comp) {
+    const std::ptrdiff_t n = last - first;
+    if (n <= 1 || nth >= last) {
+        return;
+    }
+    const int depth = 2 * static_cast<int>(std::log2(static_cast<double>(n)));
+    detail::floyd_rivest_select(first, 0, n - 1, nth - first, comp, depth);
+}
+
+template <typename RandomIt>
+void nth_element(RandomIt first, RandomIt nth, RandomIt last) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    // Qualified, or argument-dependent lookup also finds std::nth_element.
+    sorting::nth_element(first, nth, last, std::less<T>());
+}
+
+}  // namespace sorting
+}  // namespace toolbox
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+
+#include "toolbox/sorting/hybrid_sort/pdq_sort.hpp"
+#include "toolbox/sorting/selection_sort/heap_sort.hpp"
+#include "toolbox/sorting/selection_sort/nth_element.hpp"
+
+namespace toolbox {
+namespace sorting {
+
+namespace detail {
+
+// Below n / PARTIAL_SORT_HEAP_RATIO elements the k smallest are selected with a heap of k
+// elements, which rejects most elements with one comparison against its top; above, with
+// nth_element, whose partitions cost O(n) whatever k is.
+static const std::ptrdiff_t PARTIAL_SORT_HEAP_RATIO = 512;
+// heap_select that gives up once replacing the top has cost more sift steps, about log2 k each,
+// than there are elements. Returns whether [first, middle) holds the smallest elements; if not,
+// the range has only been permuted. A random order replaces the top about k ln(n / k) times,
+// well within the limit below n / PARTIAL_SORT_HEAP_RATIO; an order like a descending one, which
+// replaces it for every element, costs no more than one more pass before nth_element takes over.
+template <typename RandomIt, typename Compare>
+bool partial_sort_heap_select(RandomIt first, RandomIt middle, RandomIt last, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    std::make_heap(first, middle, comp);
+    const std::ptrdiff_t k = middle - first;
+    std::ptrdiff_t budget =
+        (last - first) / static_cast<std::ptrdiff_t>(std::bit_width(static_cast<std::size_t>(k)));
+    for (RandomIt it = middle; it < last; ++it) {
+        if (comp(*it, *first)) {
+            if (--budget < 0) {
+                return false;
+            }
+            T value = std::move(*it);
+            *it = std::move(*first);
+            heap_replace_top(first, k, std::move(value), comp);
+        }
+    }
+    return true;
+}
+
+}  // namespace detail
+
+// Rearranges [first, last) so that [first, middle) holds the middle - first smallest elements in
+// sorted order. The order of the other elements is unspecified.
+template <typename RandomIt, typename Compare>
+void partial_sort(RandomIt first, RandomIt middle, RandomIt last, Compare comp) {
+    const std::ptrdiff_t k = middle - first;
+    const std::ptrdiff_t n = last - first;
+    if (k <= 0) {
+        return;
+    }
+    const bool selected = k < n / detail::PARTIAL_SORT_HEAP_RATIO &&
+                          detail::partial_sort_heap_select(first, middle, last, comp);
+    if (!selected && k < n) {
+        sorting::nth_element(first, middle - 1, last, comp);
+        --middle;
+    }
+    pdq_sort(first, middle, comp);
+}
+
+template <typename RandomIt>
+void partial_sort(RandomIt first, RandomIt middle, RandomIt last) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    sorting::partial_sort(first, middle, last, std::less<T>());
+}
+
+}  // namespace sorting
+}  // namespace toolbox
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "toolbox/sorting/network_sort/sorting_network.hpp"
+#include "toolbox/sorting/selection_sort/heap_sort.hpp"
+
+namespace toolbox {
+namespace sorting {
+
+namespace detail {
+
+// Elements compared to the threshold at a time, before looking at them one by one.
+static const std::size_t TOP_K_FILTER_BYTES = 128;
+
+// Numbers under less or greater: a block of them is compared to the threshold without branches.
+template <typename T, typename Compare>
+struct TopKFilterable : NetworkSortable<T, Compare> {};
+
+#if defined(__AVX2__)
+
+typedef __m256i TopKMask;
+static const std::size_t TOP_K_SIMD_BYTES = 32;
+
+// Integers of 4 or 8 bytes, float and double have a compare of a whole register.
+template <typename T, typename Compare>
+struct TopKSimd
+    : std::integral_constant<bool, TopKFilterable<T, Compare>::value &&
+                                       (sizeof(T) == 4 || sizeof(T) == 8)> {};
+
+// The lanes of the register at p that are greater than t with Greater, less otherwise. Unsigned
+// integers are compared as signed ones with the top bit flipped.
+template <bool Greater, typename T>
+TopKMask top_k_simd_compare(const T *p, T t) {
+    if constexpr (std::is_same<T, float>::value) {
+        const __m256 x = _mm256_loadu_ps(p);
+        const __m256 v = _mm256_set1_ps(t);
+        return _mm256_castps_si256(Greater ? _mm256_cmp_ps(x, v, _CMP_GT_OQ)
+                                           : _mm256_cmp_ps(x, v, _CMP_LT_OQ));
+    } else if constexpr (std::is_same<T, double>::value) {
+        const __m256d x = _mm256_loadu_pd(p);
+        const __m256d v = _mm256_set1_pd(t);
+        return _mm256_castpd_si256(Greater ? _mm256_cmp_pd(x, v, _CMP_GT_OQ)
+                                           : _mm256_cmp_pd(x, v, _CMP_LT_OQ));
+    } else {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        __m256i v = sizeof(T) == 4 ? _mm256_set1_epi32(static_cast<int32_t>(t))
+                                   : _mm256_set1_epi64x(static_cast<int64_t>(t));
+        if constexpr (std::is_unsigned<T>::value) {
+            const __m256i flip = sizeof(T) == 4 ? _mm256_set1_epi32(INT32_MIN)
+                                                : _mm256_set1_epi64x(INT64_MIN);
+            x = _mm256_xor_si256(x, flip);
+            v = _mm256_xor_si256(v, flip);
+        }
+        if constexpr (sizeof(T) == 4) {
+            return Greater ? _mm256_cmpgt_epi32(x, v) : _mm256_cmpgt_epi32(v, x);
+        } else {
+            return Greater ? _mm256_cmpgt_epi64(x, v) : _mm256_cmpgt_epi64(v, x);
+        }
+    }
+}
+
+inline TopKMask top_k_mask_zero() { return _mm256_setzero_si256(); }
+inline TopKMask top_k_mask_or(TopKMask a, TopKMask b) { return _mm256_or_si256(a, b); }
+inline bool top_k_mask_any(TopKMask m) { return !_mm256_testz_si256(m, m); }
+
+#elif defined(__SSE2__)
+
+typedef __m128i TopKMask;
+static const std::size_t TOP_K_SIMD_BYTES = 16;
+
+// SSE2 has no compare of 64-bit integers.
+template <typename T, typename Compare>
+struct TopKSimd
+    : std::integral_constant<bool, TopKFilterable<T, Compare>::value &&
+                                       (sizeof(T) == 4 || std::is_same<T, double>::value)> {};
+
+template <bool Greater, typename T>
+TopKMask top_k_simd_compare(const T *p, T t) {
+    if constexpr (std::is_same<T, float>::value) {
+        const __m128 x = _mm_loadu_ps(p);
+        const __m128 v = _mm_set1_ps(t);
+        return _mm_castps_si128(Greater ? _mm_cmpgt_ps(x, v) : _mm_cmplt_ps(x, v));
+    } else if constexpr (std::is_same<T, double>::value) {
+        const __m128d x = _mm_loadu_pd(p);
+        const __m128d v = _mm_set1_pd(t);
+        return _mm_castpd_si128(Greater ? _mm_cmpgt_pd(x, v) : _mm_cmplt_pd(x, v));
+    } else {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i v = _mm_set1_epi32(static_cast<int32_t>(t));
+        if constexpr (std::is_unsigned<T>::value) {
+            const __m128i flip = _mm_set1_epi32(INT32_MIN);
+            x = _mm_xor_si128(x, flip);
+            v = _mm_xor_si128(v, flip);
+        }
+        return Greater ? _mm_cmpgt_epi32(x, v) : _mm_cmplt_epi32(x, v);
+    }
+}
+
+inline TopKMask top_k_mask_zero() { return _mm_setzero_si128(); }
+inline TopKMask top_k_mask_or(TopKMask a, TopKMask b) { return _mm_or_si128(a, b); }
+inline bool top_k_mask_any(TopKMask m) { return _mm_movemask_epi8(m) != 0; }
+
+#endif
+
+// Whether comp(p[i], t) for any of the TOP_K_FILTER_BYTES / sizeof(T) elements at p.
+template <typename T, typename Compare>
+bool top_k_block_any(const T *p, const T &t, Compare comp) {
+    const std::size_t block = TOP_K_FILTER_BYTES / sizeof(T);
+#if defined(__AVX2__) || defined(__SSE2__)
+    if constexpr (TopKSimd<T, Compare>::value) {
+        const bool greater = NetworkDescending<T, Compare>::value;
+        const std::size_t lanes = TOP_K_SIMD_BYTES / sizeof(T);
+        TopKMask any = top_k_mask_zero();
+        for (std::size_t i = 0; i < block; i += lanes) {
+            any = top_k_mask_or(any, top_k_simd_compare<greater>(p + i, t));
+        }
+        return top_k_mask_any(any);
+    }
+#endif
+    // Without a branch in the loop.
+    bool any = false;
+    for (std::size_t i = 0; i < block; i++) {
+        any |= comp(p[i], t);
+    }
+    return any;
+}
+
+// The index of the first of p[0, n) that comes before t under comp, or n if there is none.
+template <typename T, typename Compare>
+std::size_t top_k_find(const T *p, std::size_t n, const T &t, Compare comp) {
+    const std::size_t block = TOP_K_FILTER_BYTES / sizeof(T);
+    std::size_t i = 0;
+    for (; i + block <= n; i += block) {
+        if (top_k_block_any(p + i, t, comp)) {
+            for (std::size_t j = i; j < i + block; j++) {
+                if (comp(p[j], t)) {
+                    return j;
+                }
+            }
+        }
+    }
+    for (; i < n; i++) {
+        if (comp(p[i], t)) {
+            return i;
+        }
+    }
+    return n;
+}
+
+}  // namespace detail
+
+// Streaming selection of the k elements that come first under comp: the k largest with the
+// default std::greater. The elements kept form a heap with the last of them on top, so an element
+// that does not make it costs one comparison, and one that does O(log k).
+//
+// Top-k sets of parts of the input, e.g. one per thread, are combined with merge().
+template <typename T, typename Compare = std::greater<T>>
+class TopK {
+ public:
+    explicit TopK(std::size_t k, Compare comp = Compare()) : _k(k), _comp(comp) {
+        _heap.reserve(k);
+    }
+
+    void push(const T &x) {
+        if (_heap.size() < _k) {
+            _heap.push_back(x);
+            std::push_heap(_heap.begin(), _heap.end(), _comp);
+        } else if (_k > 0 && _comp(x, _heap.front())) {
+            detail::heap_replace_top(_heap.begin(), static_cast<std::ptrdiff_t>(_k), x, _comp);
+        }
+    }
+
+    // Pushes every element of [first, last). Once k elements are kept, a contiguous range of
+    // numbers under less or greater is compared to the threshold a block at a time (with SSE2 or
+    // AVX2), and only the blocks with a candidate are looked at one by one.
+    template <typename InputIt>
+    void push(InputIt first, InputIt last) {
+        for (; first != last && _heap.size() < _k; ++first) {
+            push(*first);
+        }
+        if (first == last || _k == 0) {
+            return;
+        }
+        typedef typename std::iterator_traits<InputIt>::value_type V;
+        if constexpr (std::contiguous_iterator<InputIt> && std::is_same<V, T>::value &&
+                      detail::TopKFilterable<T, Compare>::value) {
+            const T *p = std::to_address(first);
+            const std::size_t n = static_cast<std::size_t>(last - first);
+            std::size_t i = 0;
+            while ((i += detail::top_k_find(p + i, n - i, _heap.front(), _comp)) < n) {
+                detail::heap_replace_top(_heap.begin(), static_cast<std::ptrdiff_t>(_k), p[i],
+                                         _comp);
+                i++;
+            }
+        } else {
+            for (; first != last; ++first) {
+                push(*first);
+            }
+        }
+    }
+
+    // Adds the elements kept by other, e.g. the top k of another part of the input.
+    void merge(const TopK &other) { push(other._heap.begin(), other._heap.end()); }
+
+    std::size_t k() const { return _k; }
+    std::size_t size() const { return _heap.size(); }
+    bool empty() const { return _heap.empty(); }
+
+    // The last of the elements kept. Once size() == k(), an element has to come before it under
+    // comp to be kept. Requires !empty().
+    const T &threshold() const { return _heap.front(); }
+
+    // The elements kept, in order under comp.
+    std::vector<T> sorted() const {
+        std::vector<T> v = _heap;
+        std::sort_heap(v.begin(), v.end(), _comp);
+        return v;
+    }
+
+    void clear() { _heap.clear(); }
+
+ private:
+    std::size_t _k;
+    std::vector<T> _heap;
+    Compare _comp;
+};
+
+}  // namespace sorting
+}  // namespace toolbox
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "toolbox/sorting/distribution_sort/msd_radix_sort.hpp"
+#include "toolbox/sorting/distribution_sort/parallel_sort.hpp"
+#include "toolbox/sorting/distribution_sort/radix_sort.hpp"
 #include "toolbox/sorting/exchange_sort/bubble_sort.hpp"
 #include "toolbox/sorting/exchange_sort/comb_sort.hpp"
 #include "toolbox/sorting/exchange_sort/gnome_sort.hpp"
@@ -9,15 +12,23 @@
 #include "toolbox/sorting/exchange_sort/ternary_split_quick_sort.hpp"
 #include "toolbox/sorting/hybrid_sort/intro_sort.hpp"
 #include "toolbox/sorting/hybrid_sort/merge_insertion_sort.hpp"
+#include "toolbox/sorting/hybrid_sort/pdq_sort.hpp"
 #include "toolbox/sorting/hybrid_sort/tim_sort.hpp"
+#include "toolbox/sorting/indirect_sort/sort_by_key.hpp"
 #include "toolbox/sorting/insertion_sort/binary_insertion_sort.hpp"
 #include "toolbox/sorting/insertion_sort/insertion_sort.hpp"
 #include "toolbox/sorting/insertion_sort/patience_sort.hpp"
 #include "toolbox/sorting/insertion_sort/shell_sort.hpp"
+#include "toolbox/sorting/merge_sort/external_sort.hpp"
+#include "toolbox/sorting/merge_sort/kway_merge.hpp"
 #include "toolbox/sorting/merge_sort/merge_sort.hpp"
+#include "toolbox/sorting/network_sort/sorting_network.hpp"
 #include "toolbox/sorting/selection_sort/cartesian_tree_sort.hpp"
 #include "toolbox/sorting/selection_sort/cycle_sort.hpp"
 #include "toolbox/sorting/selection_sort/heap_sort.hpp"
+#include "toolbox/sorting/selection_sort/nth_element.hpp"
+#include "toolbox/sorting/selection_sort/partial_sort.hpp"
 #include "toolbox/sorting/selection_sort/selection_sort.hpp"
+#include "toolbox/sorting/selection_sort/top_k.hpp"
 #include "toolbox/sorting/selection_sort/tournament_sort.hpp"
 #include "toolbox/sorting/selection_sort/tree_sort.hpp"
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "toolbox/string/packed_dna.hpp"
 #include "toolbox/string/suffixarray.hpp"
 
 namespace toolbox {
@@ -21,6 +22,12 @@ struct fm_index {
     ~fm_index() = default;
     explicit fm_index(const std::string &s) { build(s); }
     fm_index(const std::string &s, const std::string &order) { build(s, order); }
+    /**
+     * @brief Indexes a packed DNA sequence, read as the string of its bases (ACGT and N).
+     * @note The suffix array is built from the 2-bit codes directly: the text is not unpacked to
+     * a std::string first.
+     */
+    explicit fm_index(const packed_dna &s) { build(s); }
 
     /**
      * @brief Counts the number of occurrences of a pattern in the indexed string.
@@ -132,6 +139,35 @@ struct fm_index {
         build_c();
     }
 
+    void build(const packed_dna &s) {
+        _n = s.size() + 1;
+        // Ranks in character order, as build(std::string) gives them: $ < A < C < G < N < T.
+        std::vector<int> cnt(5, 0);
+        for (std::size_t i = 0; i < s.size(); i++) {
+            cnt[s.code(i)]++;
+        }
+        _order.assign(256, -1);
+        _order[static_cast<int>('$')] = 0;
+        int rank = 0;
+        for (char c : {'A', 'C', 'G', 'N', 'T'}) {
+            if (cnt[detail::packed_dna_code(c)] > 0) {
+                _order[static_cast<int>(c)] = ++rank;
+            }
+        }
+        _num_c = rank;
+        int code_rank[5];
+        for (int c = 0; c < 5; c++) {
+            code_rank[c] = _order[static_cast<int>(detail::PACKED_DNA_SYMBOLS[c])];
+        }
+        std::vector<int> s_int(_n, 0);
+        for (std::size_t i = 0; i < s.size(); i++) {
+            s_int[i] = code_rank[s.code(i)];
+        }
+        build_bwt(s_int);
+        build_occ();
+        build_c();
+    }
+
     void build_sa_bwt() {
         std::vector<int> s_int(_n);
         for (int i = 0; i < _n; i++) {
@@ -141,10 +177,21 @@ struct fm_index {
             }
             s_int[i] = _order[static_cast<int>(_s[i])];
         }
+        build_bwt(s_int);
+    }
+
+    // Suffix array and BWT of the rank sequence s_int (s_int[_n - 1] = 0 is the '$').
+    void build_bwt(const std::vector<int> &s_int) {
+        std::vector<char> symbol(_num_c + 1, '$');
+        for (int c = 0; c < 256; c++) {
+            if (_order[c] > 0) {
+                symbol[_order[c]] = static_cast<char>(c);
+            }
+        }
         _sa = toolbox::string::suffixarray(s_int, _num_c);
         _bwt.resize(_n);
         for (int i = 0; i < _n; i++) {
-            _bwt[i] = _s[(_sa[i] + _n - 1) % _n];
+            _bwt[i] = symbol[s_int[(_sa[i] + _n - 1) % _n]];
         }
     }
 
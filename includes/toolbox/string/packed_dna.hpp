@@ -0,0 +1,365 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace toolbox {
+
+namespace string {
+
+namespace detail {
+
+// 2-bit codes of the bases; N (any other character) is code 0 with its bit set in the N-mask.
+inline const char PACKED_DNA_SYMBOLS[5] = {'A', 'C', 'G', 'T', 'N'};
+
+inline uint8_t packed_dna_code(char c) {
+    switch (c) {
+        case 'A':
+        case 'a':
+            return 0;
+        case 'C':
+        case 'c':
+            return 1;
+        case 'G':
+        case 'g':
+            return 2;
+        case 'T':
+        case 't':
+        case 'U':
+        case 'u':
+            return 3;
+        default:
+            return 4;
+    }
+}
+
+/**
+ * @brief Reverses the order of the 32 2-bit fields of x.
+ */
+inline uint64_t reverse_bases(uint64_t x) {
+    x = (x >> 2 & 0x3333333333333333ULL) | (x & 0x3333333333333333ULL) << 2;
+    x = (x >> 4 & 0x0F0F0F0F0F0F0F0FULL) | (x & 0x0F0F0F0F0F0F0F0FULL) << 4;
+    x = (x >> 8 & 0x00FF00FF00FF00FFULL) | (x & 0x00FF00FF00FF00FFULL) << 8;
+    x = (x >> 16 & 0x0000FFFF0000FFFFULL) | (x & 0x0000FFFF0000FFFFULL) << 16;
+    return x >> 32 | x << 32;
+}
+
+/**
+ * @brief Doubles each of the low 32 bits of x into a 2-bit field (bit i to bits 2i and 2i + 1).
+ */
+inline uint64_t spread_bits(uint64_t x) {
+    x &= 0xFFFFFFFFULL;
+    x = (x | x << 16) & 0x0000FFFF0000FFFFULL;
+    x = (x | x << 8) & 0x00FF00FF00FF00FFULL;
+    x = (x | x << 4) & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | x << 2) & 0x3333333333333333ULL;
+    x = (x | x << 1) & 0x5555555555555555ULL;
+    return x | x << 1;
+}
+
+}  // namespace detail
+
+/**
+ * @brief A DNA sequence packed 2 bits per base, with a 1-bit mask of the N positions.
+ * @note Base i is bits 2(i mod 32) .. 2(i mod 32) + 1 of word i / 32 (A 0, C 1, G 2, T 3). The
+ * bits past the last base are zero, and one zero word of padding follows, so that 32 bases can be
+ * read from any position without a bounds check. U reads as T; any other character is stored as
+ * N and read back as 'N', so a packed_dna compares like its std::string of ACGTN. It takes a
+ * quarter of the memory of a std::string, and 32 bases are compared with one XOR.
+ */
+class packed_dna {
+ public:
+    /**
+     * @brief Random-access iterator over the bases as characters 'A', 'C', 'G', 'T', 'N'.
+     * @note The characters are computed on access (there is no char to refer to), so reference is
+     * char. position() and sequence() give the word-level operations (common_prefix) a handle.
+     */
+    class const_iterator {
+     public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef char value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const char *pointer;
+        typedef char reference;
+
+        const_iterator() : _seq(nullptr), _pos(0) {}
+        const_iterator(const packed_dna *seq, std::size_t pos)
+            : _seq(seq), _pos(static_cast<difference_type>(pos)) {}
+
+        char operator*() const { return (*_seq)[_pos]; }
+        char operator[](difference_type d) const { return (*_seq)[_pos + d]; }
+        const_iterator &operator++() {
+            _pos++;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            _pos++;
+            return old;
+        }
+        const_iterator &operator--() {
+            _pos--;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            const_iterator old = *this;
+            _pos--;
+            return old;
+        }
+        const_iterator &operator+=(difference_type d) {
+            _pos += d;
+            return *this;
+        }
+        const_iterator &operator-=(difference_type d) {
+            _pos -= d;
+            return *this;
+        }
+        friend const_iterator operator+(const_iterator it, difference_type d) { return it += d; }
+        friend const_iterator operator+(difference_type d, const_iterator it) { return it += d; }
+        friend const_iterator operator-(const_iterator it, difference_type d) { return it -= d; }
+        friend difference_type operator-(const const_iterator &a, const const_iterator &b) {
+            return a._pos - b._pos;
+        }
+        friend bool operator==(const const_iterator &a, const const_iterator &b) {
+            return a._pos == b._pos;
+        }
+        friend std::strong_ordering operator<=>(const const_iterator &a, const const_iterator &b) {
+            return a._pos <=> b._pos;
+        }
+
+        const packed_dna &sequence() const { return *_seq; }
+        std::size_t position() const { return static_cast<std::size_t>(_pos); }
+
+     private:
+        const packed_dna *_seq;
+        difference_type _pos;
+    };
+
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    packed_dna() : _words(1, 0), _mask(1, 0), _size(0), _n_count(0) {}
+    explicit packed_dna(const std::string &s) : packed_dna() { append(s); }
+
+    std::size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    // Number of N bases.
+    std::size_t n_count() const { return _n_count; }
+
+    /**
+     * @brief The code of base i: 0 .. 3 for ACGT, 4 for N.
+     */
+    uint8_t code(std::size_t i) const {
+        if (is_n(i)) {
+            return 4;
+        }
+        return static_cast<uint8_t>(_words[i / 32] >> (2 * (i % 32)) & 3);
+    }
+    bool is_n(std::size_t i) const { return _n_count != 0 && (_mask[i / 64] >> (i % 64) & 1); }
+    char operator[](std::size_t i) const { return detail::PACKED_DNA_SYMBOLS[code(i)]; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, _size); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    // The packed words and the N-mask (64 bases per word), each with its padding word.
+    const std::vector<uint64_t> &words() const { return _words; }
+    const std::vector<uint64_t> &n_mask() const { return _mask; }
+
+    void clear() {
+        _words.assign(1, 0);
+        _mask.assign(1, 0);
+        _size = 0;
+        _n_count = 0;
+    }
+
+    void reserve(std::size_t n) {
+        _words.reserve((n + 31) / 32 + 1);
+        _mask.reserve((n + 63) / 64 + 1);
+    }
+
+    void push_back(char c) {
+        const uint8_t x = detail::packed_dna_code(c);
+        if (x == 4) {
+            _mask[_size / 64] |= 1ULL << (_size % 64);
+            _n_count++;
+        } else {
+            _words[_size / 32] |= static_cast<uint64_t>(x) << (2 * (_size % 32));
+        }
+        // The base went into the padding word: add a new one.
+        if (_size % 32 == 0) {
+            _words.push_back(0);
+        }
+        if (_size % 64 == 0) {
+            _mask.push_back(0);
+        }
+        _size++;
+    }
+
+    void append(const std::string &s) {
+        reserve(_size + s.size());
+        for (char c : s) {
+            push_back(c);
+        }
+    }
+
+    /**
+     * @brief The sequence as characters ACGTN.
+     * @note [Complexity]: O(n) time complexity.
+     */
+    std::string str() const { return std::string(begin(), end()); }
+
+    /**
+     * @brief The bases pos .. pos + 31 (those past the end read as 0) in one word, base pos in the
+     * low bits. N bases read as A; see n_bits.
+     */
+    uint64_t bases(std::size_t pos) const {
+        assert(pos <= _size);
+        const std::size_t w = pos / 32;
+        const int shift = static_cast<int>(2 * (pos % 32));
+        const uint64_t next = w + 1 < _words.size() ? _words[w + 1] : 0;
+        // (next << 1) << (63 - shift) is next << (64 - shift), and 0 for shift 0.
+        return _words[w] >> shift | (next << 1) << (63 - shift);
+    }
+
+    /**
+     * @brief The N-mask bits of bases pos .. pos + 31, base pos in bit 0.
+     */
+    uint32_t n_bits(std::size_t pos) const {
+        assert(pos <= _size);
+        const std::size_t w = pos / 64;
+        const int shift = static_cast<int>(pos % 64);
+        const uint64_t next = w + 1 < _mask.size() ? _mask[w + 1] : 0;
+        return static_cast<uint32_t>(_mask[w] >> shift | (next << 1) << (63 - shift));
+    }
+
+    /**
+     * @brief Bases pos .. pos + len - 1 (clamped to the end).
+     * @note Copied a word at a time.
+     * @note [Complexity]: O(len / 32 + N) time complexity for N N bases in the range.
+     */
+    packed_dna substr(std::size_t pos, std::size_t len = std::string::npos) const {
+        assert(pos <= _size);
+        len = std::min(len, _size - pos);
+        packed_dna r;
+        r._size = len;
+        r._words.assign((len + 31) / 32 + 1, 0);
+        r._mask.assign((len + 63) / 64 + 1, 0);
+        for (std::size_t w = 0; w * 32 < len; w++) {
+            r._words[w] = bases(pos + 32 * w);
+        }
+        r.trim();
+        r.copy_n(*this, [pos](std::size_t i) { return i - pos; }, pos, pos + len);
+        return r;
+    }
+
+    /**
+     * @brief The reverse complement (A <-> T, C <-> G, N stays N).
+     * @note Each output word is an input word with its 2-bit fields reversed and inverted, so no
+     * base is visited on its own.
+     * @note [Complexity]: O(n / 32 + N) time complexity.
+     */
+    packed_dna reverse_complement() const {
+        packed_dna r;
+        r._size = _size;
+        r._words.assign(_words.size(), 0);
+        r._mask.assign(_mask.size(), 0);
+        // Output word w holds the complements of input bases n - 32w - 1 down to n - 32w - 32.
+        for (std::size_t w = 0; w * 32 < _size; w++) {
+            const std::size_t top = _size - 32 * w;  // one past the first input base
+            if (top >= 32) {
+                r._words[w] = ~detail::reverse_bases(bases(top - 32));
+            } else {
+                r._words[w] = ~detail::reverse_bases(bases(0)) >> (2 * (32 - top));
+            }
+        }
+        r.trim();
+        // An N is stored as A, which the complement turned into T: clear it back to 0.
+        r.copy_n(*this, [this](std::size_t i) { return _size - 1 - i; }, 0, _size);
+        for (std::size_t w = 0; w < r._mask.size(); w++) {
+            for (uint64_t m = r._mask[w]; m != 0; m &= m - 1) {
+                const std::size_t i = 64 * w + std::countr_zero(m);
+                r._words[i / 32] &= ~(3ULL << (2 * (i % 32)));
+            }
+        }
+        return r;
+    }
+
+    friend bool operator==(const packed_dna &a, const packed_dna &b) {
+        return a._size == b._size && a._words == b._words && a._mask == b._mask;
+    }
+
+ private:
+    std::vector<uint64_t> _words;
+    std::vector<uint64_t> _mask;
+    std::size_t _size;
+    std::size_t _n_count;
+
+    // Zeroes the bits past the last base.
+    void trim() {
+        if (_size % 32 != 0) {
+            _words[_size / 32] &= (1ULL << (2 * (_size % 32))) - 1;
+        }
+    }
+
+    // Sets the N bits of the bases of from[first .. last), at the positions given by to(i).
+    template <typename Map>
+    void copy_n(const packed_dna &from, Map to, std::size_t first, std::size_t last) {
+        if (from._n_count == 0) {
+            return;
+        }
+        for (std::size_t w = first / 64; w < from._mask.size() && 64 * w < last; w++) {
+            for (uint64_t m = from._mask[w]; m != 0; m &= m - 1) {
+                const std::size_t i = 64 * w + std::countr_zero(m);
+                if (i >= first && i < last) {
+                    const std::size_t j = to(i);
+                    _mask[j / 64] |= 1ULL << (j % 64);
+                    _n_count++;
+                }
+            }
+        }
+    }
+};
+
+/**
+ * @brief Length of the common prefix of a[i..) and b[j..), at most limit.
+ * @note Compares 32 bases per step: the first differing base is found from the trailing zero bits
+ * of the XOR of two words, with the N-mask bits folded in so that N matches only N.
+ * @note [Complexity]: O(l / 32) time complexity for a common prefix of length l.
+ */
+inline std::size_t common_prefix(const packed_dna &a, std::size_t i, const packed_dna &b,
+                                 std::size_t j, std::size_t limit = std::string::npos) {
+    if (i >= a.size() || j >= b.size()) {
+        return 0;
+    }
+    limit = std::min(limit, std::min(a.size() - i, b.size() - j));
+    // The words are read at fixed shifts, and every position below size() is followed by a whole
+    // word (the padding), so the loop needs no bounds checks.
+    const uint64_t *wa = a.words().data() + i / 32;
+    const uint64_t *wb = b.words().data() + j / 32;
+    const int sa = static_cast<int>(2 * (i % 32));
+    const int sb = static_cast<int>(2 * (j % 32));
+    const bool masks = a.n_count() != 0 || b.n_count() != 0;
+    for (std::size_t len = 0; len < limit; len += 32, wa++, wb++) {
+        uint64_t diff = (wa[0] >> sa | (wa[1] << 1) << (63 - sa)) ^
+                        (wb[0] >> sb | (wb[1] << 1) << (63 - sb));
+        if (masks) {
+            diff |= detail::spread_bits(a.n_bits(i + len) ^ b.n_bits(j + len));
+        }
+        if (diff != 0) {
+            return std::min(limit, len + std::countr_zero(diff) / 2);
+        }
+    }
+    return limit;
+}
+
+}  // namespace string
+
+}  // namespace toolbox
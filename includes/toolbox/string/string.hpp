@@ -4,6 +4,7 @@
 #include "toolbox/string/kmp.hpp"
 #include "toolbox/string/lcp_array.hpp"
 #include "toolbox/string/morris_pratt.hpp"
+#include "toolbox/string/packed_dna.hpp"
 #include "toolbox/string/patricia_trie.hpp"
 #include "toolbox/string/rabin_karp.hpp"
 #include "toolbox/string/suffixarray.hpp"
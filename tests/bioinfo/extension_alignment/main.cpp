@@ -0,0 +1,129 @@
+#include <string>
+
+#include "toolbox/bioinfo/alignment/extension_alignment/xdrop.hpp"
+
+#include "utils/test_util.hpp"
+
+namespace {
+
+// Aligned strings must have equal length, and removing the gaps must give a prefix of each
+// original sequence (an extension is anchored at the start of both).
+bool is_valid_extension(const std::string &s1, const std::string &s2, const std::string &a1,
+                        const std::string &a2) {
+    if (a1.size() != a2.size()) {
+        return false;
+    }
+    std::string r1, r2;
+    for (char c : a1) {
+        if (c != '-') {
+            r1 += c;
+        }
+    }
+    for (char c : a2) {
+        if (c != '-') {
+            r2 += c;
+        }
+    }
+    return s1.compare(0, r1.size(), r1) == 0 && s2.compare(0, r2.size(), r2) == 0;
+}
+
+// Similarity score of a gapped alignment under match a / mismatch -x / gap -g.
+int extension_score(const std::string &a1, const std::string &a2, int a, int x, int g) {
+    int score = 0;
+    for (std::size_t i = 0; i < a1.size(); i++) {
+        if (a1[i] == '-' || a2[i] == '-') {
+            score -= g;
+        } else {
+            score += a1[i] == a2[i] ? a : -x;
+        }
+    }
+    return score;
+}
+
+// ---- X-drop extension -------------------------------------------------------
+// Default: a=1 (match score), x=1 (mismatch penalty), g=1 (gap penalty).
+
+bool test_xdrop_identical_prefix() {
+    // The common prefix extends, then the random tails drive the score down and stop it.
+    const std::string s1 = "ACGTACGTACGTTTTTTTTTT";
+    const std::string s2 = "ACGTACGTACGTGGGGGGGGGGGG";
+    std::string a1, a2;
+    int score = toolbox::alignment::xdrop_extend(s1, s2, a1, a2, 3);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(score == 12, "X-drop prefix: score == common prefix");
+    ok &= toolbox::test_utils::check(a1 == "ACGTACGTACGT" && a2 == a1,
+                                     "X-drop prefix: alignment is the common prefix");
+    return ok;
+}
+
+bool test_xdrop_gap() {
+    // One deleted base in s2: a gap costs 2, well within X = 5, and the extension carries on.
+    const std::string s1 = "GATTACAGATTACAGATTACA";
+    const std::string s2 = "GATTACAGATTCAGATTACA";
+    std::string a1, a2;
+    int score = toolbox::alignment::xdrop_extend(s1, s2, a1, a2, 5, 1, 1, 2);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(score == 18, "X-drop gap: score == 20 - 2");
+    ok &= toolbox::test_utils::check(is_valid_extension(s1, s2, a1, a2),
+                                     "X-drop gap: alignment valid");
+    ok &= toolbox::test_utils::check(extension_score(a1, a2, 1, 1, 2) == score,
+                                     "X-drop gap: alignment score == score");
+    return ok;
+}
+
+bool test_xdrop_stops_early() {
+    // The gap costs 8 but X is only 4: the extension cannot bridge it and stops before.
+    const std::string s1 = "ACGTACGTAAAAAAAACGTACGTACGTACGT";
+    const std::string s2 = "ACGTACGTCGTACGTACGTACGT";
+    std::string a1, a2;
+    int narrow = toolbox::alignment::xdrop_extend(s1, s2, a1, a2, 4);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(narrow == 8, "X-drop early: stops at the first block");
+    ok &= toolbox::test_utils::check(is_valid_extension(s1, s2, a1, a2),
+                                     "X-drop early: alignment valid");
+    int wide = toolbox::alignment::xdrop_extend(s1, s2, a1, a2, 20);
+    ok &= toolbox::test_utils::check(wide == 15, "X-drop wide: bridges the gap (23 - 8)");
+    ok &= toolbox::test_utils::check(extension_score(a1, a2, 1, 1, 1) == wide,
+                                     "X-drop wide: alignment score == score");
+    return ok;
+}
+
+bool test_xdrop_empty() {
+    std::string a1, a2;
+    int score = toolbox::alignment::xdrop_extend("", "ACGT", a1, a2, 10);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(score == 0, "X-drop empty: score == 0");
+    ok &= toolbox::test_utils::check(a1.empty() && a2.empty(), "X-drop empty: empty alignment");
+    return ok;
+}
+
+bool test_xdrop_result() {
+    const std::string s1 = "GATTACAGATTACAGATTACA";
+    const std::string s2 = "GATTACAGATTCAGATTACA";
+    std::string e1, e2, a1, a2;
+    int expected = toolbox::alignment::xdrop_extend(s1, s2, e1, e2, 5, 1, 1, 2);
+    toolbox::alignment::alignment_result res;
+    int score = toolbox::alignment::xdrop_extend(s1, s2, res, 5, 1, 1, 2);
+    toolbox::alignment::alignment_to_aligned(s1, s2, res, a1, a2);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(score == expected && res.score == score,
+                                     "X-drop result: score");
+    ok &= toolbox::test_utils::check(a1 == e1 && a2 == e2, "X-drop result: same alignment");
+    ok &= toolbox::test_utils::check(res.begin1 == 0 && res.begin2 == 0 &&
+                                         res.end1 == s1.size() && res.end2 == s2.size(),
+                                     "X-drop result: anchored at the start");
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    toolbox::test_utils::Test tests[] = {
+        {"xdrop_identical_prefix", test_xdrop_identical_prefix},
+        {"xdrop_gap", test_xdrop_gap},
+        {"xdrop_stops_early", test_xdrop_stops_early},
+        {"xdrop_empty", test_xdrop_empty},
+        {"xdrop_result", test_xdrop_result},
+    };
+    return toolbox::test_utils::run_tests(tests, sizeof(tests) / sizeof(tests[0]));
+}
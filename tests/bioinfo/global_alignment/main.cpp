@@ -1,10 +1,19 @@
 #include <iostream>
 #include <string>
+#include <vector>
 
+#include "toolbox/bioinfo/alignment/global_alignment/banded.hpp"
 #include "toolbox/bioinfo/alignment/global_alignment/diff.hpp"
+#include "toolbox/bioinfo/alignment/global_alignment/hirschberg.hpp"
+#include "toolbox/bioinfo/alignment/global_alignment/myers_bitvector.hpp"
 #include "toolbox/bioinfo/alignment/global_alignment/nw.hpp"
+#include "toolbox/bioinfo/alignment/global_alignment/nw_scored.hpp"
 #include "toolbox/bioinfo/alignment/global_alignment/nwg.hpp"
 #include "toolbox/bioinfo/alignment/global_alignment/wavefront.hpp"
+#include "toolbox/bioinfo/alignment/global_alignment/wavefront_compact.hpp"
+#include "toolbox/bioinfo/alignment/scoring.hpp"
+#include "toolbox/bioinfo/alignment/traceback.hpp"
+#include "toolbox/string/packed_dna.hpp"
 
 #include "utils/test_util.hpp"
 
@@ -31,6 +40,63 @@ bool is_valid_alignment(const std::string &s1, const std::string &s2, const std:
     return r1 == s1 && r2 == s2;
 }
 
+// Unit-cost (Levenshtein) cost of a gapped alignment.
+int unit_cost(const std::string &a1, const std::string &a2) {
+    int cost = 0;
+    for (std::size_t i = 0; i < a1.size(); i++) {
+        cost += a1[i] != a2[i];
+    }
+    return cost;
+}
+
+// Cost of a gapped alignment under match a / mismatch x / gap open o / gap extension e.
+// A run of '-' in a1 (insertion) or in a2 (deletion) costs o + e * length.
+int affine_cost(const std::string &a1, const std::string &a2, int a, int x, int o, int e) {
+    int cost = 0;
+    for (std::size_t i = 0; i < a1.size(); i++) {
+        if (a1[i] == '-') {
+            cost += e + ((i == 0 || a1[i - 1] != '-') ? o : 0);
+        } else if (a2[i] == '-') {
+            cost += e + ((i == 0 || a2[i - 1] != '-') ? o : 0);
+        } else {
+            cost += a1[i] == a2[i] ? a : x;
+        }
+    }
+    return cost;
+}
+
+// Deterministic pseudo-random DNA string (LCG).
+std::string make_dna(std::size_t n, unsigned seed) {
+    std::string s(n, 'A');
+    unsigned x = seed;
+    for (std::size_t i = 0; i < n; i++) {
+        x = x * 1664525u + 1013904223u;
+        s[i] = "ACGT"[(x >> 16) % 4];
+    }
+    return s;
+}
+
+// Copy of s with roughly one in `rate` positions substituted, deleted or duplicated.
+std::string mutate(const std::string &s, unsigned rate, unsigned seed) {
+    std::string t;
+    unsigned x = seed;
+    for (char c : s) {
+        x = x * 1664525u + 1013904223u;
+        unsigned r = (x >> 16) % (3 * rate);
+        if (r == 0) {
+            t += c == 'A' ? 'C' : 'A';
+        } else if (r == 1) {
+            continue;
+        } else if (r == 2) {
+            t += c;
+            t += c;
+        } else {
+            t += c;
+        }
+    }
+    return t;
+}
+
 // ---- Needleman-Wunsch -------------------------------------------------------
 // NW default: a=1 (match cost), x=1 (mismatch cost), g=1 (gap cost).
 // Scores reflect total cost (lower is better).
@@ -157,6 +223,17 @@ bool test_diff_general() {
     ok &= toolbox::test_utils::check(score >= 0, "Diff general: score >= 0");
     ok &= toolbox::test_utils::check(is_valid_alignment(s1, s2, a1, a2),
                                      "Diff general: alignment valid");
+    // Unit costs too give the gapped strings of diff_dp and diff_traceback.
+    for (unsigned seed = 1; seed <= 4; seed++) {
+        const std::string t1 = make_dna(90 + seed * 17, seed);
+        const std::string t2 = mutate(t1, 4, seed + 80);
+        std::vector<std::vector<int>> M;
+        std::string b1, b2;
+        toolbox::alignment::diff_all(t1, t2, a1, a2);
+        toolbox::alignment::diff_dp(t1, t2, M);
+        toolbox::alignment::diff_traceback(t1, t2, M, b1, b2);
+        ok &= toolbox::test_utils::check(a1 == b1 && a2 == b2, "Diff general: same as traceback");
+    }
     return ok;
 }
 
@@ -186,6 +263,559 @@ bool test_wavefront_general() {
     return ok;
 }
 
+bool test_diff_non_unit_cost() {
+    // x=2, g=1: not a multiple of unit costs.
+    const std::string s1 = "ACGTAGATGCATG";
+    const std::string s2 = "ACCTAGCATGCATC";
+    std::string a1, a2, b1, b2;
+    int df = toolbox::alignment::diff_all(s1, s2, a1, a2, 2, 1);
+    int nw = toolbox::alignment::needleman_wunsch_all(s1, s2, b1, b2, 0, 2, 1);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(df == nw, "Diff x=2: score == NW score");
+    ok &= toolbox::test_utils::check(is_valid_alignment(s1, s2, a1, a2),
+                                     "Diff x=2: alignment valid");
+    return ok;
+}
+
+// ---- Myers bit-vector ------------------------------------------------------
+// Unit costs: match 0, mismatch 1, gap 1.
+
+bool test_myers_empty() {
+    std::string a1, a2;
+    bool ok = true;
+    ok &= toolbox::test_utils::check(toolbox::alignment::myers_bitvector_dp("", "") == 0,
+                                     "Myers empty vs empty: score==0");
+    ok &= toolbox::test_utils::check(toolbox::alignment::myers_bitvector_dp("ACG", "") == 3,
+                                     "Myers ACG vs empty: score==3");
+    int score = toolbox::alignment::myers_bitvector_all("", "ACG", a1, a2);
+    ok &= toolbox::test_utils::check(score == 3, "Myers all empty vs ACG: score==3");
+    ok &= toolbox::test_utils::check(is_valid_alignment("", "ACG", a1, a2),
+                                     "Myers all empty vs ACG: alignment valid");
+    return ok;
+}
+
+bool test_myers_matches_nw() {
+    // Lengths straddle the 64-bit block boundary to exercise the carry between blocks.
+    const std::size_t lens[] = {1, 7, 63, 64, 65, 130, 200};
+    bool ok = true;
+    for (std::size_t li = 0; li < sizeof(lens) / sizeof(lens[0]); li++) {
+        for (unsigned seed = 1; seed <= 3; seed++) {
+            const std::string s1 = make_dna(lens[li], seed);
+            const std::string s2 = mutate(s1, 4, seed + 10);
+            std::vector<std::vector<int>> dp;
+            int expected = toolbox::alignment::needleman_wunsch_dp(s1, s2, dp, 0, 1, 1);
+            ok &= toolbox::test_utils::check(
+                toolbox::alignment::myers_bitvector_dp(s1, s2) == expected,
+                "Myers score == NW score (len " + std::to_string(lens[li]) + ")");
+            ok &= toolbox::test_utils::check(
+                toolbox::alignment::myers_bitvector_dp(s2, s1) == expected,
+                "Myers score is symmetric (len " + std::to_string(lens[li]) + ")");
+        }
+    }
+    return ok;
+}
+
+bool test_myers_hirschberg_traceback() {
+    // A tiny cutoff forces several levels of Hirschberg recursion.
+    const std::string s1 = make_dna(300, 7);
+    const std::string s2 = mutate(s1, 5, 8);
+    std::string a1, a2;
+    std::vector<std::vector<int>> dp;
+    int expected = toolbox::alignment::needleman_wunsch_dp(s1, s2, dp, 0, 1, 1);
+    int score = toolbox::alignment::myers_bitvector_all(s1, s2, a1, a2, 16);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(score == expected, "Myers all: score == NW score");
+    ok &= toolbox::test_utils::check(is_valid_alignment(s1, s2, a1, a2),
+                                     "Myers all: alignment valid");
+    ok &= toolbox::test_utils::check(unit_cost(a1, a2) == expected,
+                                     "Myers all: alignment cost == score");
+    return ok;
+}
+
+// ---- Hirschberg / Myers-Miller ----------------------------------------------
+// Linear-space variants must reach the full-table score with a valid alignment of that cost.
+
+bool test_nw_hirschberg() {
+    const int params[][3] = {{0, 1, 1}, {1, 3, 2}, {-1, 1, 2}};
+    bool ok = true;
+    for (const auto &p : params) {
+        for (unsigned seed = 1; seed <= 3; seed++) {
+            const std::string s1 = make_dna(90 + seed * 17, seed);
+            const std::string s2 = mutate(s1, 4, seed + 20);
+            std::vector<std::vector<int>> dp;
+            int expected = toolbox::alignment::needleman_wunsch_dp(s1, s2, dp, p[0], p[1], p[2]);
+            std::string a1, a2;
+            int score = toolbox::alignment::needleman_wunsch_hirschberg(s1, s2, a1, a2, p[0], p[1],
+                                                                        p[2], 32);
+            ok &= toolbox::test_utils::check(score == expected, "NW Hirschberg: score == NW");
+            ok &= toolbox::test_utils::check(is_valid_alignment(s1, s2, a1, a2),
+                                             "NW Hirschberg: alignment valid");
+            ok &= toolbox::test_utils::check(affine_cost(a1, a2, p[0], p[1], 0, p[2]) == expected,
+                                             "NW Hirschberg: alignment cost == score");
+        }
+    }
+    return ok;
+}
+
+bool test_nwg_hirschberg() {
+    const int params[][4] = {{0, 1, 0, 1}, {0, 4, 3, 1}, {1, 2, 5, 1}, {0, 9, 1, 2}};
+    bool ok = true;
+    for (const auto &p : params) {
+        for (unsigned seed = 1; seed <= 4; seed++) {
+            const std::string s1 = make_dna(80 + seed * 23, seed);
+            const std::string s2 = mutate(s1, 3, seed + 30);
+            std::vector<std::vector<int>> M, D, I;
+            int expected = toolbox::alignment::needleman_wunsch_gotoh_dp(s1, s2, M, D, I, p[0],
+                                                                         p[1], p[2], p[3]);
+            std::string a1, a2;
+            int score = toolbox::alignment::needleman_wunsch_gotoh_hirschberg(
+                s1, s2, a1, a2, p[0], p[1], p[2], p[3], 16);
+            ok &= toolbox::test_utils::check(score == expected, "NWG Myers-Miller: score == NWG");
+            ok &= toolbox::test_utils::check(is_valid_alignment(s1, s2, a1, a2),
+                                             "NWG Myers-Miller: alignment valid");
+            ok &= toolbox::test_utils::check(
+                affine_cost(a1, a2, p[0], p[1], p[2], p[3]) == expected,
+                "NWG Myers-Miller: alignment cost == score");
+        }
+    }
+    std::string a1, a2;
+    int score =
+        toolbox::alignment::needleman_wunsch_gotoh_hirschberg("", "ACG", a1, a2, 0, 1, 2, 1);
+    ok &= toolbox::test_utils::check(score == 5, "NWG Myers-Miller empty vs ACG: score==5");
+    ok &= toolbox::test_utils::check(is_valid_alignment("", "ACG", a1, a2),
+                                     "NWG Myers-Miller empty vs ACG: alignment valid");
+    return ok;
+}
+
+// ---- Banded ----------------------------------------------------------------
+
+bool test_nw_banded() {
+    bool ok = true;
+    for (unsigned seed = 1; seed <= 4; seed++) {
+        const std::string s1 = make_dna(150 + seed * 11, seed);
+        const std::string s2 = mutate(s1, 5, seed + 40);
+        std::vector<std::vector<int>> dp;
+        int expected = toolbox::alignment::needleman_wunsch_dp(s1, s2, dp, 0, 1, 1);
+        std::string a1, a2;
+        // A band wide enough for every gap gives the unbanded optimum.
+        int score = toolbox::alignment::needleman_wunsch_banded(s1, s2, a1, a2, 40, 0, 1, 1);
+        ok &= toolbox::test_utils::check(score == expected, "NW banded: wide band == NW");
+        ok &= toolbox::test_utils::check(is_valid_alignment(s1, s2, a1, a2),
+                                         "NW banded: alignment valid");
+        ok &= toolbox::test_utils::check(affine_cost(a1, a2, 0, 1, 0, 1) == score,
+                                         "NW banded: alignment cost == score");
+        // w = 0 is widened to |m - n|; a narrow band can only cost more.
+        score = toolbox::alignment::needleman_wunsch_banded(s1, s2, a1, a2, 0, 0, 1, 1);
+        ok &= toolbox::test_utils::check(score >= expected, "NW banded: narrow band >= NW");
+        ok &= toolbox::test_utils::check(is_valid_alignment(s1, s2, a1, a2),
+                                         "NW banded: narrow alignment valid");
+        ok &= toolbox::test_utils::check(affine_cost(a1, a2, 0, 1, 0, 1) == score,
+                                         "NW banded: narrow alignment cost == score");
+    }
+    std::string a1, a2;
+    int score = toolbox::alignment::needleman_wunsch_banded("ACGTACGT", "ACCTACGA", a1, a2, 0);
+    ok &= toolbox::test_utils::check(score == 2, "NW banded: substitutions only, w = 0");
+    return ok;
+}
+
+bool test_nwg_banded() {
+    const int params[][4] = {{0, 1, 0, 1}, {0, 4, 3, 1}, {1, 2, 5, 1}};
+    bool ok = true;
+    for (const auto &p : params) {
+        for (unsigned seed = 1; seed <= 3; seed++) {
+            const std::string s1 = make_dna(120 + seed * 13, seed);
+            const std::string s2 = mutate(s1, 4, seed + 50);
+            std::vector<std::vector<int>> M, D, I;
+            int expected = toolbox::alignment::needleman_wunsch_gotoh_dp(s1, s2, M, D, I, p[0],
+                                                                         p[1], p[2], p[3]);
+            std::string a1, a2;
+            int score = toolbox::alignment::needleman_wunsch_gotoh_banded(s1, s2, a1, a2, 40, p[0],
+                                                                          p[1], p[2], p[3]);
+            ok &= toolbox::test_utils::check(score == expected, "NWG banded: wide band == NWG");
+            ok &= toolbox::test_utils::check(is_valid_alignment(s1, s2, a1, a2),
+                                             "NWG banded: alignment valid");
+            ok &= toolbox::test_utils::check(
+                affine_cost(a1, a2, p[0], p[1], p[2], p[3]) == score,
+                "NWG banded: alignment cost == score");
+            score = toolbox::alignment::needleman_wunsch_gotoh_banded(s1, s2, a1, a2, 2, p[0],
+                                                                      p[1], p[2], p[3]);
+            ok &= toolbox::test_utils::check(score >= expected, "NWG banded: narrow band >= NWG");
+            ok &= toolbox::test_utils::check(
+                affine_cost(a1, a2, p[0], p[1], p[2], p[3]) == score,
+                "NWG banded: narrow alignment cost == score");
+        }
+    }
+    return ok;
+}
+
+// ---- CIGAR / packed traceback -------------------------------------------------
+
+bool test_cigar_to_string() {
+    const toolbox::alignment::cigar ops = {{'M', 5}, {'I', 1}, {'M', 3}, {'D', 12}};
+    std::string a1, a2;
+    toolbox::alignment::cigar_to_aligned("ACGTATTTCCCCCCCCCCCC", "ACGTAGTTT", ops, a1, a2);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(toolbox::alignment::cigar_to_string(ops) == "5M1I3M12D",
+                                     "CIGAR: to_string");
+    ok &= toolbox::test_utils::check(a1 == "ACGTA-TTTCCCCCCCCCCCC", "CIGAR: aligned s1");
+    ok &= toolbox::test_utils::check(a2 == "ACGTAGTTT------------", "CIGAR: aligned s2");
+    ok &= toolbox::test_utils::check(toolbox::alignment::cigar_to_string({}).empty(),
+                                     "CIGAR: empty");
+    return ok;
+}
+
+bool test_nw_cigar() {
+    const int params[][3] = {{0, 1, 1}, {0, 3, 2}, {1, 2, 3}};
+    bool ok = true;
+    for (const auto &p : params) {
+        for (unsigned seed = 1; seed <= 4; seed++) {
+            const std::string s1 = make_dna(90 + seed * 17, seed);
+            const std::string s2 = mutate(s1, 4, seed + 60);
+            std::vector<std::vector<int>> dp;
+            int expected = toolbox::alignment::needleman_wunsch_dp(s1, s2, dp, p[0], p[1], p[2]);
+            toolbox::alignment::cigar ops;
+            int score = toolbox::alignment::needleman_wunsch_cigar(s1, s2, ops, p[0], p[1], p[2]);
+            std::string a1, a2;
+            toolbox::alignment::cigar_to_aligned(s1, s2, ops, a1, a2);
+            ok &= toolbox::test_utils::check(score == expected, "NW CIGAR: score == NW");
+            ok &= toolbox::test_utils::check(is_valid_alignment(s1, s2, a1, a2),
+                                             "NW CIGAR: alignment valid");
+            ok &= toolbox::test_utils::check(affine_cost(a1, a2, p[0], p[1], 0, p[2]) == score,
+                                             "NW CIGAR: alignment cost == score");
+            toolbox::alignment::needleman_wunsch_traceback(s1, s2, dp, a1, a2, p[0], p[1], p[2]);
+            ok &= toolbox::test_utils::check(affine_cost(a1, a2, p[0], p[1], 0, p[2]) == score,
+                                             "NW traceback: alignment cost == score");
+            // Ties are broken as by the traceback, unit costs ({0, 1, 1}) included.
+            std::string b1, b2;
+            toolbox::alignment::needleman_wunsch_all(s1, s2, b1, b2, p[0], p[1], p[2]);
+            ok &= toolbox::test_utils::check(a1 == b1 && a2 == b2,
+                                             "NW all: same gapped strings as the traceback");
+        }
+    }
+    toolbox::alignment::cigar ops;
+    int score = toolbox::alignment::needleman_wunsch_cigar("", "ACG", ops);
+    ok &= toolbox::test_utils::check(score == 3, "NW CIGAR empty vs ACG: score==3");
+    ok &= toolbox::test_utils::check(toolbox::alignment::cigar_to_string(ops) == "3I",
+                                     "NW CIGAR empty vs ACG: 3I");
+    return ok;
+}
+
+bool test_nwg_cigar() {
+    const int params[][4] = {{0, 1, 0, 1}, {0, 4, 3, 1}, {1, 2, 5, 1}, {0, 4, 0, 1}};
+    bool ok = true;
+    for (const auto &p : params) {
+        for (unsigned seed = 1; seed <= 4; seed++) {
+            const std::string s1 = make_dna(90 + seed * 19, seed);
+            const std::string s2 = mutate(s1, 3, seed + 70);
+            std::vector<std::vector<int>> M, D, I;
+            int expected = toolbox::alignment::needleman_wunsch_gotoh_dp(s1, s2, M, D, I, p[0],
+                                                                         p[1], p[2], p[3]);
+            toolbox::alignment::cigar ops;
+            int score = toolbox::alignment::needleman_wunsch_gotoh_cigar(s1, s2, ops, p[0], p[1],
+                                                                         p[2], p[3]);
+            std::string a1, a2;
+            toolbox::alignment::cigar_to_aligned(s1, s2, ops, a1, a2);
+            ok &= toolbox::test_utils::check(score == expected, "NWG CIGAR: score == NWG");
+            ok &= toolbox::test_utils::check(is_valid_alignment(s1, s2, a1, a2),
+                                             "NWG CIGAR: alignment valid");
+            ok &= toolbox::test_utils::check(
+                affine_cost(a1, a2, p[0], p[1], p[2], p[3]) == score,
+                "NWG CIGAR: alignment cost == score");
+            toolbox::alignment::needleman_wunsch_gotoh_traceback(s1, s2, M, D, I, a1, a2, p[0],
+                                                                 p[1], p[2], p[3]);
+            ok &= toolbox::test_utils::check(is_valid_alignment(s1, s2, a1, a2),
+                                             "NWG traceback: alignment valid");
+            ok &= toolbox::test_utils::check(
+                affine_cost(a1, a2, p[0], p[1], p[2], p[3]) == score,
+                "NWG traceback: alignment cost == score");
+        }
+    }
+    // The gap-open test of the table traceback used to look one row / column too far and could
+    // loop forever on this pair.
+    const std::string s1 = "AGAGTGCCTAGAGCTGTACTGGTTCTTTACCTTATGT";
+    const std::string s2 = "TGAGTGCCTAAGTGTACTGGTTCTTTAGGCCGTATGT";
+    std::vector<std::vector<int>> M, D, I;
+    int expected = toolbox::alignment::needleman_wunsch_gotoh_dp(s1, s2, M, D, I, 0, 4, 0, 1);
+    std::string a1, a2;
+    toolbox::alignment::needleman_wunsch_gotoh_traceback(s1, s2, M, D, I, a1, a2, 0, 4, 0, 1);
+    ok &= toolbox::test_utils::check(is_valid_alignment(s1, s2, a1, a2),
+                                     "NWG traceback regression: alignment valid");
+    ok &= toolbox::test_utils::check(affine_cost(a1, a2, 0, 4, 0, 1) == expected,
+                                     "NWG traceback regression: alignment cost == score");
+    return ok;
+}
+
+// ---- Alignment result -------------------------------------------------------
+
+bool test_alignment_result() {
+    const std::string s1 = make_dna(150, 3);
+    const std::string s2 = mutate(s1, 4, 80);
+    bool ok = true;
+    // Each result overload gives the alignment of the gapped-string overload.
+    toolbox::alignment::alignment_result res[8];
+    std::string e1[8], e2[8];
+    int score[8], expected[8];
+    score[0] = toolbox::alignment::needleman_wunsch_all(s1, s2, res[0], 0, 3, 2);
+    expected[0] = toolbox::alignment::needleman_wunsch_all(s1, s2, e1[0], e2[0], 0, 3, 2);
+    score[1] = toolbox::alignment::needleman_wunsch_gotoh_all(s1, s2, res[1], 0, 4, 3, 1);
+    expected[1] = toolbox::alignment::needleman_wunsch_gotoh_all(s1, s2, e1[1], e2[1], 0, 4, 3, 1);
+    score[2] = toolbox::alignment::needleman_wunsch_hirschberg(s1, s2, res[2], 0, 3, 2);
+    expected[2] = toolbox::alignment::needleman_wunsch_hirschberg(s1, s2, e1[2], e2[2], 0, 3, 2);
+    score[3] = toolbox::alignment::needleman_wunsch_banded(s1, s2, res[3], 12, 0, 3, 2);
+    expected[3] = toolbox::alignment::needleman_wunsch_banded(s1, s2, e1[3], e2[3], 12, 0, 3, 2);
+    score[4] = toolbox::alignment::myers_bitvector_all(s1, s2, res[4]);
+    expected[4] = toolbox::alignment::myers_bitvector_all(s1, s2, e1[4], e2[4]);
+    score[5] = toolbox::alignment::diff_all(s1, s2, res[5], 3, 2);
+    expected[5] = toolbox::alignment::diff_all(s1, s2, e1[5], e2[5], 3, 2);
+    score[6] = toolbox::alignment::wavefront_all(s1, s2, res[6], 4, 3, 1);
+    expected[6] = toolbox::alignment::wavefront_all(s1, s2, e1[6], e2[6], 4, 3, 1);
+    score[7] = toolbox::alignment::wavefront_compact_all(s1, s2, res[7], 4, 3, 1);
+    expected[7] = toolbox::alignment::wavefront_compact_all(s1, s2, e1[7], e2[7], 4, 3, 1);
+    for (int t = 0; t < 8; t++) {
+        std::string a1, a2;
+        toolbox::alignment::alignment_to_aligned(s1, s2, res[t], a1, a2);
+        ok &= toolbox::test_utils::check(score[t] == expected[t] && res[t].score == score[t],
+                                         "Result: score == string overload");
+        ok &= toolbox::test_utils::check(a1 == e1[t] && a2 == e2[t],
+                                         "Result: same alignment as string overload");
+        ok &= toolbox::test_utils::check(res[t].begin1 == 0 && res[t].end1 == s1.size() &&
+                                             res[t].begin2 == 0 && res[t].end2 == s2.size(),
+                                         "Result: global alignment covers both strings");
+        const toolbox::alignment::cigar back = toolbox::alignment::aligned_to_cigar(a1, a2);
+        ok &= toolbox::test_utils::check(toolbox::alignment::cigar_to_string(back) ==
+                                             toolbox::alignment::cigar_to_string(res[t].ops),
+                                         "Result: aligned_to_cigar round trip");
+    }
+    toolbox::alignment::alignment_result r;
+    toolbox::alignment::needleman_wunsch_all("ACGTAC", "ACTTAGC", r, 0, 1, 1);
+    const toolbox::alignment::cigar ext =
+        toolbox::alignment::cigar_to_extended("ACGTAC", "ACTTAGC", r.ops);
+    ok &= toolbox::test_utils::check(r.score == 2, "Result extended: score == 2");
+    ok &= toolbox::test_utils::check(toolbox::alignment::cigar_to_string(r.ops) == "5M1I1M",
+                                     "Result extended: CIGAR");
+    ok &= toolbox::test_utils::check(toolbox::alignment::cigar_to_string(ext) == "2=1X2=1I1=",
+                                     "Result extended: =/X split");
+    return ok;
+}
+
+// ---- Scoring policies -------------------------------------------------------
+
+bool test_nw_scored() {
+    const int params[][3] = {{1, 0, 1}, {4, 6, 2}, {2, 5, 1}};
+    const toolbox::alignment::alphabet dna = toolbox::alignment::dna_alphabet();
+    bool ok = true;
+    for (const auto &p : params) {
+        for (unsigned seed = 1; seed <= 3; seed++) {
+            const std::string s1 = make_dna(80 + seed * 13, seed);
+            const std::string s2 = mutate(s1, 4, seed + 40);
+            std::string e1, e2;
+            int cost = toolbox::alignment::needleman_wunsch_gotoh_all(s1, s2, e1, e2, 0, p[0],
+                                                                      p[1], p[2]);
+            // Similarity 0 / -x under the policy is the negated min-cost alignment.
+            toolbox::alignment::alignment_result res;
+            int score = toolbox::alignment::needleman_wunsch_scored(
+                dna.encode(s1), dna.encode(s2), toolbox::alignment::match_mismatch_scoring(0, p[0]),
+                res, p[1], p[2]);
+            std::string a1, a2;
+            toolbox::alignment::alignment_to_aligned(s1, s2, res, a1, a2);
+            ok &= toolbox::test_utils::check(score == -cost, "NW scored: score == -NWG cost");
+            ok &= toolbox::test_utils::check(is_valid_alignment(s1, s2, a1, a2),
+                                             "NW scored: alignment valid");
+            ok &= toolbox::test_utils::check(affine_cost(a1, a2, 0, p[0], p[1], p[2]) == cost,
+                                             "NW scored: alignment cost == cost");
+        }
+    }
+    // Ambiguity codes: N and R match, so only the gap is paid.
+    const toolbox::alignment::alphabet iupac = toolbox::alignment::iupac_alphabet();
+    toolbox::alignment::alignment_result res;
+    int score = toolbox::alignment::needleman_wunsch_scored(
+        iupac.encode("ACNTRA"), iupac.encode("ACGTAAC"), toolbox::alignment::iupac_scoring(1, 1),
+        res, 2, 1);
+    ok &= toolbox::test_utils::check(score == 3, "NW IUPAC: 6 matches - one gap of 3");
+    return ok;
+}
+
+// ---- Tiled parallel DP ------------------------------------------------------
+
+bool test_nw_tiled() {
+    toolbox::parallel::thread_pool pool(4);
+    const int tiles[] = {1, 7, 32, 256};
+    bool ok = true;
+    for (unsigned seed = 1; seed <= 3; seed++) {
+        const std::string s1 = make_dna(150 + seed * 31, seed);
+        const std::string s2 = mutate(s1, 4, seed + 90);
+        std::vector<std::vector<int>> dp, M, D, I;
+        int nw = toolbox::alignment::needleman_wunsch_dp(s1, s2, dp, 0, 3, 2);
+        int nwg = toolbox::alignment::needleman_wunsch_gotoh_dp(s1, s2, M, D, I, 0, 4, 6, 2);
+        for (int tile : tiles) {
+            ok &= toolbox::test_utils::check(
+                toolbox::alignment::needleman_wunsch_tiled(s1, s2, 0, 3, 2, tile, pool) == nw,
+                "NW tiled: score == NW");
+            ok &= toolbox::test_utils::check(
+                toolbox::alignment::needleman_wunsch_gotoh_tiled(s1, s2, 0, 4, 6, 2, tile, pool) ==
+                    nwg,
+                "NWG tiled: score == NWG");
+        }
+    }
+    ok &= toolbox::test_utils::check(
+        toolbox::alignment::needleman_wunsch_gotoh_tiled("", "ACGT", 0, 1, 3, 1, 2, pool) == 7,
+        "NWG tiled: empty vs ACGT");
+    ok &= toolbox::test_utils::check(
+        toolbox::alignment::needleman_wunsch_tiled("", "", 0, 1, 1, 2, pool) == 0,
+        "NW tiled: empty vs empty");
+    return ok;
+}
+
+// ---- Compact wavefront / BiWFA ---------------------------------------------
+
+bool test_wavefront_compact() {
+    const int params[][3] = {{1, 0, 1}, {4, 6, 2}, {2, 5, 1}, {9, 1, 2}};
+    bool ok = true;
+    for (const auto &p : params) {
+        for (unsigned seed = 1; seed <= 4; seed++) {
+            const std::string s1 = make_dna(90 + seed * 17, seed);
+            const std::string s2 = mutate(s1, 4, seed + 60);
+            std::vector<std::vector<int>> M, D, I;
+            int expected = toolbox::alignment::needleman_wunsch_gotoh_dp(s1, s2, M, D, I, 0, p[0],
+                                                                         p[1], p[2]);
+            ok &= toolbox::test_utils::check(
+                toolbox::alignment::wavefront_score(s1, s2, p[0], p[1], p[2]) == expected,
+                "Wavefront score-only == NWG");
+            std::string a1, a2;
+            int score =
+                toolbox::alignment::wavefront_compact_all(s1, s2, a1, a2, p[0], p[1], p[2]);
+            ok &= toolbox::test_utils::check(score == expected, "Wavefront compact: score == NWG");
+            ok &= toolbox::test_utils::check(is_valid_alignment(s1, s2, a1, a2),
+                                             "Wavefront compact: alignment valid");
+            ok &= toolbox::test_utils::check(affine_cost(a1, a2, 0, p[0], p[1], p[2]) == score,
+                                             "Wavefront compact: alignment cost == score");
+        }
+    }
+    std::string a1, a2;
+    int score = toolbox::alignment::wavefront_compact_all("", "ACG", a1, a2, 1, 2, 1);
+    ok &= toolbox::test_utils::check(score == 5, "Wavefront compact empty vs ACG: score==5");
+    ok &= toolbox::test_utils::check(is_valid_alignment("", "ACG", a1, a2),
+                                     "Wavefront compact empty vs ACG: alignment valid");
+    return ok;
+}
+
+bool test_wavefront_bialign() {
+    const int params[][3] = {{1, 0, 1}, {4, 6, 2}, {2, 5, 1}, {9, 1, 2}};
+    bool ok = true;
+    for (const auto &p : params) {
+        for (unsigned seed = 1; seed <= 4; seed++) {
+            const std::string s1 = make_dna(90 + seed * 17, seed);
+            const std::string s2 = mutate(s1, 3, seed + 70);
+            std::vector<std::vector<int>> M, D, I;
+            int expected = toolbox::alignment::needleman_wunsch_gotoh_dp(s1, s2, M, D, I, 0, p[0],
+                                                                         p[1], p[2]);
+            // cutoff = 0 splits down to the smallest subproblems, including splits inside gaps.
+            std::string a1, a2;
+            int score =
+                toolbox::alignment::wavefront_bialign(s1, s2, a1, a2, p[0], p[1], p[2], 0);
+            ok &= toolbox::test_utils::check(score == expected, "BiWFA: score == NWG");
+            ok &= toolbox::test_utils::check(is_valid_alignment(s1, s2, a1, a2),
+                                             "BiWFA: alignment valid");
+            ok &= toolbox::test_utils::check(affine_cost(a1, a2, 0, p[0], p[1], p[2]) == score,
+                                             "BiWFA: alignment cost == score");
+        }
+    }
+    // A long read: far more than the cutoff, so the split is exercised at full size.
+    const std::string s1 = make_dna(20000, 5);
+    const std::string s2 = mutate(s1, 20, 6);
+    std::string a1, a2;
+    int score = toolbox::alignment::wavefront_bialign(s1, s2, a1, a2, 4, 6, 2);
+    ok &= toolbox::test_utils::check(score == toolbox::alignment::wavefront_score(s1, s2, 4, 6, 2),
+                                     "BiWFA long: score == score-only");
+    ok &= toolbox::test_utils::check(is_valid_alignment(s1, s2, a1, a2),
+                                     "BiWFA long: alignment valid");
+    ok &= toolbox::test_utils::check(affine_cost(a1, a2, 0, 4, 6, 2) == score,
+                                     "BiWFA long: alignment cost == score");
+    return ok;
+}
+
+// A free edit (x = 0 or e = 0) or a negative gap open is rejected at run time, not only by the
+// asserts of debug builds.
+bool test_wavefront_invalid_costs() {
+    const int params[][3] = {{0, 0, 1}, {1, 0, 0}, {1, -1, 1}, {0, 0, 0}};
+    const std::string s1 = "ACGTAGATGCATG";
+    const std::string s2 = "ACCTAGCATGCATC";
+    const toolbox::string::packed_dna p1(s1), p2(s2);
+    bool ok = true;
+    for (const auto &p : params) {
+        std::string a1 = "x", a2 = "x";
+        toolbox::alignment::alignment_result res;
+        ok &= toolbox::test_utils::check(
+            toolbox::alignment::wavefront_all(s1, s2, a1, a2, p[0], p[1], p[2]) == -1 &&
+                a1.empty() && a2.empty(),
+            "WFA invalid costs: wavefront_all == -1");
+        ok &= toolbox::test_utils::check(
+            toolbox::alignment::wavefront_all(s1, s2, res, p[0], p[1], p[2]) == -1 &&
+                res.score == -1 && res.ops.empty(),
+            "WFA invalid costs: alignment_result == -1");
+        ok &= toolbox::test_utils::check(
+            toolbox::alignment::wavefront_score(s1, s2, p[0], p[1], p[2]) == -1 &&
+                toolbox::alignment::wavefront_compact_all(s1, s2, res, p[0], p[1], p[2]) == -1 &&
+                toolbox::alignment::wavefront_bialign(s1, s2, res, p[0], p[1], p[2]) == -1,
+            "WFA invalid costs: compact engines == -1");
+        ok &= toolbox::test_utils::check(
+            toolbox::alignment::wavefront_score(p1, p2, p[0], p[1], p[2]) == -1 &&
+                toolbox::alignment::wavefront_compact_all(p1, p2, res, p[0], p[1], p[2]) == -1 &&
+                toolbox::alignment::wavefront_bialign(p1, p2, res, p[0], p[1], p[2]) == -1,
+            "WFA invalid costs: packed == -1");
+    }
+    return ok;
+}
+
+// The packed overloads give the same costs and the same CIGARs as the std::string ones.
+bool test_packed_dna() {
+    const int params[][3] = {{1, 0, 1}, {4, 6, 2}, {9, 1, 2}};
+    bool ok = true;
+    for (const auto &p : params) {
+        for (unsigned seed = 1; seed <= 4; seed++) {
+            std::string s1 = make_dna(150 + seed * 41, seed);
+            s1[seed * 7] = 'N';
+            s1[seed * 7 + 1] = 'N';
+            const std::string s2 = mutate(s1, 4, seed + 80);
+            const toolbox::string::packed_dna p1(s1), p2(s2);
+            toolbox::alignment::alignment_result r, q;
+            ok &= toolbox::test_utils::check(
+                toolbox::alignment::wavefront_score(p1, p2, p[0], p[1], p[2]) ==
+                    toolbox::alignment::wavefront_score(s1, s2, p[0], p[1], p[2]),
+                "Packed: wavefront_score");
+            toolbox::alignment::wavefront_compact_all(s1, s2, r, p[0], p[1], p[2]);
+            toolbox::alignment::wavefront_compact_all(p1, p2, q, p[0], p[1], p[2]);
+            ok &= toolbox::test_utils::check(
+                q.score == r.score && toolbox::alignment::cigar_to_string(q.ops) ==
+                                          toolbox::alignment::cigar_to_string(r.ops),
+                "Packed: wavefront_compact_all");
+            toolbox::alignment::wavefront_bialign(s1, s2, r, p[0], p[1], p[2], 0);
+            toolbox::alignment::wavefront_bialign(p1, p2, q, p[0], p[1], p[2], 0);
+            ok &= toolbox::test_utils::check(
+                q.score == r.score && toolbox::alignment::cigar_to_string(q.ops) ==
+                                          toolbox::alignment::cigar_to_string(r.ops),
+                "Packed: wavefront_bialign");
+            toolbox::alignment::needleman_wunsch_banded(s1, s2, r, 8, 0, p[0], p[2]);
+            toolbox::alignment::needleman_wunsch_banded(p1, p2, q, 8, 0, p[0], p[2]);
+            ok &= toolbox::test_utils::check(
+                q.score == r.score && toolbox::alignment::cigar_to_string(q.ops) ==
+                                          toolbox::alignment::cigar_to_string(r.ops),
+                "Packed: needleman_wunsch_banded");
+        }
+    }
+    const std::string s1 = make_dna(20000, 7);
+    const std::string s2 = mutate(s1, 20, 8);
+    toolbox::alignment::alignment_result r, q;
+    toolbox::alignment::wavefront_bialign(s1, s2, r, 4, 6, 2);
+    toolbox::alignment::wavefront_bialign(toolbox::string::packed_dna(s1),
+                                          toolbox::string::packed_dna(s2), q, 4, 6, 2);
+    ok &= toolbox::test_utils::check(q.score == r.score &&
+                                         toolbox::alignment::cigar_to_string(q.ops) ==
+                                             toolbox::alignment::cigar_to_string(r.ops),
+                                     "Packed: BiWFA long read");
+    return ok;
+}
+
 // ---- Cross-algorithm consistency -------------------------------------------
 // With matching parameters (a=0 for NW/NWG, matches free for diff/wavefront),
 // all algorithms should agree on edit distance for simple linear gap costs.
@@ -223,8 +853,26 @@ int main() {
         {"diff_identical", test_diff_identical},
         {"diff_empty", test_diff_empty},
         {"diff_general", test_diff_general},
+        {"diff_non_unit_cost", test_diff_non_unit_cost},
+        {"myers_empty", test_myers_empty},
+        {"myers_matches_nw", test_myers_matches_nw},
+        {"myers_hirschberg_traceback", test_myers_hirschberg_traceback},
+        {"nw_hirschberg", test_nw_hirschberg},
+        {"nwg_hirschberg", test_nwg_hirschberg},
+        {"nw_banded", test_nw_banded},
+        {"nwg_banded", test_nwg_banded},
+        {"cigar_to_string", test_cigar_to_string},
+        {"nw_cigar", test_nw_cigar},
+        {"nwg_cigar", test_nwg_cigar},
+        {"alignment_result", test_alignment_result},
+        {"nw_scored", test_nw_scored},
+        {"nw_tiled", test_nw_tiled},
         {"wavefront_identical", test_wavefront_identical},
         {"wavefront_general", test_wavefront_general},
+        {"wavefront_compact", test_wavefront_compact},
+        {"wavefront_bialign", test_wavefront_bialign},
+        {"wavefront_invalid_costs", test_wavefront_invalid_costs},
+        {"packed_dna", test_packed_dna},
         {"score_consistency", test_score_consistency},
     };
     return toolbox::test_utils::run_tests(tests, sizeof(tests) / sizeof(tests[0]));
@@ -1,6 +1,13 @@
 #include <string>
+#include <vector>
 
 #include "toolbox/bioinfo/alignment/local_alignment/smith_waterman.hpp"
+#include "toolbox/bioinfo/alignment/local_alignment/smith_waterman_banded.hpp"
+#include "toolbox/bioinfo/alignment/local_alignment/smith_waterman_batch.hpp"
+#include "toolbox/bioinfo/alignment/local_alignment/smith_waterman_hirschberg.hpp"
+#include "toolbox/bioinfo/alignment/local_alignment/smith_waterman_scored.hpp"
+#include "toolbox/bioinfo/alignment/local_alignment/smith_waterman_striped.hpp"
+#include "toolbox/bioinfo/alignment/scoring.hpp"
 
 #include "utils/test_util.hpp"
 
@@ -92,6 +99,369 @@ bool test_sw_general() {
     return ok;
 }
 
+// ---- Smith-Waterman (linear space) -------------------------------------------
+
+// Similarity score of a gapped alignment under match a / mismatch -x / gap -g.
+int local_score(const std::string &a1, const std::string &a2, int a, int x, int g) {
+    int score = 0;
+    for (std::size_t i = 0; i < a1.size(); i++) {
+        if (a1[i] == '-' || a2[i] == '-') {
+            score -= g;
+        } else {
+            score += a1[i] == a2[i] ? a : -x;
+        }
+    }
+    return score;
+}
+
+bool test_sw_hirschberg() {
+    const std::string s1s[] = {"ACACACTA", "TTTTGATTACATTTT", "AAAA", "", "GGATCGATTAGCTAGGCTA"};
+    const std::string s2s[] = {"AGCACACA", "GATTACA", "TTTT", "ACGT", "CGTTAGCTAGCTTAGGGA"};
+    bool ok = true;
+    for (std::size_t t = 0; t < sizeof(s1s) / sizeof(s1s[0]); t++) {
+        std::vector<std::vector<int>> dp;
+        int expected = toolbox::alignment::smith_waterman_dp(s1s[t], s2s[t], dp, 2, 1, 2);
+        std::string a1, a2;
+        // cutoff 4 forces the Hirschberg recursion even on these short inputs.
+        int score =
+            toolbox::alignment::smith_waterman_hirschberg(s1s[t], s2s[t], a1, a2, 2, 1, 2, 4);
+        ok &= toolbox::test_utils::check(score == expected, "SW Hirschberg: score == SW");
+        ok &= toolbox::test_utils::check(is_valid_local_alignment(s1s[t], s2s[t], a1, a2),
+                                         "SW Hirschberg: alignment valid");
+        ok &= toolbox::test_utils::check(local_score(a1, a2, 2, 1, 2) == expected,
+                                         "SW Hirschberg: alignment score == score");
+    }
+    return ok;
+}
+
+// ---- Smith-Waterman (CIGAR) ---------------------------------------------------
+
+bool test_sw_cigar() {
+    const std::string s1s[] = {"ACACACTA", "TTTTGATTACATTTT", "AAAA", "", "GGATCGATTAGCTAGGCTA"};
+    const std::string s2s[] = {"AGCACACA", "GATTACA", "TTTT", "ACGT", "CGTTAGCTAGCTTAGGGA"};
+    bool ok = true;
+    for (std::size_t t = 0; t < sizeof(s1s) / sizeof(s1s[0]); t++) {
+        std::vector<std::vector<int>> dp;
+        int expected = toolbox::alignment::smith_waterman_dp(s1s[t], s2s[t], dp, 2, 1, 2);
+        std::string e1, e2;
+        toolbox::alignment::smith_waterman_traceback(s1s[t], s2s[t], dp, e1, e2, 2, 1, 2);
+        toolbox::alignment::cigar ops;
+        std::size_t begin1 = 0;
+        std::size_t begin2 = 0;
+        int score =
+            toolbox::alignment::smith_waterman_cigar(s1s[t], s2s[t], ops, begin1, begin2, 2, 1, 2);
+        std::string a1, a2;
+        toolbox::alignment::cigar_to_aligned(s1s[t], s2s[t], ops, a1, a2, begin1, begin2);
+        ok &= toolbox::test_utils::check(score == expected, "SW CIGAR: score == SW");
+        // The packed traceback breaks ties exactly like the table traceback.
+        ok &= toolbox::test_utils::check(a1 == e1 && a2 == e2, "SW CIGAR: same alignment");
+        ok &= toolbox::test_utils::check(local_score(a1, a2, 2, 1, 2) == expected,
+                                         "SW CIGAR: alignment score == score");
+    }
+    toolbox::alignment::cigar ops;
+    std::size_t begin1 = 0;
+    std::size_t begin2 = 0;
+    int score = toolbox::alignment::smith_waterman_cigar("GATTACA", "TTTTGATTACATTTT", ops, begin1,
+                                                         begin2);
+    ok &= toolbox::test_utils::check(score == 7 && toolbox::alignment::cigar_to_string(ops) == "7M",
+                                     "SW CIGAR substring: 7M");
+    ok &= toolbox::test_utils::check(begin1 == 0 && begin2 == 4, "SW CIGAR substring: begin");
+    return ok;
+}
+
+bool test_sw_result() {
+    const std::string s1s[] = {"ACACACTA", "TTTTGATTACATTTT", "AAAA", "", "GGATCGATTAGCTAGGCTA"};
+    const std::string s2s[] = {"AGCACACA", "GATTACA", "TTTT", "ACGT", "CGTTAGCTAGCTTAGGGA"};
+    bool ok = true;
+    for (std::size_t t = 0; t < sizeof(s1s) / sizeof(s1s[0]); t++) {
+        std::string e1, e2, a1, a2;
+        int expected = toolbox::alignment::smith_waterman_all(s1s[t], s2s[t], e1, e2, 2, 1, 2);
+        toolbox::alignment::alignment_result res[3];
+        toolbox::alignment::smith_waterman_all(s1s[t], s2s[t], res[0], 2, 1, 2);
+        toolbox::alignment::smith_waterman_hirschberg(s1s[t], s2s[t], res[1], 2, 1, 2);
+        toolbox::alignment::smith_waterman_banded(s1s[t], s2s[t], res[2], 20, 2, 1, 2);
+        for (const toolbox::alignment::alignment_result &r : res) {
+            toolbox::alignment::alignment_to_aligned(s1s[t], s2s[t], r, a1, a2);
+            ok &= toolbox::test_utils::check(r.score == expected, "SW result: score == SW");
+            ok &= toolbox::test_utils::check(local_score(a1, a2, 2, 1, 2) == expected,
+                                             "SW result: alignment score == score");
+            ok &= toolbox::test_utils::check(
+                r.end1 <= s1s[t].size() && r.end2 <= s2s[t].size(),
+                "SW result: coordinates inside the strings");
+        }
+        toolbox::alignment::alignment_to_aligned(s1s[t], s2s[t], res[0], a1, a2);
+        ok &= toolbox::test_utils::check(a1 == e1 && a2 == e2, "SW result: same alignment");
+    }
+    toolbox::alignment::alignment_result r;
+    toolbox::alignment::smith_waterman_all("GATTACA", "TTTTGATTACATTTT", r);
+    ok &= toolbox::test_utils::check(r.begin1 == 0 && r.end1 == 7, "SW result: s1 range");
+    ok &= toolbox::test_utils::check(r.begin2 == 4 && r.end2 == 11, "SW result: s2 range");
+    return ok;
+}
+
+bool test_sw_tiled() {
+    const std::string s1s[] = {"ACACACTA", "TTTTGATTACATTTT", "AAAA", "", "GGATCGATTAGCTAGGCTA"};
+    const std::string s2s[] = {"AGCACACA", "GATTACA", "TTTT", "ACGT", "CGTTAGCTAGCTTAGGGA"};
+    toolbox::parallel::thread_pool pool(4);
+    bool ok = true;
+    for (std::size_t t = 0; t < sizeof(s1s) / sizeof(s1s[0]); t++) {
+        std::vector<std::vector<int>> dp;
+        int expected = toolbox::alignment::smith_waterman_dp(s1s[t], s2s[t], dp, 2, 1, 2);
+        for (int tile = 1; tile <= 5; tile += 2) {
+            int score =
+                toolbox::alignment::smith_waterman_tiled(s1s[t], s2s[t], 2, 1, 2, tile, pool);
+            ok &= toolbox::test_utils::check(score == expected, "SW tiled: score == SW");
+        }
+    }
+    return ok;
+}
+
+// ---- Smith-Waterman (banded) --------------------------------------------------
+
+bool test_sw_banded() {
+    const std::string s1s[] = {"ACACACTA", "TTTTGATTACATTTT", "AAAA", "", "GGATCGATTAGCTAGGCTA"};
+    const std::string s2s[] = {"AGCACACA", "GATTACA", "TTTT", "ACGT", "CGTTAGCTAGCTTAGGGA"};
+    bool ok = true;
+    for (std::size_t t = 0; t < sizeof(s1s) / sizeof(s1s[0]); t++) {
+        std::string e1, e2, a1, a2;
+        int expected = toolbox::alignment::smith_waterman_all(s1s[t], s2s[t], e1, e2, 2, 1, 2);
+        // A band covering the whole table reproduces smith_waterman_all exactly.
+        int score = toolbox::alignment::smith_waterman_banded(s1s[t], s2s[t], a1, a2, 20, 2, 1, 2);
+        ok &= toolbox::test_utils::check(score == expected, "SW banded: full band == SW");
+        ok &= toolbox::test_utils::check(a1 == e1 && a2 == e2, "SW banded: same alignment");
+        score = toolbox::alignment::smith_waterman_banded(s1s[t], s2s[t], a1, a2, 1, 2, 1, 2);
+        ok &= toolbox::test_utils::check(score <= expected, "SW banded: narrow band <= SW");
+        ok &= toolbox::test_utils::check(is_valid_local_alignment(s1s[t], s2s[t], a1, a2),
+                                         "SW banded: alignment valid");
+        ok &= toolbox::test_utils::check(local_score(a1, a2, 2, 1, 2) == score,
+                                         "SW banded: alignment score == score");
+    }
+    // "GATTACA" sits 4 columns right of the main diagonal: w = 3 misses it, w = 4 finds it.
+    std::string a1, a2;
+    int narrow = toolbox::alignment::smith_waterman_banded("GATTACA", "TTTTGATTACA", a1, a2, 3);
+    int wide = toolbox::alignment::smith_waterman_banded("GATTACA", "TTTTGATTACA", a1, a2, 4);
+    ok &= toolbox::test_utils::check(narrow < 7 && wide == 7, "SW banded: band limits offset");
+    return ok;
+}
+
+// ---- Smith-Waterman (striped SIMD) -------------------------------------------
+
+bool test_sw_striped() {
+    const std::string s1s[] = {"ACACACTA", "TTTTGATTACATTTT", "AAAA", "", "GGATCGATTAGCTAGGCTA"};
+    const std::string s2s[] = {"AGCACACA", "GATTACA", "TTTT", "ACGT", "CGTTAGCTAGCTTAGGGA"};
+    bool ok = true;
+    for (std::size_t t = 0; t < sizeof(s1s) / sizeof(s1s[0]); t++) {
+        std::vector<std::vector<int>> dp;
+        int expected = toolbox::alignment::smith_waterman_dp(s1s[t], s2s[t], dp, 2, 1, 2);
+        // o = 0, e = g: the affine gap model reduces to the linear one.
+        int score = toolbox::alignment::smith_waterman_striped(s1s[t], s2s[t], 2, 1, 0, 2);
+        ok &= toolbox::test_utils::check(score == expected, "SW striped: score == SW");
+        ok &= toolbox::test_utils::check(
+            score == toolbox::alignment::detail::smith_waterman_affine_score(s1s[t], s2s[t], 2, 1,
+                                                                             0, 2),
+            "SW striped: score == scalar affine SW");
+    }
+    return ok;
+}
+
+bool test_sw_striped_affine() {
+    // Query longer than one register of lanes, so the lazy-F loop crosses segment boundaries.
+    std::string q;
+    unsigned seed = 7;
+    for (int i = 0; i < 300; i++) {
+        seed = seed * 1103515245u + 12345u;
+        q += "ACGT"[(seed >> 16) % 4];
+    }
+    const std::string t = q.substr(40, 120) + "GGGGGGGGGG" + q.substr(170, 100);
+    toolbox::alignment::smith_waterman_profile profile(q, 2, 3, 5, 1);
+    int expected = toolbox::alignment::detail::smith_waterman_affine_score(q, t, 2, 3, 5, 1);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(profile.align(t) == expected,
+                                     "SW striped affine: score == scalar affine SW");
+    ok &= toolbox::test_utils::check(profile.align(q) == 600,
+                                     "SW striped affine: profile reused, self score == 2 * length");
+    return ok;
+}
+
+bool test_sw_striped_overflow() {
+    // 8-bit lanes saturate at 255, 16-bit lanes at 32767; both must fall back transparently.
+    const std::string s(2000, 'A');
+    bool ok = true;
+    int score16 = toolbox::alignment::smith_waterman_striped(s, s, 1, 1, 0, 1);
+    int score32 = toolbox::alignment::smith_waterman_striped(s, s, 20, 1, 0, 1);
+    ok &= toolbox::test_utils::check(score16 == 2000, "SW striped: 16-bit fallback");
+    ok &= toolbox::test_utils::check(score32 == 40000, "SW striped: scalar fallback");
+    return ok;
+}
+
+// ---- Scoring policies ---------------------------------------------------------
+
+// Score of a gapped alignment under a scoring policy, with gaps of length k costing o + k * e.
+template <typename Scoring>
+int scored_alignment_score(const toolbox::alignment::alphabet &abc, const Scoring &scoring,
+                           const std::string &a1, const std::string &a2, int o, int e) {
+    int score = 0;
+    for (std::size_t i = 0; i < a1.size(); i++) {
+        if (a1[i] == '-') {
+            score -= e + ((i == 0 || a1[i - 1] != '-') ? o : 0);
+        } else if (a2[i] == '-') {
+            score -= e + ((i == 0 || a2[i - 1] != '-') ? o : 0);
+        } else {
+            score += scoring.score(0, abc.encode(a1[i]), abc.encode(a2[i]));
+        }
+    }
+    return score;
+}
+
+bool test_scoring_matrices() {
+    const toolbox::alignment::alphabet protein = toolbox::alignment::protein_alphabet();
+    const toolbox::alignment::matrix_scoring blosum = toolbox::alignment::blosum62();
+    bool ok = true;
+    ok &= toolbox::test_utils::check(protein.size() == 24 && blosum.size() == 24,
+                                     "BLOSUM62: 24 symbols");
+    bool symmetric = true;
+    for (int c1 = 0; c1 < 24; c1++) {
+        for (int c2 = 0; c2 < 24; c2++) {
+            symmetric &= blosum.score(0, c1, c2) == blosum.score(0, c2, c1);
+        }
+    }
+    ok &= toolbox::test_utils::check(symmetric, "BLOSUM62: symmetric");
+    ok &= toolbox::test_utils::check(
+        blosum.score(0, protein.encode('W'), protein.encode('W')) == 11 &&
+            blosum.score(0, protein.encode('c'), protein.encode('C')) == 9 &&
+            blosum.score(0, protein.encode('I'), protein.encode('V')) == 3 &&
+            blosum.score(0, protein.encode('E'), protein.encode('Z')) == 4,
+        "BLOSUM62: entries");
+    ok &= toolbox::test_utils::check(protein.encode('J') == protein.encode('X'),
+                                     "Protein alphabet: unknown -> X");
+    const toolbox::alignment::alphabet iupac = toolbox::alignment::iupac_alphabet();
+    const toolbox::alignment::matrix_scoring ambiguous = toolbox::alignment::iupac_scoring(2, 3);
+    ok &= toolbox::test_utils::check(
+        ambiguous.score(0, iupac.encode('A'), iupac.encode('R')) == 2 &&
+            ambiguous.score(0, iupac.encode('N'), iupac.encode('c')) == 2 &&
+            ambiguous.score(0, iupac.encode('Y'), iupac.encode('R')) == -3 &&
+            ambiguous.score(0, iupac.encode('U'), iupac.encode('T')) == 2,
+        "IUPAC scoring: ambiguity codes");
+    const toolbox::alignment::alphabet bytes = toolbox::alignment::byte_alphabet();
+    const toolbox::alignment::matrix_scoring identity(bytes, 1, 1);
+    ok &= toolbox::test_utils::check(bytes.size() == 256 && bytes.encode('a') == 'a' &&
+                                         identity.score(0, 'a', 'A') == -1,
+                                     "Byte alphabet: 256 x 256 identity");
+    return ok;
+}
+
+bool test_sw_scored() {
+    const std::string s1s[] = {"ACACACTA", "TTTTGATTACATTTT", "AAAA", "", "GGATCGATTAGCTAGGCTA"};
+    const std::string s2s[] = {"AGCACACA", "GATTACA", "TTTT", "ACGT", "CGTTAGCTAGCTTAGGGA"};
+    const toolbox::alignment::alphabet dna = toolbox::alignment::dna_alphabet();
+    const toolbox::alignment::match_mismatch_scoring mm(2, 1);
+    bool ok = true;
+    for (std::size_t t = 0; t < sizeof(s1s) / sizeof(s1s[0]); t++) {
+        const toolbox::alignment::encoded_sequence e1 = dna.encode(s1s[t]);
+        const toolbox::alignment::encoded_sequence e2 = dna.encode(s2s[t]);
+        std::string a1, a2;
+        int expected = toolbox::alignment::smith_waterman_all(s1s[t], s2s[t], a1, a2, 2, 1, 2);
+        toolbox::alignment::alignment_result res;
+        // o = 0, e = g: the affine gap model reduces to the linear one.
+        int score = toolbox::alignment::smith_waterman_scored(e1, e2, mm, res, 0, 2);
+        toolbox::alignment::alignment_to_aligned(s1s[t], s2s[t], res, a1, a2);
+        ok &= toolbox::test_utils::check(score == expected, "SW scored: score == SW");
+        ok &= toolbox::test_utils::check(local_score(a1, a2, 2, 1, 2) == expected,
+                                         "SW scored: alignment score == score");
+        const toolbox::alignment::profile_scoring profile(e1, dna.size(), mm);
+        score = toolbox::alignment::smith_waterman_scored(e1, e2, profile, res, 0, 2);
+        ok &= toolbox::test_utils::check(score == expected, "SW scored: profile == SW");
+    }
+    // Protein local alignment with BLOSUM62 and the usual 11 / 1 affine gaps.
+    const std::string p1 = "MKTAYIAKQRQISFVKSHFSRQLEERLGLIEVQAPILSRVGDGTQDNLSGAEKAVQVKVKALPDAQ";
+    const std::string p2 = "KQRQISFVKSHFSRQDILDLWIYHTQGYFPDWQNYTPGPGVRYPLTFGWCYKLVPVEP";
+    const toolbox::alignment::alphabet protein = toolbox::alignment::protein_alphabet();
+    const toolbox::alignment::matrix_scoring blosum = toolbox::alignment::blosum62();
+    const toolbox::alignment::encoded_sequence q = protein.encode(p1);
+    const toolbox::alignment::encoded_sequence r = protein.encode(p2);
+    toolbox::alignment::alignment_result res;
+    int score = toolbox::alignment::smith_waterman_scored(q, r, blosum, res, 11, 1);
+    std::string a1, a2;
+    toolbox::alignment::alignment_to_aligned(p1, p2, res, a1, a2);
+    ok &= toolbox::test_utils::check(score > 0 && res.begin1 == 7 && res.begin2 == 0,
+                                     "SW BLOSUM62: shared segment found");
+    ok &= toolbox::test_utils::check(
+        scored_alignment_score(protein, blosum, a1, a2, 11, 1) == score,
+        "SW BLOSUM62: alignment score == score");
+    // The striped kernel builds its query profile from the same policy.
+    const toolbox::alignment::smith_waterman_profile striped(q, protein.size(), blosum, 11, 1);
+    ok &= toolbox::test_utils::check(striped.align(r) == score, "SW BLOSUM62: striped == scored");
+    return ok;
+}
+
+// ---- Smith-Waterman (inter-sequence batch) -----------------------------------
+
+// Targets of mixed lengths (so batches are padded), including empty ones and ones with a
+// saturating score.
+std::vector<std::string> batch_targets(const std::string &query) {
+    std::vector<std::string> targets;
+    unsigned seed = 11;
+    for (int t = 0; t < 70; t++) {
+        std::string s;
+        const int len = t % 13 == 0 ? 0 : 5 + t * 7 % 90;
+        for (int i = 0; i < len; i++) {
+            seed = seed * 1103515245u + 12345u;
+            s += "ACGT"[(seed >> 16) % 4];
+        }
+        if (t % 4 == 0) {
+            s += query.substr(t % 20, 30);
+        }
+        targets.push_back(s);
+    }
+    targets.push_back(std::string(400, 'A'));
+    return targets;
+}
+
+bool test_sw_batch() {
+    const std::string query = "ACGTTGCAAGCTAGCTAGGATCCGATCGATTTACGGACTAAAAAAAAAAAAAAAAAAAAAAAAAA";
+    const std::vector<std::string> targets = batch_targets(query);
+    toolbox::parallel::thread_pool pool(3);
+    bool ok = true;
+    for (int a : {1, 2, 40}) {
+        std::vector<int> scores(targets.size(), -1);
+        toolbox::alignment::smith_waterman_batch(query, targets, scores, a, 3, 5, 2, pool);
+        bool same = true;
+        for (std::size_t t = 0; t < targets.size(); t++) {
+            same &= scores[t] ==
+                    toolbox::alignment::smith_waterman_striped(query, targets[t], a, 3, 5, 2);
+        }
+        ok &= toolbox::test_utils::check(same, "SW batch: scores == striped SW");
+    }
+    std::vector<int> none;
+    toolbox::alignment::smith_waterman_batch(query, {}, none, 2, 3, 5, 2, pool);
+    ok &= toolbox::test_utils::check(none.empty(), "SW batch: no targets");
+    return ok;
+}
+
+bool test_sw_batch_top_k() {
+    const std::string query = "ACGTTGCAAGCTAGCTAGGATCCGATCGATTTACGGACT";
+    const std::vector<std::string> targets = batch_targets(query);
+    std::vector<int> scores(targets.size());
+    toolbox::alignment::smith_waterman_batch(query, targets, scores, 2, 3, 5, 2);
+    std::vector<toolbox::alignment::batch_hit> hits =
+        toolbox::alignment::smith_waterman_batch_top_k(query, targets, 5, 2, 3, 5, 2);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(hits.size() == 5, "SW top-k: k hits");
+    for (std::size_t h = 0; h < hits.size(); h++) {
+        int better = 0;
+        for (std::size_t t = 0; t < targets.size(); t++) {
+            better += scores[t] > hits[h].score ||
+                      (scores[t] == hits[h].score && t < hits[h].target);
+        }
+        ok &= toolbox::test_utils::check(scores[hits[h].target] == hits[h].score,
+                                         "SW top-k: hit score matches");
+        ok &= toolbox::test_utils::check(better == static_cast<int>(h), "SW top-k: rank");
+    }
+    hits = toolbox::alignment::smith_waterman_batch_top_k(query, targets, 1000, 2, 3, 5, 2);
+    ok &= toolbox::test_utils::check(hits.size() == targets.size(), "SW top-k: k > #targets");
+    return ok;
+}
+
 }  // namespace
 
 int main() {
@@ -101,6 +471,18 @@ int main() {
         {"sw_no_similarity", test_sw_no_similarity},
         {"sw_empty_input", test_sw_empty_input},
         {"sw_general", test_sw_general},
+        {"sw_hirschberg", test_sw_hirschberg},
+        {"sw_cigar", test_sw_cigar},
+        {"sw_result", test_sw_result},
+        {"sw_tiled", test_sw_tiled},
+        {"sw_banded", test_sw_banded},
+        {"sw_striped", test_sw_striped},
+        {"sw_striped_affine", test_sw_striped_affine},
+        {"sw_striped_overflow", test_sw_striped_overflow},
+        {"scoring_matrices", test_scoring_matrices},
+        {"sw_scored", test_sw_scored},
+        {"sw_batch", test_sw_batch},
+        {"sw_batch_top_k", test_sw_batch_top_k},
     };
     return toolbox::test_utils::run_tests(tests, sizeof(tests) / sizeof(tests[0]));
 }
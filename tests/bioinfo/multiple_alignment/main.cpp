@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "toolbox/bioinfo/alignment/global_alignment/nw_scored.hpp"
+#include "toolbox/bioinfo/alignment/global_alignment/wavefront_compact.hpp"
+#include "toolbox/bioinfo/alignment/multiple_alignment/progressive.hpp"
+#include "toolbox/bioinfo/alignment/scoring.hpp"
+#include "toolbox/parallel/thread_pool/thread_pool.hpp"
+
+#include "utils/test_util.hpp"
+
+namespace {
+
+// Verify a multiple alignment: rows of equal length, each row is its sequence with gaps, and
+// no column is made of gaps only.
+bool is_valid_msa(const std::vector<std::string> &seqs, const std::vector<std::string> &rows) {
+    if (rows.size() != seqs.size()) {
+        return false;
+    }
+    for (std::size_t r = 0; r < rows.size(); r++) {
+        std::string ungapped;
+        for (char c : rows[r]) {
+            if (c != '-') {
+                ungapped += c;
+            }
+        }
+        if (rows[r].size() != rows[0].size() || ungapped != seqs[r]) {
+            return false;
+        }
+    }
+    for (std::size_t c = 0; !rows.empty() && c < rows[0].size(); c++) {
+        bool residue = false;
+        for (const std::string &row : rows) {
+            residue |= row[c] != '-';
+        }
+        if (!residue) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A family of sequences: random substitutions and indels applied to one ancestor.
+std::vector<std::string> random_family(std::mt19937 &rng, int count, int len) {
+    std::string ancestor(len, 'A');
+    for (char &c : ancestor) {
+        c = "ACGT"[rng() % 4];
+    }
+    std::vector<std::string> seqs;
+    for (int k = 0; k < count; k++) {
+        std::string s;
+        for (char c : ancestor) {
+            const unsigned r = rng() % 100;
+            if (r < 4) {
+                s += "ACGT"[rng() % 4];
+            } else if (r < 6) {
+                continue;
+            } else if (r < 8) {
+                s += c;
+                s += "ACGT"[rng() % 4];
+            } else {
+                s += c;
+            }
+        }
+        seqs.push_back(s);
+    }
+    return seqs;
+}
+
+// ---- Distances and guide tree ------------------------------------------------
+
+bool test_pairwise_distances() {
+    const std::vector<std::string> seqs = {"ACGTACGT", "ACGAACGT", "TTTT", ""};
+    toolbox::parallel::thread_pool pool(3);
+    const std::vector<std::vector<double>> d = toolbox::alignment::pairwise_distances(seqs, pool);
+    bool ok = true;
+    for (std::size_t i = 0; i < seqs.size(); i++) {
+        for (std::size_t j = 0; j < seqs.size(); j++) {
+            const std::size_t len = std::max(seqs[i].size(), seqs[j].size());
+            const double expected =
+                i == j || len == 0
+                    ? 0.0
+                    : static_cast<double>(toolbox::alignment::wavefront_score(seqs[i], seqs[j])) /
+                          len;
+            ok &= toolbox::test_utils::check(d[i][j] == expected,
+                                             "Distances: d == edit distance / max length");
+        }
+    }
+    ok &= toolbox::test_utils::check(d[0][1] == 1.0 / 8, "Distances: one substitution in 8");
+    return ok;
+}
+
+bool test_upgma() {
+    // {0, 1} at distance 2 and {2, 3} at distance 4, 10 between the groups.
+    const std::vector<std::vector<double>> d = {
+        {0, 2, 10, 10}, {2, 0, 10, 10}, {10, 10, 0, 4}, {10, 10, 4, 0}};
+    const toolbox::alignment::guide_tree tree = toolbox::alignment::upgma_tree(d);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(tree.size() == 7, "UPGMA: 2n - 1 nodes");
+    ok &= toolbox::test_utils::check(tree[4].height == 1.0 && tree[4].size == 2 &&
+                                         tree[4].left + tree[4].right == 1,
+                                     "UPGMA: {0, 1} merged first at height 1");
+    ok &= toolbox::test_utils::check(tree[5].height == 2.0 && tree[5].size == 2,
+                                     "UPGMA: {2, 3} at height 2");
+    ok &= toolbox::test_utils::check(tree[6].height == 5.0 && tree[6].size == 4,
+                                     "UPGMA: root at height 5");
+    // Average linkage: {0, 1} to 2 is (3 + 5) / 2 = 4 < 6, so 2 joins before 3.
+    const std::vector<std::vector<double>> e = {
+        {0, 1, 3, 9}, {1, 0, 5, 9}, {3, 5, 0, 9}, {9, 9, 9, 0}};
+    const toolbox::alignment::guide_tree t2 = toolbox::alignment::upgma_tree(e);
+    ok &= toolbox::test_utils::check(t2[5].height == 2.0 && t2[5].size == 3,
+                                     "UPGMA: average linkage to the merged cluster");
+    ok &= toolbox::test_utils::check(t2[6].height == 4.5, "UPGMA: root at 9 / 2");
+    ok &= toolbox::test_utils::check(toolbox::alignment::upgma_tree({{0}}).size() == 1,
+                                     "UPGMA: single leaf");
+    return ok;
+}
+
+// ---- Progressive alignment ---------------------------------------------------
+
+bool test_profile_align_pair() {
+    // One row on each side: the profile DP is the pairwise one, scaled by 64.
+    const toolbox::alignment::alphabet abc = toolbox::alignment::dna_alphabet();
+    const toolbox::alignment::match_mismatch_scoring scoring(2, 3);
+    std::mt19937 rng(38);
+    bool ok = true;
+    for (int t = 0; t < 20; t++) {
+        const std::vector<std::string> seqs = random_family(rng, 2, 5 + t * 3);
+        toolbox::alignment::alignment_result pair, prof;
+        const int expected = toolbox::alignment::needleman_wunsch_scored(
+            abc.encode(seqs[0]), abc.encode(seqs[1]), scoring, pair, 4, 1);
+        const int score =
+            toolbox::alignment::profile_align({seqs[0]}, {seqs[1]}, abc, scoring, prof, 4, 1);
+        ok &= toolbox::test_utils::check(score == 64 * expected,
+                                         "Profile pair: score == 64 x needleman_wunsch_scored");
+        ok &= toolbox::test_utils::check(
+            toolbox::alignment::cigar_to_string(prof.ops) ==
+                toolbox::alignment::cigar_to_string(pair.ops),
+            "Profile pair: same CIGAR");
+    }
+    return ok;
+}
+
+bool test_progressive_identical() {
+    const std::vector<std::string> seqs(5, "ACGTTGCA");
+    const std::vector<std::string> rows = toolbox::alignment::progressive_align(
+        seqs, toolbox::alignment::dna_alphabet(), toolbox::alignment::match_mismatch_scoring());
+    return toolbox::test_utils::check(rows == seqs, "Progressive identical: no gaps");
+}
+
+bool test_progressive_indel() {
+    // The two short sequences lack the same TT: one gap block, in the same columns.
+    const std::vector<std::string> seqs = {"ACGTTACG", "ACGACG", "ACGTTACG", "ACGACG"};
+    const std::vector<std::string> rows = toolbox::alignment::progressive_align(
+        seqs, toolbox::alignment::dna_alphabet(), toolbox::alignment::match_mismatch_scoring(),
+        2, 1);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(is_valid_msa(seqs, rows), "Progressive indel: valid");
+    ok &= toolbox::test_utils::check(rows[0].size() == 8, "Progressive indel: 8 columns");
+    ok &= toolbox::test_utils::check(rows[1] == rows[3] && rows[0] == rows[2],
+                                     "Progressive indel: equal sequences, equal rows");
+    return ok;
+}
+
+bool test_progressive_family() {
+    std::mt19937 rng(3801);
+    toolbox::parallel::thread_pool serial(1), pool(4);
+    const toolbox::alignment::alphabet abc = toolbox::alignment::dna_alphabet();
+    const toolbox::alignment::match_mismatch_scoring scoring(2, 3);
+    bool ok = true;
+    for (int count : {1, 2, 3, 17, 40}) {
+        const std::vector<std::string> seqs = random_family(rng, count, 120);
+        const std::vector<std::string> rows1 =
+            toolbox::alignment::progressive_align(seqs, abc, scoring, 4, 1, serial);
+        const std::vector<std::string> rows4 =
+            toolbox::alignment::progressive_align(seqs, abc, scoring, 4, 1, pool);
+        ok &= toolbox::test_utils::check(is_valid_msa(seqs, rows4), "Progressive family: valid");
+        ok &= toolbox::test_utils::check(rows1 == rows4,
+                                         "Progressive family: independent of the threads");
+    }
+    ok &= toolbox::test_utils::check(
+        toolbox::alignment::progressive_align({}, abc, scoring).empty(), "Progressive: empty");
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    toolbox::test_utils::Test tests[] = {
+        {"pairwise_distances", test_pairwise_distances},
+        {"upgma", test_upgma},
+        {"profile_align_pair", test_profile_align_pair},
+        {"progressive_identical", test_progressive_identical},
+        {"progressive_indel", test_progressive_indel},
+        {"progressive_family", test_progressive_family},
+    };
+    return toolbox::test_utils::run_tests(tests, sizeof(tests) / sizeof(tests[0]));
+}
@@ -1,6 +1,8 @@
 #include <string>
+#include <vector>
 
 #include "toolbox/bioinfo/alignment/overlap_alignment/overlap.hpp"
+#include "toolbox/bioinfo/alignment/overlap_alignment/overlap_hirschberg.hpp"
 
 #include "utils/test_util.hpp"
 
@@ -94,6 +96,100 @@ bool test_overlap_general() {
     return ok;
 }
 
+// ---- Overlap alignment (linear space) ------------------------------------------
+
+bool test_overlap_hirschberg() {
+    const std::string s1s[] = {"AAACCGT", "AAAA", "", "ACGT", "TAGCTAGGA", "GATTACAGATTACA"};
+    const std::string s2s[] = {"CCGTGGG", "TTTT", "ACGT", "", "AGGATCCGA", "TACAGGTTACACCC"};
+    bool ok = true;
+    for (std::size_t t = 0; t < sizeof(s1s) / sizeof(s1s[0]); t++) {
+        std::vector<std::vector<int>> dp;
+        int expected = toolbox::alignment::overlap_dp(s1s[t], s2s[t], dp, 2, 1, 2);
+        std::string a1, a2;
+        // cutoff 4 forces the Hirschberg recursion even on these short inputs.
+        int score = toolbox::alignment::overlap_hirschberg(s1s[t], s2s[t], a1, a2, 2, 1, 2, 4);
+        ok &= toolbox::test_utils::check(score == expected, "Overlap Hirschberg: score == overlap");
+        ok &= toolbox::test_utils::check(is_valid_overlap_alignment(s1s[t], s2s[t], a1, a2),
+                                         "Overlap Hirschberg: alignment valid");
+    }
+    return ok;
+}
+
+// ---- Overlap alignment (CIGAR) -------------------------------------------------
+
+bool test_overlap_cigar() {
+    const std::string s1s[] = {"AAACCGT", "AAAA", "", "ACGT", "TAGCTAGGA", "GATTACAGATTACA"};
+    const std::string s2s[] = {"CCGTGGG", "TTTT", "ACGT", "", "AGGATCCGA", "TACAGGTTACACCC"};
+    bool ok = true;
+    for (std::size_t t = 0; t < sizeof(s1s) / sizeof(s1s[0]); t++) {
+        std::vector<std::vector<int>> dp;
+        int expected = toolbox::alignment::overlap_dp(s1s[t], s2s[t], dp, 2, 1, 2);
+        std::string e1, e2;
+        toolbox::alignment::overlap_traceback(s1s[t], s2s[t], dp, e1, e2, 2, 1, 2);
+        toolbox::alignment::cigar ops;
+        std::size_t begin1 = 0;
+        int score = toolbox::alignment::overlap_cigar(s1s[t], s2s[t], ops, begin1, 2, 1, 2);
+        std::string a1, a2;
+        toolbox::alignment::cigar_to_aligned(s1s[t], s2s[t], ops, a1, a2, begin1);
+        ok &= toolbox::test_utils::check(score == expected, "Overlap CIGAR: score == overlap");
+        ok &= toolbox::test_utils::check(a1 == e1 && a2 == e2, "Overlap CIGAR: same alignment");
+        ok &= toolbox::test_utils::check(is_valid_overlap_alignment(s1s[t], s2s[t], a1, a2),
+                                         "Overlap CIGAR: alignment valid");
+    }
+    toolbox::alignment::cigar ops;
+    std::size_t begin1 = 0;
+    toolbox::alignment::overlap_cigar("AAACCGT", "CCGTGGG", ops, begin1);
+    ok &= toolbox::test_utils::check(toolbox::alignment::cigar_to_string(ops) == "4M",
+                                     "Overlap CIGAR basic: 4M");
+    ok &= toolbox::test_utils::check(begin1 == 3, "Overlap CIGAR basic: begin1 == 3");
+    return ok;
+}
+
+bool test_overlap_result() {
+    const std::string s1s[] = {"AAACCGT", "AAAA", "", "ACGT", "TAGCTAGGA", "GATTACAGATTACA"};
+    const std::string s2s[] = {"CCGTGGG", "TTTT", "ACGT", "", "AGGATCCGA", "TACAGGTTACACCC"};
+    bool ok = true;
+    for (std::size_t t = 0; t < sizeof(s1s) / sizeof(s1s[0]); t++) {
+        std::string e1, e2, a1, a2;
+        int expected = toolbox::alignment::overlap_all(s1s[t], s2s[t], e1, e2, 2, 1, 2);
+        toolbox::alignment::alignment_result res[2];
+        toolbox::alignment::overlap_all(s1s[t], s2s[t], res[0], 2, 1, 2);
+        toolbox::alignment::overlap_hirschberg(s1s[t], s2s[t], res[1], 2, 1, 2);
+        for (const toolbox::alignment::alignment_result &r : res) {
+            toolbox::alignment::alignment_to_aligned(s1s[t], s2s[t], r, a1, a2);
+            ok &= toolbox::test_utils::check(r.score == expected, "Overlap result: score");
+            ok &= toolbox::test_utils::check(is_valid_overlap_alignment(s1s[t], s2s[t], a1, a2),
+                                             "Overlap result: alignment valid");
+            // A suffix of s1 against a prefix of s2.
+            ok &= toolbox::test_utils::check(r.end1 == s1s[t].size() && r.begin2 == 0,
+                                             "Overlap result: suffix / prefix");
+        }
+        toolbox::alignment::alignment_to_aligned(s1s[t], s2s[t], res[0], a1, a2);
+        ok &= toolbox::test_utils::check(a1 == e1 && a2 == e2, "Overlap result: same alignment");
+    }
+    toolbox::alignment::alignment_result r;
+    toolbox::alignment::overlap_all("AAACCGT", "CCGTGGG", r);
+    ok &= toolbox::test_utils::check(r.begin1 == 3 && r.end2 == 4,
+                                     "Overlap result basic: CCGT overlap");
+    return ok;
+}
+
+bool test_overlap_tiled() {
+    const std::string s1s[] = {"AAACCGT", "AAAA", "", "ACGT", "TAGCTAGGA", "GATTACAGATTACA"};
+    const std::string s2s[] = {"CCGTGGG", "TTTT", "ACGT", "", "AGGATCCGA", "TACAGGTTACACCC"};
+    toolbox::parallel::thread_pool pool(4);
+    bool ok = true;
+    for (std::size_t t = 0; t < sizeof(s1s) / sizeof(s1s[0]); t++) {
+        std::vector<std::vector<int>> dp;
+        int expected = toolbox::alignment::overlap_dp(s1s[t], s2s[t], dp, 2, 1, 2);
+        for (int tile = 1; tile <= 5; tile += 2) {
+            int score = toolbox::alignment::overlap_tiled(s1s[t], s2s[t], 2, 1, 2, tile, pool);
+            ok &= toolbox::test_utils::check(score == expected, "Overlap tiled: score == overlap");
+        }
+    }
+    return ok;
+}
+
 }  // namespace
 
 int main() {
@@ -103,6 +199,10 @@ int main() {
         {"overlap_empty_s1", test_overlap_empty_s1},
         {"overlap_empty_s2", test_overlap_empty_s2},
         {"overlap_general", test_overlap_general},
+        {"overlap_hirschberg", test_overlap_hirschberg},
+        {"overlap_cigar", test_overlap_cigar},
+        {"overlap_result", test_overlap_result},
+        {"overlap_tiled", test_overlap_tiled},
     };
     return toolbox::test_utils::run_tests(tests, sizeof(tests) / sizeof(tests[0]));
 }
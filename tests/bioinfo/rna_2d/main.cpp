@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "toolbox/bioinfo/rna_2d/nussinov.hpp"
+#include "toolbox/bioinfo/rna_2d/zuker.hpp"
+#include "toolbox/parallel/thread_pool/thread_pool.hpp"
+
+#include "utils/test_util.hpp"
+
+namespace {
+
+std::string random_rna(std::mt19937 &rng, int n) {
+    std::string s(n, 'A');
+    for (char &c : s) {
+        c = "ACGU"[rng() % 4];
+    }
+    return s;
+}
+
+// The classic dense recurrence: max over every split point, is_base_pair on every cell.
+int dense_nussinov(const std::string &seq, int min_loop) {
+    const int n = static_cast<int>(seq.size());
+    if (n == 0) {
+        return 0;
+    }
+    std::vector<std::vector<int>> dp(n + 1, std::vector<int>(n, 0));
+    for (int k = 1; k < n; k++) {
+        for (int i = 0; i + k < n; i++) {
+            const int j = i + k;
+            const bool paired = k > min_loop && toolbox::rna_2d::is_base_pair(seq[i], seq[j]);
+            int best = (k >= 2 ? dp[i + 1][j - 1] : 0) + paired;
+            for (int l = i; l < j; l++) {
+                best = std::max(best, dp[i][l] + dp[l + 1][j]);
+            }
+            dp[i][j] = best;
+        }
+    }
+    return dp[0][n - 1];
+}
+
+// Whether structure is balanced, pairs only complementary bases and every pair encloses at
+// least min_loop bases.
+bool valid_structure(const std::string &seq, const std::string &structure, int min_loop) {
+    std::vector<int> open;
+    for (int k = 0; k < static_cast<int>(structure.size()); k++) {
+        if (structure[k] == '(') {
+            open.push_back(k);
+        } else if (structure[k] == ')') {
+            if (open.empty() || k - open.back() - 1 < min_loop ||
+                !toolbox::rna_2d::is_base_pair(seq[open.back()], seq[k])) {
+                return false;
+            }
+            open.pop_back();
+        }
+    }
+    return open.empty();
+}
+
+int count_pairs(const std::string &structure) {
+    int pairs = 0;
+    for (char c : structure) {
+        pairs += c == '(';
+    }
+    return pairs;
+}
+
+// Minimum of structure_energy over every structure of seq[i..n) (canonical pairs, hairpins of
+// at least 3 bases), built on top of the partial structure s.
+int brute_force_mfe(const std::string &seq, std::string &s, int i) {
+    const int n = static_cast<int>(seq.size());
+    if (i >= n) {
+        return toolbox::rna_2d::structure_energy(seq, s);
+    }
+    if (s[i] != '.') {
+        return brute_force_mfe(seq, s, i + 1);
+    }
+    int best = brute_force_mfe(seq, s, i + 1);
+    // Pair i with j only if [i + 1, j) is free: later positions are filled left to right.
+    for (int j = i + 1; j < n; j++) {
+        if (s[j] != '.') {
+            break;
+        }
+        if (j - i > 3 && toolbox::rna_2d::detail::pair_type(seq[i], seq[j]) != 0) {
+            s[i] = '(';
+            s[j] = ')';
+            best = std::min(best, brute_force_mfe(seq, s, i + 1));
+            s[i] = s[j] = '.';
+        }
+    }
+    return best;
+}
+
+// ---- Nussinov ----------------------------------------------------------------
+
+bool test_nussinov_basic() {
+    const std::string seq = "GGGAAAUCC";
+    std::vector<std::vector<int>> dp;
+    int pairs = toolbox::rna_2d::nussinov_dp(seq, dp);
+    std::string structure = toolbox::rna_2d::nussinov_traceback(seq, dp);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(pairs == 3, "Nussinov basic: 3 pairs");
+    ok &= toolbox::test_utils::check(structure == "(((...)))", "Nussinov basic: structure");
+    ok &= toolbox::test_utils::check(toolbox::rna_2d::nussinov_dp("", dp) == 0,
+                                     "Nussinov basic: empty sequence");
+    return ok;
+}
+
+bool test_nussinov_fold() {
+    std::mt19937 rng(36);
+    toolbox::parallel::thread_pool pool(4);
+    bool ok = true;
+    for (int n : {0, 1, 2, 5, 17, 64, 129, 400}) {
+        const std::string seq = random_rna(rng, n);
+        std::vector<std::vector<int>> dp;
+        const int expected = toolbox::rna_2d::nussinov_dp(seq, dp);
+        const std::string structure = toolbox::rna_2d::nussinov_traceback(seq, dp);
+        std::string fast;
+        const int pairs = toolbox::rna_2d::nussinov_fold(seq, fast, 0, pool);
+        ok &= toolbox::test_utils::check(pairs == expected, "Nussinov fold: pairs == nussinov_dp");
+        ok &= toolbox::test_utils::check(fast == structure,
+                                         "Nussinov fold: structure == nussinov_traceback");
+    }
+    return ok;
+}
+
+bool test_nussinov_min_loop() {
+    std::mt19937 rng(37);
+    toolbox::parallel::thread_pool pool(4);
+    bool ok = true;
+    for (int min_loop : {0, 1, 3, 5}) {
+        for (int n : {0, 1, 4, 9, 33, 120, 350}) {
+            const std::string seq = random_rna(rng, n);
+            std::vector<std::vector<int>> dp;
+            const int pairs = toolbox::rna_2d::nussinov_dp(seq, dp, min_loop);
+            const std::string structure = toolbox::rna_2d::nussinov_traceback(seq, dp, min_loop);
+            std::string fast;
+            const int fast_pairs = toolbox::rna_2d::nussinov_fold(seq, fast, min_loop, pool);
+            ok &= toolbox::test_utils::check(pairs == dense_nussinov(seq, min_loop),
+                                             "Nussinov min loop: pairs == dense recurrence");
+            ok &= toolbox::test_utils::check(count_pairs(structure) == pairs,
+                                             "Nussinov min loop: structure has the pairs");
+            ok &= toolbox::test_utils::check(valid_structure(seq, structure, min_loop),
+                                             "Nussinov min loop: loops >= min_loop");
+            ok &= toolbox::test_utils::check(fast_pairs == pairs && fast == structure,
+                                             "Nussinov min loop: nussinov_fold agrees");
+        }
+    }
+    // GGGAAAUCC folds as (((...))) with a 3-base loop but only as ((.....)) with 5.
+    ok &= toolbox::test_utils::check(toolbox::rna_2d::nussinov_all("GGGAAAUCC", 5) == "((.....))",
+                                     "Nussinov min loop: loop of 5");
+    return ok;
+}
+
+// ---- Zuker -------------------------------------------------------------------
+// Energies in dcal/mol.
+
+bool test_zuker_hairpin() {
+    // Three GC/GC stacks (-330 each) closing a GAAA... triloop (540).
+    const std::string seq = "GGGGAAACCCC";
+    std::string structure;
+    int e = toolbox::rna_2d::zuker_fold(seq, structure);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(e == -450, "Zuker hairpin: energy == -450");
+    ok &= toolbox::test_utils::check(structure == "((((...))))", "Zuker hairpin: structure");
+    ok &= toolbox::test_utils::check(toolbox::rna_2d::structure_energy(seq, structure) == e,
+                                     "Zuker hairpin: structure_energy == mfe");
+    std::string open;
+    ok &= toolbox::test_utils::check(toolbox::rna_2d::zuker_fold("AAAAAAAA", open) == 0,
+                                     "Zuker hairpin: no pair -> 0");
+    ok &= toolbox::test_utils::check(open == "........", "Zuker hairpin: open chain");
+    return ok;
+}
+
+bool test_zuker_brute_force() {
+    std::mt19937 rng(3601);
+    bool ok = true;
+    for (int t = 0; t < 60; t++) {
+        const std::string seq = random_rna(rng, 6 + t % 9);
+        std::string s(seq.size(), '.');
+        const int expected = brute_force_mfe(seq, s, 0);
+        std::string structure;
+        const int e = toolbox::rna_2d::zuker_fold(seq, structure);
+        ok &= toolbox::test_utils::check(e == expected, "Zuker brute force: mfe == minimum");
+        ok &= toolbox::test_utils::check(toolbox::rna_2d::structure_energy(seq, structure) == e,
+                                         "Zuker brute force: structure_energy == mfe");
+    }
+    return ok;
+}
+
+bool test_zuker_parallel() {
+    std::mt19937 rng(3602);
+    toolbox::parallel::thread_pool serial(1), pool(4);
+    bool ok = true;
+    for (int n : {40, 150, 500}) {
+        const std::string seq = random_rna(rng, n);
+        std::string s1, s4;
+        const toolbox::rna_2d::energy_model model;
+        const int e1 = toolbox::rna_2d::zuker_fold(seq, s1, model, serial);
+        const int e4 = toolbox::rna_2d::zuker_fold(seq, s4, model, pool);
+        ok &= toolbox::test_utils::check(e1 == e4, "Zuker parallel: same energy");
+        ok &= toolbox::test_utils::check(s1 == s4, "Zuker parallel: same structure");
+        ok &= toolbox::test_utils::check(toolbox::rna_2d::structure_energy(seq, s4) == e4,
+                                         "Zuker parallel: structure_energy == mfe");
+    }
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    toolbox::test_utils::Test tests[] = {
+        {"nussinov_basic", test_nussinov_basic},
+        {"nussinov_fold", test_nussinov_fold},
+        {"nussinov_min_loop", test_nussinov_min_loop},
+        {"zuker_hairpin", test_zuker_hairpin},
+        {"zuker_brute_force", test_zuker_brute_force},
+        {"zuker_parallel", test_zuker_parallel},
+    };
+    return toolbox::test_utils::run_tests(tests, sizeof(tests) / sizeof(tests[0]));
+}
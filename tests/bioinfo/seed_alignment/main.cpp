@@ -0,0 +1,382 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "toolbox/bioinfo/alignment/seed_alignment/kmer_index.hpp"
+#include "toolbox/bioinfo/alignment/seed_alignment/seed_chain.hpp"
+#include "toolbox/parallel/thread_pool/thread_pool.hpp"
+#include "toolbox/string/packed_dna.hpp"
+
+#include "utils/test_util.hpp"
+
+namespace {
+
+std::string random_dna(std::mt19937 &rng, std::size_t n, const char *alphabet = "ACGT") {
+    const std::size_t sigma = std::char_traits<char>::length(alphabet);
+    std::string s(n, 'A');
+    for (char &c : s) {
+        c = alphabet[rng() % sigma];
+    }
+    return s;
+}
+
+// A read of s[pos, pos + len) with about rate% substitutions and indels.
+std::string mutate(std::mt19937 &rng, const std::string &s, std::size_t pos, std::size_t len,
+                   unsigned rate) {
+    std::string r;
+    for (std::size_t i = pos; i < pos + len; i++) {
+        const unsigned x = rng() % 300;
+        if (x < rate) {
+            r += "ACGT"[rng() % 4];
+        } else if (x < 2 * rate) {
+            continue;
+        } else if (x < 3 * rate) {
+            r += s[i];
+            r += "ACGT"[rng() % 4];
+        } else {
+            r += s[i];
+        }
+    }
+    return r;
+}
+
+// The definition: the leftmost smallest canonical k-mer hash of each window, repeats merged.
+std::vector<toolbox::alignment::minimizer> naive_minimizers(const std::string &s, int k, int w) {
+    std::vector<toolbox::alignment::minimizer> out;
+    if (s.size() < static_cast<std::size_t>(k)) {
+        return out;
+    }
+    const uint64_t mask = (1ULL << (2 * k)) - 1;
+    const int kmers = static_cast<int>(s.size()) - k + 1;
+    std::vector<toolbox::alignment::minimizer> all(kmers);
+    std::vector<bool> valid(kmers, false);
+    for (int p = 0; p < kmers; p++) {
+        uint64_t fwd = 0, rev = 0;
+        bool ok = true;
+        for (int q = 0; q < k; q++) {
+            const int c = toolbox::alignment::detail::nucleotide_code(s[p + q]);
+            ok &= c < 4;
+            fwd = fwd << 2 | (c & 3);
+            rev |= static_cast<uint64_t>(3 - (c & 3)) << (2 * q);
+        }
+        valid[p] = ok && fwd != rev;
+        all[p] = {toolbox::alignment::detail::kmer_hash(std::min(fwd, rev), mask),
+                  static_cast<uint32_t>(p), rev < fwd ? 1u : 0u};
+    }
+    const int windows = kmers >= w ? kmers - w + 1 : 1;
+    for (int t = 0; t < windows; t++) {
+        int best = -1;
+        for (int p = t; p < std::min(t + w, kmers); p++) {
+            if (valid[p] && (best < 0 || all[p].hash < all[best].hash)) {
+                best = p;
+            }
+        }
+        if (best >= 0 && (out.empty() || out.back().pos != all[best].pos)) {
+            out.push_back(all[best]);
+        }
+    }
+    return out;
+}
+
+bool same_minimizers(const std::vector<toolbox::alignment::minimizer> &a,
+                     const std::vector<toolbox::alignment::minimizer> &b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); i++) {
+        if (a[i].hash != b[i].hash || a[i].pos != b[i].pos || a[i].rev != b[i].rev) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The hits an index of targets must hold, sorted as in the index.
+std::vector<toolbox::alignment::kmer_hit> expected_hits(const std::vector<std::string> &targets,
+                                                        int k, int w) {
+    std::vector<toolbox::alignment::kmer_hit> hits;
+    for (std::size_t t = 0; t < targets.size(); t++) {
+        for (const toolbox::alignment::minimizer &m :
+             toolbox::alignment::compute_minimizers(targets[t], k, w)) {
+            hits.push_back({m.hash, static_cast<uint32_t>(t), m.pos << 1 | m.rev});
+        }
+    }
+    std::sort(hits.begin(), hits.end(), [](const auto &a, const auto &b) {
+        return a.hash != b.hash ? a.hash < b.hash
+                                : a.target != b.target ? a.target < b.target
+                                                       : a.pos_rev < b.pos_rev;
+    });
+    return hits;
+}
+
+bool same_hits(const toolbox::alignment::kmer_index &index,
+               const std::vector<toolbox::alignment::kmer_hit> &hits) {
+    if (index.size() != hits.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < hits.size(); i++) {
+        const toolbox::alignment::kmer_hit &h = index.begin()[i];
+        if (h.hash != hits[i].hash || h.target != hits[i].target ||
+            h.pos_rev != hits[i].pos_rev) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ---- Minimizers --------------------------------------------------------------
+
+bool test_minimizers() {
+    std::mt19937 rng(39);
+    bool ok = true;
+    for (int t = 0; t < 200; t++) {
+        const int k = 1 + t % 16;
+        const int w = 1 + t % 11;
+        // Some N's, and a small alphabet now and then for ties and palindromes.
+        const std::string s = random_dna(rng, t % 90, t % 5 == 0 ? "ACGTN" : t % 5 == 1 ? "AT"
+                                                                                      : "ACGT");
+        ok &= toolbox::test_utils::check(
+            same_minimizers(toolbox::alignment::compute_minimizers(s, k, w),
+                            naive_minimizers(s, k, w)),
+            "Minimizers: == definition");
+    }
+    // Every window of w k-mers holds a minimizer: a shared stretch of w + k - 1 bases is seen.
+    const std::string s = random_dna(rng, 500);
+    const std::vector<toolbox::alignment::minimizer> m =
+        toolbox::alignment::compute_minimizers(s, 15, 10);
+    bool dense = !m.empty() && m.front().pos <= 9 && m.back().pos + 10 >= 500 - 15 + 1;
+    for (std::size_t i = 1; i < m.size(); i++) {
+        dense &= m[i].pos > m[i - 1].pos && m[i].pos - m[i - 1].pos <= 10;
+    }
+    ok &= toolbox::test_utils::check(dense, "Minimizers: at most w apart");
+    return ok;
+}
+
+// ---- Index -------------------------------------------------------------------
+
+bool test_kmer_index_build() {
+    std::mt19937 rng(3901);
+    // The long target spans several parallel chunks of 2^20 windows.
+    const std::vector<std::string> targets = {random_dna(rng, 2200000),
+                                              random_dna(rng, 5000, "ACGTN"), "",
+                                              random_dna(rng, 12)};
+    toolbox::parallel::thread_pool pool(4);
+    const toolbox::alignment::kmer_index index(targets, 15, 10, pool);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(same_hits(index, expected_hits(targets, 15, 10)),
+                                     "Index build: hits == minimizers of every target");
+    ok &= toolbox::test_utils::check(index.target_count() == 4 && index.target_length(1) == 5000,
+                                     "Index build: target lengths");
+    const toolbox::alignment::minimizer m = toolbox::alignment::compute_minimizers(targets[1])[7];
+    const auto range = index.find(m.hash);
+    bool found = false;
+    for (const toolbox::alignment::kmer_hit *h = range.first; h != range.second; h++) {
+        ok &= toolbox::test_utils::check(h->hash == m.hash, "Index find: hash matches");
+        found |= h->target == 1 && h->pos_rev == (m.pos << 1 | m.rev);
+    }
+    ok &= toolbox::test_utils::check(found, "Index find: occurrence found");
+    ok &= toolbox::test_utils::check(index.find(~0ULL).first == index.find(~0ULL).second,
+                                     "Index find: absent hash");
+    return ok;
+}
+
+bool test_kmer_index_map() {
+    std::mt19937 rng(3902);
+    const std::vector<std::string> targets = {random_dna(rng, 30000), random_dna(rng, 700)};
+    const toolbox::alignment::kmer_index index(targets, 13, 7);
+    const std::string path = "kmer_index_test.bin";
+    bool ok = true;
+    ok &= toolbox::test_utils::check(index.save(path), "Index map: save");
+    toolbox::alignment::kmer_index mapped;
+    ok &= toolbox::test_utils::check(mapped.map(path), "Index map: map");
+    ok &= toolbox::test_utils::check(mapped.k() == 13 && mapped.w() == 7 &&
+                                         mapped.target_count() == 2 &&
+                                         mapped.target_length(0) == 30000,
+                                     "Index map: parameters");
+    ok &= toolbox::test_utils::check(same_hits(mapped, expected_hits(targets, 13, 7)),
+                                     "Index map: same hits");
+    toolbox::alignment::kmer_index moved(std::move(mapped));
+    ok &= toolbox::test_utils::check(same_hits(moved, expected_hits(targets, 13, 7)),
+                                     "Index map: moved mapping");
+    std::FILE *f = std::fopen(path.c_str(), "wb");
+    std::fputs("not an index, but long enough to have a header of 48 bytes....", f);
+    std::fclose(f);
+    ok &= toolbox::test_utils::check(!moved.map(path), "Index map: rejects other files");
+    ok &= toolbox::test_utils::check(moved.size() == index.size(), "Index map: kept on failure");
+    std::remove(path.c_str());
+    ok &= toolbox::test_utils::check(!moved.map(path), "Index map: missing file");
+    return ok;
+}
+
+// ---- Seed and extend ---------------------------------------------------------
+
+bool test_map_query() {
+    std::mt19937 rng(3903);
+    const std::vector<std::string> targets = {random_dna(rng, 100000), random_dna(rng, 60000),
+                                              random_dna(rng, 40000)};
+    const toolbox::alignment::kmer_index index(targets);
+    bool ok = true;
+    int correct = 0;
+    const int reads = 40;
+    for (int r = 0; r < reads; r++) {
+        const uint32_t t = rng() % 3;
+        const std::size_t len = 300 + rng() % 700;
+        const std::size_t pos = rng() % (targets[t].size() - len);
+        const bool rev = r % 2 == 1;
+        std::string read = mutate(rng, targets[t], pos, len, 5);
+        if (rev) {
+            read = toolbox::alignment::detail::reverse_complement(read);
+        }
+        const std::vector<toolbox::alignment::seed_mapping> maps =
+            toolbox::alignment::map_query(index, targets, read);
+        if (maps.empty()) {
+            continue;
+        }
+        const toolbox::alignment::seed_mapping &m = maps[0];
+        const long long shift = static_cast<long long>(m.aln.begin2) - static_cast<long long>(pos);
+        correct += m.target == t && m.rev == rev && shift >= -20 && shift <= 20;
+        // The alignment covers the whole read and its score is its edit count.
+        std::size_t qlen = 0, tlen = 0;
+        int edits = 0;
+        std::size_t i = 0, j = m.aln.begin2;
+        const std::string q = rev ? toolbox::alignment::detail::reverse_complement(read) : read;
+        for (const toolbox::alignment::cigar_op &c : m.aln.ops) {
+            for (int x = 0; x < c.len; x++) {
+                if (c.op == 'M') {
+                    edits += q[i++] != targets[m.target][j++];
+                } else if (c.op == 'D') {
+                    i++;
+                    edits++;
+                } else {
+                    j++;
+                    edits++;
+                }
+            }
+        }
+        qlen = i;
+        tlen = j - m.aln.begin2;
+        ok &= toolbox::test_utils::check(qlen == read.size() && m.aln.end1 == read.size(),
+                                         "Map query: the whole read is aligned");
+        ok &= toolbox::test_utils::check(m.aln.end2 - m.aln.begin2 == tlen && edits == m.aln.score,
+                                         "Map query: score == edits of the CIGAR");
+    }
+    ok &= toolbox::test_utils::check(correct == reads, "Map query: reads mapped to their origin");
+    ok &= toolbox::test_utils::check(
+        toolbox::alignment::map_query(index, targets, random_dna(rng, 400)).empty(),
+        "Map query: unrelated read not mapped");
+    return ok;
+}
+
+bool test_chain_anchors() {
+    // Two colinear anchors and one off-diagonal outlier on target 0, forward strand.
+    const std::vector<toolbox::alignment::seed_anchor> anchors = {
+        {0, 0, 100, 0}, {0, 0, 120, 20}, {0, 0, 140, 40}, {0, 0, 3000, 45}};
+    toolbox::alignment::seed_options options;
+    options.min_score = 1;
+    const std::vector<toolbox::alignment::seed_chain> chains =
+        toolbox::alignment::chain_anchors(anchors, 15, options);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(chains.size() == 2, "Chain: two chains");
+    ok &= toolbox::test_utils::check(chains[0].anchors == 3 && chains[0].score == 45 &&
+                                         chains[0].qbegin == 0 && chains[0].qend == 55 &&
+                                         chains[0].tbegin == 100 && chains[0].tend == 155,
+                                     "Chain: colinear anchors chained");
+    ok &= toolbox::test_utils::check(chains[1].anchors == 1 && chains[1].score == 15,
+                                     "Chain: the outlier alone");
+    return ok;
+}
+
+// Packed targets and queries give the same index and the same mappings.
+bool test_packed_dna() {
+    std::mt19937 rng(3904);
+    const std::vector<std::string> targets = {random_dna(rng, 80000),
+                                              random_dna(rng, 3000, "ACGTN")};
+    std::vector<toolbox::string::packed_dna> packed;
+    for (const std::string &t : targets) {
+        packed.push_back(toolbox::string::packed_dna(t));
+    }
+    const toolbox::alignment::kmer_index index(targets);
+    const toolbox::alignment::kmer_index packed_index(packed);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(same_hits(packed_index, expected_hits(targets, 15, 10)),
+                                     "Packed: same index");
+    for (int r = 0; r < 10; r++) {
+        const std::size_t pos = rng() % 79000;
+        std::string read = mutate(rng, targets[0], pos, 600, 5);
+        if (r % 2 == 1) {
+            read = toolbox::alignment::detail::reverse_complement(read);
+        }
+        const std::vector<toolbox::alignment::seed_mapping> a =
+            toolbox::alignment::map_query(index, targets, read);
+        const std::vector<toolbox::alignment::seed_mapping> b = toolbox::alignment::map_query(
+            packed_index, packed, toolbox::string::packed_dna(read));
+        bool same = a.size() == b.size() && !a.empty();
+        for (std::size_t i = 0; same && i < a.size(); i++) {
+            same = a[i].target == b[i].target && a[i].rev == b[i].rev &&
+                   a[i].aln.score == b[i].aln.score && a[i].aln.begin2 == b[i].aln.begin2 &&
+                   toolbox::alignment::cigar_to_string(a[i].aln.ops) ==
+                       toolbox::alignment::cigar_to_string(b[i].aln.ops);
+        }
+        ok &= toolbox::test_utils::check(same, "Packed: same mappings");
+    }
+    return ok;
+}
+
+// A soft-masked (lowercase) query is complemented like the packed one, so its reverse strand
+// mappings are the same.
+bool test_soft_masked() {
+    bool ok = true;
+    const std::string mixed = "acgtuACGTUgcNa";
+    ok &= toolbox::test_utils::check(
+        toolbox::alignment::detail::reverse_complement(mixed) == "TNGCAACGTAACGT" &&
+            toolbox::alignment::detail::reverse_complement(mixed) ==
+                toolbox::string::packed_dna(mixed).reverse_complement().str(),
+        "Soft-masked: reverse complement");
+    std::mt19937 rng(3905);
+    const std::vector<std::string> targets = {random_dna(rng, 60000)};
+    const std::vector<toolbox::string::packed_dna> packed = {
+        toolbox::string::packed_dna(targets[0])};
+    const toolbox::alignment::kmer_index index(targets);
+    for (int r = 0; r < 10; r++) {
+        // Even reads map to the forward strand, odd reads to the reverse strand.
+        std::string upper = mutate(rng, targets[0], rng() % 59000, 600, 5);
+        if (r % 2 == 1) {
+            upper = toolbox::alignment::detail::reverse_complement(upper);
+        }
+        std::string read = upper;
+        std::transform(read.begin(), read.end(), read.begin(),
+                       [](char c) { return static_cast<char>(c - 'A' + 'a'); });
+        const std::vector<toolbox::alignment::seed_mapping> a =
+            toolbox::alignment::map_query(index, targets, read);
+        const std::vector<toolbox::alignment::seed_mapping> b =
+            toolbox::alignment::map_query(index, packed, toolbox::string::packed_dna(read));
+        const std::vector<toolbox::alignment::seed_mapping> u =
+            toolbox::alignment::map_query(index, targets, upper);
+        ok &= toolbox::test_utils::check(
+            !a.empty() && !b.empty() && !u.empty() && a[0].rev == static_cast<uint32_t>(r % 2) &&
+                b[0].rev == a[0].rev && a[0].aln.score == b[0].aln.score &&
+                a[0].aln.score == u[0].aln.score && a[0].aln.begin2 == b[0].aln.begin2 &&
+                toolbox::alignment::cigar_to_string(a[0].aln.ops) ==
+                    toolbox::alignment::cigar_to_string(b[0].aln.ops),
+            "Soft-masked: same mappings on both strands");
+    }
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    toolbox::test_utils::Test tests[] = {
+        {"minimizers", test_minimizers},
+        {"kmer_index_build", test_kmer_index_build},
+        {"kmer_index_map", test_kmer_index_map},
+        {"chain_anchors", test_chain_anchors},
+        {"map_query", test_map_query},
+        {"packed_dna", test_packed_dna},
+        {"soft_masked", test_soft_masked},
+    };
+    return toolbox::test_utils::run_tests(tests, sizeof(tests) / sizeof(tests[0]));
+}
@@ -0,0 +1,77 @@
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "toolbox/parallel/thread_pool/thread_pool.hpp"
+
+#include "utils/test_util.hpp"
+
+namespace {
+
+bool test_parallel_for_covers_range() {
+    toolbox::parallel::thread_pool pool(4);
+    std::vector<int> hit(1000, 0);
+    pool.parallel_for(0, hit.size(), [&](std::size_t i) { hit[i]++; });
+    bool ok = true;
+    for (std::size_t i = 0; i < hit.size(); i++) {
+        ok &= hit[i] == 1;
+    }
+    ok = toolbox::test_utils::check(ok, "every index visited exactly once");
+    ok &= toolbox::test_utils::check(pool.size() == 4, "size() counts the caller");
+    return ok;
+}
+
+bool test_parallel_for_subrange() {
+    toolbox::parallel::thread_pool pool(3);
+    std::atomic<long long> sum(0);
+    pool.parallel_for(10, 20, [&](std::size_t i) { sum += static_cast<long long>(i); });
+    bool ok = true;
+    ok &= toolbox::test_utils::check(sum == 145, "sum over [10, 20)");
+    pool.parallel_for(5, 5, [&](std::size_t) { sum = -1; });
+    ok &= toolbox::test_utils::check(sum == 145, "empty range runs nothing");
+    return ok;
+}
+
+bool test_single_thread() {
+    toolbox::parallel::thread_pool pool(1);
+    std::vector<std::size_t> order;
+    pool.parallel_for(0, 5, [&](std::size_t i) { order.push_back(i); });
+    const std::vector<std::size_t> expected = {0, 1, 2, 3, 4};
+    return toolbox::test_utils::check(order == expected, "one thread runs the loop in order");
+}
+
+bool test_nested() {
+    // Every outer iteration runs an inner loop on the same pool; the waiting threads must keep
+    // picking up queued jobs instead of blocking the pool.
+    toolbox::parallel::thread_pool pool(3);
+    std::atomic<int> count(0);
+    pool.parallel_for(0, 8, [&](std::size_t) {
+        pool.parallel_for(0, 50, [&](std::size_t) { count++; });
+    });
+    return toolbox::test_utils::check(count == 400, "nested parallel_for completes");
+}
+
+bool test_reuse() {
+    toolbox::parallel::thread_pool &pool = toolbox::parallel::default_thread_pool();
+    bool ok = true;
+    for (int round = 0; round < 20; round++) {
+        std::atomic<int> count(0);
+        pool.parallel_for(0, 100, [&](std::size_t) { count++; });
+        ok &= count == 100;
+    }
+    return toolbox::test_utils::check(ok, "default pool reused across loops");
+}
+
+}  // namespace
+
+int main() {
+    toolbox::test_utils::Test tests[] = {
+        {"parallel_for_covers_range", test_parallel_for_covers_range},
+        {"parallel_for_subrange", test_parallel_for_subrange},
+        {"single_thread", test_single_thread},
+        {"nested", test_nested},
+        {"reuse", test_reuse},
+    };
+    return toolbox::test_utils::run_tests(tests, sizeof(tests) / sizeof(tests[0]));
+}
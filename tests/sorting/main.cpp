@@ -1,7 +1,18 @@
+#include <sys/resource.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "toolbox/sorting/sorting.hpp"
@@ -241,6 +252,15 @@ bool test_ternary_split_quick_sort_asc(const SortTestCase &tc) {
 bool test_merge_insertion_sort_asc(const SortTestCase &tc) {
     return run_sort_test(tc, toolbox::sorting::merge_insertion_sort<std::vector<int>::iterator>);
 }
+bool test_radix_sort_asc(const SortTestCase &tc) {
+    return run_sort_test(tc, toolbox::sorting::radix_sort<std::vector<int>::iterator>);
+}
+bool test_pdq_sort_asc(const SortTestCase &tc) {
+    return run_sort_test(tc, toolbox::sorting::pdq_sort<std::vector<int>::iterator>);
+}
+bool test_parallel_sort_asc(const SortTestCase &tc) {
+    return run_sort_test(tc, toolbox::sorting::parallel_sort<std::vector<int>::iterator>);
+}
 
 // Descending (custom comparator)
 bool test_bubble_sort_desc(const SortTestCase &tc) {
@@ -328,6 +348,779 @@ bool test_merge_insertion_sort_desc(const SortTestCase &tc) {
     return run_sort_test_desc(
         tc, toolbox::sorting::merge_insertion_sort<std::vector<int>::iterator, std::greater<int>>);
 }
+bool test_pdq_sort_desc(const SortTestCase &tc) {
+    return run_sort_test_desc(
+        tc, toolbox::sorting::pdq_sort<std::vector<int>::iterator, std::greater<int>>);
+}
+// radix_sort takes a key instead of a comparator: ~x orders the ints the other way round.
+void radix_sort_greater(std::vector<int>::iterator first, std::vector<int>::iterator last,
+                        std::greater<int>) {
+    toolbox::sorting::radix_sort(first, last, [](int x) { return ~x; });
+}
+bool test_radix_sort_desc(const SortTestCase &tc) {
+    return run_sort_test_desc(tc, radix_sort_greater);
+}
+void parallel_sort_greater(std::vector<int>::iterator first, std::vector<int>::iterator last,
+                           std::greater<int> comp) {
+    toolbox::sorting::parallel_sort(first, last, comp);
+}
+bool test_parallel_sort_desc(const SortTestCase &tc) {
+    return run_sort_test_desc(tc, parallel_sort_greater);
+}
+
+// ---- Distribution sorts on other key types ----------------------------------
+
+bool test_radix_sort_floats() {
+    std::vector<double> v;
+    const double special[] = {0.0,
+                              -0.0,
+                              1.0,
+                              -1.0,
+                              std::numeric_limits<double>::infinity(),
+                              -std::numeric_limits<double>::infinity(),
+                              std::numeric_limits<double>::denorm_min(),
+                              -std::numeric_limits<double>::denorm_min(),
+                              std::numeric_limits<double>::max(),
+                              std::numeric_limits<double>::lowest()};
+    unsigned s = 7;
+    for (int i = 0; i < 5000; i++) {
+        s = s * 1664525u + 1013904223u;
+        v.push_back((static_cast<int>(s >> 8) % 20001 - 10000) / 64.0);
+        if (i % 500 == 0) {
+            v.insert(v.end(), special, special + 10);
+        }
+    }
+    std::vector<float> f(v.begin(), v.end());
+    std::vector<double> expected = v;
+    std::vector<float> expected_f = f;
+    std::sort(expected.begin(), expected.end());
+    std::sort(expected_f.begin(), expected_f.end());
+    toolbox::sorting::radix_sort(v.begin(), v.end());
+    toolbox::sorting::radix_sort(f.begin(), f.end());
+    bool ok = toolbox::test_utils::check(v == expected, "radix_sort double");
+    ok &= toolbox::test_utils::check(f == expected_f, "radix_sort float");
+    // -0.0 == 0.0, but the bit-flipped keys put every -0.0 before every 0.0.
+    bool zeros_ordered = true;
+    for (std::size_t i = 1; i < v.size(); i++) {
+        zeros_ordered &= !(std::signbit(v[i]) && v[i] == 0.0 && !std::signbit(v[i - 1]) &&
+                           v[i - 1] == 0.0);
+    }
+    return ok && toolbox::test_utils::check(zeros_ordered, "radix_sort -0.0 before 0.0");
+}
+
+bool test_radix_sort_integer_widths() {
+    std::vector<int64_t> w;
+    std::vector<uint8_t> b;
+    std::vector<int16_t> h;
+    unsigned s = 11;
+    for (int i = 0; i < 3000; i++) {
+        s = s * 1664525u + 1013904223u;
+        w.push_back((static_cast<int64_t>(s) << 31) * (i % 2 ? 1 : -1));
+        b.push_back(static_cast<uint8_t>(s >> 24));
+        h.push_back(static_cast<int16_t>(s >> 16));
+    }
+    w.push_back(std::numeric_limits<int64_t>::min());
+    w.push_back(std::numeric_limits<int64_t>::max());
+    std::vector<int64_t> ew = w;
+    std::vector<uint8_t> eb = b;
+    std::vector<int16_t> eh = h;
+    std::sort(ew.begin(), ew.end());
+    std::sort(eb.begin(), eb.end());
+    std::sort(eh.begin(), eh.end());
+    toolbox::sorting::radix_sort(w.begin(), w.end());
+    toolbox::sorting::radix_sort(b.begin(), b.end());
+    toolbox::sorting::radix_sort(h.begin(), h.end());
+    bool ok = toolbox::test_utils::check(w == ew, "radix_sort int64_t");
+    ok &= toolbox::test_utils::check(b == eb, "radix_sort uint8_t");
+    return ok && toolbox::test_utils::check(h == eh, "radix_sort int16_t");
+}
+
+struct Event {
+    uint32_t timestamp;
+    int id;
+};
+
+bool test_radix_sort_records_stable() {
+    for (std::size_t n : {std::size_t(40), std::size_t(20000)}) {
+        std::vector<Event> v;
+        unsigned s = 3;
+        for (std::size_t i = 0; i < n; i++) {
+            s = s * 1664525u + 1013904223u;
+            v.push_back(Event{s % 97u, static_cast<int>(i)});
+        }
+        std::vector<Event> expected = v;
+        std::stable_sort(expected.begin(), expected.end(), [](const Event &a, const Event &b) {
+            return a.timestamp < b.timestamp;
+        });
+        toolbox::sorting::radix_sort(v.begin(), v.end(),
+                                     [](const Event &e) { return e.timestamp; });
+        bool same = true;
+        for (std::size_t i = 0; i < n; i++) {
+            same &= v[i].timestamp == expected[i].timestamp && v[i].id == expected[i].id;
+        }
+        if (!toolbox::test_utils::check(same, "radix_sort records stable, n = " +
+                                                  std::to_string(n))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_tim_sort_stable() {
+    // Sorted runs of different lengths with few distinct keys, as left by log-structured merges:
+    // merges gallop, and equal keys must keep their order.
+    std::vector<Event> v;
+    unsigned s = 13;
+    for (int run = 0; run < 40; run++) {
+        s = s * 1664525u + 1013904223u;
+        const int len = 50 + static_cast<int>((s >> 8) % 3000);
+        std::vector<uint32_t> keys;
+        for (int i = 0; i < len; i++) {
+            s = s * 1664525u + 1013904223u;
+            keys.push_back((s >> 8) % 200u);
+        }
+        std::sort(keys.begin(), keys.end());
+        if (run % 5 == 4) {
+            std::reverse(keys.begin(), keys.end());
+        }
+        for (uint32_t k : keys) {
+            v.push_back(Event{k, static_cast<int>(v.size())});
+        }
+    }
+    const auto by_timestamp = [](const Event &a, const Event &b) {
+        return a.timestamp < b.timestamp;
+    };
+    std::vector<Event> expected = v;
+    std::stable_sort(expected.begin(), expected.end(), by_timestamp);
+    toolbox::sorting::tim_sort(v.begin(), v.end(), by_timestamp);
+    bool same = true;
+    for (std::size_t i = 0; i < v.size(); i++) {
+        same &= v[i].timestamp == expected[i].timestamp && v[i].id == expected[i].id;
+    }
+    return toolbox::test_utils::check(same, "tim_sort keeps equal keys in order");
+}
+
+bool test_merge_sort_stable() {
+    // Few distinct keys, and more elements than a merge tile holds, so equal keys meet in the
+    // run sort, in merges within a tile and in merges across tiles.
+    const auto by_timestamp = [](const Event &a, const Event &b) {
+        return a.timestamp < b.timestamp;
+    };
+    bool same = true;
+    unsigned s = 29;
+    for (int n : {33, 1000, 40000, 40017}) {
+        std::vector<Event> v;
+        for (int i = 0; i < n; i++) {
+            s = s * 1664525u + 1013904223u;
+            v.push_back(Event{(s >> 8) % 50u, i});
+        }
+        std::vector<Event> expected = v;
+        std::stable_sort(expected.begin(), expected.end(), by_timestamp);
+        toolbox::sorting::merge_sort(v.begin(), v.end(), by_timestamp);
+        for (std::size_t i = 0; i < v.size(); i++) {
+            same &= v[i].timestamp == expected[i].timestamp && v[i].id == expected[i].id;
+        }
+    }
+    return toolbox::test_utils::check(same, "merge_sort keeps equal keys in order");
+}
+
+bool test_kway_merge_stable() {
+    // Shards of uneven lengths, some empty, with few distinct keys; ids number the elements in
+    // shard order, so a stable merge equals a stable sort of the concatenation.
+    const auto by_timestamp = [](const Event &a, const Event &b) {
+        return a.timestamp < b.timestamp;
+    };
+    unsigned s = 31;
+    std::vector<std::vector<Event>> shards(37);
+    int id = 0;
+    for (std::size_t k = 0; k < shards.size(); k++) {
+        s = s * 1664525u + 1013904223u;
+        const std::size_t len = k % 5 == 0 ? 0 : (s >> 8) % 300;
+        for (std::size_t i = 0; i < len; i++) {
+            s = s * 1664525u + 1013904223u;
+            shards[k].push_back(Event{(s >> 8) % 20u, id++});
+        }
+        std::stable_sort(shards[k].begin(), shards[k].end(), by_timestamp);
+    }
+    std::vector<Event> all;
+    std::vector<std::pair<std::vector<Event>::const_iterator, std::vector<Event>::const_iterator>>
+        ranges;
+    for (const std::vector<Event> &shard : shards) {
+        all.insert(all.end(), shard.begin(), shard.end());
+        ranges.emplace_back(shard.begin(), shard.end());
+    }
+    std::vector<Event> expected = all;
+    std::stable_sort(expected.begin(), expected.end(), by_timestamp);
+    std::vector<Event> merged;
+    toolbox::sorting::kway_merge(ranges.begin(), ranges.end(), std::back_inserter(merged),
+                                 by_timestamp);
+    // patience_sort and tournament_sort merge through the same loser tree, and are stable too.
+    std::vector<Event> patience = all;
+    toolbox::sorting::patience_sort(patience.begin(), patience.end(), by_timestamp);
+    std::vector<Event> tournament = all;
+    toolbox::sorting::tournament_sort(tournament.begin(), tournament.end(), by_timestamp);
+    bool same = merged.size() == expected.size();
+    for (std::size_t i = 0; same && i < expected.size(); i++) {
+        same = merged[i].id == expected[i].id && patience[i].id == expected[i].id &&
+               tournament[i].id == expected[i].id;
+    }
+    std::vector<int> a = {1, 4, 9};
+    std::vector<int> b = {2, 3, 10, 11};
+    std::pair<int *, int *> plain[] = {{a.data(), a.data() + a.size()},
+                                       {b.data(), b.data() + b.size()}};
+    int out[7];
+    int *end = toolbox::sorting::kway_merge(plain, plain + 2, out);
+    same &= end == out + 7 && std::is_sorted(out, end);
+    return toolbox::test_utils::check(same, "kway_merge merges shards stably");
+}
+
+bool test_sort_by_key() {
+    const auto by_timestamp = [](const Event &a, const Event &b) {
+        return a.timestamp < b.timestamp;
+    };
+    const auto timestamp = [](const Event &e) { return e.timestamp; };
+    // Not "t" + std::to_string(...), which trips gcc 12's -Wrestrict at -O3.
+    const auto name = [](const Event &e) {
+        return std::string("t").append(std::to_string(e.timestamp % 7));
+    };
+    bool same = true;
+    unsigned s = 37;
+    for (int n : {0, 1, 50, 5000}) {
+        std::vector<Event> v;
+        for (int i = 0; i < n; i++) {
+            s = s * 1664525u + 1013904223u;
+            v.push_back(Event{(s >> 8) % 40u, i});
+        }
+        // Numeric keys, ascending and descending, take the radix path; the string key the
+        // comparison path. All of them are stable.
+        std::vector<Event> expected = v;
+        std::stable_sort(expected.begin(), expected.end(), by_timestamp);
+        std::vector<Event> got = v;
+        toolbox::sorting::sort_by_key(got.begin(), got.end(), timestamp);
+        const std::vector<std::size_t> perm =
+            toolbox::sorting::argsort_by_key(v.begin(), v.end(), timestamp);
+        for (std::size_t i = 0; i < expected.size(); i++) {
+            same &= got[i].id == expected[i].id && v[perm[i]].id == expected[i].id;
+        }
+        expected = v;
+        std::stable_sort(expected.begin(), expected.end(),
+                         [](const Event &a, const Event &b) { return a.timestamp > b.timestamp; });
+        got = v;
+        toolbox::sorting::sort_by_key(got.begin(), got.end(), timestamp, std::greater<uint32_t>());
+        for (std::size_t i = 0; i < expected.size(); i++) {
+            same &= got[i].id == expected[i].id;
+        }
+        expected = v;
+        std::stable_sort(expected.begin(), expected.end(), [&](const Event &a, const Event &b) {
+            return name(a) < name(b);
+        });
+        got = v;
+        toolbox::sorting::sort_by_key(got.begin(), got.end(), name);
+        for (std::size_t i = 0; i < expected.size(); i++) {
+            same &= got[i].id == expected[i].id;
+        }
+        // argsort by value: the records compared in place, and plain numbers.
+        const std::vector<std::size_t> by_value = toolbox::sorting::argsort(
+            v.begin(), v.end(), [&](const Event &a, const Event &b) { return name(a) < name(b); });
+        for (std::size_t i = 0; i < expected.size(); i++) {
+            same &= v[by_value[i]].id == expected[i].id;
+        }
+        std::vector<double> d;
+        for (const Event &e : v) {
+            d.push_back(static_cast<double>(e.timestamp) - 20.5);
+        }
+        const std::vector<std::size_t> order = toolbox::sorting::argsort(d.begin(), d.end());
+        for (std::size_t i = 1; i < order.size(); i++) {
+            same &= d[order[i - 1]] < d[order[i]] ||
+                    (d[order[i - 1]] == d[order[i]] && order[i - 1] < order[i]);
+        }
+    }
+    return toolbox::test_utils::check(same, "sort_by_key and argsort order stably by key");
+}
+
+std::vector<std::vector<int>> selection_inputs(std::size_t n) {
+    std::vector<std::vector<int>> inputs;
+    inputs.push_back(make_random(n, 11));
+    inputs.push_back(make_sorted(n));
+    inputs.push_back(make_reverse(n));
+    inputs.push_back(make_duplicates(n));
+    std::vector<int> pipe(n), few = make_random(n, 12);
+    for (std::size_t i = 0; i < n; i++) {
+        pipe[i] = static_cast<int>(i < n / 2 ? i : n - i);
+        few[i] %= 3;
+    }
+    inputs.push_back(pipe);
+    inputs.push_back(few);
+    return inputs;
+}
+
+bool test_partial_sort() {
+    bool ok = true;
+    for (std::size_t n : {std::size_t(0), std::size_t(1), std::size_t(100), std::size_t(200000)}) {
+        for (const std::vector<int> &input : selection_inputs(n)) {
+            std::vector<int> expected = input;
+            std::sort(expected.begin(), expected.end());
+            // Small k takes the heap, which a descending input makes give up; large k nth_element.
+            for (std::size_t k : {std::size_t(0), std::size_t(1), std::size_t(10), n / 3, n}) {
+                k = std::min(k, n);
+                std::vector<int> v = input;
+                toolbox::sorting::partial_sort(v.begin(), v.begin() + k, v.end());
+                std::vector<int> rest(v.begin() + k, v.end());
+                std::sort(rest.begin(), rest.end());
+                ok &= std::equal(v.begin(), v.begin() + k, expected.begin()) &&
+                      std::equal(rest.begin(), rest.end(), expected.begin() + k);
+                std::vector<double> d(input.begin(), input.end());
+                toolbox::sorting::partial_sort(d.begin(), d.begin() + k, d.end(),
+                                               std::greater<double>());
+                for (std::size_t i = 0; i < k; i++) {
+                    ok &= d[i] == expected[n - 1 - i];
+                }
+            }
+        }
+    }
+    std::vector<std::string> strs;
+    for (int x : make_random(5000, 13)) {
+        strs.push_back(std::to_string(x));
+    }
+    std::vector<std::string> expected = strs;
+    std::sort(expected.begin(), expected.end());
+    toolbox::sorting::partial_sort(strs.begin(), strs.begin() + 7, strs.end());
+    ok &= std::equal(strs.begin(), strs.begin() + 7, expected.begin());
+    return toolbox::test_utils::check(ok, "partial_sort sorts the k smallest elements first");
+}
+
+bool test_nth_element() {
+    bool ok = true;
+    for (std::size_t n : {std::size_t(1), std::size_t(2), std::size_t(17), std::size_t(5000),
+                          std::size_t(200000)}) {
+        for (const std::vector<int> &input : selection_inputs(n)) {
+            std::vector<int> expected = input;
+            std::sort(expected.begin(), expected.end());
+            for (std::size_t k : {std::size_t(0), n / 7, n / 2, n - 1}) {
+                std::vector<int> v = input;
+                toolbox::sorting::nth_element(v.begin(), v.begin() + k, v.end());
+                ok &= v[k] == expected[k];
+                for (std::size_t i = 0; i < n; i++) {
+                    ok &= i < k ? v[i] <= v[k] : v[i] >= v[k];
+                }
+                std::sort(v.begin(), v.end());
+                ok &= v == expected;
+            }
+        }
+    }
+    std::vector<std::string> strs;
+    for (int x : make_random(5000, 14)) {
+        strs.push_back(std::to_string(x % 100));
+    }
+    std::vector<std::string> expected = strs;
+    std::sort(expected.begin(), expected.end(), std::greater<std::string>());
+    toolbox::sorting::nth_element(strs.begin(), strs.begin() + 1234, strs.end(),
+                                  std::greater<std::string>());
+    ok &= strs[1234] == expected[1234];
+    return toolbox::test_utils::check(ok, "nth_element puts the k-th element in place");
+}
+
+template <typename T, typename Compare>
+bool check_top_k(const std::vector<T> &v, std::size_t k, Compare comp) {
+    std::vector<T> expected = v;
+    std::sort(expected.begin(), expected.end(), comp);
+    expected.resize(std::min(k, v.size()));
+    // The whole range at once, one element at a time, and three shards merged.
+    toolbox::sorting::TopK<T, Compare> all(k, comp);
+    all.push(v.begin(), v.end());
+    toolbox::sorting::TopK<T, Compare> one(k, comp);
+    for (const T &x : v) {
+        one.push(x);
+    }
+    toolbox::sorting::TopK<T, Compare> merged(k, comp);
+    for (std::size_t part = 0; part < 3; part++) {
+        toolbox::sorting::TopK<T, Compare> shard(k, comp);
+        shard.push(v.begin() + static_cast<std::ptrdiff_t>(v.size() * part / 3),
+                   v.begin() + static_cast<std::ptrdiff_t>(v.size() * (part + 1) / 3));
+        merged.merge(shard);
+    }
+    return all.sorted() == expected && one.sorted() == expected && merged.sorted() == expected &&
+           all.size() == expected.size();
+}
+
+bool test_top_k() {
+    bool ok = true;
+    for (std::size_t n : {std::size_t(0), std::size_t(5), std::size_t(1000), std::size_t(100000)}) {
+        std::vector<int> ints = make_random(n, 15);
+        std::vector<float> floats;
+        std::vector<uint32_t> u32;
+        std::vector<uint64_t> u64;
+        std::vector<int16_t> i16;
+        std::vector<std::string> strs;
+        for (int x : ints) {
+            floats.push_back(static_cast<float>(x % 5000) - 2500.5f);
+            // Values on both sides of the top bit, which the unsigned compares have to order.
+            u32.push_back(static_cast<uint32_t>(x) * 2654435761u);
+            u64.push_back(static_cast<uint64_t>(x) << 40);
+            i16.push_back(static_cast<int16_t>(x % 30000 - 15000));
+            strs.push_back(std::to_string(x % 777));
+        }
+        for (std::size_t k : {std::size_t(0), std::size_t(1), std::size_t(100), n + 1}) {
+            ok &= check_top_k(ints, k, std::greater<int>()) &&
+                  check_top_k(ints, k, std::less<int>()) &&
+                  check_top_k(floats, k, std::greater<float>()) &&
+                  check_top_k(floats, k, std::less<float>()) &&
+                  check_top_k(u32, k, std::greater<uint32_t>()) &&
+                  check_top_k(u32, k, std::less<uint32_t>()) &&
+                  check_top_k(u64, k, std::greater<uint64_t>()) &&
+                  check_top_k(u64, k, std::less<uint64_t>()) &&
+                  check_top_k(i16, k, std::greater<int16_t>()) &&
+                  check_top_k(strs, k, std::greater<std::string>());
+        }
+    }
+    // An increasing stream replaces the top for every element.
+    std::vector<double> rising(50000);
+    for (std::size_t i = 0; i < rising.size(); i++) {
+        rising[i] = static_cast<double>(i) * 0.5;
+    }
+    ok &= check_top_k(rising, 64, std::greater<double>()) &&
+          check_top_k(rising, 64, std::less<double>());
+    toolbox::sorting::TopK<int> top(3);
+    for (int x : {5, 1, 9, 7, 3}) {
+        top.push(x);
+    }
+    ok &= top.threshold() == 5 && top.sorted() == std::vector<int>({9, 7, 5});
+    return toolbox::test_utils::check(ok, "TopK keeps the k first elements, also merged");
+}
+
+template <std::size_t N>
+bool check_sort_n(unsigned &s) {
+    std::vector<int> a;
+    std::vector<float> b;
+    std::vector<uint64_t> c;
+    std::vector<std::string> d;
+    for (std::size_t i = 0; i < N; i++) {
+        s = s * 1664525u + 1013904223u;
+        a.push_back(static_cast<int>(s >> 8) % 7 - 3);
+        // Signed zeros compare equal, but both must survive the sort.
+        b.push_back(i % 3 == 0 ? (i % 2 ? -0.0f : 0.0f) : static_cast<float>(s >> 20) - 2048.0f);
+        c.push_back(static_cast<uint64_t>(s) << 33);
+        d.push_back(std::to_string(s % 100));
+    }
+    std::vector<int> ea = a;
+    std::vector<float> eb = b;
+    std::vector<uint64_t> ec = c;
+    std::vector<std::string> ed = d;
+    std::sort(ea.begin(), ea.end());
+    std::sort(eb.begin(), eb.end(), std::greater<float>());
+    std::sort(ec.begin(), ec.end());
+    std::sort(ed.begin(), ed.end());
+    toolbox::sorting::sort_n<N>(a.begin());
+    toolbox::sorting::sort_n<N>(b.begin(), std::greater<float>());
+    toolbox::sorting::sort_n<N>(c.begin());
+    toolbox::sorting::sort_n<N>(d.begin());
+    const auto negative_zeros = [](const std::vector<float> &v) {
+        return std::count_if(v.begin(), v.end(),
+                             [](float x) { return x == 0.0f && std::signbit(x); });
+    };
+    return a == ea && b == eb && negative_zeros(b) == negative_zeros(eb) && c == ec && d == ed;
+}
+
+template <std::size_t... N>
+bool check_sort_n_sizes(std::index_sequence<N...>) {
+    unsigned s = 7;
+    bool ok = true;
+    for (int round = 0; round < 20; round++) {
+        ok &= (check_sort_n<N>(s) & ...);
+    }
+    return ok;
+}
+
+bool test_sort_n_sizes() {
+    return toolbox::test_utils::check(check_sort_n_sizes(std::make_index_sequence<33>()),
+                                      "sort_n sorts every size up to 32");
+}
+
+std::string temp_path(const char *name) {
+    const char *dir = std::getenv("TMPDIR");
+    return std::string(dir != nullptr && *dir != '\0' ? dir : "/tmp") + "/toolbox_sorting_test_" +
+           std::to_string(::getpid()) + "_" + name;
+}
+
+bool test_external_sort_records() {
+    // 300000 records in the minimum budget make a dozen runs, merged in two passes.
+    std::vector<uint64_t> v(300000);
+    unsigned s = 5;
+    for (uint64_t &x : v) {
+        s = s * 1664525u + 1013904223u;
+        x = (static_cast<uint64_t>(s) << 20) ^ (s >> 7);
+    }
+    const std::string in = temp_path("records.in");
+    const std::string out = temp_path("records.out");
+    std::FILE *f = std::fopen(in.c_str(), "wb");
+    std::fwrite(v.data(), sizeof(uint64_t), v.size(), f);
+    std::fclose(f);
+    const bool ok = toolbox::sorting::external_sort<uint64_t>(in, out, 0);
+    std::vector<uint64_t> got(v.size() + 1);
+    f = std::fopen(out.c_str(), "rb");
+    got.resize(f != nullptr ? std::fread(got.data(), sizeof(uint64_t), got.size(), f) : 0);
+    if (f != nullptr) {
+        std::fclose(f);
+    }
+    // A file that is not a whole number of records is rejected.
+    f = std::fopen(in.c_str(), "ab");
+    std::fputc('x', f);
+    std::fclose(f);
+    const bool rejected = !toolbox::sorting::external_sort<uint64_t>(in, out, 0);
+    std::remove(in.c_str());
+    std::remove(out.c_str());
+    std::sort(v.begin(), v.end());
+    return toolbox::test_utils::check(ok && got == v && rejected,
+                                      "external_sort sorts binary records through temp files");
+}
+
+bool test_external_sort_open_files() {
+    // 1.5 million records in the minimum budget make 46 runs, more than the 24 temporary files a
+    // limit of 48 open files leaves to the sort: the oldest runs are merged as the runs are made.
+    std::vector<uint64_t> v(1500000);
+    unsigned s = 13;
+    for (uint64_t &x : v) {
+        s = s * 1664525u + 1013904223u;
+        x = (static_cast<uint64_t>(s) << 24) ^ (s >> 5);
+    }
+    const std::string in = temp_path("open_files.in");
+    const std::string out = temp_path("open_files.out");
+    std::FILE *f = std::fopen(in.c_str(), "wb");
+    std::fwrite(v.data(), sizeof(uint64_t), v.size(), f);
+    std::fclose(f);
+    struct rlimit saved;
+    ::getrlimit(RLIMIT_NOFILE, &saved);
+    struct rlimit low = saved;
+    low.rlim_cur = std::min<rlim_t>(saved.rlim_cur, 48);
+    ::setrlimit(RLIMIT_NOFILE, &low);
+    const bool ok = toolbox::sorting::external_sort<uint64_t>(in, out, 0);
+    ::setrlimit(RLIMIT_NOFILE, &saved);
+    std::vector<uint64_t> got(v.size() + 1);
+    f = std::fopen(out.c_str(), "rb");
+    got.resize(f != nullptr ? std::fread(got.data(), sizeof(uint64_t), got.size(), f) : 0);
+    if (f != nullptr) {
+        std::fclose(f);
+    }
+    std::remove(in.c_str());
+    std::remove(out.c_str());
+    std::sort(v.begin(), v.end());
+    return toolbox::test_utils::check(ok && got == v,
+                                      "external_sort keeps its runs within the open file limit");
+}
+
+bool test_external_sort_lines() {
+    std::vector<std::string> lines;
+    unsigned s = 11;
+    for (int i = 0; i < 40000; i++) {
+        s = s * 1664525u + 1013904223u;
+        lines.push_back(std::string((s >> 8) % 40, static_cast<char>('a' + (s >> 16) % 26)) +
+                        std::to_string(s % 1000));
+    }
+    lines.push_back("");
+    lines.push_back(std::string(300000, 'm'));  // longer than a chunk
+    lines.push_back("last line without newline");
+    const std::string in = temp_path("lines.in");
+    const std::string out = temp_path("lines.out");
+    std::FILE *f = std::fopen(in.c_str(), "wb");
+    for (std::size_t i = 0; i < lines.size(); i++) {
+        std::fputs(lines[i].c_str(), f);
+        if (i + 1 < lines.size()) {
+            std::fputc('\n', f);
+        }
+    }
+    std::fclose(f);
+    const bool ok =
+        toolbox::sorting::external_sort_lines(in, out, 0, std::greater<std::string_view>());
+    std::string expected;
+    std::sort(lines.begin(), lines.end(), std::greater<std::string>());
+    for (const std::string &line : lines) {
+        expected += line + "\n";
+    }
+    std::string got;
+    f = std::fopen(out.c_str(), "rb");
+    for (int c; f != nullptr && (c = std::fgetc(f)) != EOF;) {
+        got.push_back(static_cast<char>(c));
+    }
+    if (f != nullptr) {
+        std::fclose(f);
+    }
+    std::remove(in.c_str());
+    std::remove(out.c_str());
+    return toolbox::test_utils::check(ok && got == expected,
+                                      "external_sort_lines sorts newline-delimited text");
+}
+
+bool test_msd_radix_sort_strings() {
+    std::vector<std::string> v;
+    v.push_back("");
+    v.push_back("");
+    v.push_back(std::string(1, '\xff'));
+    v.push_back(std::string("a\0b", 3));
+    v.push_back("a");
+    v.push_back(std::string(300, 'x'));
+    v.push_back(std::string(300, 'x') + "a");
+    unsigned s = 5;
+    for (int i = 0; i < 20000; i++) {
+        s = s * 1664525u + 1013904223u;
+        std::string str = i % 3 ? "prefix/" : "";
+        for (unsigned len = s % 9; len > 0; len--) {
+            s = s * 1664525u + 1013904223u;
+            str += static_cast<char>('a' + (s >> 16) % 4);
+        }
+        v.push_back(str);
+    }
+    std::vector<std::string> expected = v;
+    std::sort(expected.begin(), expected.end());
+    toolbox::sorting::msd_radix_sort(v.begin(), v.end());
+    bool ok = toolbox::test_utils::check(v == expected, "msd_radix_sort strings");
+    std::vector<std::string> small(expected.rbegin(), expected.rbegin() + 20);
+    toolbox::sorting::msd_radix_sort(small.begin(), small.end());
+    return ok && toolbox::test_utils::check(std::is_sorted(small.begin(), small.end()),
+                                            "msd_radix_sort small input");
+}
+
+bool test_pdq_sort_patterns() {
+    const std::size_t n = 100000;
+    std::vector<std::vector<int>> inputs;
+    inputs.push_back(make_random(n, 5));
+    inputs.push_back(make_sorted(n));
+    inputs.push_back(make_reverse(n));
+    inputs.push_back(make_duplicates(n));
+    std::vector<int> late = make_sorted(n);  // a sorted batch with a few late arrivals
+    std::vector<int> noise = make_random(100, 6);
+    late.insert(late.end(), noise.begin(), noise.end());
+    inputs.push_back(late);
+    std::vector<int> swapped = make_sorted(n);
+    std::vector<int> pos = make_random(2000, 8);
+    for (std::size_t i = 0; i + 1 < pos.size(); i += 2) {
+        std::swap(swapped[pos[i] * 10], swapped[pos[i + 1] * 10]);
+    }
+    inputs.push_back(swapped);
+    std::vector<int> pipe(n), saw(n), few = make_random(n, 9);
+    for (std::size_t i = 0; i < n; i++) {
+        pipe[i] = static_cast<int>(i < n / 2 ? i : n - i);
+        saw[i] = static_cast<int>(i % 1000);
+        few[i] %= 4;
+    }
+    inputs.push_back(pipe);
+    inputs.push_back(saw);
+    inputs.push_back(few);
+    bool ok = true;
+    for (std::size_t i = 0; i < inputs.size(); i++) {
+        std::vector<int> expected = inputs[i];
+        std::sort(expected.begin(), expected.end());
+        std::vector<int> v = inputs[i];
+        toolbox::sorting::pdq_sort(v.begin(), v.end());
+        // The comparator below is not std::less, so it takes the branchy partition.
+        std::vector<int> w = inputs[i];
+        toolbox::sorting::pdq_sort(w.begin(), w.end(), [](int a, int b) { return a < b; });
+        std::vector<double> d(inputs[i].begin(), inputs[i].end());
+        toolbox::sorting::pdq_sort(d.begin(), d.end(), std::greater<double>());
+        std::reverse(d.begin(), d.end());
+        ok &= toolbox::test_utils::check(v == expected && w == expected &&
+                                             std::equal(d.begin(), d.end(), expected.begin()),
+                                         "pdq_sort pattern " + std::to_string(i));
+    }
+    std::vector<std::string> strs;
+    for (int x : make_random(5000, 10)) {
+        strs.push_back(std::to_string(x));
+    }
+    std::vector<std::string> expected = strs;
+    std::sort(expected.begin(), expected.end());
+    toolbox::sorting::pdq_sort(strs.begin(), strs.end());
+    return ok && toolbox::test_utils::check(strs == expected, "pdq_sort strings");
+}
+
+bool test_parallel_sort_large() {
+    toolbox::parallel::thread_pool pool(3);
+    std::vector<std::vector<int>> inputs;
+    inputs.push_back(make_random(200000, 17));
+    inputs.push_back(make_sorted(100000));
+    inputs.push_back(make_reverse(100000));
+    inputs.push_back(make_duplicates(100000));
+    inputs.push_back(std::vector<int>(50000, 4));
+    bool ok = true;
+    for (std::size_t i = 0; i < inputs.size(); i++) {
+        std::vector<int> expected = inputs[i];
+        std::vector<int> v = inputs[i];
+        std::vector<int> d = inputs[i];
+        std::sort(expected.begin(), expected.end());
+        toolbox::sorting::parallel_sort(v.begin(), v.end(), std::less<int>(), pool);
+        toolbox::sorting::parallel_sort(d.begin(), d.end(), std::greater<int>(), pool);
+        std::reverse(d.begin(), d.end());
+        ok &= toolbox::test_utils::check(v == expected && d == expected,
+                                         "parallel_sort input " + std::to_string(i));
+    }
+    // A record without a default constructor, which owns memory: the buffer is constructed by
+    // the scatter and destroyed once.
+    struct Labeled {
+        explicit Labeled(int x) : key(x), label(std::to_string(x) + " is the key of this record") {}
+        int key;
+        std::string label;
+    };
+    std::vector<Labeled> labeled;
+    for (int x : make_random(100000, 18)) {
+        labeled.emplace_back(x % 5000);
+    }
+    const auto by_key = [](const Labeled &a, const Labeled &b) { return a.key < b.key; };
+    toolbox::sorting::parallel_sort(labeled.begin(), labeled.end(), by_key, pool);
+    bool same = std::is_sorted(labeled.begin(), labeled.end(), by_key);
+    for (const Labeled &l : labeled) {
+        same &= l.label == std::to_string(l.key) + " is the key of this record";
+    }
+    return ok && toolbox::test_utils::check(same, "parallel_sort records without a default "
+                                                  "constructor");
+}
+
+bool test_parallel_sort_deterministic() {
+    // Equal keys with different ids: the order among them must not depend on the threads.
+    std::vector<Event> v;
+    unsigned s = 21;
+    for (int i = 0; i < 300000; i++) {
+        s = s * 1664525u + 1013904223u;
+        v.push_back(Event{(s >> 8) % (i < 150000 ? 1000u : 50u), i});
+    }
+    const auto by_timestamp = [](const Event &a, const Event &b) {
+        return a.timestamp < b.timestamp;
+    };
+    std::vector<std::vector<int>> ids;
+    for (std::size_t threads : {std::size_t(1), std::size_t(2), std::size_t(5)}) {
+        toolbox::parallel::thread_pool pool(threads);
+        std::vector<Event> w = v;
+        toolbox::sorting::parallel_sort(w.begin(), w.end(), by_timestamp, pool);
+        if (!toolbox::test_utils::check(std::is_sorted(w.begin(), w.end(), by_timestamp),
+                                        "parallel_sort records sorted")) {
+            return false;
+        }
+        ids.push_back(std::vector<int>());
+        for (const Event &e : w) {
+            ids.back().push_back(e.id);
+        }
+    }
+    return toolbox::test_utils::check(ids[0] == ids[1] && ids[0] == ids[2],
+                                      "parallel_sort same order for 1, 2 and 5 threads");
+}
+
+struct Named {
+    std::string name;
+    int id;
+};
+
+bool test_msd_radix_sort_key() {
+    std::vector<Named> v;
+    unsigned s = 9;
+    for (int i = 0; i < 5000; i++) {
+        s = s * 1664525u + 1013904223u;
+        v.push_back(Named{"chr" + std::to_string(s % 200u), i});
+    }
+    toolbox::sorting::msd_radix_sort(v.begin(), v.end(),
+                                     [](const Named &x) -> const std::string & { return x.name; });
+    bool ok = true;
+    for (std::size_t i = 1; i < v.size(); i++) {
+        ok &= v[i - 1].name <= v[i].name;
+    }
+    return toolbox::test_utils::check(ok, "msd_radix_sort with a key extractor");
+}
 
 // ---- Algorithm test runner -----------------------------------------------
 
@@ -380,9 +1173,35 @@ int main() {
         {"ternary_split_quick_sort", test_ternary_split_quick_sort_asc,
          test_ternary_split_quick_sort_desc},
         {"merge_insertion_sort", test_merge_insertion_sort_asc, test_merge_insertion_sort_desc},
+        {"radix_sort", test_radix_sort_asc, test_radix_sort_desc},
+        {"pdq_sort", test_pdq_sort_asc, test_pdq_sort_desc},
+        {"parallel_sort", test_parallel_sort_asc, test_parallel_sort_desc},
     };
     const std::size_t num_algos = sizeof(algos) / sizeof(algos[0]);
 
+    toolbox::test_utils::Test key_tests[] = {
+        {"radix_sort_floats", test_radix_sort_floats},
+        {"radix_sort_integer_widths", test_radix_sort_integer_widths},
+        {"radix_sort_records_stable", test_radix_sort_records_stable},
+        {"tim_sort_stable", test_tim_sort_stable},
+        {"merge_sort_stable", test_merge_sort_stable},
+        {"kway_merge_stable", test_kway_merge_stable},
+        {"sort_n_sizes", test_sort_n_sizes},
+        {"sort_by_key", test_sort_by_key},
+        {"partial_sort", test_partial_sort},
+        {"nth_element", test_nth_element},
+        {"top_k", test_top_k},
+        {"external_sort_records", test_external_sort_records},
+        {"external_sort_open_files", test_external_sort_open_files},
+        {"external_sort_lines", test_external_sort_lines},
+        {"msd_radix_sort_strings", test_msd_radix_sort_strings},
+        {"msd_radix_sort_key", test_msd_radix_sort_key},
+        {"pdq_sort_patterns", test_pdq_sort_patterns},
+        {"parallel_sort_large", test_parallel_sort_large},
+        {"parallel_sort_deterministic", test_parallel_sort_deterministic},
+    };
+    const std::size_t num_key_tests = sizeof(key_tests) / sizeof(key_tests[0]);
+
     int pass = 0, fail = 0;
     for (std::size_t a = 0; a < num_algos; ++a) {
         bool ok = run_algorithm(algos[a], cases);
@@ -396,6 +1215,17 @@ int main() {
             ++fail;
         }
     }
+    for (std::size_t t = 0; t < num_key_tests; ++t) {
+        if (key_tests[t].fn()) {
+            std::cout << toolbox::color::cyan << "PASS " << key_tests[t].name
+                      << toolbox::color::reset << "\n";
+            ++pass;
+        } else {
+            std::cout << toolbox::color::yellow << "FAIL " << key_tests[t].name
+                      << toolbox::color::reset << "\n";
+            ++fail;
+        }
+    }
 
     std::cout << "\n";
     if (fail == 0) {
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "toolbox/string/fm_index.hpp"
+#include "toolbox/string/packed_dna.hpp"
 
 #include "utils/test_util.hpp"
 
@@ -136,6 +137,27 @@ bool test_locate_order(
     return all_passed;
 }
 
+// An index of the packed text answers like the index of the text.
+bool test_packed(const std::pair<std::string, std::vector<std::string>> &test_case) {
+    const std::string &text = test_case.first;
+    const std::vector<std::string> &patterns = test_case.second;
+    bool all_passed = true;
+    toolbox::string::fm_index index(text);
+    toolbox::string::fm_index packed(toolbox::string::packed_dna{text});
+    for (const auto &pattern : patterns) {
+        std::vector<int> positions = packed.locate(pattern);
+        std::vector<int> expected_positions = index.locate(pattern);
+        std::sort(expected_positions.begin(), expected_positions.end());
+        std::sort(positions.begin(), positions.end());
+        if (packed.count(pattern) != index.count(pattern) || positions != expected_positions) {
+            std::cerr << "Packed test failed for\n- text    '" << text << "'\n- pattern '"
+                      << pattern << "'" << std::endl;
+            all_passed = false;
+        }
+    }
+    return all_passed;
+}
+
 }  // namespace
 
 int main() {
@@ -145,6 +167,16 @@ int main() {
     toolbox::test_utils::runTests<std::pair<std::string, std::vector<std::string>>>(
         {{test_count, "Count Test"}, {test_locate, "Locate Test"}}, std::make_pair(text, patterns));
 
+    std::string dna = text + "NNACGTNACG";
+    patterns.push_back("N");
+    patterns.push_back("NAC");
+    patterns.push_back("TNA");
+    toolbox::test_utils::runTests<std::pair<std::string, std::vector<std::string>>>(
+        {{test_packed, "Packed DNA Test"}}, std::make_pair(dna, patterns));
+    toolbox::test_utils::runTests<std::pair<std::string, std::vector<std::string>>>(
+        {{test_packed, "Packed DNA Test on Empty String"}},
+        std::make_pair(std::string(), patterns));
+
     std::string order = "GTCA";
     toolbox::test_utils::runTests<std::tuple<std::string, std::vector<std::string>, std::string>>(
         {{test_count_order, "Count Test with Order"},
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "toolbox/string/packed_dna.hpp"
+
+#include "utils/test_util.hpp"
+
+namespace {
+
+std::string random_dna(std::mt19937 &rng, std::size_t n, const char *alphabet = "ACGTN") {
+    const std::size_t sigma = std::char_traits<char>::length(alphabet);
+    std::string s(n, 'A');
+    for (char &c : s) {
+        c = alphabet[rng() % sigma];
+    }
+    return s;
+}
+
+std::string naive_reverse_complement(const std::string &s) {
+    std::string r;
+    for (auto it = s.rbegin(); it != s.rend(); ++it) {
+        const char *from = "ACGTN";
+        const char *to = "TGCAN";
+        r += to[std::char_traits<char>::find(from, 5, *it) - from];
+    }
+    return r;
+}
+
+bool test_round_trip() {
+    bool ok = true;
+    const toolbox::string::packed_dna p("ACGTuacgXnN");
+    ok &= toolbox::test_utils::check(p.str() == "ACGTTACGNNN", "Round trip: lowercase, U and N");
+    ok &= toolbox::test_utils::check(p.size() == 11 && p.n_count() == 3, "Round trip: counts");
+    ok &= toolbox::test_utils::check(p.code(1) == 1 && p.code(8) == 4 && p.is_n(9) &&
+                                         !p.is_n(7) && p[3] == 'T',
+                                     "Round trip: code and is_n");
+    ok &= toolbox::test_utils::check(toolbox::string::packed_dna().str().empty(),
+                                     "Round trip: empty");
+    std::mt19937 rng(40);
+    for (std::size_t n : {31u, 32u, 33u, 64u, 65u, 1000u}) {
+        const std::string s = random_dna(rng, n);
+        const toolbox::string::packed_dna q(s);
+        ok &= toolbox::test_utils::check(q.str() == s, "Round trip: random");
+        ok &= toolbox::test_utils::check(q.words().size() == (n + 31) / 32 + 1,
+                                         "Round trip: 2 bits per base");
+    }
+    return ok;
+}
+
+bool test_iterators() {
+    std::mt19937 rng(41);
+    const std::string s = random_dna(rng, 300);
+    const toolbox::string::packed_dna p(s);
+    bool ok = true;
+    ok &= toolbox::test_utils::check(std::equal(p.begin(), p.end(), s.begin(), s.end()),
+                                     "Iterators: forward");
+    ok &= toolbox::test_utils::check(std::string(p.rbegin(), p.rend()) ==
+                                         std::string(s.rbegin(), s.rend()),
+                                     "Iterators: reverse");
+    ok &= toolbox::test_utils::check(
+        std::count(p.begin(), p.end(), 'G') == std::count(s.begin(), s.end(), 'G') &&
+            p.end() - p.begin() == 300 && (p.begin() + 17)[3] == s[20] &&
+            *(p.end() - 1) == s.back(),
+        "Iterators: random access");
+    ok &= toolbox::test_utils::check(
+        std::search(p.begin(), p.end(), s.begin() + 100, s.begin() + 110) - p.begin() <= 100,
+        "Iterators: std::search");
+    return ok;
+}
+
+bool test_substr_reverse_complement() {
+    std::mt19937 rng(42);
+    bool ok = true;
+    for (int t = 0; t < 300; t++) {
+        const std::string s = random_dna(rng, rng() % 200, t % 2 ? "ACGT" : "ACGTN");
+        const toolbox::string::packed_dna p(s);
+        const toolbox::string::packed_dna r = p.reverse_complement();
+        ok &= toolbox::test_utils::check(r.str() == naive_reverse_complement(s),
+                                         "Reverse complement == naive");
+        ok &= toolbox::test_utils::check(r.reverse_complement() == p,
+                                         "Reverse complement: involution");
+        const std::size_t pos = s.empty() ? 0 : rng() % (s.size() + 1);
+        const std::size_t len = rng() % 100;
+        const toolbox::string::packed_dna q = p.substr(pos, len);
+        ok &= toolbox::test_utils::check(q.str() == s.substr(pos, len), "Substr == naive");
+        ok &= toolbox::test_utils::check(q == toolbox::string::packed_dna(s.substr(pos, len)),
+                                         "Substr: same words as a fresh packing");
+    }
+    return ok;
+}
+
+bool test_common_prefix() {
+    std::mt19937 rng(43);
+    bool ok = true;
+    for (int t = 0; t < 500; t++) {
+        // Long shared runs, so that whole words match.
+        std::string a = random_dna(rng, 50 + rng() % 150, t % 3 ? "ACGT" : "ACGTN");
+        std::string b = a.substr(rng() % 40);
+        for (int e = 0; e < 3; e++) {
+            b[rng() % b.size()] = "ACGTN"[rng() % 5];
+        }
+        const toolbox::string::packed_dna pa(a), pb(b);
+        const std::size_t i = rng() % (a.size() + 1);
+        const std::size_t j = rng() % (b.size() + 1);
+        std::size_t expected = 0;
+        while (i + expected < a.size() && j + expected < b.size() &&
+               a[i + expected] == b[j + expected]) {
+            expected++;
+        }
+        ok &= toolbox::test_utils::check(
+            toolbox::string::common_prefix(pa, i, pb, j) == expected, "Common prefix == naive");
+        ok &= toolbox::test_utils::check(
+            toolbox::string::common_prefix(pa, i, pb, j, 5) == std::min<std::size_t>(expected, 5),
+            "Common prefix: limit");
+    }
+    const toolbox::string::packed_dna n1("ACGNNA"), n2("ACGNNC"), n3("ACGANC");
+    ok &= toolbox::test_utils::check(toolbox::string::common_prefix(n1, 0, n2, 0) == 5,
+                                     "Common prefix: N matches N");
+    ok &= toolbox::test_utils::check(toolbox::string::common_prefix(n1, 0, n3, 0) == 3,
+                                     "Common prefix: N does not match A");
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    toolbox::test_utils::Test tests[] = {
+        {"round_trip", test_round_trip},
+        {"iterators", test_iterators},
+        {"substr_reverse_complement", test_substr_reverse_complement},
+        {"common_prefix", test_common_prefix},
+    };
+    return toolbox::test_utils::run_tests(tests, sizeof(tests) / sizeof(tests[0]));
+}